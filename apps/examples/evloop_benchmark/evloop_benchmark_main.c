@@ -0,0 +1,249 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * examples/evloop_benchmark/evloop_benchmark_main.c
+ *
+ * Measures a turn of the libtuv event loop with a few active pipes while
+ * the number of idle pipes watched by the loop grows.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include <uv.h>
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_EVLOOP_BENCHMARK_TURNS
+#define CONFIG_EXAMPLES_EVLOOP_BENCHMARK_TURNS 1000
+#endif
+
+#define EBENCH_MINIDLE  8
+#define EBENCH_MAXIDLE  256
+#define EBENCH_NACTIVE  2
+
+/* The select() backend of libtuv watches at most TUV_POLL_EVENTS_SIZE
+ * descriptors.
+ */
+
+#ifdef CONFIG_FS_EPOLL
+#define EBENCH_BACKEND  "epoll"
+#define EBENCH_MAXFDS   (EBENCH_MAXIDLE + EBENCH_NACTIVE)
+#else
+#define EBENCH_BACKEND  "select"
+#define EBENCH_MAXFDS   TUV_POLL_EVENTS_SIZE
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct ebench_pipe_s {
+	uv_poll_t handle;
+	int fd[2];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uv_loop_t g_loop;
+static struct ebench_pipe_s *g_pipes;
+static int g_npipes;
+static int g_pending;			/* Active pipes written but not read yet */
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t ebench_now_usec(void)
+{
+	struct timespec ts;
+
+#ifdef CLOCK_MONOTONIC
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+	clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void ebench_read_cb(uv_poll_t *handle, int status, int events)
+{
+	struct ebench_pipe_s *p = (struct ebench_pipe_s *)handle->data;
+	char c;
+
+	if (status == 0 && (events & UV_READABLE) && read(p->fd[0], &c, 1) == 1) {
+		g_pending--;
+	}
+}
+
+/* Open one more pipe and watch its read end */
+
+static int ebench_addpipe(void)
+{
+	struct ebench_pipe_s *p = &g_pipes[g_npipes];
+
+	if (pipe(p->fd) < 0) {
+		return -1;
+	}
+
+	if (uv_poll_init(&g_loop, &p->handle, p->fd[0]) != 0) {
+		close(p->fd[0]);
+		close(p->fd[1]);
+		return -1;
+	}
+
+	p->handle.data = p;
+	uv_poll_start(&p->handle, UV_READABLE, ebench_read_cb);
+	g_npipes++;
+	return 0;
+}
+
+/* Time 'turns' turns with the first 'nactive' pipes written */
+
+static uint32_t ebench_measure(int nactive, int turns)
+{
+	uint64_t usec;
+	int turn;
+	int i;
+
+	usec = ebench_now_usec();
+	for (turn = 0; turn < turns; turn++) {
+		for (i = 0; i < nactive; i++) {
+			if (write(g_pipes[i].fd[1], "x", 1) == 1) {
+				g_pending++;
+			}
+		}
+
+		while (g_pending > 0) {
+			uv_run(&g_loop, UV_RUN_ONCE);
+		}
+	}
+
+	usec = ebench_now_usec() - usec;
+	return (uint32_t)(usec / turns);
+}
+
+/****************************************************************************
+ * evloop_benchmark_main
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int evloop_benchmark_main(int argc, char *argv[])
+#endif
+{
+	int turns = CONFIG_EXAMPLES_EVLOOP_BENCHMARK_TURNS;
+	int maxidle = EBENCH_MAXIDLE;
+	int nactive = EBENCH_NACTIVE;
+	int nidle;
+	int i;
+
+	if (argc > 1) {
+		maxidle = atoi(argv[1]);
+	}
+
+	if (argc > 2) {
+		nactive = atoi(argv[2]);
+	}
+
+	if (nactive < 1) {
+		nactive = 1;
+	}
+
+	if (maxidle + nactive > EBENCH_MAXFDS) {
+		maxidle = EBENCH_MAXFDS - nactive;
+		printf("The %s backend watches at most %d descriptors\n", EBENCH_BACKEND, EBENCH_MAXFDS);
+	}
+
+	if (maxidle < 0 || turns < 1) {
+		printf("usage: %s [maxidle] [nactive]\n", argv[0]);
+		return -1;
+	}
+
+	g_pipes = (struct ebench_pipe_s *)calloc(maxidle + nactive, sizeof(struct ebench_pipe_s));
+	if (g_pipes == NULL) {
+		printf("Out of memory\n");
+		return -1;
+	}
+
+	g_npipes = 0;
+	g_pending = 0;
+	uv_loop_init(&g_loop);
+
+	for (i = 0; i < nactive; i++) {
+		if (ebench_addpipe() < 0) {
+			printf("Cannot open the active pipes\n");
+			goto out;
+		}
+	}
+
+	printf("%s backend, %d active pipes, microseconds per turn\n", EBENCH_BACKEND, nactive);
+	printf("  %8s %10s\n", "idle", "usec");
+
+	/* Measure with no idle pipe, then with 8, 16, 32, ... */
+
+	nidle = 0;
+	for (;;) {
+		while (g_npipes < nactive + nidle) {
+			if (ebench_addpipe() < 0) {
+				printf("Out of descriptors at %d idle pipes\n", g_npipes - nactive);
+				goto out;
+			}
+		}
+
+		printf("  %8d %10u\n", nidle, (unsigned int)ebench_measure(nactive, turns));
+
+		if (nidle >= maxidle) {
+			break;
+		}
+
+		nidle = nidle == 0 ? EBENCH_MINIDLE : nidle * 2;
+		if (nidle > maxidle) {
+			nidle = maxidle;
+		}
+	}
+
+out:
+	for (i = 0; i < g_npipes; i++) {
+		uv_close((uv_handle_t *)&g_pipes[i].handle, NULL);
+	}
+
+	uv_run(&g_loop, UV_RUN_DEFAULT);
+	for (i = 0; i < g_npipes; i++) {
+		close(g_pipes[i].fd[0]);
+		close(g_pipes[i].fd[1]);
+	}
+
+	uv_loop_close(&g_loop);
+	free(g_pipes);
+	return 0;
+}
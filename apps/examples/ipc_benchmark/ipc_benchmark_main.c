@@ -0,0 +1,426 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * examples/ipc_benchmark/ipc_benchmark_main.c
+ *
+ * Compares shared memory channels with message queues and pipes between
+ * two threads: the throughput of a stream of messages, and the latency of
+ * a message sent back and forth.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <mqueue.h>
+#include <errno.h>
+#include <time.h>
+
+#include <tinyara/shmchan.h>
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_IPC_BENCHMARK_MESSAGES
+#define CONFIG_EXAMPLES_IPC_BENCHMARK_MESSAGES 10000
+#endif
+
+#define IBENCH_DEPTH    8		/* Messages queued before the sender blocks */
+#define IBENCH_MAXSIZE  1024
+#define IBENCH_KEY      0x1bc	/* Keys of the two channels */
+
+#if !defined(CONFIG_DISABLE_MQUEUE) && CONFIG_MQ_MAXMSGSIZE > 0
+#define IBENCH_MQUEUE
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A transport has two directions: 0 from the main thread to the peer
+ * thread, 1 back.  recv() returns the first byte of the message, or -1.
+ */
+
+struct ibench_ops_s {
+	const char *name;
+	int (*open)(size_t size);
+	int (*send)(int dir, const uint8_t *msg, size_t size);
+	int (*recv)(int dir, size_t size);
+	void (*close)(void);
+};
+
+struct ibench_peer_s {
+	const struct ibench_ops_s *ops;
+	size_t size;
+	int count;
+	bool echo;					/* Send each message back */
+	int errors;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct shmch_s g_shmch[2];
+#ifdef IBENCH_MQUEUE
+static mqd_t g_mqd[2];
+#endif
+static int g_pipefd[2][2];
+
+static uint8_t g_msg[IBENCH_MAXSIZE];	/* Echoes of the peer thread */
+static uint8_t g_rxbuf[IBENCH_MAXSIZE];	/* Used by the peer thread only */
+static uint8_t g_echobuf[IBENCH_MAXSIZE];	/* Used by the main thread only */
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t ibench_now_usec(void)
+{
+	struct timespec ts;
+
+#ifdef CLOCK_MONOTONIC
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+	clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Shared memory channels: the message is written into and read from the
+ * ring buffers in place.
+ */
+
+static int shm_open2(size_t size)
+{
+	if (shmch_create(IBENCH_KEY, IBENCH_DEPTH, size, SHMCH_SPSC, &g_shmch[0]) < 0) {
+		return -1;
+	}
+
+	if (shmch_create(IBENCH_KEY + 1, IBENCH_DEPTH, size, SHMCH_SPSC, &g_shmch[1]) < 0) {
+		shmch_close(&g_shmch[0]);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int shm_send(int dir, const uint8_t *msg, size_t size)
+{
+	uint8_t *buf = (uint8_t *)shmch_reserve(&g_shmch[dir], true);
+
+	if (buf == NULL) {
+		return -1;
+	}
+
+	memcpy(buf, msg, size);
+	return shmch_commit(&g_shmch[dir], buf, size);
+}
+
+static int shm_recv(int dir, size_t size)
+{
+	uint8_t *buf;
+	size_t len;
+	int first;
+
+	buf = (uint8_t *)shmch_receive(&g_shmch[dir], &len, true);
+	if (buf == NULL || len != size) {
+		return -1;
+	}
+
+	first = buf[0];
+	shmch_release(&g_shmch[dir]);
+	return first;
+}
+
+static void shm_close2(void)
+{
+	shmch_close(&g_shmch[0]);
+	shmch_close(&g_shmch[1]);
+}
+
+/* Message queues */
+
+#ifdef IBENCH_MQUEUE
+static int mq_open2(size_t size)
+{
+	struct mq_attr attr;
+
+	if (size > CONFIG_MQ_MAXMSGSIZE) {
+		return -1;
+	}
+
+	memset(&attr, 0, sizeof(attr));
+	attr.mq_maxmsg = IBENCH_DEPTH;
+	attr.mq_msgsize = size;
+
+	g_mqd[0] = mq_open("ibench0", O_RDWR | O_CREAT, 0666, &attr);
+	if (g_mqd[0] == (mqd_t)-1) {
+		return -1;
+	}
+
+	g_mqd[1] = mq_open("ibench1", O_RDWR | O_CREAT, 0666, &attr);
+	if (g_mqd[1] == (mqd_t)-1) {
+		mq_close(g_mqd[0]);
+		mq_unlink("ibench0");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int mq_send2(int dir, const uint8_t *msg, size_t size)
+{
+	return mq_send(g_mqd[dir], (const char *)msg, size, 0);
+}
+
+static int mq_recv2(int dir, size_t size)
+{
+	uint8_t *buf = dir == 0 ? g_rxbuf : g_echobuf;
+
+	if (mq_receive(g_mqd[dir], (char *)buf, size, NULL) != (ssize_t)size) {
+		return -1;
+	}
+
+	return buf[0];
+}
+
+static void mq_close2(void)
+{
+	mq_close(g_mqd[0]);
+	mq_close(g_mqd[1]);
+	mq_unlink("ibench0");
+	mq_unlink("ibench1");
+}
+#endif
+
+/* Pipes */
+
+static int pipe_open2(size_t size)
+{
+	if (pipe(g_pipefd[0]) < 0) {
+		return -1;
+	}
+
+	if (pipe(g_pipefd[1]) < 0) {
+		close(g_pipefd[0][0]);
+		close(g_pipefd[0][1]);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int pipe_send(int dir, const uint8_t *msg, size_t size)
+{
+	ssize_t n;
+
+	while (size > 0) {
+		n = write(g_pipefd[dir][1], msg, size);
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return -1;
+		}
+
+		msg += n;
+		size -= n;
+	}
+
+	return 0;
+}
+
+static int pipe_recv(int dir, size_t size)
+{
+	uint8_t *buf = dir == 0 ? g_rxbuf : g_echobuf;
+	size_t nread = 0;
+	ssize_t n;
+
+	while (nread < size) {
+		n = read(g_pipefd[dir][0], buf + nread, size - nread);
+		if (n <= 0) {
+			if (n < 0 && errno == EINTR) {
+				continue;
+			}
+			return -1;
+		}
+
+		nread += n;
+	}
+
+	return buf[0];
+}
+
+static void pipe_close2(void)
+{
+	close(g_pipefd[0][0]);
+	close(g_pipefd[0][1]);
+	close(g_pipefd[1][0]);
+	close(g_pipefd[1][1]);
+}
+
+static const struct ibench_ops_s g_transports[] = {
+	{"shmchan", shm_open2, shm_send, shm_recv, shm_close2},
+#ifdef IBENCH_MQUEUE
+	{"mqueue", mq_open2, mq_send2, mq_recv2, mq_close2},
+#endif
+	{"pipe", pipe_open2, pipe_send, pipe_recv, pipe_close2},
+};
+
+/* The peer thread receives 'count' messages, checking their first byte,
+ * and sends each one back if 'echo' is set.
+ */
+
+static void *ibench_peer(void *arg)
+{
+	struct ibench_peer_s *peer = (struct ibench_peer_s *)arg;
+	int i;
+
+	for (i = 0; i < peer->count; i++) {
+		if (peer->ops->recv(0, peer->size) != (uint8_t)i) {
+			peer->errors++;
+		}
+
+		if (peer->echo) {
+			g_msg[0] = (uint8_t)i;
+			if (peer->ops->send(1, g_msg, peer->size) < 0) {
+				peer->errors++;
+				break;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+/* Time 'count' messages of 'size' bytes, sent one after the other or each
+ * waiting for its echo.  Returns the time in microseconds, or zero.
+ */
+
+static uint64_t ibench_run(const struct ibench_ops_s *ops, size_t size, int count, bool echo, int *errors)
+{
+	struct ibench_peer_s peer;
+	pthread_t thread;
+	uint8_t msg[IBENCH_MAXSIZE];
+	uint64_t start;
+	int ret;
+	int i;
+
+	memset(&peer, 0, sizeof(peer));
+	peer.ops = ops;
+	peer.size = size;
+	peer.count = count;
+	peer.echo = echo;
+
+	memset(msg, 0x5a, size);
+
+	ret = pthread_create(&thread, NULL, ibench_peer, &peer);
+	if (ret != 0) {
+		printf("pthread_create() failed: %d\n", ret);
+		(*errors)++;
+		return 0;
+	}
+
+	start = ibench_now_usec();
+	for (i = 0; i < count; i++) {
+		msg[0] = (uint8_t)i;
+		if (ops->send(0, msg, size) < 0) {
+			printf("%s: send failed: %d\n", ops->name, errno);
+			(*errors)++;
+			break;
+		}
+
+		if (echo && ops->recv(1, size) != (uint8_t)i) {
+			(*errors)++;
+		}
+	}
+
+	/* The peer has the last message when it returns */
+
+	pthread_join(thread, NULL);
+	*errors += peer.errors;
+	return i == count ? ibench_now_usec() - start : 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * ipc_benchmark_main
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int ipc_benchmark_main(int argc, char *argv[])
+#endif
+{
+	const struct ibench_ops_s *ops;
+	int count = CONFIG_EXAMPLES_IPC_BENCHMARK_MESSAGES;
+	size_t size = 32;
+	uint64_t stream;
+	uint64_t pingpong;
+	int errors = 0;
+	int i;
+
+	if (argc > 1) {
+		size = (size_t)strtoul(argv[1], NULL, 10);
+	}
+
+	if (argc > 2) {
+		count = atoi(argv[2]);
+	}
+
+	if (size < 1 || size > IBENCH_MAXSIZE || count < 1) {
+		printf("usage: %s [size] [count]\n", argv[0]);
+		return 1;
+	}
+
+	printf("ipc benchmark: %d messages of %lu bytes, %d queued\n", count, (unsigned long)size, IBENCH_DEPTH);
+	printf("%10s %10s %10s %12s %8s\n", "transport", "msg/s", "KB/s", "usec/round", "errors");
+
+	for (i = 0; i < sizeof(g_transports) / sizeof(g_transports[0]); i++) {
+		int before = errors;
+
+		ops = &g_transports[i];
+		if (ops->open(size) < 0) {
+			printf("%10s (cannot open for %lu bytes: %d)\n", ops->name, (unsigned long)size, errno);
+			continue;
+		}
+
+		stream = ibench_run(ops, size, count, false, &errors);
+		pingpong = ibench_run(ops, size, count, true, &errors);
+		ops->close();
+
+		printf("%10s %10llu %10llu %12llu %8d\n", ops->name, stream ? (unsigned long long)count * 1000000 / stream : 0ULL, stream ? (unsigned long long)count * size * 1000000 / 1024 / stream : 0ULL, (unsigned long long)pingpong / count, errors - before);
+	}
+
+	printf("ipc benchmark: %s\n", errors == 0 ? "PASS" : "FAIL");
+	return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,358 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * examples/json_benchmark/json_benchmark_main.c
+ *
+ * Compares the time and the heap allocations of the cJSON parse modes and
+ * of the streaming tokenizer on a device shadow document.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+#include <apps/netutils/cJSON.h>
+#include <apps/netutils/json_stream.h>
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_JSON_BENCHMARK_ITERATIONS
+#define CONFIG_EXAMPLES_JSON_BENCHMARK_ITERATIONS 200
+#endif
+
+#ifndef CONFIG_EXAMPLES_JSON_BENCHMARK_ARENA_SIZE
+#define CONFIG_EXAMPLES_JSON_BENCHMARK_ARENA_SIZE 4096
+#endif
+
+#define JBENCH_HEAP    0
+#define JBENCH_ARENA   1
+#define JBENCH_INSITU  2
+#define JBENCH_STREAM  3
+#define JBENCH_NMODES  4
+
+#define JBENCH_CHUNK   64		/* Bytes given to the tokenizer at a time */
+#define JBENCH_TOKEN   64		/* Token buffer of the tokenizer */
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const char g_document[] =
+	"{\"state\":{"
+	"\"desired\":{\"power\":\"on\",\"mode\":\"cool\",\"target\":23.5,"
+	"\"fan\":{\"speed\":3,\"swing\":true},\"schedule\":["
+	"{\"day\":\"mon\",\"on\":\"07:00\",\"off\":\"09:30\"},"
+	"{\"day\":\"tue\",\"on\":\"07:00\",\"off\":\"09:30\"},"
+	"{\"day\":\"sat\",\"on\":\"10:00\",\"off\":\"23:00\"}]},"
+	"\"reported\":{\"power\":\"on\",\"mode\":\"cool\",\"target\":23.5,"
+	"\"temperature\":25.12,\"humidity\":48,\"fan\":{\"speed\":3,\"swing\":true},"
+	"\"firmware\":\"TizenRT 1.1 \\\"release\\\"\",\"location\":\"Living room\\n2F\","
+	"\"errors\":[],\"sensors\":[12,15,19,22,25,25,24,21],"
+	"\"network\":{\"ssid\":\"home\",\"rssi\":-61,\"ip\":\"192.168.0.27\"}}},"
+	"\"metadata\":{\"desired\":{\"power\":{\"timestamp\":1500000000},"
+	"\"mode\":{\"timestamp\":1500000000},\"target\":{\"timestamp\":1500000123}},"
+	"\"reported\":{\"temperature\":{\"timestamp\":1500000456},"
+	"\"humidity\":{\"timestamp\":1500000456}}},"
+	"\"version\":1024,\"timestamp\":1500000789,"
+	"\"clientToken\":\"client-\\u0041\\u0042-00001\"}";
+
+static const char *g_modenames[JBENCH_NMODES] = { "heap", "arena", "insitu", "stream" };
+
+static char g_buffer[CONFIG_EXAMPLES_JSON_BENCHMARK_ARENA_SIZE];
+static unsigned int g_nallocs;
+static unsigned int g_nevents;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t jbench_now_usec(void)
+{
+	struct timespec ts;
+
+#ifdef CLOCK_MONOTONIC
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+	clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Allocation hook of cJSON counting the heap allocations */
+
+static void *jbench_malloc(size_t size)
+{
+	g_nallocs++;
+	return malloc(size);
+}
+
+/* Parse the document once in 'mode'.  'text' is the work copy of the
+ * document for the in-situ parse.
+ */
+
+static cJSON *jbench_parse(int mode, cJSON_Arena *arena, char *text)
+{
+	switch (mode) {
+	case JBENCH_ARENA:
+		return cJSON_ParseArena(g_document, arena);
+
+	case JBENCH_INSITU:
+		memcpy(text, g_document, sizeof(g_document));
+		return cJSON_ParseInSitu(text, arena);
+
+	default:
+		return cJSON_Parse(g_document);
+	}
+}
+
+static void jbench_free(int mode, cJSON_Arena *arena, cJSON *root)
+{
+	if (mode == JBENCH_HEAP) {
+		cJSON_Delete(root);
+	} else {
+		cJSON_ResetArena(arena);
+	}
+}
+
+/* Tokenizer callback of the timed runs: count the events */
+
+static int jbench_count(void *arg, int event, const char *value, size_t len)
+{
+	g_nevents++;
+	return 0;
+}
+
+/* Tokenizer callback of the check: write every event back out */
+
+static int jbench_rewrite(void *arg, int event, const char *value, size_t len)
+{
+	struct json_writer_s *w = (struct json_writer_s *)arg;
+
+	switch (event) {
+	case JSON_OBJECT_BEGIN:
+		return json_write_object_begin(w);
+
+	case JSON_OBJECT_END:
+		return json_write_object_end(w);
+
+	case JSON_ARRAY_BEGIN:
+		return json_write_array_begin(w);
+
+	case JSON_ARRAY_END:
+		return json_write_array_end(w);
+
+	case JSON_KEY:
+		return json_write_key(w, value);
+
+	case JSON_STRING:
+		return json_write_stringn(w, value, len);
+
+	case JSON_NUMBER:
+		return json_write_raw(w, value, len);
+
+	case JSON_TRUE:
+	case JSON_FALSE:
+		return json_write_bool(w, event == JSON_TRUE);
+
+	case JSON_NULL:
+		return json_write_null(w);
+
+	default:
+		/* The token buffer holds every string of the document */
+
+		return -E2BIG;
+	}
+}
+
+/* Feed the document to a tokenizer in chunks */
+
+static int jbench_stream(json_callback_t cb, void *arg)
+{
+	struct json_parser_s parser;
+	char token[JBENCH_TOKEN];
+	size_t len = sizeof(g_document) - 1;
+	size_t pos;
+	size_t n;
+	int ret;
+
+	ret = json_parser_init(&parser, token, sizeof(token), cb, arg);
+	for (pos = 0; pos < len && ret == 0; pos += n) {
+		n = len - pos < JBENCH_CHUNK ? len - pos : JBENCH_CHUNK;
+		ret = json_parser_feed(&parser, g_document + pos, n);
+	}
+
+	if (ret == 0) {
+		ret = json_parser_finish(&parser);
+	}
+
+	if (ret < 0) {
+		printf("stream: error %d at byte %u\n", ret, (unsigned int)json_parser_offset(&parser));
+	}
+
+	return ret;
+}
+
+/* Check that every mode parses the document to the same tree.  The
+ * tokenizer is checked by writing its events to a document that cJSON
+ * parses again.
+ */
+
+static int jbench_verify(cJSON_Arena *arena, char *text)
+{
+	struct json_writer_s writer;
+	char *expected = NULL;
+	char *printed;
+	cJSON *root;
+	int ret = 0;
+	int mode;
+	int tree;
+
+	for (mode = 0; mode < JBENCH_NMODES && ret == 0; mode++) {
+		tree = mode;
+		if (mode == JBENCH_STREAM) {
+			json_writer_init(&writer, text, sizeof(g_document), NULL, NULL);
+			if (jbench_stream(jbench_rewrite, &writer) < 0 || json_writer_finish(&writer) < 0) {
+				ret = -1;
+				break;
+			}
+
+			root = cJSON_Parse(text);
+			tree = JBENCH_HEAP;
+		} else {
+			root = jbench_parse(mode, arena, text);
+		}
+
+		if (root == NULL) {
+			printf("%s: parse error near '%.16s'\n", g_modenames[mode], cJSON_GetErrorPtr());
+			return -1;
+		}
+
+		printed = cJSON_PrintUnformatted(root);
+		jbench_free(tree, arena, root);
+		if (printed == NULL) {
+			ret = -1;
+		} else if (expected == NULL) {
+			expected = printed;
+		} else {
+			if (strcmp(expected, printed) != 0) {
+				printf("%s: the parsed document differs\n", g_modenames[mode]);
+				ret = -1;
+			}
+
+			free(printed);
+		}
+	}
+
+	free(expected);
+	return ret;
+}
+
+/****************************************************************************
+ * json_benchmark_main
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int json_benchmark_main(int argc, char *argv[])
+#endif
+{
+	int iterations = CONFIG_EXAMPLES_JSON_BENCHMARK_ITERATIONS;
+	cJSON_Hooks hooks;
+	cJSON_Arena arena;
+	uint64_t usec;
+	char used[12];
+	cJSON *root;
+	char *text;
+	int mode;
+	int i;
+
+	if (argc > 1) {
+		iterations = atoi(argv[1]);
+	}
+
+	if (iterations < 1) {
+		printf("usage: %s [iterations]\n", argv[0]);
+		return -1;
+	}
+
+	text = (char *)malloc(sizeof(g_document));
+	if (text == NULL) {
+		printf("Out of memory\n");
+		return -1;
+	}
+
+	hooks.malloc_fn = jbench_malloc;
+	hooks.free_fn = free;
+	cJSON_InitHooks(&hooks);
+	cJSON_InitArena(&arena, g_buffer, sizeof(g_buffer), sizeof(g_buffer));
+
+	if (jbench_verify(&arena, text) < 0) {
+		goto out;
+	}
+
+	printf("%u byte document, %d parses, arena of %u bytes, stream chunks of %d bytes\n", (unsigned int)(sizeof(g_document) - 1), iterations, (unsigned int)sizeof(g_buffer), JBENCH_CHUNK);
+	printf("  %-8s %10s %10s %10s\n", "mode", "usec", "allocs", "arena");
+
+	for (mode = 0; mode < JBENCH_NMODES; mode++) {
+		g_nallocs = 0;
+		strcpy(used, "-");
+
+		usec = jbench_now_usec();
+		for (i = 0; i < iterations && mode == JBENCH_STREAM; i++) {
+			if (jbench_stream(jbench_count, NULL) < 0) {
+				goto out;
+			}
+		}
+
+		for (i = 0; i < iterations && mode != JBENCH_STREAM; i++) {
+			root = jbench_parse(mode, &arena, text);
+			if (root == NULL) {
+				printf("%s: out of memory\n", g_modenames[mode]);
+				goto out;
+			}
+
+			/* Bytes of the arena taken by a parse that fits in the buffer */
+
+			if (mode != JBENCH_HEAP && i == 0 && arena.base == g_buffer) {
+				snprintf(used, sizeof(used), "%u", (unsigned int)arena.used);
+			}
+
+			jbench_free(mode, &arena, root);
+		}
+
+		usec = jbench_now_usec() - usec;
+		printf("  %-8s %10u %10u %10s\n", g_modenames[mode], (unsigned int)(usec / iterations), g_nallocs / iterations, used);
+	}
+
+out:
+	cJSON_InitHooks(NULL);
+	cJSON_ResetArena(&arena);
+	free(text);
+	return 0;
+}
@@ -0,0 +1,185 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * examples/kernel_benchmark/kbench_gran.c
+ *
+ * Measures gran_alloc() and gran_free() in a granule heap kept at a given
+ * occupancy by random allocations of 1 to 8 granules.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <tinyara/mm/gran.h>
+
+#include "kernel_benchmark.h"
+
+#if defined(CONFIG_GRAN) && !defined(CONFIG_GRAN_SINGLE)
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#define KBENCH_GRAN_LOG2      5		/* 32 byte granules */
+#define KBENCH_GRAN_SIZE      (1 << KBENCH_GRAN_LOG2)
+#define KBENCH_GRAN_NGRANULES 1024
+#define KBENCH_GRAN_MAXRUN    8
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct kbench_gran_s {
+	FAR void *mem;
+	uint16_t ngranules;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct kbench_gran_s g_allocs[KBENCH_GRAN_NGRANULES];
+static int g_nallocs;
+static int g_used;				/* Granules allocated */
+static uint32_t g_seed;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t kbench_gran_rand(void)
+{
+	g_seed = g_seed * 1103515245 + 12345;
+	return g_seed >> 8;
+}
+
+static bool kbench_gran_alloc(GRAN_HANDLE handle)
+{
+	int n = 1 + kbench_gran_rand() % KBENCH_GRAN_MAXRUN;
+	FAR void *mem;
+
+	mem = gran_alloc(handle, n * KBENCH_GRAN_SIZE);
+	if (mem == NULL) {
+		return false;
+	}
+
+	g_allocs[g_nallocs].mem = mem;
+	g_allocs[g_nallocs].ngranules = n;
+	g_nallocs++;
+	g_used += n;
+	return true;
+}
+
+static void kbench_gran_free(GRAN_HANDLE handle)
+{
+	int i = kbench_gran_rand() % g_nallocs;
+
+	gran_free(handle, g_allocs[i].mem, g_allocs[i].ngranules * KBENCH_GRAN_SIZE);
+	g_used -= g_allocs[i].ngranules;
+	g_allocs[i] = g_allocs[--g_nallocs];
+}
+
+/* Fill a new heap up to 'percent' and time free/alloc pairs that keep it
+ * there.
+ */
+
+static int kbench_gran_measure(FAR void *heap, int percent)
+{
+	GRAN_HANDLE handle;
+	char name[40];
+	uint64_t start;
+	uint32_t failed = 0;
+	uint32_t i;
+	int target = KBENCH_GRAN_NGRANULES * percent / 100;
+
+	handle = gran_initialize(heap, KBENCH_GRAN_NGRANULES * KBENCH_GRAN_SIZE, KBENCH_GRAN_LOG2, KBENCH_GRAN_LOG2);
+	if (handle == NULL) {
+		printf("kbench_gran: gran_initialize failed\n");
+		return -1;
+	}
+
+	g_nallocs = 0;
+	g_used = 0;
+	g_seed = percent;
+	while (g_used < target) {
+		if (!kbench_gran_alloc(handle)) {
+			break;
+		}
+	}
+
+	start = kbench_now_usec();
+	for (i = 0; i < CONFIG_EXAMPLES_KERNEL_BENCHMARK_ITERATIONS; i++) {
+		kbench_gran_free(handle);
+		while (g_used < target) {
+			if (!kbench_gran_alloc(handle)) {
+				failed++;
+				break;
+			}
+		}
+	}
+
+	snprintf(name, sizeof(name), "free + alloc at %d%% used", percent);
+	kbench_report(name, CONFIG_EXAMPLES_KERNEL_BENCHMARK_ITERATIONS, kbench_now_usec() - start);
+	if (failed > 0) {
+		printf("  %-32s : %8lu failed allocations\n", "", (unsigned long)failed);
+	}
+
+	while (g_nallocs > 0) {
+		kbench_gran_free(handle);
+	}
+
+	gran_release(handle);
+	return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int kbench_gran(int argc, char *argv[])
+{
+	FAR void *heap;
+	int percent;
+
+	/* The allocator does not touch the heap, but it must be real memory */
+
+	heap = malloc(KBENCH_GRAN_NGRANULES * KBENCH_GRAN_SIZE);
+	if (heap == NULL) {
+		printf("kbench_gran: out of memory\n");
+		return -1;
+	}
+
+	printf("Granule allocator, %d granules, runs of 1 to %d (%d iterations)\n", KBENCH_GRAN_NGRANULES, KBENCH_GRAN_MAXRUN, CONFIG_EXAMPLES_KERNEL_BENCHMARK_ITERATIONS);
+
+	for (percent = 50; percent <= 90; percent += 10) {
+		if (kbench_gran_measure(heap, percent) < 0) {
+			break;
+		}
+	}
+
+	free(heap);
+	return 0;
+}
+
+#endif /* CONFIG_GRAN && !CONFIG_GRAN_SINGLE */
@@ -0,0 +1,277 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * examples/kernel_benchmark/kbench_mq.c
+ *
+ * Measures a message queue ping-pong between two threads while a growing
+ * number of unrelated threads are blocked receiving on another queue.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <pthread.h>
+#ifdef CONFIG_MQ_ZEROCOPY
+#include <tinyara/mqueue.h>
+#endif
+
+#include "kernel_benchmark.h"
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#define KBENCH_MQ_MSGSIZE CONFIG_MQ_MAXMSGSIZE
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static mqd_t g_park;
+static mqd_t g_ping;
+static mqd_t g_pong;
+static volatile int g_stop;
+#ifdef CONFIG_MQ_ZEROCOPY
+static volatile int g_zerocopy;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static pthread_addr_t park_thread(pthread_addr_t arg)
+{
+	char msg[KBENCH_MQ_MSGSIZE];
+
+	while (mq_receive(g_park, msg, sizeof(msg), NULL) < 0) {
+	}
+
+	return NULL;
+}
+
+static pthread_addr_t pong_thread(pthread_addr_t arg)
+{
+	char msg[KBENCH_MQ_MSGSIZE];
+
+	while (!g_stop) {
+#ifdef CONFIG_MQ_ZEROCOPY
+		if (g_zerocopy) {
+			char *buffer;
+
+			/* Bounce the very same buffer back */
+
+			if (mq_receivebuffer(g_ping, &buffer, NULL) >= 0) {
+				if (mq_sendbuffer(g_pong, buffer, KBENCH_MQ_MSGSIZE, 1) != OK) {
+					mq_releasebuffer(buffer);
+				}
+			}
+			continue;
+		}
+#endif
+		if (mq_receive(g_ping, msg, sizeof(msg), NULL) >= 0) {
+			mq_send(g_pong, msg, sizeof(msg), 1);
+		}
+	}
+
+	return NULL;
+}
+
+static void kbench_mq_pingpong(int nparked)
+{
+	char msg[KBENCH_MQ_MSGSIZE];
+	char name[40];
+	uint64_t start;
+	uint32_t i;
+
+	memset(msg, 0x5a, sizeof(msg));
+
+	start = kbench_now_usec();
+	for (i = 0; i < CONFIG_EXAMPLES_KERNEL_BENCHMARK_ITERATIONS; i++) {
+		mq_send(g_ping, msg, sizeof(msg), 1);
+		while (mq_receive(g_pong, msg, sizeof(msg), NULL) < 0) {
+		}
+	}
+
+	snprintf(name, sizeof(name), "mq ping-pong, %d parked", nparked);
+	kbench_report(name, CONFIG_EXAMPLES_KERNEL_BENCHMARK_ITERATIONS, kbench_now_usec() - start);
+}
+
+#ifdef CONFIG_MQ_ZEROCOPY
+static void kbench_mq_pingpong_zerocopy(int nparked)
+{
+	char name[40];
+	char *buffer;
+	uint64_t start;
+	uint32_t i;
+
+	buffer = mq_getbuffer(g_ping);
+	if (buffer == NULL) {
+		return;
+	}
+
+	memset(buffer, 0x5a, KBENCH_MQ_MSGSIZE);
+	g_zerocopy = 1;
+
+	start = kbench_now_usec();
+	for (i = 0; i < CONFIG_EXAMPLES_KERNEL_BENCHMARK_ITERATIONS; i++) {
+		if (mq_sendbuffer(g_ping, buffer, KBENCH_MQ_MSGSIZE, 1) != OK) {
+			break;
+		}
+
+		while (mq_receivebuffer(g_pong, &buffer, NULL) < 0) {
+		}
+	}
+
+	snprintf(name, sizeof(name), "mq zero-copy, %d parked", nparked);
+	kbench_report(name, i, kbench_now_usec() - start);
+
+	/* Switch the pong thread back while it waits for the next ping */
+
+	g_zerocopy = 0;
+	mq_send(g_ping, buffer, KBENCH_MQ_MSGSIZE, 1);
+	while (mq_receive(g_pong, buffer, KBENCH_MQ_MSGSIZE, NULL) < 0) {
+	}
+	mq_releasebuffer(buffer);
+}
+#endif
+
+static mqd_t kbench_mq_open(const char *name, int maxmsg)
+{
+	struct mq_attr attr;
+
+	attr.mq_maxmsg = maxmsg;
+	attr.mq_msgsize = KBENCH_MQ_MSGSIZE;
+	attr.mq_flags = 0;
+
+	return mq_open(name, O_RDWR | O_CREAT, 0666, &attr);
+}
+
+static void kbench_mq_close(mqd_t mqdes, const char *name)
+{
+	if (mqdes != (mqd_t)-1) {
+		mq_close(mqdes);
+		mq_unlink(name);
+	}
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int kbench_mq(int argc, char *argv[])
+{
+	char msg[KBENCH_MQ_MSGSIZE];
+	pthread_t *parked;
+	pthread_t pong;
+	int nwaiters = CONFIG_EXAMPLES_KERNEL_BENCHMARK_WAITERS;
+	int nparked = 0;
+	int ret = -1;
+	int step;
+	int i;
+
+	if (argc > 1) {
+		nwaiters = atoi(argv[1]);
+		if (nwaiters < 0) {
+			nwaiters = 0;
+		}
+	}
+
+	parked = (pthread_t *)malloc((nwaiters > 0 ? nwaiters : 1) * sizeof(pthread_t));
+	if (parked == NULL) {
+		printf("kbench_mq: out of memory\n");
+		return -1;
+	}
+
+	g_park = kbench_mq_open("kbench_park", 1);
+	g_ping = kbench_mq_open("kbench_ping", 1);
+	g_pong = kbench_mq_open("kbench_pong", 1);
+	if (g_park == (mqd_t)-1 || g_ping == (mqd_t)-1 || g_pong == (mqd_t)-1) {
+		printf("kbench_mq: mq_open failed\n");
+		goto errout;
+	}
+
+	g_stop = 0;
+	if (kbench_thread_create(&pong, KBENCH_PRIORITY, KBENCH_STACKSIZE, pong_thread) != 0) {
+		printf("kbench_mq: failed to create pong thread\n");
+		goto errout;
+	}
+
+	printf("Message queue wakeup (%d iterations, %d byte messages)\n", CONFIG_EXAMPLES_KERNEL_BENCHMARK_ITERATIONS, KBENCH_MQ_MSGSIZE);
+
+	/* 0, 1, 4, 16, ... parked threads, then the requested maximum */
+
+	step = 0;
+	for (;;) {
+		while (nparked < step) {
+			if (kbench_thread_create(&parked[nparked], KBENCH_PARK_PRIORITY, KBENCH_PARK_STACKSIZE + KBENCH_MQ_MSGSIZE, park_thread) != 0) {
+				printf("  could only park %d threads\n", nparked);
+				nwaiters = nparked;
+				break;
+			}
+			nparked++;
+		}
+
+		kbench_mq_pingpong(nparked);
+#ifdef CONFIG_MQ_ZEROCOPY
+		kbench_mq_pingpong_zerocopy(nparked);
+#endif
+
+		if (nparked >= nwaiters) {
+			break;
+		}
+
+		step = step == 0 ? 1 : step * 4;
+		if (step > nwaiters) {
+			step = nwaiters;
+		}
+	}
+
+	memset(msg, 0, sizeof(msg));
+	g_stop = 1;
+	mq_send(g_ping, msg, sizeof(msg), 1);
+	pthread_join(pong, NULL);
+
+	/* The parked threads have the higher priority and take each message
+	 * as soon as it is sent.
+	 */
+
+	for (i = 0; i < nparked; i++) {
+		mq_send(g_park, msg, sizeof(msg), 1);
+	}
+
+	for (i = 0; i < nparked; i++) {
+		pthread_join(parked[i], NULL);
+	}
+
+	ret = 0;
+
+errout:
+	kbench_mq_close(g_park, "kbench_park");
+	kbench_mq_close(g_ping, "kbench_ping");
+	kbench_mq_close(g_pong, "kbench_pong");
+	free(parked);
+	return ret;
+}
@@ -0,0 +1,175 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * examples/kernel_benchmark/kbench_sem.c
+ *
+ * Measures a semaphore ping-pong between two threads while a growing number
+ * of unrelated threads are blocked on another semaphore. The cost of a
+ * round trip should not depend on how many tasks wait elsewhere.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sched.h>
+
+#include "kernel_benchmark.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static sem_t g_park;
+static sem_t g_ping;
+static sem_t g_pong;
+static volatile int g_stop;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void kbench_sem_wait(sem_t *sem)
+{
+	while (sem_wait(sem) != 0) {
+	}
+}
+
+static pthread_addr_t park_thread(pthread_addr_t arg)
+{
+	kbench_sem_wait(&g_park);
+	return NULL;
+}
+
+static pthread_addr_t pong_thread(pthread_addr_t arg)
+{
+	for (;;) {
+		kbench_sem_wait(&g_ping);
+		if (g_stop) {
+			break;
+		}
+		sem_post(&g_pong);
+	}
+
+	return NULL;
+}
+
+static void kbench_pingpong(int nparked)
+{
+	char name[40];
+	uint64_t start;
+	uint32_t i;
+
+	start = kbench_now_usec();
+	for (i = 0; i < CONFIG_EXAMPLES_KERNEL_BENCHMARK_ITERATIONS; i++) {
+		sem_post(&g_ping);
+		kbench_sem_wait(&g_pong);
+	}
+
+	snprintf(name, sizeof(name), "sem ping-pong, %d parked", nparked);
+	kbench_report(name, CONFIG_EXAMPLES_KERNEL_BENCHMARK_ITERATIONS, kbench_now_usec() - start);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int kbench_sem(int argc, char *argv[])
+{
+	pthread_t *parked;
+	pthread_t pong;
+	int nwaiters = CONFIG_EXAMPLES_KERNEL_BENCHMARK_WAITERS;
+	int nparked = 0;
+	int step;
+	int i;
+
+	if (argc > 1) {
+		nwaiters = atoi(argv[1]);
+		if (nwaiters < 0) {
+			nwaiters = 0;
+		}
+	}
+
+	parked = (pthread_t *)malloc((nwaiters > 0 ? nwaiters : 1) * sizeof(pthread_t));
+	if (parked == NULL) {
+		printf("kbench_sem: out of memory\n");
+		return -1;
+	}
+
+	sem_init(&g_park, 0, 0);
+	sem_init(&g_ping, 0, 0);
+	sem_init(&g_pong, 0, 0);
+	g_stop = 0;
+
+	if (kbench_thread_create(&pong, KBENCH_PRIORITY, KBENCH_STACKSIZE, pong_thread) != 0) {
+		printf("kbench_sem: failed to create pong thread\n");
+		free(parked);
+		return -1;
+	}
+
+	printf("Semaphore wakeup (%d iterations)\n", CONFIG_EXAMPLES_KERNEL_BENCHMARK_ITERATIONS);
+
+	/* 0, 1, 4, 16, ... parked threads, then the requested maximum */
+
+	step = 0;
+	for (;;) {
+		while (nparked < step) {
+			if (kbench_thread_create(&parked[nparked], KBENCH_PARK_PRIORITY, KBENCH_PARK_STACKSIZE, park_thread) != 0) {
+				printf("  could only park %d threads\n", nparked);
+				nwaiters = nparked;
+				break;
+			}
+			nparked++;
+		}
+
+		kbench_pingpong(nparked);
+
+		if (nparked >= nwaiters) {
+			break;
+		}
+
+		step = step == 0 ? 1 : step * 4;
+		if (step > nwaiters) {
+			step = nwaiters;
+		}
+	}
+
+	g_stop = 1;
+	sem_post(&g_ping);
+	pthread_join(pong, NULL);
+
+	for (i = 0; i < nparked; i++) {
+		sem_post(&g_park);
+	}
+
+	for (i = 0; i < nparked; i++) {
+		pthread_join(parked[i], NULL);
+	}
+
+	sem_destroy(&g_park);
+	sem_destroy(&g_ping);
+	sem_destroy(&g_pong);
+	free(parked);
+	return 0;
+}
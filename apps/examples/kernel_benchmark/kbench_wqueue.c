@@ -0,0 +1,159 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * examples/kernel_benchmark/kbench_wqueue.c
+ *
+ * Measures the round trip of immediate work on the low priority work queue
+ * while a growing number of delayed work items are pending on it.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <semaphore.h>
+#include <tinyara/clock.h>
+#include <tinyara/wqueue.h>
+
+#include "kernel_benchmark.h"
+
+#ifdef CONFIG_SCHED_LPWORK
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+/* Pending work is parked far enough in the future never to run */
+
+#define KBENCH_WQUEUE_PARK_DELAY  (3600 * CLOCKS_PER_SEC)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static sem_t g_done;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void kbench_wqueue_worker(FAR void *arg)
+{
+	sem_post(&g_done);
+}
+
+static void kbench_wqueue_park_worker(FAR void *arg)
+{
+}
+
+static void kbench_wqueue_roundtrip(int nparked)
+{
+	struct work_s work;
+	char name[40];
+	uint64_t start;
+	uint32_t i;
+
+	memset(&work, 0, sizeof(work));
+
+	start = kbench_now_usec();
+	for (i = 0; i < CONFIG_EXAMPLES_KERNEL_BENCHMARK_ITERATIONS; i++) {
+		work_queue(LPWORK, &work, kbench_wqueue_worker, NULL, 0);
+		while (sem_wait(&g_done) != 0) {
+		}
+	}
+
+	snprintf(name, sizeof(name), "work round trip, %d pending", nparked);
+	kbench_report(name, CONFIG_EXAMPLES_KERNEL_BENCHMARK_ITERATIONS, kbench_now_usec() - start);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int kbench_wqueue(int argc, char *argv[])
+{
+	struct work_s *parked;
+	int nwaiters = CONFIG_EXAMPLES_KERNEL_BENCHMARK_WAITERS;
+	int nparked = 0;
+	uint64_t start;
+	uint64_t usec = 0;
+	int step;
+	int i;
+
+	if (argc > 1) {
+		nwaiters = atoi(argv[1]);
+		if (nwaiters < 0) {
+			nwaiters = 0;
+		}
+	}
+
+	parked = (struct work_s *)zalloc((nwaiters > 0 ? nwaiters : 1) * sizeof(struct work_s));
+	if (parked == NULL) {
+		printf("kbench_wqueue: out of memory\n");
+		return -1;
+	}
+
+	sem_init(&g_done, 0, 0);
+
+	printf("Low priority work queue (%d iterations)\n", CONFIG_EXAMPLES_KERNEL_BENCHMARK_ITERATIONS);
+
+	/* 0, 1, 4, 16, ... pending work items, then the requested maximum.
+	 * Their deadlines are spread out so that they are not all queued at
+	 * the same place.
+	 */
+
+	step = 0;
+	for (;;) {
+		start = kbench_now_usec();
+		while (nparked < step) {
+			work_queue(LPWORK, &parked[nparked], kbench_wqueue_park_worker, NULL, KBENCH_WQUEUE_PARK_DELAY + (nparked * 7919) % 1000);
+			nparked++;
+		}
+		usec += kbench_now_usec() - start;
+
+		kbench_wqueue_roundtrip(nparked);
+
+		if (nparked >= nwaiters) {
+			break;
+		}
+
+		step = step == 0 ? 1 : step * 4;
+		if (step > nwaiters) {
+			step = nwaiters;
+		}
+	}
+
+	if (nparked > 0) {
+		kbench_report("queue delayed work", nparked, usec);
+	}
+
+	for (i = 0; i < nparked; i++) {
+		work_cancel(LPWORK, &parked[i]);
+	}
+
+	sem_destroy(&g_done);
+	free(parked);
+	return 0;
+}
+
+#endif /* CONFIG_SCHED_LPWORK */
@@ -0,0 +1,81 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * examples/kernel_benchmark/kernel_benchmark.h
+ ****************************************************************************/
+
+#ifndef __APPS_EXAMPLES_KERNEL_BENCHMARK_KERNEL_BENCHMARK_H
+#define __APPS_EXAMPLES_KERNEL_BENCHMARK_KERNEL_BENCHMARK_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <tinyara/wqueue.h>
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_KERNEL_BENCHMARK_ITERATIONS
+#define CONFIG_EXAMPLES_KERNEL_BENCHMARK_ITERATIONS 10000
+#endif
+
+#ifndef CONFIG_EXAMPLES_KERNEL_BENCHMARK_WAITERS
+#define CONFIG_EXAMPLES_KERNEL_BENCHMARK_WAITERS 256
+#endif
+
+/* Priority of the threads that run the measured loop. Helper threads that
+ * only have to be present (blocked) use KBENCH_PARK_PRIORITY, which is
+ * higher, so that they sort ahead of the measured threads in any
+ * prioritized list.
+ */
+
+#define KBENCH_PRIORITY       100
+#define KBENCH_PARK_PRIORITY  (KBENCH_PRIORITY + 50)
+#define KBENCH_STACKSIZE      2048
+#define KBENCH_PARK_STACKSIZE 1024
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Common helpers (kernel_benchmark_main.c) */
+
+uint64_t kbench_now_usec(void);
+void kbench_report(const char *name, uint32_t count, uint64_t usec);
+int kbench_thread_create(pthread_t *thread, int prio, size_t stacksize, pthread_startroutine_t entry);
+
+/* Benchmarks */
+
+int kbench_sem(int argc, char *argv[]);
+#ifndef CONFIG_DISABLE_MQUEUE
+int kbench_mq(int argc, char *argv[]);
+#endif
+#ifdef CONFIG_SCHED_LPWORK
+int kbench_wqueue(int argc, char *argv[]);
+#endif
+#if defined(CONFIG_GRAN) && !defined(CONFIG_GRAN_SINGLE)
+int kbench_gran(int argc, char *argv[]);
+#endif
+
+#endif /* __APPS_EXAMPLES_KERNEL_BENCHMARK_KERNEL_BENCHMARK_H */
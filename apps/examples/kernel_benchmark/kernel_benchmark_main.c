@@ -0,0 +1,157 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * examples/kernel_benchmark/kernel_benchmark_main.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "kernel_benchmark.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct kbench_entry_s {
+	const char *name;
+	int (*func)(int argc, char *argv[]);
+	const char *usage;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct kbench_entry_s g_kbench[] = {
+	{"sem", kbench_sem, "[nwaiters]"},
+#ifndef CONFIG_DISABLE_MQUEUE
+	{"mq", kbench_mq, "[nwaiters]"},
+#endif
+#ifdef CONFIG_SCHED_LPWORK
+	{"wqueue", kbench_wqueue, "[npending]"},
+#endif
+#if defined(CONFIG_GRAN) && !defined(CONFIG_GRAN_SINGLE)
+	{"gran", kbench_gran, ""},
+#endif
+};
+
+#define KBENCH_COUNT (sizeof(g_kbench) / sizeof(g_kbench[0]))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void kbench_usage(const char *progname)
+{
+	unsigned int i;
+
+	printf("Usage: %s <benchmark> [options]\n", progname);
+	for (i = 0; i < KBENCH_COUNT; i++) {
+		printf("  %s %s\n", g_kbench[i].name, g_kbench[i].usage);
+	}
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+uint64_t kbench_now_usec(void)
+{
+	struct timespec ts;
+
+#ifdef CLOCK_MONOTONIC
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+	clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Create a joinable thread with the given priority and stack size */
+
+int kbench_thread_create(pthread_t *thread, int prio, size_t stacksize, pthread_startroutine_t entry)
+{
+	pthread_attr_t attr;
+	struct sched_param sparam;
+	int ret;
+
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, stacksize);
+	sparam.sched_priority = prio;
+	pthread_attr_setschedparam(&attr, &sparam);
+
+	ret = pthread_create(thread, &attr, entry, NULL);
+	pthread_attr_destroy(&attr);
+	return ret;
+}
+
+/* Print the rate and the average cost of 'count' operations that took
+ * 'usec' in total, without floating point support in printf.
+ */
+
+void kbench_report(const char *name, uint32_t count, uint64_t usec)
+{
+	uint64_t nsec_per_op;
+	uint64_t ops_per_sec;
+
+	if (usec == 0) {
+		usec = 1;
+	}
+
+	nsec_per_op = usec * 1000 / (count ? count : 1);
+	ops_per_sec = (uint64_t)count * 1000000 / usec;
+
+	printf("  %-32s : %8lu ops/s %8lu.%03lu us/op\n", name, (unsigned long)ops_per_sec,
+		   (unsigned long)(nsec_per_op / 1000), (unsigned long)(nsec_per_op % 1000));
+}
+
+/****************************************************************************
+ * kernel_benchmark_main
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int kernel_benchmark_main(int argc, char *argv[])
+#endif
+{
+	unsigned int i;
+
+	if (argc < 2) {
+		kbench_usage(argv[0]);
+		return -1;
+	}
+
+	for (i = 0; i < KBENCH_COUNT; i++) {
+		if (strcmp(argv[1], g_kbench[i].name) == 0) {
+			return g_kbench[i].func(argc - 1, &argv[1]);
+		}
+	}
+
+	kbench_usage(argv[0]);
+	return -1;
+}
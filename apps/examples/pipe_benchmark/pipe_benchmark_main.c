@@ -0,0 +1,228 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * examples/pipe_benchmark/pipe_benchmark_main.c
+ *
+ * Measures the throughput of a pipe between two threads for read and write
+ * sizes from 1 byte to 4 KB.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <errno.h>
+#include <time.h>
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_PIPE_BENCHMARK_KBYTES
+#define CONFIG_EXAMPLES_PIPE_BENCHMARK_KBYTES 256
+#endif
+
+/* The data is a repeating pattern of PBENCH_PERIOD bytes.  The period is
+ * prime so that a lost or repeated chunk of any of the sizes shows up.
+ */
+
+#define PBENCH_PERIOD   251
+#define PBENCH_MAXCHUNK 4096
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct pbench_reader_s {
+	int fd;
+	size_t chunk;
+	size_t total;
+	size_t nread;
+	size_t errors;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const size_t g_chunks[] = { 1, 16, 64, 256, 1024, 4096 };
+
+/* PBENCH_MAXCHUNK bytes of the pattern from any offset in the period */
+
+static uint8_t g_pattern[PBENCH_MAXCHUNK + PBENCH_PERIOD];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t pbench_now_usec(void)
+{
+	struct timespec ts;
+
+#ifdef CLOCK_MONOTONIC
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+	clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Read until end of file, checking every byte against the pattern */
+
+static void *pbench_reader(void *arg)
+{
+	struct pbench_reader_s *rd = (struct pbench_reader_s *)arg;
+	uint8_t *buffer;
+	ssize_t n;
+
+	buffer = (uint8_t *)malloc(rd->chunk);
+	if (buffer == NULL) {
+		rd->errors = rd->total;
+		return NULL;
+	}
+
+	for (;;) {
+		n = read(rd->fd, buffer, rd->chunk);
+		if (n <= 0) {
+			if (n < 0 && errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+
+		if (memcmp(buffer, &g_pattern[rd->nread % PBENCH_PERIOD], n) != 0) {
+			rd->errors++;
+		}
+
+		rd->nread += n;
+	}
+
+	free(buffer);
+	return NULL;
+}
+
+/* Send 'total' bytes in writes of 'chunk' bytes and return the time in
+ * microseconds until the reader has seen all of them, or zero on failure.
+ */
+
+static uint64_t pbench_run(size_t chunk, size_t total, struct pbench_reader_s *rd)
+{
+	pthread_t reader;
+	uint64_t start;
+	size_t nwritten;
+	ssize_t n;
+	int fd[2];
+	int ret;
+
+	if (pipe(fd) < 0) {
+		printf("pipe() failed: %d\n", errno);
+		return 0;
+	}
+
+	memset(rd, 0, sizeof(*rd));
+	rd->fd = fd[0];
+	rd->chunk = chunk;
+	rd->total = total;
+
+	start = pbench_now_usec();
+
+	ret = pthread_create(&reader, NULL, pbench_reader, rd);
+	if (ret != 0) {
+		printf("pthread_create() failed: %d\n", ret);
+		close(fd[0]);
+		close(fd[1]);
+		return 0;
+	}
+
+	nwritten = 0;
+	while (nwritten < total) {
+		size_t len = total - nwritten < chunk ? total - nwritten : chunk;
+
+		n = write(fd[1], &g_pattern[nwritten % PBENCH_PERIOD], len);
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			printf("write() failed: %d\n", errno);
+			break;
+		}
+
+		nwritten += n;
+	}
+
+	/* Closing the write end makes the reader see end of file */
+
+	close(fd[1]);
+	pthread_join(reader, NULL);
+	close(fd[0]);
+
+	return pbench_now_usec() - start;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * pipe_benchmark_main
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int pipe_benchmark_main(int argc, char *argv[])
+#endif
+{
+	struct pbench_reader_s rd;
+	size_t total;
+	size_t errors = 0;
+	uint64_t usec;
+	int i;
+
+	total = (size_t)CONFIG_EXAMPLES_PIPE_BENCHMARK_KBYTES * 1024;
+	if (argc > 1) {
+		total = (size_t)strtoul(argv[1], NULL, 10) * 1024;
+	}
+
+	for (i = 0; i < sizeof(g_pattern); i++) {
+		g_pattern[i] = (uint8_t)((i % PBENCH_PERIOD) * 7);
+	}
+
+	printf("pipe benchmark: %lu KB per size, pipe buffer %d bytes\n", (unsigned long)(total / 1024), CONFIG_DEV_PIPE_SIZE);
+	printf("%8s %12s %10s %8s\n", "size", "usec", "KB/s", "errors");
+
+	for (i = 0; i < sizeof(g_chunks) / sizeof(g_chunks[0]); i++) {
+		usec = pbench_run(g_chunks[i], total, &rd);
+		if (rd.nread != total) {
+			rd.errors++;
+		}
+
+		printf("%8lu %12llu %10llu %8lu\n", (unsigned long)g_chunks[i], (unsigned long long)usec, usec ? (unsigned long long)total * 1000000 / 1024 / usec : 0ULL, (unsigned long)rd.errors);
+		errors += rd.errors;
+	}
+
+	printf("pipe benchmark: %s\n", errors == 0 ? "PASS" : "FAIL");
+	return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,574 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * examples/printf_benchmark/printf_benchmark_main.c
+ *
+ * Checks the integer and floating point conversions of snprintf() and
+ * measures the cost of one call for common formats.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#ifndef FAR
+#define FAR
+#endif
+
+/* The host build (Makefile.host) links the TizenRT formatter under tr_
+ * names and compares it to the host C library, which is assumed to be
+ * correctly rounded.
+ */
+
+#ifdef PRINTF_BENCHMARK_HOST
+int tr_snprintf(FAR char *buf, size_t size, FAR const char *format, ...);
+
+#define PB_SNPRINTF tr_snprintf
+#define PB_HAVE_LONG_LONG 1
+#else
+#define PB_SNPRINTF snprintf
+#ifdef CONFIG_HAVE_LONG_LONG
+#define PB_HAVE_LONG_LONG 1
+#endif
+#endif
+
+#ifndef CONFIG_EXAMPLES_PRINTF_BENCHMARK_CALLS
+#define CONFIG_EXAMPLES_PRINTF_BENCHMARK_CALLS 20000
+#endif
+
+/* Values are cycled through from a table of PB_NVALUES entries */
+
+#define PB_NVALUES   64
+#define PB_BUFSIZE   128
+
+/* Number of random values compared in the host build */
+
+#define PB_HOST_NCHECKS 200000
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef int (*pb_snprintf_t)(FAR char *buf, size_t size, FAR const char *format, ...);
+
+enum pb_type_e {
+	PB_INT,
+	PB_UINT,
+	PB_LLONG,
+	PB_DOUBLE
+};
+
+struct pb_case_s {
+	const char *name;
+	const char *fmt;
+	enum pb_type_e type;
+};
+
+/* An expected output of the floating point formatter.  Digits beyond the
+ * shortest representation that reads back exactly print as zeros, so
+ * "%.17g" prints exactly that representation.
+ */
+
+struct pb_golden_s {
+	const char *fmt;
+	double value;
+	const char *expected;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct pb_case_s g_cases[] = {
+	{"int", "%d", PB_INT},
+	{"uint", "%u", PB_UINT},
+	{"hex", "%x", PB_UINT},
+	{"hex08", "%08x", PB_UINT},
+#ifdef PB_HAVE_LONG_LONG
+	{"llong", "%lld", PB_LLONG},
+#endif
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+	{"fixed", "%f", PB_DOUBLE},
+	{"fixed3", "%.3f", PB_DOUBLE},
+	{"exp", "%e", PB_DOUBLE},
+	{"general", "%g", PB_DOUBLE},
+	{"exact", "%.17g", PB_DOUBLE},
+#endif
+};
+
+#define PB_NCASES (sizeof(g_cases) / sizeof(g_cases[0]))
+
+#ifdef CONFIG_LIBC_DTOA_SHORTEST
+static const struct pb_golden_s g_golden[] = {
+	{"%f", 0.0, "0.000000"},
+	{"%g", -0.0, "-0"},
+	{"%f", 1.0, "1.000000"},
+	{"%f", 123456789.0, "123456789.000000"},
+	{"%.3f", 2.0005, "2.001"},
+	{"%.1f", 0.05, "0.1"},
+	{"%.1f", 0.25, "0.2"},
+	{"%.0f", 2.5, "2"},
+	{"%.0f", 3.5, "4"},
+	{"%.2f", 1.005, "1.00"},
+	{"%e", 1e100, "1.000000e+100"},
+	{"%.3e", 6.02214076e23, "6.022e+23"},
+	{"%E", 1.5e-7, "1.500000E-07"},
+	{"%g", 0.1, "0.1"},
+	{"%g", 100000.0, "100000"},
+	{"%g", 1000000.0, "1e+06"},
+	{"%g", 0.0001, "0.0001"},
+	{"%g", 0.00001, "1e-05"},
+	{"%g", 999999.5, "1e+06"},
+	{"%#g", 1.0, "1.00000"},
+	{"%g", 1.0 / 3.0, "0.333333"},
+	{"%.17g", 0.1, "0.1"},
+	{"%.17g", 1.0 / 3.0, "0.3333333333333333"},
+	{"%.17g", 4.9406564584124654e-324, "5e-324"},
+	{"%.17g", 1.7976931348623157e308, "1.7976931348623157e+308"},
+	{"%+.2f", 3.14159, "+3.14"},
+	{"%10.3f", -3.14159, "    -3.142"},
+	{"%-10.1e|", 12345.0, "1.2e+04   |"},
+};
+
+#define PB_NGOLDEN (sizeof(g_golden) / sizeof(g_golden[0]))
+#endif
+
+static int g_ints[PB_NVALUES];
+static unsigned int g_uints[PB_NVALUES];
+#ifdef PB_HAVE_LONG_LONG
+static long long g_llongs[PB_NVALUES];
+#endif
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+static double g_doubles[PB_NVALUES];
+#endif
+
+static uint32_t g_seed = 0x2545f491;
+
+/****************************************************************************
+ * Private Functions: Values
+ ****************************************************************************/
+
+static uint32_t pb_random(void)
+{
+	/* xorshift32 */
+
+	g_seed ^= g_seed << 13;
+	g_seed ^= g_seed >> 17;
+	g_seed ^= g_seed << 5;
+	return g_seed;
+}
+
+/* Random integers of all lengths, not only the long ones that uniformly
+ * distributed values would give.
+ */
+
+static uint32_t pb_random_u32(void)
+{
+	uint32_t r = pb_random();
+
+	return r >> (pb_random() % 32);
+}
+
+#ifdef PB_HAVE_LONG_LONG
+static unsigned long long pb_random_u64(void)
+{
+	unsigned long long r = ((unsigned long long)pb_random() << 32) | pb_random();
+
+	return r >> (pb_random() % 64);
+}
+#endif
+
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+/* A random double with 53 significant bits, between 1e-5 and 1e9 so that
+ * "%f" needs at most 15 (DBL_DIG) significant digits.  Up to that many, the
+ * digits of the shortest representation padded with zeros are the correctly
+ * rounded ones.
+ */
+
+static double pb_random_double(void)
+{
+	double value = (double)(((unsigned long long)pb_random() << 21) ^ pb_random()) / 9007199254740992.0;
+	int expt = (int)(pb_random() % 15) - 5;
+
+	while (expt > 0) {
+		value *= 10.0;
+		expt--;
+	}
+
+	while (expt < 0) {
+		value /= 10.0;
+		expt++;
+	}
+
+	return (pb_random() & 1) ? -value : value;
+}
+#endif
+
+static void pb_fill_values(void)
+{
+	int i;
+
+	for (i = 0; i < PB_NVALUES; i++) {
+		g_uints[i] = pb_random_u32();
+		g_ints[i] = (i & 1) ? -(int)(pb_random_u32() >> 1) : (int)(pb_random_u32() >> 1);
+#ifdef PB_HAVE_LONG_LONG
+		g_llongs[i] = (i & 1) ? -(long long)(pb_random_u64() >> 1) : (long long)(pb_random_u64() >> 1);
+#endif
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+		g_doubles[i] = pb_random_double();
+#endif
+	}
+
+	/* The edge cases */
+
+	g_ints[0] = 0;
+	g_ints[1] = INT_MIN;
+	g_ints[2] = INT_MAX;
+	g_uints[0] = 0;
+	g_uints[1] = UINT_MAX;
+#ifdef PB_HAVE_LONG_LONG
+	g_llongs[0] = 0;
+	g_llongs[1] = LLONG_MIN;
+	g_llongs[2] = LLONG_MAX;
+#endif
+}
+
+/****************************************************************************
+ * Private Functions: Verification
+ ****************************************************************************/
+
+/* Call 'call' with value 'i' of the table for the type of 'c' */
+
+static int pb_format(pb_snprintf_t call, FAR const struct pb_case_s *c, int i, FAR char *buf)
+{
+	switch (c->type) {
+	case PB_INT:
+		return call(buf, PB_BUFSIZE, c->fmt, g_ints[i]);
+	case PB_UINT:
+		return call(buf, PB_BUFSIZE, c->fmt, g_uints[i]);
+#ifdef PB_HAVE_LONG_LONG
+	case PB_LLONG:
+		return call(buf, PB_BUFSIZE, c->fmt, g_llongs[i]);
+#endif
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+	case PB_DOUBLE:
+		return call(buf, PB_BUFSIZE, c->fmt, g_doubles[i]);
+#endif
+	default:
+		return -1;
+	}
+}
+
+/* The expected integer conversions, one digit at a time.  The harness does
+ * not use printf itself, so that it does not depend on what it tests.
+ */
+
+static void pb_ref_integer(FAR const struct pb_case_s *c, int i, FAR char *buf)
+{
+	unsigned long long value;
+	unsigned int base = 10;
+	unsigned int width = 0;
+	bool negative = false;
+	char digits[24];
+	int n = 0;
+
+	switch (c->type) {
+	case PB_INT:
+		negative = g_ints[i] < 0;
+		value = negative ? 0 - (unsigned long long)(long long)g_ints[i] : (unsigned long long)g_ints[i];
+		break;
+#ifdef PB_HAVE_LONG_LONG
+	case PB_LLONG:
+		negative = g_llongs[i] < 0;
+		value = negative ? 0 - (unsigned long long)g_llongs[i] : (unsigned long long)g_llongs[i];
+		break;
+#endif
+	default:
+		value = g_uints[i];
+		if (strchr(c->fmt, 'x') != NULL) {
+			base = 16;
+			width = (strcmp(c->fmt, "%08x") == 0) ? 8 : 0;
+		}
+		break;
+	}
+
+	do {
+		digits[n++] = "0123456789abcdef"[value % base];
+		value /= base;
+	} while (value != 0);
+
+	while (n < (int)width) {
+		digits[n++] = '0';
+	}
+
+	if (negative) {
+		*buf++ = '-';
+	}
+
+	while (n > 0) {
+		*buf++ = digits[--n];
+	}
+
+	*buf = '\0';
+}
+
+static int pb_verify_integers(void)
+{
+	char expected[PB_BUFSIZE];
+	char result[PB_BUFSIZE];
+	unsigned int ci;
+	int errors = 0;
+	int ret;
+	int i;
+
+	for (ci = 0; ci < PB_NCASES; ci++) {
+		FAR const struct pb_case_s *c = &g_cases[ci];
+
+		if (c->type == PB_DOUBLE) {
+			continue;
+		}
+
+		for (i = 0; i < PB_NVALUES; i++) {
+			pb_ref_integer(c, i, expected);
+			ret = pb_format(PB_SNPRINTF, c, i, result);
+			if (strcmp(result, expected) != 0 || ret != (int)strlen(expected)) {
+				printf("  FAIL %s: \"%s\" (%d), expected \"%s\"\n", c->fmt, result, ret, expected);
+				errors++;
+			}
+		}
+	}
+
+	return errors;
+}
+
+#ifdef CONFIG_LIBC_DTOA_SHORTEST
+static int pb_verify_golden(void)
+{
+	char result[PB_BUFSIZE];
+	unsigned int i;
+	int errors = 0;
+
+	for (i = 0; i < PB_NGOLDEN; i++) {
+		PB_SNPRINTF(result, PB_BUFSIZE, g_golden[i].fmt, g_golden[i].value);
+		if (strcmp(result, g_golden[i].expected) != 0) {
+			printf("  FAIL %s: \"%s\", expected \"%s\"\n", g_golden[i].fmt, result, g_golden[i].expected);
+			errors++;
+		}
+	}
+
+	return errors;
+}
+#endif
+
+#ifdef PRINTF_BENCHMARK_HOST
+/* Compare every case with the host C library on many random values, and
+ * check that "%.17g" of random bit patterns reads back exactly.  The host
+ * library prints 17 digits for "%.17g", not the shortest ones.
+ */
+
+static int pb_verify_host(void)
+{
+	char expected[PB_BUFSIZE];
+	char result[PB_BUFSIZE];
+	unsigned int ci;
+	int errors = 0;
+	int n;
+	int i;
+
+	for (n = 0; n < PB_HOST_NCHECKS / PB_NVALUES; n++) {
+		pb_fill_values();
+
+		for (ci = 0; ci < PB_NCASES; ci++) {
+			if (strcmp(g_cases[ci].fmt, "%.17g") == 0) {
+				continue;
+			}
+
+			for (i = 0; i < PB_NVALUES; i++) {
+				pb_format(snprintf, &g_cases[ci], i, expected);
+				pb_format(PB_SNPRINTF, &g_cases[ci], i, result);
+				if (strcmp(result, expected) != 0 && errors++ < 8) {
+					printf("  FAIL %s: \"%s\", host \"%s\"\n", g_cases[ci].fmt, result, expected);
+				}
+			}
+		}
+	}
+
+	for (n = 0; n < PB_HOST_NCHECKS; n++) {
+		unsigned long long bits = ((unsigned long long)pb_random() << 32) | pb_random();
+		double value;
+
+		memcpy(&value, &bits, sizeof(value));
+		if (value != value || value - value != 0.0) {
+			continue;			/* NaN or infinity */
+		}
+
+		PB_SNPRINTF(result, PB_BUFSIZE, "%.17g", value);
+		if (strtod(result, NULL) != value && errors++ < 8) {
+			printf("  FAIL %%.17g: \"%s\" does not read back\n", result);
+		}
+	}
+
+	return errors;
+}
+#endif
+
+static int pb_verify(void)
+{
+	int errors;
+
+	pb_fill_values();
+	errors = pb_verify_integers();
+#ifdef CONFIG_LIBC_DTOA_SHORTEST
+	errors += pb_verify_golden();
+#endif
+#ifdef PRINTF_BENCHMARK_HOST
+	errors += pb_verify_host();
+	pb_fill_values();
+#endif
+	return errors;
+}
+
+/****************************************************************************
+ * Private Functions: Timing
+ ****************************************************************************/
+
+static uint64_t pb_now_usec(void)
+{
+	struct timespec ts;
+
+#ifdef CLOCK_MONOTONIC
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+	clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Return the average cost of one call of 'op' in nanoseconds */
+
+static uint32_t pb_time(pb_snprintf_t op, FAR const struct pb_case_s *c, uint32_t calls)
+{
+	pb_snprintf_t volatile call = op;
+	char buf[PB_BUFSIZE];
+	uint32_t i;
+	uint64_t start;
+	uint64_t usec;
+
+	if (calls == 0) {
+		calls = 1;
+	}
+
+	start = pb_now_usec();
+	for (i = 0; i < calls; i++) {
+		(void)pb_format(call, c, i % PB_NVALUES, buf);
+	}
+	usec = pb_now_usec() - start;
+
+	return (uint32_t)(usec * 1000 / calls);
+}
+
+static void pb_bench(FAR const struct pb_case_s *c, uint32_t calls)
+{
+	uint32_t nsec = pb_time(PB_SNPRINTF, c, calls);
+
+#ifdef PRINTF_BENCHMARK_HOST
+	uint32_t host = pb_time(snprintf, c, calls);
+	uint32_t x100 = nsec ? (uint32_t)((uint64_t)host * 100 / nsec) : 0;
+
+	printf("  %-8s %-6s %10lu %10lu %5lu.%02lux\n", c->name, c->fmt, (unsigned long)nsec, (unsigned long)host, (unsigned long)(x100 / 100), (unsigned long)(x100 % 100));
+#else
+	printf("  %-8s %-6s %10lu\n", c->name, c->fmt, (unsigned long)nsec);
+#endif
+}
+
+static void pb_usage(const char *progname)
+{
+	unsigned int i;
+
+	printf("Usage: %s [verify|all|<format>] [calls]\n", progname);
+	printf("  formats:");
+	for (i = 0; i < PB_NCASES; i++) {
+		printf(" %s", g_cases[i].name);
+	}
+	printf("\n");
+}
+
+/****************************************************************************
+ * printf_benchmark_main
+ ****************************************************************************/
+
+#if defined(CONFIG_BUILD_KERNEL) || defined(PRINTF_BENCHMARK_HOST)
+int main(int argc, FAR char *argv[])
+#else
+int printf_benchmark_main(int argc, char *argv[])
+#endif
+{
+	const char *which = (argc > 1) ? argv[1] : "all";
+	uint32_t calls = CONFIG_EXAMPLES_PRINTF_BENCHMARK_CALLS;
+	bool verify_only = (strcmp(which, "verify") == 0);
+	bool all = verify_only || (strcmp(which, "all") == 0);
+	bool found = all;
+	int errors;
+	unsigned int i;
+
+	if (argc > 2) {
+		calls = (uint32_t)strtoul(argv[2], NULL, 0);
+	}
+
+	for (i = 0; i < PB_NCASES && !found; i++) {
+		found = (strcmp(which, g_cases[i].name) == 0);
+	}
+
+	if (!found) {
+		pb_usage(argv[0]);
+		return -1;
+	}
+
+	errors = pb_verify();
+	printf("verify: %s\n", errors ? "FAIL" : "PASS");
+	if (errors || verify_only) {
+		return errors ? -1 : 0;
+	}
+
+#ifdef PRINTF_BENCHMARK_HOST
+	printf("  %-8s %-6s %10s %10s %8s\n", "name", "format", "ns/call", "host ns", "speedup");
+#else
+	printf("  %-8s %-6s %10s\n", "name", "format", "ns/call");
+#endif
+
+	for (i = 0; i < PB_NCASES; i++) {
+		if (all || strcmp(which, g_cases[i].name) == 0) {
+			pb_bench(&g_cases[i], calls);
+		}
+	}
+
+	return 0;
+}
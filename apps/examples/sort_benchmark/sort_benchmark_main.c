@@ -0,0 +1,522 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * examples/sort_benchmark/sort_benchmark_main.c
+ *
+ * Checks qsort() and mergesort() on random, presorted and adversarial
+ * inputs, then compares their run times and numbers of comparisons.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#ifndef FAR
+#define FAR
+#endif
+
+/* The host build (Makefile.host) links the TizenRT versions under tr_
+ * names so that they do not replace the functions of the host C library.
+ */
+
+#ifdef SORT_BENCHMARK_HOST
+void tr_qsort(FAR void *base, size_t nmemb, size_t size, int (*compar)(const void *, const void *));
+int tr_mergesort(FAR void *base, size_t nmemb, size_t size, int (*compar)(const void *, const void *));
+
+#define SBENCH_QSORT tr_qsort
+#define SBENCH_MERGESORT tr_mergesort
+#else
+#define SBENCH_QSORT qsort
+#define SBENCH_MERGESORT mergesort
+#endif
+
+#ifndef CONFIG_EXAMPLES_SORT_BENCHMARK_NMEMB
+#define CONFIG_EXAMPLES_SORT_BENCHMARK_NMEMB 2000
+#endif
+
+/* Every size up to SBENCH_VERIFY_MAXSIZE is checked, then a few larger
+ * ones.  Each measurement sorts about SBENCH_BUDGET elements in total.
+ */
+
+#define SBENCH_VERIFY_MAXSIZE 48
+#define SBENCH_BUDGET         1000000
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* 12 bytes:  A multiple of the word size on 32-bit targets only */
+
+struct sbench_rec_s {
+	int32_t key;
+	int32_t seq;				/* Original position, to check stability */
+	int32_t payload;
+};
+
+typedef void (*sbench_sort_t)(FAR struct sbench_rec_s *recs, size_t nmemb);
+
+struct sbench_sorter_s {
+	const char *name;
+	sbench_sort_t sort;
+	bool stable;
+};
+
+enum sbench_input_e {
+	SBENCH_RANDOM,
+	SBENCH_SORTED,
+	SBENCH_REVERSED,
+	SBENCH_FEWKEYS,
+	SBENCH_ORGANPIPE,
+	SBENCH_SAWTOOTH,
+	SBENCH_KILLER,
+	SBENCH_NINPUTS
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const char *g_inputs[SBENCH_NINPUTS] = {
+	"random", "sorted", "reversed", "fewkeys", "organpipe", "sawtooth", "killer"
+};
+
+static FAR struct sbench_rec_s *g_input;
+static FAR struct sbench_rec_s *g_work;
+
+static uint32_t g_ncompares;
+static uint32_t g_seed;
+
+/* State of the adversary that builds the "killer" input */
+
+static int32_t g_gas;
+static int32_t g_nsolid;
+static int32_t g_candidate;
+
+#ifdef SORT_BENCHMARK_HOST
+static bool g_nomem;
+#endif
+
+/****************************************************************************
+ * Private Functions: Sorts
+ ****************************************************************************/
+
+static int sbench_compare(const void *a, const void *b)
+{
+	int32_t ka = ((FAR const struct sbench_rec_s *)a)->key;
+	int32_t kb = ((FAR const struct sbench_rec_s *)b)->key;
+
+	g_ncompares++;
+	return ka < kb ? -1 : ka > kb;
+}
+
+static void sbench_qsort(FAR struct sbench_rec_s *recs, size_t nmemb)
+{
+	SBENCH_QSORT(recs, nmemb, sizeof(struct sbench_rec_s), sbench_compare);
+}
+
+static void sbench_mergesort(FAR struct sbench_rec_s *recs, size_t nmemb)
+{
+	(void)SBENCH_MERGESORT(recs, nmemb, sizeof(struct sbench_rec_s), sbench_compare);
+}
+
+#ifdef SORT_BENCHMARK_HOST
+/* mergesort() allocates through this, so that it can be made to fail */
+
+void *sbench_malloc(size_t size)
+{
+	return g_nomem ? NULL : malloc(size);
+}
+
+static void sbench_mergesort_nomem(FAR struct sbench_rec_s *recs, size_t nmemb)
+{
+	g_nomem = true;
+	sbench_mergesort(recs, nmemb);
+	g_nomem = false;
+}
+
+static void sbench_host_qsort(FAR struct sbench_rec_s *recs, size_t nmemb)
+{
+	qsort(recs, nmemb, sizeof(struct sbench_rec_s), sbench_compare);
+}
+#endif
+
+static const struct sbench_sorter_s g_sorters[] = {
+	{"qsort", sbench_qsort, false},
+	{"mergesort", sbench_mergesort, true},
+#ifdef SORT_BENCHMARK_HOST
+	{"mergesort-nomem", sbench_mergesort_nomem, true},
+	{"host-qsort", sbench_host_qsort, false},
+#endif
+};
+
+#define SBENCH_NSORTERS (sizeof(g_sorters) / sizeof(g_sorters[0]))
+
+/****************************************************************************
+ * Private Functions: Inputs
+ ****************************************************************************/
+
+static uint32_t sbench_random(void)
+{
+	/* xorshift32 */
+
+	g_seed ^= g_seed << 13;
+	g_seed ^= g_seed >> 17;
+	g_seed ^= g_seed << 5;
+	return g_seed;
+}
+
+/* McIlroy's adversary ("A Killer Adversary for Quicksort", 1999):  All
+ * keys start as "gas" and are only given a value ("frozen") when the sort
+ * compares two of them.  The pivot candidate is kept as gas as long as
+ * possible, which makes it the worst pivot the sort could have chosen.
+ * The values are kept in the payload of g_input, indexed by the key.
+ */
+
+static int sbench_adversary(const void *a, const void *b)
+{
+	int32_t x = ((FAR const struct sbench_rec_s *)a)->key;
+	int32_t y = ((FAR const struct sbench_rec_s *)b)->key;
+	int32_t vx;
+	int32_t vy;
+
+	if (g_input[x].payload == g_gas && g_input[y].payload == g_gas) {
+		if (x == g_candidate) {
+			g_input[x].payload = g_nsolid++;
+		} else {
+			g_input[y].payload = g_nsolid++;
+		}
+	}
+
+	if (g_input[x].payload == g_gas) {
+		g_candidate = x;
+	} else if (g_input[y].payload == g_gas) {
+		g_candidate = y;
+	}
+
+	vx = g_input[x].payload;
+	vy = g_input[y].payload;
+	return vx < vy ? -1 : vx > vy;
+}
+
+static void sbench_killer(size_t nmemb)
+{
+	size_t i;
+
+	g_gas = (int32_t)nmemb;
+	g_nsolid = 0;
+	g_candidate = 0;
+
+	for (i = 0; i < nmemb; i++) {
+		g_input[i].payload = g_gas;
+		g_work[i].key = (int32_t)i;
+	}
+
+	SBENCH_QSORT(g_work, nmemb, sizeof(struct sbench_rec_s), sbench_adversary);
+
+	for (i = 0; i < nmemb; i++) {
+		if (g_input[i].payload == g_gas) {
+			g_input[i].payload = g_nsolid++;
+		}
+
+		g_input[i].key = g_input[i].payload;
+	}
+}
+
+static void sbench_generate(enum sbench_input_e input, size_t nmemb)
+{
+	size_t i;
+
+	g_seed = 0x2545f491 + (uint32_t)nmemb;
+
+	if (input == SBENCH_KILLER) {
+		sbench_killer(nmemb);
+	}
+
+	for (i = 0; i < nmemb; i++) {
+		int32_t n = (int32_t)nmemb;
+		int32_t k = (int32_t)i;
+
+		switch (input) {
+		case SBENCH_RANDOM:
+			k = (int32_t)(sbench_random() >> 1);
+			break;
+		case SBENCH_SORTED:
+			break;
+		case SBENCH_REVERSED:
+			k = n - k;
+			break;
+		case SBENCH_FEWKEYS:
+			k = (int32_t)(sbench_random() % 4);
+			break;
+		case SBENCH_ORGANPIPE:
+			k = k < n / 2 ? k : n - k;
+			break;
+		case SBENCH_SAWTOOTH:
+			k = k % 64;
+			break;
+		default:
+			k = g_input[i].key;
+			break;
+		}
+
+		g_input[i].key = k;
+		g_input[i].seq = (int32_t)i;
+		g_input[i].payload = ~k;
+	}
+}
+
+/****************************************************************************
+ * Private Functions: Verification
+ ****************************************************************************/
+
+/* The result must be ordered, must hold each input record exactly once
+ * and, for a stable sort, must keep records with equal keys in order.
+ */
+
+static int sbench_check(FAR const struct sbench_sorter_s *sorter, enum sbench_input_e input, size_t nmemb)
+{
+	uint64_t seqsum = 0;
+	uint64_t seqsq = 0;
+	size_t i;
+
+	memcpy(g_work, g_input, nmemb * sizeof(struct sbench_rec_s));
+	sorter->sort(g_work, nmemb);
+
+	for (i = 0; i < nmemb; i++) {
+		FAR const struct sbench_rec_s *rec = &g_work[i];
+
+		if (rec->seq < 0 || rec->seq >= (int32_t)nmemb || rec->key != g_input[rec->seq].key || rec->payload != ~rec->key) {
+			printf("  FAIL %s %s n=%u: record %u is corrupted\n", sorter->name, g_inputs[input], (unsigned int)nmemb, (unsigned int)i);
+			return 1;
+		}
+
+		if (i > 0 && (rec[-1].key > rec->key || (sorter->stable && rec[-1].key == rec->key && rec[-1].seq > rec->seq))) {
+			printf("  FAIL %s %s n=%u: records %u and %u are out of order\n", sorter->name, g_inputs[input], (unsigned int)nmemb, (unsigned int)i - 1, (unsigned int)i);
+			return 1;
+		}
+
+		seqsum += (uint64_t)rec->seq;
+		seqsq += (uint64_t)rec->seq * (uint64_t)rec->seq;
+	}
+
+	if (nmemb > 0 && (seqsum != (uint64_t)nmemb * (nmemb - 1) / 2 || seqsq != (uint64_t)nmemb * (nmemb - 1) * (2 * nmemb - 1) / 6)) {
+		printf("  FAIL %s %s n=%u: records are lost or duplicated\n", sorter->name, g_inputs[input], (unsigned int)nmemb);
+		return 1;
+	}
+
+	return 0;
+}
+
+static int sbench_verify(enum sbench_input_e input, size_t maxsize)
+{
+	static const size_t sizes[] = { 100, 257, 1000 };
+	unsigned int j;
+	size_t n;
+	int errors = 0;
+
+	for (j = 0; j < SBENCH_NSORTERS; j++) {
+		for (n = 0; n <= SBENCH_VERIFY_MAXSIZE && n <= maxsize; n++) {
+			sbench_generate(input, n);
+			errors += sbench_check(&g_sorters[j], input, n);
+		}
+
+		for (n = 0; n < sizeof(sizes) / sizeof(sizes[0]) && sizes[n] <= maxsize; n++) {
+			sbench_generate(input, sizes[n]);
+			errors += sbench_check(&g_sorters[j], input, sizes[n]);
+		}
+
+		sbench_generate(input, maxsize);
+		errors += sbench_check(&g_sorters[j], input, maxsize);
+
+		if (errors > 8) {
+			break;
+		}
+	}
+
+	return errors;
+}
+
+/****************************************************************************
+ * Private Functions: Timing
+ ****************************************************************************/
+
+static uint64_t sbench_now_usec(void)
+{
+	struct timespec ts;
+
+#ifdef CLOCK_MONOTONIC
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+	clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Return the time of one sort in microseconds, without the time to copy
+ * the input, and the comparisons it made in *ncompares.
+ */
+
+static uint32_t sbench_time(sbench_sort_t sort, size_t nmemb, FAR uint32_t *ncompares)
+{
+	size_t bytes = nmemb * sizeof(struct sbench_rec_s);
+	uint32_t count = SBENCH_BUDGET / (nmemb ? nmemb : 1);
+	uint64_t copy;
+	uint64_t usec;
+	uint32_t i;
+
+	if (count == 0) {
+		count = 1;
+	}
+
+	copy = sbench_now_usec();
+	for (i = 0; i < count; i++) {
+		memcpy(g_work, g_input, bytes);
+	}
+	copy = sbench_now_usec() - copy;
+
+	g_ncompares = 0;
+	usec = sbench_now_usec();
+	for (i = 0; i < count; i++) {
+		memcpy(g_work, g_input, bytes);
+		sort(g_work, nmemb);
+	}
+	usec = sbench_now_usec() - usec;
+
+	*ncompares = g_ncompares / count;
+	usec = usec > copy ? usec - copy : 0;
+	return (uint32_t)(usec / count);
+}
+
+static void sbench_bench(enum sbench_input_e input, size_t nmemb)
+{
+	unsigned int j;
+
+	sbench_generate(input, nmemb);
+	printf("  %-10s", g_inputs[input]);
+
+	for (j = 0; j < SBENCH_NSORTERS; j++) {
+		uint32_t ncompares;
+		uint32_t usec = sbench_time(g_sorters[j].sort, nmemb, &ncompares);
+
+		printf(" %9lu %9lu", (unsigned long)usec, (unsigned long)ncompares);
+	}
+
+	printf("\n");
+}
+
+static void sbench_usage(const char *progname)
+{
+	unsigned int i;
+
+	printf("Usage: %s [verify|all|<input>] [nmemb]\n", progname);
+	printf("  inputs:");
+	for (i = 0; i < SBENCH_NINPUTS; i++) {
+		printf(" %s", g_inputs[i]);
+	}
+	printf("\n");
+}
+
+/****************************************************************************
+ * sort_benchmark_main
+ ****************************************************************************/
+
+#if defined(CONFIG_BUILD_KERNEL) || defined(SORT_BENCHMARK_HOST)
+int main(int argc, FAR char *argv[])
+#else
+int sort_benchmark_main(int argc, char *argv[])
+#endif
+{
+	const char *which = (argc > 1) ? argv[1] : "all";
+	size_t nmemb = CONFIG_EXAMPLES_SORT_BENCHMARK_NMEMB;
+	bool verify_only = (strcmp(which, "verify") == 0);
+	bool all = verify_only || (strcmp(which, "all") == 0);
+	bool found = false;
+	int errors = 0;
+	unsigned int i;
+	unsigned int j;
+
+	if (argc > 2) {
+		nmemb = (size_t)strtoul(argv[2], NULL, 0);
+	}
+
+	if (nmemb < 1) {
+		nmemb = 1;
+	}
+
+	g_input = (FAR struct sbench_rec_s *)malloc(nmemb * sizeof(struct sbench_rec_s));
+	g_work = (FAR struct sbench_rec_s *)malloc(nmemb * sizeof(struct sbench_rec_s));
+	if (g_input == NULL || g_work == NULL) {
+		printf("Failed to allocate %u elements\n", (unsigned int)nmemb);
+		free(g_input);
+		free(g_work);
+		return -1;
+	}
+
+	for (i = 0; i < SBENCH_NINPUTS; i++) {
+		if (!all && strcmp(which, g_inputs[i]) != 0) {
+			continue;
+		}
+
+		found = true;
+		if (sbench_verify((enum sbench_input_e)i, nmemb) != 0) {
+			printf("%s: wrong results\n", g_inputs[i]);
+			errors++;
+		}
+	}
+
+	if (!found) {
+		sbench_usage(argv[0]);
+		errors = -1;
+		goto out;
+	}
+
+	printf("verify: %s\n", errors ? "FAIL" : "PASS");
+	if (errors || verify_only) {
+		goto out;
+	}
+
+	printf("%u elements of %u bytes, microseconds and comparisons per sort\n", (unsigned int)nmemb, (unsigned int)sizeof(struct sbench_rec_s));
+	printf("  %-10s", "input");
+	for (j = 0; j < SBENCH_NSORTERS; j++) {
+		printf(" %19s", g_sorters[j].name);
+	}
+	printf("\n");
+
+	for (i = 0; i < SBENCH_NINPUTS; i++) {
+		if (all || strcmp(which, g_inputs[i]) == 0) {
+			sbench_bench((enum sbench_input_e)i, nmemb);
+		}
+	}
+
+out:
+	free(g_input);
+	free(g_work);
+	return errors ? -1 : 0;
+}
@@ -0,0 +1,574 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * examples/string_benchmark/string_benchmark_main.c
+ *
+ * Compares the libc memory and string functions against the byte loops of
+ * the generic versions over a sweep of sizes and alignments, after checking
+ * that both give the same results.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#ifndef FAR
+#define FAR
+#endif
+
+/* The host build (Makefile.host) links the TizenRT versions under tr_
+ * names so that they do not replace the functions of the host C library.
+ */
+
+#ifdef STRING_BENCHMARK_HOST
+FAR void *tr_memcpy(FAR void *dest, FAR const void *src, size_t n);
+FAR void *tr_memset(FAR void *s, int c, size_t n);
+int tr_memcmp(FAR const void *s1, FAR const void *s2, size_t n);
+FAR void *tr_memchr(FAR const void *s, int c, size_t n);
+size_t tr_strlen(FAR const char *s);
+int tr_strcmp(FAR const char *s1, FAR const char *s2);
+FAR char *tr_strchr(FAR const char *s, int c);
+
+#define SB_MEMCPY tr_memcpy
+#define SB_MEMSET tr_memset
+#define SB_MEMCMP tr_memcmp
+#define SB_MEMCHR tr_memchr
+#define SB_STRLEN tr_strlen
+#define SB_STRCMP tr_strcmp
+#define SB_STRCHR tr_strchr
+#else
+#define SB_MEMCPY memcpy
+#define SB_MEMSET memset
+#define SB_MEMCMP memcmp
+#define SB_MEMCHR memchr
+#define SB_STRLEN strlen
+#define SB_STRCMP strcmp
+#define SB_STRCHR strchr
+#endif
+
+#ifndef CONFIG_EXAMPLES_STRING_BENCHMARK_BYTES
+#define CONFIG_EXAMPLES_STRING_BENCHMARK_BYTES 4194304
+#endif
+
+/* Buffer layout:  Each operand starts at an offset of 0 to SB_MAXALIGN - 1
+ * into its buffer and is followed by guard bytes that must not change.
+ */
+
+#define SB_MAXSIZE   4096
+#define SB_MAXALIGN  8
+#define SB_GUARD     16
+#define SB_BUFSIZE   (SB_MAXALIGN + SB_MAXSIZE + SB_GUARD)
+
+/* Sizes checked exhaustively against the byte loops */
+
+#define SB_VERIFY_MAXSIZE 72
+
+/* The byte that the search functions look for.  Fill bytes are never zero
+ * and never this value, and include bytes with the top bit set.
+ */
+
+#define SB_TARGET    0xff
+#define SB_FILL(i)   ((unsigned char)(1 + ((i) * 37) % 254))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One operation on 'n' bytes at 'dst' and 'src'.  Returns the result of the
+ * call in a form that can be compared, pointers as offsets.
+ */
+
+typedef long (*sb_op_t)(FAR unsigned char *dst, FAR const unsigned char *src, size_t n);
+
+struct sb_func_s {
+	const char *name;
+	sb_op_t ref;				/* The generic byte loop */
+	sb_op_t lib;				/* The libc function */
+	bool writes;				/* dst is written:  Compare the buffers */
+	bool string;				/* Operands are NUL terminated strings */
+	unsigned char hit;			/* A src byte that ends the scan early */
+	void (*prepare)(FAR unsigned char *dst, FAR unsigned char *src, size_t n);
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static unsigned char g_src[SB_BUFSIZE];
+static unsigned char g_dst[SB_BUFSIZE];
+static unsigned char g_chk[SB_BUFSIZE];
+
+static const size_t g_sizes[] = { 8, 16, 32, 64, 256, 1024, 4096 };
+
+#define SB_NSIZES (sizeof(g_sizes) / sizeof(g_sizes[0]))
+
+/****************************************************************************
+ * Private Functions: Generic byte loops
+ ****************************************************************************/
+
+/* These are the generic versions as they are without
+ * CONFIG_LIBC_STRING_OPTSPEED.
+ */
+
+static FAR void *ref_memcpy(FAR void *dest, FAR const void *src, size_t n)
+{
+	FAR unsigned char *pout = (FAR unsigned char *)dest;
+	FAR const unsigned char *pin = (FAR const unsigned char *)src;
+
+	while (n-- > 0) {
+		*pout++ = *pin++;
+	}
+	return dest;
+}
+
+static FAR void *ref_memset(FAR void *s, int c, size_t n)
+{
+	FAR unsigned char *p = (FAR unsigned char *)s;
+
+	while (n-- > 0) {
+		*p++ = c;
+	}
+	return s;
+}
+
+static int ref_memcmp(FAR const void *s1, FAR const void *s2, size_t n)
+{
+	FAR const unsigned char *p1 = (FAR const unsigned char *)s1;
+	FAR const unsigned char *p2 = (FAR const unsigned char *)s2;
+
+	while (n-- > 0) {
+		if (*p1 < *p2) {
+			return -1;
+		} else if (*p1 > *p2) {
+			return 1;
+		}
+
+		p1++;
+		p2++;
+	}
+	return 0;
+}
+
+static FAR void *ref_memchr(FAR const void *s, int c, size_t n)
+{
+	FAR const unsigned char *p = (FAR const unsigned char *)s;
+
+	while (n--) {
+		if (*p == (unsigned char)c) {
+			return (FAR void *)p;
+		}
+
+		p++;
+	}
+
+	return NULL;
+}
+
+static size_t ref_strlen(FAR const char *s)
+{
+	FAR const char *sc;
+
+	for (sc = s; *sc != '\0'; ++sc);
+	return sc - s;
+}
+
+static int ref_strcmp(FAR const char *cs, FAR const char *ct)
+{
+	signed char result;
+
+	for (;;) {
+		if ((result = *cs - *ct++) != 0 || !*cs++) {
+			break;
+		}
+	}
+	return result;
+}
+
+static FAR char *ref_strchr(FAR const char *s, int c)
+{
+	for (;; s++) {
+		if (*s == (char)c) {
+			return (FAR char *)s;
+		}
+
+		if (!*s) {
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+/****************************************************************************
+ * Private Functions: Operations
+ ****************************************************************************/
+
+/* Pointers are returned as offsets from 'base', and NULL as -1 */
+
+static long sb_offset(FAR const void *p, FAR const void *base)
+{
+	return p ? (long)((FAR const unsigned char *)p - (FAR const unsigned char *)base) : -1;
+}
+
+/* memcmp and strcmp only return the sign in a comparable form */
+
+#define SB_SIGN(x) ((x) < 0 ? -1 : (x) > 0)
+
+static long ref_op_memcpy(FAR unsigned char *dst, FAR const unsigned char *src, size_t n)
+{
+	return sb_offset(ref_memcpy(dst, src, n), dst);
+}
+
+static long lib_op_memcpy(FAR unsigned char *dst, FAR const unsigned char *src, size_t n)
+{
+	return sb_offset(SB_MEMCPY(dst, src, n), dst);
+}
+
+static long ref_op_memset(FAR unsigned char *dst, FAR const unsigned char *src, size_t n)
+{
+	return sb_offset(ref_memset(dst, 0x5a, n), dst);
+}
+
+static long lib_op_memset(FAR unsigned char *dst, FAR const unsigned char *src, size_t n)
+{
+	return sb_offset(SB_MEMSET(dst, 0x5a, n), dst);
+}
+
+static long ref_op_memcmp(FAR unsigned char *dst, FAR const unsigned char *src, size_t n)
+{
+	return SB_SIGN(ref_memcmp(dst, src, n));
+}
+
+static long lib_op_memcmp(FAR unsigned char *dst, FAR const unsigned char *src, size_t n)
+{
+	return SB_SIGN(SB_MEMCMP(dst, src, n));
+}
+
+static long ref_op_memchr(FAR unsigned char *dst, FAR const unsigned char *src, size_t n)
+{
+	return sb_offset(ref_memchr(src, SB_TARGET, n), src);
+}
+
+static long lib_op_memchr(FAR unsigned char *dst, FAR const unsigned char *src, size_t n)
+{
+	return sb_offset(SB_MEMCHR(src, SB_TARGET, n), src);
+}
+
+static long ref_op_strlen(FAR unsigned char *dst, FAR const unsigned char *src, size_t n)
+{
+	return (long)ref_strlen((FAR const char *)src);
+}
+
+static long lib_op_strlen(FAR unsigned char *dst, FAR const unsigned char *src, size_t n)
+{
+	return (long)SB_STRLEN((FAR const char *)src);
+}
+
+static long ref_op_strcmp(FAR unsigned char *dst, FAR const unsigned char *src, size_t n)
+{
+	return SB_SIGN(ref_strcmp((FAR const char *)dst, (FAR const char *)src));
+}
+
+static long lib_op_strcmp(FAR unsigned char *dst, FAR const unsigned char *src, size_t n)
+{
+	return SB_SIGN(SB_STRCMP((FAR const char *)dst, (FAR const char *)src));
+}
+
+static long ref_op_strchr(FAR unsigned char *dst, FAR const unsigned char *src, size_t n)
+{
+	return sb_offset(ref_strchr((FAR const char *)src, SB_TARGET), src);
+}
+
+static long lib_op_strchr(FAR unsigned char *dst, FAR const unsigned char *src, size_t n)
+{
+	return sb_offset(SB_STRCHR((FAR const char *)src, SB_TARGET), src);
+}
+
+/* Prepare the operands so that a call runs over all of the 'n' bytes:
+ * Compared buffers are equal, the searched byte is the last one and
+ * strings are n - 1 characters long.
+ */
+
+static void sb_prep_fill(FAR unsigned char *dst, FAR unsigned char *src, size_t n)
+{
+	size_t i;
+
+	for (i = 0; i < n; i++) {
+		src[i] = SB_FILL(i);
+		dst[i] = SB_FILL(i);
+	}
+}
+
+static void sb_prep_search(FAR unsigned char *dst, FAR unsigned char *src, size_t n)
+{
+	sb_prep_fill(dst, src, n);
+	if (n > 0) {
+		src[n - 1] = SB_TARGET;
+	}
+}
+
+static void sb_prep_string(FAR unsigned char *dst, FAR unsigned char *src, size_t n)
+{
+	sb_prep_fill(dst, src, n);
+	if (n > 0) {
+		src[n - 1] = '\0';
+		dst[n - 1] = '\0';
+	}
+}
+
+static const struct sb_func_s g_funcs[] = {
+	{"memcpy", ref_op_memcpy, lib_op_memcpy, true, false, 0x00, sb_prep_fill},
+	{"memset", ref_op_memset, lib_op_memset, true, false, 0x00, sb_prep_fill},
+	{"memcmp", ref_op_memcmp, lib_op_memcmp, false, false, 0x00, sb_prep_fill},
+	{"memchr", ref_op_memchr, lib_op_memchr, false, false, SB_TARGET, sb_prep_search},
+	{"strlen", ref_op_strlen, lib_op_strlen, false, true, 0x00, sb_prep_string},
+	{"strcmp", ref_op_strcmp, lib_op_strcmp, false, true, 0x00, sb_prep_string},
+	{"strchr", ref_op_strchr, lib_op_strchr, false, true, SB_TARGET, sb_prep_string},
+};
+
+#define SB_NFUNCS (sizeof(g_funcs) / sizeof(g_funcs[0]))
+
+/****************************************************************************
+ * Private Functions: Verification
+ ****************************************************************************/
+
+/* Prepare the operands of 'func' at the given alignments, then replace the
+ * src byte at 'pos' (if not negative) with 'val'.  The harness uses the
+ * byte loops itself, so that it does not depend on what it tests.
+ */
+
+static void sb_setup(FAR const struct sb_func_s *func, size_t n, int salign, int dalign, int pos, unsigned char val)
+{
+	ref_memset(g_src, 0xa5, sizeof(g_src));
+	ref_memset(g_dst, 0xa5, sizeof(g_dst));
+	func->prepare(&g_dst[dalign], &g_src[salign], n);
+	if (pos >= 0) {
+		g_src[salign + pos] = val;
+	}
+}
+
+/* Run 'func' with both implementations on the same operands and compare
+ * the results and, for the functions that write, the whole buffer.
+ */
+
+static int sb_check(FAR const struct sb_func_s *func, size_t n, int salign, int dalign, int pos, unsigned char val)
+{
+	long expected;
+	long result;
+
+	sb_setup(func, n, salign, dalign, pos, val);
+	expected = func->ref(&g_dst[dalign], &g_src[salign], n);
+	ref_memcpy(g_chk, g_dst, sizeof(g_dst));
+
+	sb_setup(func, n, salign, dalign, pos, val);
+	result = func->lib(&g_dst[dalign], &g_src[salign], n);
+
+	if (result != expected || (func->writes && ref_memcmp(g_chk, g_dst, sizeof(g_dst)) != 0)) {
+		printf("  FAIL %s n=%u src+%d dst+%d pos=%d: %ld, expected %ld\n", func->name, (unsigned int)n, salign, dalign, pos, result, expected);
+		return 1;
+	}
+
+	return 0;
+}
+
+static int sb_verify(FAR const struct sb_func_s *func)
+{
+	size_t n;
+	int last;
+	int salign;
+	int dalign;
+	int errors = 0;
+
+	/* Strings need room for the terminator */
+
+	for (n = func->string ? 1 : 0; n <= SB_VERIFY_MAXSIZE; n++) {
+		last = (int)n - (func->string ? 2 : 1);
+
+		for (salign = 0; salign < SB_MAXALIGN; salign++) {
+			for (dalign = 0; dalign < SB_MAXALIGN; dalign++) {
+				errors += sb_check(func, n, salign, dalign, -1, 0);
+
+				if (last >= 0) {
+					/* An early end of the scan, and bytes that a sloppy
+					 * zero byte test on whole words could mistake for zero.
+					 */
+
+					errors += sb_check(func, n, salign, dalign, last / 2, func->hit);
+					errors += sb_check(func, n, salign, dalign, 0, 0x80);
+					errors += sb_check(func, n, salign, dalign, last, 0x01);
+				}
+
+				if (errors > 8) {
+					return errors;
+				}
+			}
+		}
+	}
+
+	return errors;
+}
+
+/****************************************************************************
+ * Private Functions: Timing
+ ****************************************************************************/
+
+static uint64_t sb_now_usec(void)
+{
+	struct timespec ts;
+
+#ifdef CLOCK_MONOTONIC
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+	clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Return the throughput of 'op' on 'n' bytes in KB/s, running it over
+ * about 'budget' bytes.
+ */
+
+static uint32_t sb_time(sb_op_t op, size_t n, int salign, int dalign, uint32_t budget)
+{
+	FAR unsigned char *src = &g_src[salign];
+	FAR unsigned char *dst = &g_dst[dalign];
+	sb_op_t volatile call = op;
+	uint32_t count = budget / n;
+	uint32_t i;
+	uint64_t start;
+	uint64_t usec;
+
+	if (count == 0) {
+		count = 1;
+	}
+
+	start = sb_now_usec();
+	for (i = 0; i < count; i++) {
+		(void)call(dst, src, n);
+	}
+	usec = sb_now_usec() - start;
+
+	if (usec == 0) {
+		usec = 1;
+	}
+
+	return (uint32_t)((uint64_t)count * n * 1000000 / 1024 / usec);
+}
+
+static void sb_bench(FAR const struct sb_func_s *func, uint32_t budget)
+{
+	unsigned int i;
+
+	printf("%s\n", func->name);
+	printf("  %6s %10s %10s %10s %8s\n", "size", "ref KB/s", "KB/s", "+1/+3 KB/s", "speedup");
+
+	for (i = 0; i < SB_NSIZES; i++) {
+		size_t n = g_sizes[i];
+		uint32_t ref;
+		uint32_t lib;
+		uint32_t mis;
+		uint32_t x100;
+
+		func->prepare(g_dst, g_src, n);
+		ref = sb_time(func->ref, n, 0, 0, budget);
+		lib = sb_time(func->lib, n, 0, 0, budget);
+
+		func->prepare(&g_dst[3], &g_src[1], n);
+		mis = sb_time(func->lib, n, 1, 3, budget);
+
+		x100 = ref ? (uint32_t)((uint64_t)lib * 100 / ref) : 0;
+		printf("  %6u %10lu %10lu %10lu %5lu.%02lux\n", (unsigned int)n, (unsigned long)ref, (unsigned long)lib, (unsigned long)mis, (unsigned long)(x100 / 100), (unsigned long)(x100 % 100));
+	}
+}
+
+static void sb_usage(const char *progname)
+{
+	unsigned int i;
+
+	printf("Usage: %s [verify|all|<function>] [bytes]\n", progname);
+	printf("  functions:");
+	for (i = 0; i < SB_NFUNCS; i++) {
+		printf(" %s", g_funcs[i].name);
+	}
+	printf("\n");
+}
+
+/****************************************************************************
+ * string_benchmark_main
+ ****************************************************************************/
+
+#if defined(CONFIG_BUILD_KERNEL) || defined(STRING_BENCHMARK_HOST)
+int main(int argc, FAR char *argv[])
+#else
+int string_benchmark_main(int argc, char *argv[])
+#endif
+{
+	const char *which = (argc > 1) ? argv[1] : "all";
+	uint32_t budget = CONFIG_EXAMPLES_STRING_BENCHMARK_BYTES;
+	bool verify_only = (strcmp(which, "verify") == 0);
+	bool all = verify_only || (strcmp(which, "all") == 0);
+	bool found = false;
+	int errors = 0;
+	unsigned int i;
+
+	if (argc > 2) {
+		budget = (uint32_t)strtoul(argv[2], NULL, 0);
+	}
+
+	for (i = 0; i < SB_NFUNCS; i++) {
+		if (!all && strcmp(which, g_funcs[i].name) != 0) {
+			continue;
+		}
+
+		found = true;
+		if (sb_verify(&g_funcs[i]) != 0) {
+			printf("%s: results differ from the generic version\n", g_funcs[i].name);
+			errors++;
+		}
+	}
+
+	if (!found) {
+		sb_usage(argv[0]);
+		return -1;
+	}
+
+	printf("verify: %s\n", errors ? "FAIL" : "PASS");
+	if (errors || verify_only) {
+		return errors ? -1 : 0;
+	}
+
+	for (i = 0; i < SB_NFUNCS; i++) {
+		if (all || strcmp(which, g_funcs[i].name) == 0) {
+			sb_bench(&g_funcs[i], budget);
+		}
+	}
+
+	return 0;
+}
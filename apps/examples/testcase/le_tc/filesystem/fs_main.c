@@ -34,12 +34,15 @@
 #include <poll.h>
 #endif
 #include <errno.h>
+#include <aio.h>
 #include <semaphore.h>
 #include <sys/stat.h>
 #include <sys/sendfile.h>
 #include <sys/statfs.h>
 #include <sys/select.h>
+#include <sys/epoll.h>
 
+#include <tinyara/fs/fs.h>
 #include <tinyara/fs/ioctl.h>
 #include <tinyara/fs/fs_utils.h>
 #include <apps/shell/tash.h>
@@ -81,6 +84,12 @@
 
 #define VFS_FOLDER_PATH MOUNT_DIR"folder"
 
+#define VFS_DRIVER_PATH "/dev/tc_inode"
+
+#define VFS_AIO_FILE_PATH MOUNT_DIR"aio"
+
+#define VFS_WRBEHIND_FILE_PATH MOUNT_DIR"wrbehind"
+
 #define VFS_LOOP_COUNT 5
 
 #define LONG_FILE_PATH MOUNT_DIR"long"
@@ -583,6 +592,90 @@ static void fs_vfs_pread_tc(void)
 	TC_SUCCESS_RESULT();
 }
 
+#ifdef CONFIG_FS_AIO_RING
+/**
+* @testcase         fs_vfs_aio_ring_tc
+* @brief            Write and read back a file through a batched AIO ring
+* @scenario         Queue VFS_LOOP_COUNT writes and an fsync with one call, wait for their
+*                   completions, then read the data back the same way
+* @apicovered       aio_ring_setup, aio_ring_enter, aio_ring_getsqe, aio_ring_peekcqe, aio_ring_cqeseen
+* @precondition     NA
+* @postcondition    NA
+*/
+static void fs_vfs_aio_ring_tc(void)
+{
+	struct aio_ring_s *ring;
+	struct aio_sqe_s *sqe;
+	struct aio_cqe_s *cqe;
+	char buf[VFS_LOOP_COUNT][20];
+	int ringfd;
+	int fd;
+	int ret;
+	int i;
+
+	ringfd = aio_ring_setup(8, &ring);
+	TC_ASSERT_GEQ("aio_ring_setup", ringfd, 0);
+
+	fd = open(VFS_AIO_FILE_PATH, O_RDWR | O_CREAT | O_TRUNC);
+	TC_ASSERT_GEQ_CLEANUP("open", fd, 0, close(ringfd));
+
+	for (i = 0; i < VFS_LOOP_COUNT; i++) {
+		snprintf(buf[i], sizeof(buf[i]), "%-19d", i);
+		sqe = aio_ring_getsqe(ring);
+		sqe->op = AIO_RING_WRITE;
+		sqe->fd = fd;
+		sqe->offset = i * sizeof(buf[i]);
+		sqe->buf = buf[i];
+		sqe->nbytes = sizeof(buf[i]);
+		sqe->udata = NULL;
+	}
+
+	sqe = aio_ring_getsqe(ring);
+	sqe->op = AIO_RING_FSYNC;
+	sqe->fd = fd;
+
+	ret = aio_ring_enter(ringfd, VFS_LOOP_COUNT + 1, VFS_LOOP_COUNT + 1);
+	TC_ASSERT_EQ_CLEANUP("aio_ring_enter", ret, VFS_LOOP_COUNT + 1, close(fd); close(ringfd));
+
+	for (i = 0; i < VFS_LOOP_COUNT + 1; i++) {
+		cqe = aio_ring_peekcqe(ring);
+		TC_ASSERT_NEQ_CLEANUP("aio_ring_peekcqe", cqe, NULL, close(fd); close(ringfd));
+		TC_ASSERT_GEQ_CLEANUP("aio_ring_enter", cqe->result, 0, close(fd); close(ringfd));
+		aio_ring_cqeseen(ring);
+	}
+
+	/* Read the records back in reverse order */
+
+	for (i = VFS_LOOP_COUNT - 1; i >= 0; i--) {
+		sqe = aio_ring_getsqe(ring);
+		sqe->op = AIO_RING_READ;
+		sqe->fd = fd;
+		sqe->offset = i * sizeof(buf[i]);
+		sqe->buf = buf[i];
+		sqe->nbytes = sizeof(buf[i]);
+		sqe->udata = (void *)(intptr_t)i;
+		memset(buf[i], 0, sizeof(buf[i]));
+	}
+
+	ret = aio_ring_enter(ringfd, VFS_LOOP_COUNT, VFS_LOOP_COUNT);
+	TC_ASSERT_EQ_CLEANUP("aio_ring_enter", ret, VFS_LOOP_COUNT, close(fd); close(ringfd));
+
+	for (i = 0; i < VFS_LOOP_COUNT; i++) {
+		cqe = aio_ring_peekcqe(ring);
+		TC_ASSERT_NEQ_CLEANUP("aio_ring_peekcqe", cqe, NULL, close(fd); close(ringfd));
+		TC_ASSERT_EQ_CLEANUP("aio_ring_enter", cqe->result, 20, close(fd); close(ringfd));
+		TC_ASSERT_EQ_CLEANUP("aio_ring_enter", atoi(buf[(intptr_t)cqe->udata]), (intptr_t)cqe->udata, close(fd); close(ringfd));
+		aio_ring_cqeseen(ring);
+	}
+
+	close(fd);
+	close(ringfd);
+	unlink(VFS_AIO_FILE_PATH);
+
+	TC_SUCCESS_RESULT();
+}
+#endif
+
 /**
 * @testcase         fs_vfs_mkdir_tc
 * @brief            Create folders
@@ -906,6 +999,42 @@ static void fs_vfs_stat_tc(void)
 	TC_SUCCESS_RESULT();
 }
 
+/**
+* @testcase         fs_vfs_inode_lookup_tc
+* @brief            Look up a driver path before, while and after it is registered
+* @scenario         A failed lookup of a path must not hide a driver registered later, and a
+*                   successful one must not outlive the driver
+* @apicovered       stat, register_driver, unregister_driver
+* @precondition     NA
+* @postcondition    NA
+*/
+static void fs_vfs_inode_lookup_tc(void)
+{
+	static const struct file_operations ops;
+	struct stat st;
+	int ret;
+
+	ret = stat(VFS_DRIVER_PATH, &st);
+	TC_ASSERT_EQ("stat", ret, ERROR);
+
+	ret = register_driver(VFS_DRIVER_PATH, &ops, 0666, NULL);
+	TC_ASSERT_EQ("register_driver", ret, OK);
+
+	ret = stat(VFS_DRIVER_PATH, &st);
+	TC_ASSERT_EQ_CLEANUP("stat", ret, OK, unregister_driver(VFS_DRIVER_PATH));
+
+	ret = stat(VFS_DRIVER_PATH, &st);
+	TC_ASSERT_EQ_CLEANUP("stat", ret, OK, unregister_driver(VFS_DRIVER_PATH));
+
+	ret = unregister_driver(VFS_DRIVER_PATH);
+	TC_ASSERT_EQ("unregister_driver", ret, OK);
+
+	ret = stat(VFS_DRIVER_PATH, &st);
+	TC_ASSERT_EQ("stat", ret, ERROR);
+
+	TC_SUCCESS_RESULT();
+}
+
 /**
 * @testcase         fs_vfs_statfs_tc
 * @brief            Get status of mounted file system
@@ -1129,6 +1258,180 @@ static void fs_vfs_select_tc(void)
 }
 #endif
 
+#ifdef CONFIG_FS_EPOLL
+/**
+* @testcase         fs_vfs_epoll_tc
+* @brief            Wait for the events of descriptors in an epoll interest set
+* @scenario         Add the read ends of VFS_LOOP_COUNT pipes to a set, write some of the pipes
+*                   and check that exactly those are reported, until their data is read.
+*                   Closing a descriptor removes it from the set.
+* @apicovered       epoll_create, epoll_ctl, epoll_wait
+* @precondition     CONFIG_FS_EPOLL should be enabled
+* @postcondition    NA
+*/
+static void fs_vfs_epoll_tc(void)
+{
+	struct epoll_event events[VFS_LOOP_COUNT];
+	struct epoll_event ev;
+	int fds[VFS_LOOP_COUNT][2];
+	int epfd;
+	int ret;
+	int i;
+	char c;
+
+	epfd = epoll_create(VFS_LOOP_COUNT);
+	TC_ASSERT_GEQ("epoll_create", epfd, 0);
+
+	for (i = 0; i < VFS_LOOP_COUNT; i++) {
+		ret = pipe(fds[i]);
+		TC_ASSERT_EQ_CLEANUP("pipe", ret, OK, close(epfd));
+
+		ev.events = EPOLLIN;
+		ev.data.u32 = i;
+		ret = epoll_ctl(epfd, EPOLL_CTL_ADD, fds[i][0], &ev);
+		TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, OK, close(epfd));
+	}
+
+	ret = epoll_ctl(epfd, EPOLL_CTL_ADD, fds[0][0], &ev);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, ERROR, close(epfd));
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", errno, EEXIST, close(epfd));
+
+	/* Nothing written: the wait times out */
+
+	ret = epoll_wait(epfd, events, VFS_LOOP_COUNT, 10);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 0, close(epfd));
+
+	/* Write the odd pipes */
+
+	for (i = 1; i < VFS_LOOP_COUNT; i += 2) {
+		ret = write(fds[i][1], "x", 1);
+		TC_ASSERT_EQ_CLEANUP("write", ret, 1, close(epfd));
+	}
+
+	ret = epoll_wait(epfd, events, VFS_LOOP_COUNT, 1000);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, VFS_LOOP_COUNT / 2, close(epfd));
+	for (i = 0; i < ret; i++) {
+		TC_ASSERT_EQ_CLEANUP("epoll_wait", events[i].data.u32 % 2, 1, close(epfd));
+		TC_ASSERT_EQ_CLEANUP("epoll_wait", events[i].events, EPOLLIN, close(epfd));
+	}
+
+	/* Level triggered: reported again until the data is read */
+
+	ret = epoll_wait(epfd, events, VFS_LOOP_COUNT, 0);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, VFS_LOOP_COUNT / 2, close(epfd));
+
+	for (i = 1; i < VFS_LOOP_COUNT; i += 2) {
+		ret = read(fds[i][0], &c, 1);
+		TC_ASSERT_EQ_CLEANUP("read", ret, 1, close(epfd));
+	}
+
+	ret = epoll_wait(epfd, events, VFS_LOOP_COUNT, 0);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 0, close(epfd));
+
+	/* A closed descriptor leaves the set, and a new file that gets its
+	 * number is not in the set.
+	 */
+
+	close(fds[0][0]);
+	close(fds[0][1]);
+	ret = epoll_ctl(epfd, EPOLL_CTL_DEL, fds[0][0], NULL);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, ERROR, close(epfd));
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", errno, ENOENT, close(epfd));
+
+	ret = pipe(fds[0]);
+	TC_ASSERT_EQ_CLEANUP("pipe", ret, OK, close(epfd));
+	ret = write(fds[0][1], "x", 1);
+	TC_ASSERT_EQ_CLEANUP("write", ret, 1, close(epfd));
+	ret = epoll_wait(epfd, events, VFS_LOOP_COUNT, 0);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 0, close(epfd));
+	close(fds[0][0]);
+	close(fds[0][1]);
+
+	for (i = 1; i < VFS_LOOP_COUNT; i++) {
+		ret = epoll_ctl(epfd, EPOLL_CTL_DEL, fds[i][0], NULL);
+		TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, OK, close(epfd));
+		close(fds[i][0]);
+		close(fds[i][1]);
+	}
+
+	close(epfd);
+	TC_SUCCESS_RESULT();
+}
+#endif
+
+#ifdef CONFIG_FS_WRITEBEHIND
+/**
+* @testcase         fs_vfs_writebehind_tc
+* @brief            Buffer the writes of a file opened with O_WRBEHIND
+* @scenario         Write VFS_LOOP_COUNT records, seek back and read them, then write them
+*                   again, close the file and check its contents through another descriptor
+* @apicovered       open, write, lseek, read, fsync, close
+* @precondition     CONFIG_FS_WRITEBEHIND should be enabled
+* @postcondition    NA
+*/
+static void fs_vfs_writebehind_tc(void)
+{
+	char buf[sizeof(VFS_TEST_CONTENTS_1)];
+	int len = sizeof(VFS_TEST_CONTENTS_1);
+	off_t off;
+	int ret;
+	int fd;
+	int i;
+
+	fd = open(VFS_WRBEHIND_FILE_PATH, O_RDWR | O_CREAT | O_TRUNC | O_WRBEHIND);
+	TC_ASSERT_GEQ("open", fd, 0);
+
+	for (i = 0; i < VFS_LOOP_COUNT; i++) {
+		ret = write(fd, VFS_TEST_CONTENTS_1, len);
+		TC_ASSERT_EQ_CLEANUP("write", ret, len, close(fd));
+	}
+
+	/* The seek writes the buffered records first */
+
+	off = lseek(fd, 0, SEEK_SET);
+	TC_ASSERT_EQ_CLEANUP("lseek", off, 0, close(fd));
+
+	for (i = 0; i < VFS_LOOP_COUNT; i++) {
+		ret = read(fd, buf, len);
+		TC_ASSERT_EQ_CLEANUP("read", ret, len, close(fd));
+		TC_ASSERT_EQ_CLEANUP("read", strcmp(buf, VFS_TEST_CONTENTS_1), 0, close(fd));
+	}
+
+	for (i = 0; i < VFS_LOOP_COUNT; i++) {
+		ret = write(fd, VFS_TEST_CONTENTS_2, len);
+		TC_ASSERT_EQ_CLEANUP("write", ret, len, close(fd));
+	}
+
+	ret = fsync(fd);
+	TC_ASSERT_EQ_CLEANUP("fsync", ret, OK, close(fd));
+
+	ret = write(fd, VFS_TEST_CONTENTS_2, len);
+	TC_ASSERT_EQ_CLEANUP("write", ret, len, close(fd));
+
+	ret = close(fd);
+	TC_ASSERT_EQ("close", ret, OK);
+
+	/* close() wrote the last record */
+
+	fd = open(VFS_WRBEHIND_FILE_PATH, O_RDONLY);
+	TC_ASSERT_GEQ("open", fd, 0);
+
+	off = lseek(fd, 0, SEEK_END);
+	TC_ASSERT_EQ_CLEANUP("lseek", off, (2 * VFS_LOOP_COUNT + 1) * len, close(fd));
+
+	off = lseek(fd, -len, SEEK_END);
+	TC_ASSERT_GEQ_CLEANUP("lseek", off, 0, close(fd));
+
+	ret = read(fd, buf, len);
+	TC_ASSERT_EQ_CLEANUP("read", ret, len, close(fd));
+	TC_ASSERT_EQ_CLEANUP("read", strcmp(buf, VFS_TEST_CONTENTS_2), 0, close(fd));
+
+	close(fd);
+	unlink(VFS_WRBEHIND_FILE_PATH);
+	TC_SUCCESS_RESULT();
+}
+#endif
+
 /**
 * @testcase         fs_vfs_rename_tc
 * @brief            Rename file to specific name
@@ -1832,6 +2135,9 @@ static int fs_sample_launcher(int argc, char **args)
 	fs_vfs_lseek_tc();
 	fs_vfs_pwrite_tc();
 	fs_vfs_pread_tc();
+#ifdef CONFIG_FS_AIO_RING
+	fs_vfs_aio_ring_tc();
+#endif
 	fs_vfs_mkdir_tc();
 	fs_vfs_opendir_tc();
 	fs_vfs_readdir_tc();
@@ -1843,6 +2149,7 @@ static int fs_sample_launcher(int argc, char **args)
 	fs_vfs_rmdir_tc();
 	fs_vfs_unlink_tc();
 	fs_vfs_stat_tc();
+	fs_vfs_inode_lookup_tc();
 	fs_vfs_statfs_tc();
 #if defined(CONFIG_PIPES) && (CONFIG_DEV_PIPE_SIZE > 11)
 	fs_vfs_mkfifo_tc();
@@ -1852,6 +2159,12 @@ static int fs_sample_launcher(int argc, char **args)
 #ifndef CONFIG_DISABLE_POLL
 	fs_vfs_poll_tc();
 	fs_vfs_select_tc();
+#ifdef CONFIG_FS_EPOLL
+	fs_vfs_epoll_tc();
+#endif
+#endif
+#ifdef CONFIG_FS_WRITEBEHIND
+	fs_vfs_writebehind_tc();
 #endif
 	fs_vfs_rename_tc();
 	fs_vfs_ioctl_tc();
@@ -109,6 +109,10 @@ int kernel_tc_main(int argc, char *argv[])
 	libc_semaphore_main();
 #endif
 
+#ifdef CONFIG_TC_KERNEL_LIBC_SHMCHAN
+	libc_shmchan_main();
+#endif
+
 #ifdef CONFIG_TC_KERNEL_LIBC_SIGNAL
 	libc_signal_main();
 #endif
@@ -198,6 +202,10 @@ int kernel_tc_main(int argc, char *argv[])
 #ifdef CONFIG_TC_KERNEL_UMM_HEAP
 	umm_heap_main();
 #endif
+
+#ifdef CONFIG_TC_KERNEL_WQUEUE
+	wqueue_main();
+#endif
 	printf("\n=== TINYARA Kernel TC COMPLETE ===\n");
 	printf("\t\tTotal pass : %d\n\t\tTotal fail : %d\n", total_pass, total_fail);
 
@@ -25,6 +25,7 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <time.h>
+#include <unistd.h>
 #include <tinyara/time.h>
 #include <sys/time.h>
 #include "../../../../../os/kernel/clock/clock.h"
@@ -39,6 +40,7 @@ extern struct timespec g_basetime;
 #define SEC_2   2
 #define SEC_10  10
 #define NSEC_20 20
+#define CPUTIME_BUSY_MSEC 200
 
 
 /**
@@ -230,6 +232,88 @@ static void tc_clock_clock_abstime2ticks(void)
 	TC_SUCCESS_RESULT();
 }
 
+#ifdef CONFIG_SCHED_CPUTIME
+/**
+* @fn                   :tc_clock_clock_cputime
+* @brief                :Return the CPU time measured for a thread
+* @scenario             :Sleep once and check that the time and switch counts of the thread
+*                        only grow, and that an invalid pid is refused
+* API's covered         :clock_cputime, clock_schedlatency
+* Preconditions         :none
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_clock_clock_cputime(void)
+{
+	int ret_chk;
+	int i;
+	uint32_t total = 0;
+	struct cputime_s before;
+	struct cputime_s after;
+	struct schedlat_s schedlat;
+
+	ret_chk = clock_cputime(getpid(), &before);
+	TC_ASSERT_EQ("clock_cputime", ret_chk, OK);
+
+	sleep(1);
+
+	ret_chk = clock_cputime(getpid(), &after);
+	TC_ASSERT_EQ("clock_cputime", ret_chk, OK);
+	TC_ASSERT_GEQ("clock_cputime", after.runtime, before.runtime);
+	TC_ASSERT_GEQ("clock_cputime", after.waittime, before.waittime);
+	TC_ASSERT_GEQ("clock_cputime", after.nvcsw, before.nvcsw + 1);
+	TC_ASSERT_GEQ("clock_cputime", after.nivcsw, before.nivcsw);
+
+	ret_chk = clock_cputime(-1, &after);
+	TC_ASSERT_EQ("clock_cputime", ret_chk, -ESRCH);
+
+	clock_schedlatency(&schedlat);
+	for (i = 0; i < CLOCK_SCHEDLAT_NBUCKETS; i++) {
+		total += schedlat.count[i];
+	}
+
+	TC_ASSERT_GT("clock_schedlatency", total, 0);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @fn                   :tc_clock_clock_cputime_busy
+* @brief                :Charge the CPU time of a busy thread to it
+* @scenario             :Spin for CPUTIME_BUSY_MSEC and check that the run time of the thread
+*                        grows by at least half and at most twice that time
+* API's covered         :clock_cputime
+* Preconditions         :none
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_clock_clock_cputime_busy(void)
+{
+	int ret_chk;
+	uint64_t elapsed;
+	struct timespec start;
+	struct timespec now;
+	struct cputime_s before;
+	struct cputime_s after;
+
+	ret_chk = clock_cputime(getpid(), &before);
+	TC_ASSERT_EQ("clock_cputime", ret_chk, OK);
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	do {
+		clock_gettime(CLOCK_REALTIME, &now);
+		elapsed = (uint64_t)(now.tv_sec - start.tv_sec) * USEC_PER_SEC + now.tv_nsec / NSEC_PER_USEC - start.tv_nsec / NSEC_PER_USEC;
+	} while (elapsed < CPUTIME_BUSY_MSEC * USEC_PER_MSEC);
+
+	ret_chk = clock_cputime(getpid(), &after);
+	TC_ASSERT_EQ("clock_cputime", ret_chk, OK);
+	TC_ASSERT_GEQ("clock_cputime", after.runtime - before.runtime, elapsed / 2);
+	TC_ASSERT_LEQ("clock_cputime", after.runtime - before.runtime, elapsed * 2);
+
+	TC_SUCCESS_RESULT();
+}
+#endif
+
 /****************************************************************************
  * Name: clock
  ****************************************************************************/
@@ -243,6 +327,10 @@ int clock_main(void)
 	tc_clock_clock_set_get_time();
 	tc_clock_clock_getres();
 	tc_clock_clock_abstime2ticks();
+#ifdef CONFIG_SCHED_CPUTIME
+	tc_clock_clock_cputime();
+	tc_clock_clock_cputime_busy();
+#endif
 
 	return 0;
 }
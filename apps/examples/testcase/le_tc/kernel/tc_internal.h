@@ -73,6 +73,7 @@ int libc_pthread_main(void);
 int libc_queue_main(void);
 int libc_sched_main(void);
 int libc_semaphore_main(void);
+int libc_shmchan_main(void);
 int libc_signal_main(void);
 int libc_spawn_main(void);
 int libc_stdio_main(void);
@@ -91,6 +92,7 @@ int task_main(void);
 int termios_main(void);
 int timer_main(void);
 int umm_heap_main(void);
+int wqueue_main(void);
 int tash_heapinfo_main(void);
 int tash_stackmonitor_main(void);
 
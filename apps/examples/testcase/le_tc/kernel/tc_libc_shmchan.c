@@ -0,0 +1,294 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file tc_libc_shmchan.c
+
+/// @brief Test Case Example for Libc Shared memory channel API
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <tinyara/shmchan.h>
+#include "tc_internal.h"
+
+#define SHMCH_KEY       0x5343
+#define SHMCH_NSLOTS    4
+#define SHMCH_MSGSIZE   32
+#define SHMCH_NPRODUCER 2
+#define SHMCH_NMESSAGE  200
+
+static struct shmch_s g_prodch[SHMCH_NPRODUCER];
+
+/**
+* @fn                   :tc_libc_shmchan_create_open
+* @brief                :shmch_create creates and attaches a channel, shmch_open attaches it again.
+* @Scenario             :Invalid arguments and a second create of the same key are rejected.
+*                        The channel stays until the last attachment is closed.
+* @API'scovered         :shmch_create, shmch_open, shmch_close, shmch_msgsize
+* @Preconditions        :NA
+* @Postconditions       :NA
+* @return               :void
+*/
+static void tc_libc_shmchan_create_open(void)
+{
+	struct shmch_s ch;
+	struct shmch_s ch2;
+	int ret_chk;
+
+	ret_chk = shmch_create(SHMCH_KEY, 3, SHMCH_MSGSIZE, SHMCH_SPSC, &ch);
+	TC_ASSERT_EQ("shmch_create", ret_chk, ERROR);
+	TC_ASSERT_EQ("shmch_create", get_errno(), EINVAL);
+
+	ret_chk = shmch_create(SHMCH_KEY, SHMCH_NSLOTS, 0, SHMCH_SPSC, &ch);
+	TC_ASSERT_EQ("shmch_create", ret_chk, ERROR);
+	TC_ASSERT_EQ("shmch_create", get_errno(), EINVAL);
+
+	ret_chk = shmch_open(SHMCH_KEY, &ch);
+	TC_ASSERT_EQ("shmch_open", ret_chk, ERROR);
+	TC_ASSERT_EQ("shmch_open", get_errno(), ENOENT);
+
+	ret_chk = shmch_create(SHMCH_KEY, SHMCH_NSLOTS, SHMCH_MSGSIZE, SHMCH_SPSC, &ch);
+	TC_ASSERT_EQ("shmch_create", ret_chk, OK);
+	TC_ASSERT_GEQ_CLEANUP("shmch_msgsize", shmch_msgsize(&ch), SHMCH_MSGSIZE, shmch_close(&ch));
+
+	ret_chk = shmch_create(SHMCH_KEY, SHMCH_NSLOTS, SHMCH_MSGSIZE, SHMCH_SPSC, &ch2);
+	TC_ASSERT_EQ_CLEANUP("shmch_create", ret_chk, ERROR, shmch_close(&ch));
+	TC_ASSERT_EQ_CLEANUP("shmch_create", get_errno(), EEXIST, shmch_close(&ch));
+
+	ret_chk = shmch_open(SHMCH_KEY, &ch2);
+	TC_ASSERT_EQ_CLEANUP("shmch_open", ret_chk, OK, shmch_close(&ch));
+	TC_ASSERT_EQ_CLEANUP("shmch_msgsize", shmch_msgsize(&ch2), shmch_msgsize(&ch), shmch_close(&ch); shmch_close(&ch2));
+
+	ret_chk = shmch_close(&ch);
+	TC_ASSERT_EQ_CLEANUP("shmch_close", ret_chk, OK, shmch_close(&ch2));
+
+	/* The channel is still attached through ch2 */
+
+	ret_chk = shmch_open(SHMCH_KEY, &ch);
+	TC_ASSERT_EQ_CLEANUP("shmch_open", ret_chk, OK, shmch_close(&ch2));
+	shmch_close(&ch);
+
+	ret_chk = shmch_close(&ch2);
+	TC_ASSERT_EQ("shmch_close", ret_chk, OK);
+
+	ret_chk = shmch_open(SHMCH_KEY, &ch);
+	TC_ASSERT_EQ("shmch_open", ret_chk, ERROR);
+	TC_ASSERT_EQ("shmch_open", get_errno(), ENOENT);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @fn                   :tc_libc_shmchan_ring
+* @brief                :Buffers pass from shmch_reserve/shmch_commit to shmch_receive/shmch_release in order.
+* @Scenario             :Without waiting, receive on an empty ring and reserve on a full ring fail with EAGAIN.
+*                        Each message is received in place with its length, oldest first.
+* @API'scovered         :shmch_reserve, shmch_commit, shmch_receive, shmch_release
+* @Preconditions        :NA
+* @Postconditions       :NA
+* @return               :void
+*/
+static void tc_libc_shmchan_ring(void)
+{
+	struct shmch_s ch;
+	FAR void *bufs[SHMCH_NSLOTS];
+	FAR uint8_t *buf;
+	size_t len;
+	int ret_chk;
+	int i;
+
+	ret_chk = shmch_create(SHMCH_KEY, SHMCH_NSLOTS, SHMCH_MSGSIZE, SHMCH_SPSC, &ch);
+	TC_ASSERT_EQ("shmch_create", ret_chk, OK);
+
+	buf = shmch_receive(&ch, &len, false);
+	TC_ASSERT_EQ_CLEANUP("shmch_receive", buf, NULL, shmch_close(&ch));
+	TC_ASSERT_EQ_CLEANUP("shmch_receive", get_errno(), EAGAIN, shmch_close(&ch));
+
+	ret_chk = shmch_release(&ch);
+	TC_ASSERT_EQ_CLEANUP("shmch_release", ret_chk, ERROR, shmch_close(&ch));
+	TC_ASSERT_EQ_CLEANUP("shmch_release", get_errno(), EINVAL, shmch_close(&ch));
+
+	/* Fill the ring */
+
+	for (i = 0; i < SHMCH_NSLOTS; i++) {
+		bufs[i] = shmch_reserve(&ch, false);
+		TC_ASSERT_NEQ_CLEANUP("shmch_reserve", bufs[i], NULL, shmch_close(&ch));
+		memset(bufs[i], i + 1, i + 1);
+	}
+
+	buf = shmch_reserve(&ch, false);
+	TC_ASSERT_EQ_CLEANUP("shmch_reserve", buf, NULL, shmch_close(&ch));
+	TC_ASSERT_EQ_CLEANUP("shmch_reserve", get_errno(), EAGAIN, shmch_close(&ch));
+
+	ret_chk = shmch_commit(&ch, &ch, 1);
+	TC_ASSERT_EQ_CLEANUP("shmch_commit", ret_chk, ERROR, shmch_close(&ch));
+	TC_ASSERT_EQ_CLEANUP("shmch_commit", get_errno(), EINVAL, shmch_close(&ch));
+
+	ret_chk = shmch_commit(&ch, bufs[0], shmch_msgsize(&ch) + 1);
+	TC_ASSERT_EQ_CLEANUP("shmch_commit", ret_chk, ERROR, shmch_close(&ch));
+	TC_ASSERT_EQ_CLEANUP("shmch_commit", get_errno(), EINVAL, shmch_close(&ch));
+
+	for (i = 0; i < SHMCH_NSLOTS; i++) {
+		ret_chk = shmch_commit(&ch, bufs[i], i + 1);
+		TC_ASSERT_EQ_CLEANUP("shmch_commit", ret_chk, OK, shmch_close(&ch));
+	}
+
+	/* A buffer is committed only once */
+
+	ret_chk = shmch_commit(&ch, bufs[0], 1);
+	TC_ASSERT_EQ_CLEANUP("shmch_commit", ret_chk, ERROR, shmch_close(&ch));
+	TC_ASSERT_EQ_CLEANUP("shmch_commit", get_errno(), EINVAL, shmch_close(&ch));
+
+	/* Drain it, the messages are read where they were written */
+
+	for (i = 0; i < SHMCH_NSLOTS; i++) {
+		buf = shmch_receive(&ch, &len, false);
+		TC_ASSERT_EQ_CLEANUP("shmch_receive", buf, bufs[i], shmch_close(&ch));
+		TC_ASSERT_EQ_CLEANUP("shmch_receive", len, i + 1, shmch_close(&ch));
+		TC_ASSERT_EQ_CLEANUP("shmch_receive", buf[i], i + 1, shmch_close(&ch));
+
+		ret_chk = shmch_release(&ch);
+		TC_ASSERT_EQ_CLEANUP("shmch_release", ret_chk, OK, shmch_close(&ch));
+	}
+
+	buf = shmch_receive(&ch, &len, false);
+	TC_ASSERT_EQ_CLEANUP("shmch_receive", buf, NULL, shmch_close(&ch));
+
+	ret_chk = shmch_close(&ch);
+	TC_ASSERT_EQ("shmch_close", ret_chk, OK);
+
+	TC_SUCCESS_RESULT();
+}
+
+static pthread_addr_t shmchan_producer(pthread_addr_t arg)
+{
+	FAR struct shmch_s *ch = (FAR struct shmch_s *)arg;
+	FAR uint32_t *msg;
+	uint32_t id = ch - g_prodch;
+	uint32_t seq;
+
+	for (seq = 0; seq < SHMCH_NMESSAGE; seq++) {
+		msg = shmch_reserve(ch, true);
+		if (msg == NULL) {
+			return (pthread_addr_t)ERROR;
+		}
+
+		msg[0] = id;
+		msg[1] = seq;
+		if (shmch_commit(ch, msg, 2 * sizeof(uint32_t)) != OK) {
+			return (pthread_addr_t)ERROR;
+		}
+	}
+
+	return (pthread_addr_t)OK;
+}
+
+/**
+* @fn                   :tc_libc_shmchan_mpsc
+* @brief                :Several producers share a channel created with SHMCH_MPSC.
+* @Scenario             :Producer threads attached with shmch_open send through a small ring while the
+*                        consumer waits for messages.  Every message arrives once and in the order of its producer.
+* @API'scovered         :shmch_open, shmch_reserve, shmch_commit, shmch_receive, shmch_release
+* @Preconditions        :NA
+* @Postconditions       :NA
+* @return               :void
+*/
+static void tc_libc_shmchan_mpsc(void)
+{
+	struct shmch_s ch;
+	pthread_t tid[SHMCH_NPRODUCER];
+	pthread_addr_t result;
+	uint32_t next[SHMCH_NPRODUCER];
+	FAR uint32_t *msg;
+	size_t len;
+	int nthread;
+	int ret_chk;
+	int failed = 0;
+	int i;
+
+	ret_chk = shmch_create(SHMCH_KEY, SHMCH_NSLOTS, SHMCH_MSGSIZE, SHMCH_MPSC, &ch);
+	TC_ASSERT_EQ("shmch_create", ret_chk, OK);
+
+	for (nthread = 0; nthread < SHMCH_NPRODUCER; nthread++) {
+		next[nthread] = 0;
+		if (shmch_open(SHMCH_KEY, &g_prodch[nthread]) != OK) {
+			break;
+		}
+
+		if (pthread_create(&tid[nthread], NULL, shmchan_producer, &g_prodch[nthread]) != 0) {
+			shmch_close(&g_prodch[nthread]);
+			break;
+		}
+	}
+
+	if (nthread < SHMCH_NPRODUCER) {
+		failed = 1;
+	}
+
+	/* Take every message even after a bad one so no producer stays blocked */
+
+	for (i = 0; i < nthread * SHMCH_NMESSAGE; i++) {
+		msg = shmch_receive(&ch, &len, true);
+		if (msg == NULL) {
+			failed = 1;
+			break;
+		}
+
+		if (len != 2 * sizeof(uint32_t) || msg[0] >= nthread || msg[1] != next[msg[0]]) {
+			failed = 1;
+		} else {
+			next[msg[0]]++;
+		}
+
+		shmch_release(&ch);
+	}
+
+	for (i = 0; i < nthread; i++) {
+		pthread_join(tid[i], &result);
+		if (result != (pthread_addr_t)OK) {
+			failed = 1;
+		}
+
+		shmch_close(&g_prodch[i]);
+	}
+
+	ret_chk = shmch_close(&ch);
+	TC_ASSERT_EQ("shmch_close", ret_chk, OK);
+	TC_ASSERT_EQ("shmch_receive", failed, 0);
+
+	TC_SUCCESS_RESULT();
+}
+
+/****************************************************************************
+ * Name: libc_shmchan
+ ****************************************************************************/
+
+int libc_shmchan_main(void)
+{
+	tc_libc_shmchan_create_open();
+	tc_libc_shmchan_ring();
+	tc_libc_shmchan_mpsc();
+
+	return 0;
+}
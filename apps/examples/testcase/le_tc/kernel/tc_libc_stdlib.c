@@ -43,6 +43,8 @@
 #define BINARY 2
 #define QSORT_SMALL_ARRSIZE 6
 #define QSORT_BIG_ARRSIZE 45
+#define MERGESORT_ARRSIZE 40
+#define MERGESORT_NKEYS 5
 #define BSEARCH_ARRSIZE 10
 
 /**
@@ -55,6 +57,21 @@ static int compare(const void *a, const void *b)
 	return (*(int *)a - *(int *)b);
 }
 
+struct mergesort_pair_s {
+	int key;
+	int seq;
+};
+
+/**
+* @fn                   :compare_key
+* @description          :Function for tc_libc_stdlib_mergesort
+* @return               :int
+*/
+static int compare_key(const void *a, const void *b)
+{
+	return ((struct mergesort_pair_s *)a)->key - ((struct mergesort_pair_s *)b)->key;
+}
+
 /**
 * @fn                   :tc_abs_labs_llabs
 * @brief                :Returns the absolute value of parameter
@@ -200,6 +217,46 @@ static void tc_libc_stdlib_qsort(void)
 	TC_SUCCESS_RESULT();
 }
 
+/**
+* @fn                   :tc_mergesort
+* @brief                :Sorts the elements of the array, keeping equal elements in order
+* @Scenario             :Sorts pairs with few distinct keys and checks that pairs with the same key
+*                        keep their original order.
+* API's covered         :mergesort
+* Preconditions         :None
+* Postconditions        :None
+* @return               :void
+*/
+static void tc_libc_stdlib_mergesort(void)
+{
+	struct mergesort_pair_s pairs[MERGESORT_ARRSIZE];
+	int data_idx;
+	int ret_chk;
+
+	for (data_idx = 0; data_idx < MERGESORT_ARRSIZE; data_idx++) {
+		pairs[data_idx].key = (data_idx * 7) % MERGESORT_NKEYS;
+		pairs[data_idx].seq = data_idx;
+	}
+
+	ret_chk = mergesort(pairs, MERGESORT_ARRSIZE, sizeof(struct mergesort_pair_s), compare_key);
+	TC_ASSERT_EQ("mergesort", ret_chk, 0);
+
+	for (data_idx = 0; data_idx < MERGESORT_ARRSIZE - 1; data_idx++) {
+		TC_ASSERT_LEQ("mergesort", pairs[data_idx].key, pairs[data_idx + 1].key);
+		if (pairs[data_idx].key == pairs[data_idx + 1].key) {
+			TC_ASSERT_LT("mergesort", pairs[data_idx].seq, pairs[data_idx + 1].seq);
+		}
+	}
+
+	/* A zero element size is invalid */
+
+	ret_chk = mergesort(pairs, MERGESORT_ARRSIZE, 0, compare_key);
+	TC_ASSERT_EQ("mergesort", ret_chk, -1);
+	TC_ASSERT_EQ("mergesort", errno, EINVAL);
+
+	TC_SUCCESS_RESULT();
+}
+
 /**
 * @fn                   :tc_rand
 * @brief                :Returns a pseudo-random integral number
@@ -508,6 +565,7 @@ int libc_stdlib_main(void)
 	tc_libc_stdlib_imaxabs();
 	tc_libc_stdlib_itoa();
 	tc_libc_stdlib_qsort();
+	tc_libc_stdlib_mergesort();
 	tc_libc_stdlib_rand();
 	tc_libc_stdlib_strtol();
 	tc_libc_stdlib_strtoll();
@@ -62,6 +62,10 @@
 #include <sys/types.h>
 #include <ctype.h>
 #include <fcntl.h>
+#include <sched.h>
+#ifdef CONFIG_MQ_ZEROCOPY
+#include <tinyara/mqueue.h>
+#endif
 #include "tc_internal.h"
 
 /**************************************************************************
@@ -90,6 +94,8 @@
 
 #define HALF_SECOND_USEC_USEC   500000L
 
+#define PRIO_WAITERS            3
+
 #ifdef CONFIG_EXAMPLES_OSTEST_STACKSIZE
 #define STACKSIZE CONFIG_EXAMPLES_OSTEST_STACKSIZE
 #else
@@ -118,6 +124,10 @@ static mqd_t g_timedrecv_mqfd;
 static int enter_notify_handler = 0;
 static int timedsend_check = 0;
 static int timedreceive_check = 0;
+static mqd_t g_prio_mqfd;
+static mqd_t g_other_mqfd;
+static volatile int g_wake_order[PRIO_WAITERS + 1];
+static volatile int g_wake_cnt;
 /**************************************************************************
 * Private Functions
 **************************************************************************/
@@ -586,6 +596,157 @@ static void tc_mqueue_mq_unlink(void)
 	TC_SUCCESS_RESULT();
 }
 
+/**
+* @fn                   :prio_receiver_func
+* @description          :Function for tc_mqueue_mq_receive_priority_order
+* @return               :void*
+*/
+static void *prio_receiver_func(void *arg)
+{
+	int msg;
+	mqd_t mqdes = (intptr_t)arg > PRIO_WAITERS ? g_other_mqfd : g_prio_mqfd;
+
+	if (mq_receive(mqdes, (char *)&msg, sizeof(msg), NULL) == sizeof(msg)) {
+		g_wake_order[g_wake_cnt++] = (intptr_t)arg;
+	}
+	return NULL;
+}
+
+/**
+* @fn                   :tc_mqueue_mq_receive_priority_order
+* @brief                :this tc tests that mq_send wakes the highest priority receiver of its queue
+* @scenario             :receivers of increasing priority block on one queue in the order low, high, middle
+*                        while a higher priority receiver waits on another queue. Each mq_send must wake
+*                        the highest priority receiver of its own queue only.
+* API's covered         :mq_send, mq_receive
+* Preconditions         :none
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_mqueue_mq_receive_priority_order(void)
+{
+	static const int create_order[PRIO_WAITERS + 1] = { 1, 3, 2, 4 };
+	pthread_t thread[PRIO_WAITERS + 1];
+	pthread_attr_t attr;
+	struct sched_param sparam;
+	struct mq_attr mqattr;
+	int base_prio;
+	int index;
+	int ret_chk;
+
+	mqattr.mq_maxmsg = PRIO_WAITERS + 1;
+	mqattr.mq_msgsize = sizeof(int);
+	mqattr.mq_flags = 0;
+
+	g_prio_mqfd = mq_open("mqprio", O_CREAT | O_RDWR, 0666, &mqattr);
+	TC_ASSERT_NEQ("mq_open", g_prio_mqfd, (mqd_t)-1);
+	g_other_mqfd = mq_open("mqother", O_CREAT | O_RDWR, 0666, &mqattr);
+	TC_ASSERT_NEQ_CLEANUP("mq_open", g_other_mqfd, (mqd_t)-1, goto errout_with_prio);
+
+	sched_getparam(0, &sparam);
+	base_prio = sparam.sched_priority;
+	g_wake_cnt = 0;
+
+	/* Receiver n runs at base + n, so it preempts us as soon as it is woken */
+
+	for (index = 0; index <= PRIO_WAITERS; index++) {
+		pthread_attr_init(&attr);
+		sparam.sched_priority = base_prio + create_order[index];
+		pthread_attr_setschedparam(&attr, &sparam);
+		ret_chk = pthread_create(&thread[index], &attr, prio_receiver_func, (void *)(intptr_t)create_order[index]);
+		pthread_attr_destroy(&attr);
+		TC_ASSERT_EQ_CLEANUP("pthread_create", ret_chk, OK, goto errout_with_other);
+	}
+
+	for (index = 0; index < PRIO_WAITERS; index++) {
+		ret_chk = mq_send(g_prio_mqfd, (const char *)&index, sizeof(index), 1);
+		TC_ASSERT_EQ_CLEANUP("mq_send", ret_chk, OK, goto errout_with_other);
+	}
+
+	TC_ASSERT_EQ_CLEANUP("mq_send", g_wake_cnt, PRIO_WAITERS, goto errout_with_other);
+	for (index = 0; index < PRIO_WAITERS; index++) {
+		TC_ASSERT_EQ_CLEANUP("mq_send", g_wake_order[index], PRIO_WAITERS - index, goto errout_with_other);
+	}
+
+	ret_chk = mq_send(g_other_mqfd, (const char *)&index, sizeof(index), 1);
+	TC_ASSERT_EQ_CLEANUP("mq_send", ret_chk, OK, goto errout_with_other);
+	TC_ASSERT_EQ_CLEANUP("mq_send", g_wake_cnt, PRIO_WAITERS + 1, goto errout_with_other);
+
+	for (index = 0; index <= PRIO_WAITERS; index++) {
+		pthread_join(thread[index], NULL);
+	}
+
+	mq_close(g_other_mqfd);
+	mq_unlink("mqother");
+	mq_close(g_prio_mqfd);
+	mq_unlink("mqprio");
+	TC_SUCCESS_RESULT();
+	return;
+
+errout_with_other:
+	mq_close(g_other_mqfd);
+	mq_unlink("mqother");
+errout_with_prio:
+	mq_close(g_prio_mqfd);
+	mq_unlink("mqprio");
+}
+
+#ifdef CONFIG_MQ_ZEROCOPY
+/**
+* @fn                   :tc_mqueue_mq_zerocopy
+* @brief                :this tc tests the zero-copy message buffer interface
+* @scenario             :a message built in a buffer from mq_getbuffer is sent with mq_sendbuffer and
+*                        mq_receivebuffer must return that same buffer with its contents and priority
+* API's covered         :mq_getbuffer, mq_sendbuffer, mq_receivebuffer, mq_releasebuffer
+* Preconditions         :none
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_mqueue_mq_zerocopy(void)
+{
+	mqd_t mqdes;
+	char *sndbuf;
+	char *rcvbuf = NULL;
+	ssize_t nbytes;
+	int prio = 0;
+
+	mqdes = mq_open("mqzerocopy", O_CREAT | O_RDWR | O_NONBLOCK, 0666, 0);
+	TC_ASSERT_NEQ("mq_open", mqdes, (mqd_t)-1);
+
+	sndbuf = mq_getbuffer(mqdes);
+	TC_ASSERT_NEQ_CLEANUP("mq_getbuffer", sndbuf, NULL, goto cleanup);
+
+	strncpy(sndbuf, TEST_MESSAGE, TEST_MSGLEN);
+	TC_ASSERT_EQ_CLEANUP("mq_sendbuffer", mq_sendbuffer(mqdes, sndbuf, TEST_MSGLEN, 5), OK, {
+		mq_releasebuffer(sndbuf);
+		goto cleanup;
+	});
+
+	nbytes = mq_receivebuffer(mqdes, &rcvbuf, &prio);
+	TC_ASSERT_EQ_CLEANUP("mq_receivebuffer", nbytes, (ssize_t)TEST_MSGLEN, goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("mq_receivebuffer", rcvbuf, sndbuf, goto release);
+	TC_ASSERT_EQ_CLEANUP("mq_receivebuffer", prio, 5, goto release);
+	TC_ASSERT_EQ_CLEANUP("mq_receivebuffer", strcmp(rcvbuf, TEST_MESSAGE), 0, goto release);
+	mq_releasebuffer(rcvbuf);
+
+	/* The queue is empty again */
+
+	TC_ASSERT_EQ_CLEANUP("mq_receivebuffer", mq_receivebuffer(mqdes, &rcvbuf, NULL), ERROR, goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("mq_receivebuffer", get_errno(), EAGAIN, goto cleanup);
+
+	mq_close(mqdes);
+	mq_unlink("mqzerocopy");
+	TC_SUCCESS_RESULT();
+	return;
+
+release:
+	mq_releasebuffer(rcvbuf);
+cleanup:
+	mq_close(mqdes);
+	mq_unlink("mqzerocopy");
+}
+#endif
+
 /****************************************************************************
  * Name: mqueue
  ****************************************************************************/
@@ -595,6 +756,10 @@ int mqueue_main(void)
 	tc_mqueue_mq_notify();
 	tc_mqueue_mq_timedsend_timedreceive();
 	tc_mqueue_mq_unlink();
+	tc_mqueue_mq_receive_priority_order();
+#ifdef CONFIG_MQ_ZEROCOPY
+	tc_mqueue_mq_zerocopy();
+#endif
 
 	return 0;
 }
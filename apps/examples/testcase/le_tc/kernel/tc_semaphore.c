@@ -28,10 +28,14 @@
 #define PSHARED     0
 #define SEC_2       2
 #define LOOP_CNT    5
+#define PRIO_WAITERS 3
 
 static sem_t g_empty;
 static sem_t g_full;
 static sem_t g_sem;
+static sem_t g_other;
+static volatile int g_wake_order[PRIO_WAITERS + 1];
+static volatile int g_wake_cnt;
 
 /**
 * @fn                   :producer_func
@@ -321,6 +325,87 @@ static void tc_semaphore_sem_timedwait(void)
 	TC_SUCCESS_RESULT();
 }
 
+/**
+* @fn                   :prio_waiter_func
+* @description          :Function for tc_semaphore_sem_post_priority_order
+* @return               :void*
+*/
+static void *prio_waiter_func(void *arg)
+{
+	sem_t *sem = (sem_t *)((intptr_t)arg > PRIO_WAITERS ? &g_other : &g_sem);
+
+	while (sem_wait(sem) != OK) {
+	}
+	g_wake_order[g_wake_cnt++] = (intptr_t)arg;
+	return NULL;
+}
+
+/**
+* @fn                   :tc_semaphore_sem_post_priority_order
+* @brief                :this tc tests that sem_post wakes the highest priority waiter
+* @scenario             :waiters of increasing priority block on one semaphore in the order low, high, middle
+*                        while a higher priority task waits on another semaphore. Each sem_post must wake
+*                        the highest priority waiter of its own semaphore only.
+* API's covered         :sem_wait, sem_post
+* Preconditions         :none
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_semaphore_sem_post_priority_order(void)
+{
+	static const int create_order[PRIO_WAITERS + 1] = { 1, 3, 2, 4 };
+	pthread_t thread[PRIO_WAITERS + 1];
+	pthread_attr_t attr;
+	struct sched_param sparam;
+	int base_prio;
+	int ret_chk;
+	int index;
+
+	ret_chk = sched_getparam(0, &sparam);
+	TC_ASSERT_EQ("sched_getparam", ret_chk, OK);
+	base_prio = sparam.sched_priority;
+
+	ret_chk = sem_init(&g_sem, PSHARED, 0);
+	TC_ASSERT_EQ("sem_init", ret_chk, OK);
+	ret_chk = sem_init(&g_other, PSHARED, 0);
+	TC_ASSERT_EQ("sem_init", ret_chk, OK);
+	g_wake_cnt = 0;
+
+	/* Waiter n runs at base + n, so it preempts us as soon as it is woken */
+
+	for (index = 0; index <= PRIO_WAITERS; index++) {
+		pthread_attr_init(&attr);
+		sparam.sched_priority = base_prio + create_order[index];
+		pthread_attr_setschedparam(&attr, &sparam);
+		ret_chk = pthread_create(&thread[index], &attr, prio_waiter_func, (void *)(intptr_t)create_order[index]);
+		pthread_attr_destroy(&attr);
+		TC_ASSERT_EQ("pthread_create", ret_chk, OK);
+	}
+
+	for (index = 0; index < PRIO_WAITERS; index++) {
+		ret_chk = sem_post(&g_sem);
+		TC_ASSERT_EQ("sem_post", ret_chk, OK);
+	}
+
+	TC_ASSERT_EQ("sem_post", g_wake_cnt, PRIO_WAITERS);
+	for (index = 0; index < PRIO_WAITERS; index++) {
+		TC_ASSERT_EQ("sem_post", g_wake_order[index], PRIO_WAITERS - index);
+	}
+
+	ret_chk = sem_post(&g_other);
+	TC_ASSERT_EQ("sem_post", ret_chk, OK);
+	TC_ASSERT_EQ("sem_post", g_wake_cnt, PRIO_WAITERS + 1);
+
+	for (index = 0; index <= PRIO_WAITERS; index++) {
+		pthread_join(thread[index], NULL);
+	}
+
+	sem_destroy(&g_sem);
+	sem_destroy(&g_other);
+
+	TC_SUCCESS_RESULT();
+}
+
 /**
 * @fn                   :tc_semaphore_sem_destroy
 * @brief                :this tc tests sem_destroy function
@@ -361,6 +446,7 @@ int semaphore_main(void)
 	tc_semaphore_sem_post_wait();
 	tc_semaphore_sem_trywait();
 	tc_semaphore_sem_timedwait();
+	tc_semaphore_sem_post_priority_order();
 	tc_semaphore_sem_destroy();
 
 	return 0;
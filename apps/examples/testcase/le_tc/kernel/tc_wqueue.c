@@ -0,0 +1,218 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file tc_wqueue.c
+/// @brief Test Case Example for kernel work queue API
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <semaphore.h>
+#include <tinyara/clock.h>
+#include <tinyara/wqueue.h>
+#include "tc_internal.h"
+
+#define WQ_NWORK        4
+#define WQ_MSEC(n)      MSEC2TICK(n)
+
+static struct work_s g_work[WQ_NWORK];
+static volatile int g_run_order[WQ_NWORK];
+static volatile int g_run_cnt;
+static sem_t g_wq_sem;
+
+/**
+* @fn                   :wq_order_worker
+* @description          :Function for tc_wqueue_work_queue_deadline_order
+* @return               :void
+*/
+static void wq_order_worker(FAR void *arg)
+{
+	g_run_order[g_run_cnt++] = (intptr_t)arg;
+	sem_post(&g_wq_sem);
+}
+
+/**
+* @fn                   :tc_wqueue_work_queue_deadline_order
+* @brief                :this tc tests that queued work runs in deadline order
+* @scenario             :work 0, 1 and 2 are queued with 300, 100 and 200 ms delays. 150 ms later work 3 is
+*                        queued with a 120 ms delay, so it falls due after work 2 although its delay is
+*                        shorter. The work must run in the order 1, 2, 3, 0.
+* API's covered         :work_queue
+* Preconditions         :none
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_wqueue_work_queue_deadline_order(void)
+{
+	static const int expected[WQ_NWORK] = { 1, 2, 3, 0 };
+	int index;
+	int ret_chk;
+
+	memset(g_work, 0, sizeof(g_work));
+	g_run_cnt = 0;
+	sem_init(&g_wq_sem, 0, 0);
+
+	ret_chk = work_queue(LPWORK, &g_work[0], wq_order_worker, (void *)0, WQ_MSEC(300));
+	TC_ASSERT_EQ("work_queue", ret_chk, OK);
+	ret_chk = work_queue(LPWORK, &g_work[1], wq_order_worker, (void *)1, WQ_MSEC(100));
+	TC_ASSERT_EQ("work_queue", ret_chk, OK);
+	ret_chk = work_queue(LPWORK, &g_work[2], wq_order_worker, (void *)2, WQ_MSEC(200));
+	TC_ASSERT_EQ("work_queue", ret_chk, OK);
+
+	/* Queueing the same work again is refused */
+
+	ret_chk = work_queue(LPWORK, &g_work[2], wq_order_worker, (void *)2, WQ_MSEC(200));
+	TC_ASSERT_EQ("work_queue", ret_chk, -EALREADY);
+
+	usleep(150 * USEC_PER_MSEC);
+	ret_chk = work_queue(LPWORK, &g_work[3], wq_order_worker, (void *)3, WQ_MSEC(120));
+	TC_ASSERT_EQ("work_queue", ret_chk, OK);
+
+	for (index = 0; index < WQ_NWORK; index++) {
+		while (sem_wait(&g_wq_sem) != OK) {
+		}
+	}
+
+	for (index = 0; index < WQ_NWORK; index++) {
+		TC_ASSERT_EQ("work_queue", g_run_order[index], expected[index]);
+	}
+
+	sem_destroy(&g_wq_sem);
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @fn                   :tc_wqueue_work_cancel
+* @brief                :this tc tests that cancelled work does not run
+* @scenario             :two work items are queued, the earlier one is cancelled and only the later one
+*                        must run
+* API's covered         :work_queue, work_cancel
+* Preconditions         :none
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_wqueue_work_cancel(void)
+{
+	int ret_chk;
+
+	memset(g_work, 0, sizeof(g_work));
+	g_run_cnt = 0;
+	sem_init(&g_wq_sem, 0, 0);
+
+	ret_chk = work_queue(LPWORK, &g_work[0], wq_order_worker, (void *)0, WQ_MSEC(50));
+	TC_ASSERT_EQ("work_queue", ret_chk, OK);
+	ret_chk = work_queue(LPWORK, &g_work[1], wq_order_worker, (void *)1, WQ_MSEC(100));
+	TC_ASSERT_EQ("work_queue", ret_chk, OK);
+
+	ret_chk = work_cancel(LPWORK, &g_work[0]);
+	TC_ASSERT_EQ("work_cancel", ret_chk, OK);
+	ret_chk = work_cancel(LPWORK, &g_work[0]);
+	TC_ASSERT_EQ("work_cancel", ret_chk, -ENOENT);
+
+	while (sem_wait(&g_wq_sem) != OK) {
+	}
+
+	TC_ASSERT_EQ("work_cancel", g_run_cnt, 1);
+	TC_ASSERT_EQ("work_cancel", g_run_order[0], 1);
+
+	sem_destroy(&g_wq_sem);
+	TC_SUCCESS_RESULT();
+}
+
+#if CONFIG_SCHED_LPNTHREADS > 1
+/**
+* @fn                   :wq_long_worker
+* @description          :Function for tc_wqueue_work_queue_long
+* @return               :void
+*/
+static void wq_long_worker(FAR void *arg)
+{
+	usleep(300 * USEC_PER_MSEC);
+	wq_order_worker(arg);
+}
+
+/**
+* @fn                   :tc_wqueue_work_queue_long
+* @brief                :this tc tests that long work does not delay short work
+* @scenario             :work 0 takes 300 ms and is queued with LPWORK_LONG, then work 1 is queued with
+*                        LPWORK and a 10 ms delay. Work 1 must complete first. With work queue accounting,
+*                        the run of work 0 must be charged to the long worker.
+* API's covered         :work_queue, work_getstats
+* Preconditions         :CONFIG_SCHED_LPNTHREADS > 1
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_wqueue_work_queue_long(void)
+{
+	int index;
+	int ret_chk;
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+	struct work_stats_s before;
+	struct work_stats_s after;
+	pid_t pid;
+
+	ret_chk = work_getstats(LPWORK, CONFIG_SCHED_LPNTHREADS - 1, &pid, &before);
+	TC_ASSERT_EQ("work_getstats", ret_chk, OK);
+#endif
+
+	memset(g_work, 0, sizeof(g_work));
+	g_run_cnt = 0;
+	sem_init(&g_wq_sem, 0, 0);
+
+	ret_chk = work_queue(LPWORK_LONG, &g_work[0], wq_long_worker, (void *)0, 0);
+	TC_ASSERT_EQ("work_queue", ret_chk, OK);
+	ret_chk = work_queue(LPWORK, &g_work[1], wq_order_worker, (void *)1, WQ_MSEC(10));
+	TC_ASSERT_EQ("work_queue", ret_chk, OK);
+
+	for (index = 0; index < 2; index++) {
+		while (sem_wait(&g_wq_sem) != OK) {
+		}
+	}
+
+	TC_ASSERT_EQ("work_queue", g_run_order[0], 1);
+	TC_ASSERT_EQ("work_queue", g_run_order[1], 0);
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+	ret_chk = work_getstats(LPWORK, CONFIG_SCHED_LPNTHREADS - 1, &pid, &after);
+	TC_ASSERT_EQ("work_getstats", ret_chk, OK);
+	TC_ASSERT_EQ("work_getstats", after.nrun - before.nrun, 1);
+	TC_ASSERT_EQ("work_getstats", after.maxrun >= MSEC2TICK(300), true);
+	ret_chk = work_getstats(LPWORK, CONFIG_SCHED_LPNTHREADS, &pid, &after);
+	TC_ASSERT_EQ("work_getstats", ret_chk, -EINVAL);
+#endif
+
+	sem_destroy(&g_wq_sem);
+	TC_SUCCESS_RESULT();
+}
+#endif
+
+/****************************************************************************
+ * Name: wqueue
+ ****************************************************************************/
+
+int wqueue_main(void)
+{
+	tc_wqueue_work_queue_deadline_order();
+	tc_wqueue_work_cancel();
+#if CONFIG_SCHED_LPNTHREADS > 1
+	tc_wqueue_work_queue_long();
+#endif
+
+	return 0;
+}
@@ -0,0 +1,1079 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * apps/examples/tls_benchmark/tls_benchmark_main.c
+ *
+ * Measures the cost of the os/net/tls primitives on the running build:
+ * throughput of the symmetric ciphers, hashes and DRBG, rate of the public
+ * key operations, and latency/heap peak of TLS and DTLS handshakes run
+ * between a client and a server connected by an in-memory loopback BIO.
+ *
+ * The same source builds natively on the host with Makefile.host
+ * (TLS_BENCHMARK_HOST is defined there).
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#ifdef TLS_BENCHMARK_HOST
+#include <malloc.h>
+#endif
+
+#include "tls/config.h"
+#include "tls/aes.h"
+#include "tls/gcm.h"
+#include "tls/sha1.h"
+#include "tls/sha256.h"
+#include "tls/sha512.h"
+#include "tls/md.h"
+#include "tls/ctr_drbg.h"
+#include "tls/bignum.h"
+#include "tls/rsa.h"
+#include "tls/ecp.h"
+#include "tls/ecdh.h"
+#include "tls/ecdsa.h"
+#include "tls/pk.h"
+#include "tls/certs.h"
+#include "tls/x509_crt.h"
+#include "tls/ssl.h"
+#include "tls/ssl_cache.h"
+#include "tls/ssl_ciphersuites.h"
+#include "tls/timing.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_TLS_BENCHMARK_DURATION
+#define CONFIG_EXAMPLES_TLS_BENCHMARK_DURATION 1000
+#endif
+
+#ifndef CONFIG_EXAMPLES_TLS_BENCHMARK_HANDSHAKES
+#define CONFIG_EXAMPLES_TLS_BENCHMARK_HANDSHAKES 3
+#endif
+
+#ifndef CONFIG_EXAMPLES_TLS_BENCHMARK_STACKSIZE
+#define CONFIG_EXAMPLES_TLS_BENCHMARK_STACKSIZE 51200
+#endif
+
+#ifdef TLS_BENCHMARK_HOST
+#define FAR
+typedef void *pthread_addr_t;
+#endif
+
+#define TLS_BENCHMARK_PRIORITY      100
+#define TLS_BENCHMARK_SCHED_POLICY  SCHED_RR
+
+#define BENCH_WINDOW_USEC   ((uint64_t)CONFIG_EXAMPLES_TLS_BENCHMARK_DURATION * 1000)
+#define BENCH_BLOCK_SIZE    1024		/* Bytes processed per symmetric call */
+
+/* Each direction of the loopback BIO must hold the largest flight that one
+ * side can emit before the peer gets a chance to drain it.
+ */
+
+#define BENCH_CHAN_SIZE     (8 * 1024)
+#define BENCH_MAX_STEPS     256
+
+#define BENCH_GROUP_CIPHER     (1 << 0)
+#define BENCH_GROUP_HASH       (1 << 1)
+#define BENCH_GROUP_DRBG       (1 << 2)
+#define BENCH_GROUP_PK         (1 << 3)
+#define BENCH_GROUP_HANDSHAKE  (1 << 4)
+#define BENCH_GROUP_ALL        0x1f
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef int (*bench_op_t)(void *arg);
+
+/* One direction of the in-memory loopback transport. In datagram mode every
+ * record is stored with a two byte length prefix so that recv() returns
+ * exactly one datagram, as a UDP socket would.
+ */
+
+struct bench_chan_s {
+	unsigned char data[BENCH_CHAN_SIZE];
+	size_t head;
+	size_t tail;
+	int datagram;
+};
+
+struct bench_peer_s {
+	struct bench_chan_s *tx;
+	struct bench_chan_s *rx;
+};
+
+struct bench_handshake_s {
+	const char *name;
+	int transport;
+	int ciphersuite;
+	const char *crt;
+	const size_t *crt_len;
+	const char *key;
+	const size_t *key_len;
+};
+
+struct bench_group_s {
+	const char *name;
+	int mask;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static unsigned char g_block[BENCH_BLOCK_SIZE];
+static mbedtls_ctr_drbg_context g_drbg;
+static uint32_t g_entropy_state = 0x2545f491;
+
+static const struct bench_group_s g_groups[] = {
+	{"cipher", BENCH_GROUP_CIPHER},
+	{"hash", BENCH_GROUP_HASH},
+	{"drbg", BENCH_GROUP_DRBG},
+	{"pk", BENCH_GROUP_PK},
+	{"handshake", BENCH_GROUP_HANDSHAKE},
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t bench_now_usec(void)
+{
+	struct timespec ts;
+
+#ifdef CLOCK_MONOTONIC
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+	clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static long bench_heap_used(void)
+{
+#if defined(TLS_BENCHMARK_HOST)
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+	struct mallinfo2 info = mallinfo2();
+#else
+	struct mallinfo info = mallinfo();
+#endif
+	return (long)info.uordblks;
+#elif defined(CONFIG_CAN_PASS_STRUCTS)
+	struct mallinfo info = mallinfo();
+	return (long)info.uordblks;
+#else
+	struct mallinfo info;
+	mallinfo(&info);
+	return (long)info.uordblks;
+#endif
+}
+
+/* The benchmark only needs a DRBG that runs at the real speed, not a secure
+ * one, so it is seeded from a fixed xorshift sequence. This also keeps the
+ * results independent of a hardware RNG being present.
+ */
+
+static int bench_entropy(void *data, unsigned char *output, size_t len)
+{
+	size_t i;
+
+	(void)data;
+	for (i = 0; i < len; i++) {
+		g_entropy_state ^= g_entropy_state << 13;
+		g_entropy_state ^= g_entropy_state >> 17;
+		g_entropy_state ^= g_entropy_state << 5;
+		output[i] = (unsigned char)g_entropy_state;
+	}
+
+	return 0;
+}
+
+/* Run op back-to-back for the measurement window. At least one call is
+ * always made so that very slow operations still produce a figure.
+ */
+
+static int bench_run(bench_op_t op, void *arg, uint32_t *count, uint64_t *usec)
+{
+	uint64_t start;
+	uint64_t elapsed;
+	uint32_t n = 0;
+	int ret;
+
+	start = bench_now_usec();
+	do {
+		ret = op(arg);
+		if (ret != 0) {
+			return ret;
+		}
+		n++;
+		elapsed = bench_now_usec() - start;
+	} while (elapsed < BENCH_WINDOW_USEC);
+
+	*count = n;
+	*usec = elapsed ? elapsed : 1;
+	return 0;
+}
+
+static void bench_throughput(const char *name, bench_op_t op, void *arg)
+{
+	uint32_t count;
+	uint64_t usec;
+	uint64_t centi;
+	int ret;
+
+	ret = bench_run(op, arg, &count, &usec);
+	if (ret != 0) {
+		printf("  %-24s : FAILED (-0x%04x)\n", name, -ret);
+		return;
+	}
+
+	/* Hundredths of MB/s, printed without floating point support */
+
+	centi = (uint64_t)count * BENCH_BLOCK_SIZE * 100 * 1000000 / usec / (1024 * 1024);
+	printf("  %-24s : %6lu.%02lu MB/s\n", name, (unsigned long)(centi / 100), (unsigned long)(centi % 100));
+}
+
+static void bench_rate(const char *name, bench_op_t op, void *arg)
+{
+	uint32_t count;
+	uint64_t usec;
+	uint64_t centi;
+	int ret;
+
+	ret = bench_run(op, arg, &count, &usec);
+	if (ret != 0) {
+		printf("  %-24s : FAILED (-0x%04x)\n", name, -ret);
+		return;
+	}
+
+	centi = (uint64_t)count * 100 * 1000000 / usec;
+	printf("  %-24s : %6lu.%02lu ops/s\n", name, (unsigned long)(centi / 100), (unsigned long)(centi % 100));
+}
+
+/****************************************************************************
+ * Symmetric primitives
+ ****************************************************************************/
+
+struct bench_aes_s {
+	mbedtls_aes_context aes;
+	unsigned char iv[16];
+	unsigned char stream[16];
+	size_t nc_off;
+};
+
+static int bench_aes_cbc(void *arg)
+{
+	struct bench_aes_s *ctx = arg;
+
+	return mbedtls_aes_crypt_cbc(&ctx->aes, MBEDTLS_AES_ENCRYPT, BENCH_BLOCK_SIZE, ctx->iv, g_block, g_block);
+}
+
+#if defined(MBEDTLS_CIPHER_MODE_CTR)
+static int bench_aes_ctr(void *arg)
+{
+	struct bench_aes_s *ctx = arg;
+
+	return mbedtls_aes_crypt_ctr(&ctx->aes, BENCH_BLOCK_SIZE, &ctx->nc_off, ctx->iv, ctx->stream, g_block, g_block);
+}
+#endif
+
+#if defined(MBEDTLS_GCM_C)
+static int bench_aes_gcm(void *arg)
+{
+	unsigned char iv[12] = { 0 };
+	unsigned char tag[16];
+
+	return mbedtls_gcm_crypt_and_tag((mbedtls_gcm_context *)arg, MBEDTLS_GCM_ENCRYPT, BENCH_BLOCK_SIZE, iv, sizeof(iv), NULL, 0, g_block, g_block, sizeof(tag), tag);
+}
+#endif
+
+static void bench_cipher(void)
+{
+	static const unsigned int keybits[] = { 128, 256 };
+	struct bench_aes_s ctx;
+	unsigned char key[32];
+	char name[32];
+	unsigned int i;
+
+	printf("Symmetric ciphers (%d byte blocks)\n", BENCH_BLOCK_SIZE);
+	bench_entropy(NULL, key, sizeof(key));
+
+	for (i = 0; i < sizeof(keybits) / sizeof(keybits[0]); i++) {
+		memset(&ctx, 0, sizeof(ctx));
+		mbedtls_aes_init(&ctx.aes);
+		mbedtls_aes_setkey_enc(&ctx.aes, key, keybits[i]);
+
+		snprintf(name, sizeof(name), "AES-%u-CBC", keybits[i]);
+		bench_throughput(name, bench_aes_cbc, &ctx);
+#if defined(MBEDTLS_CIPHER_MODE_CTR)
+		snprintf(name, sizeof(name), "AES-%u-CTR", keybits[i]);
+		bench_throughput(name, bench_aes_ctr, &ctx);
+#endif
+		mbedtls_aes_free(&ctx.aes);
+
+#if defined(MBEDTLS_GCM_C)
+		{
+			mbedtls_gcm_context gcm;
+
+			mbedtls_gcm_init(&gcm);
+			mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, key, keybits[i]);
+			snprintf(name, sizeof(name), "AES-%u-GCM", keybits[i]);
+			bench_throughput(name, bench_aes_gcm, &gcm);
+			mbedtls_gcm_free(&gcm);
+		}
+#endif
+	}
+}
+
+/****************************************************************************
+ * Hashes, HMAC and DRBG
+ ****************************************************************************/
+
+#if defined(MBEDTLS_SHA1_C)
+static int bench_sha1(void *arg)
+{
+	mbedtls_sha1_update((mbedtls_sha1_context *)arg, g_block, BENCH_BLOCK_SIZE);
+	return 0;
+}
+#endif
+
+#if defined(MBEDTLS_SHA256_C)
+static int bench_sha256(void *arg)
+{
+	mbedtls_sha256_update((mbedtls_sha256_context *)arg, g_block, BENCH_BLOCK_SIZE);
+	return 0;
+}
+
+static int bench_hmac(void *arg)
+{
+	return mbedtls_md_hmac_update((mbedtls_md_context_t *)arg, g_block, BENCH_BLOCK_SIZE);
+}
+#endif
+
+#if defined(MBEDTLS_SHA512_C)
+static int bench_sha512(void *arg)
+{
+	mbedtls_sha512_update((mbedtls_sha512_context *)arg, g_block, BENCH_BLOCK_SIZE);
+	return 0;
+}
+#endif
+
+static void bench_hash(void)
+{
+	printf("Hashes (%d byte updates)\n", BENCH_BLOCK_SIZE);
+
+#if defined(MBEDTLS_SHA1_C)
+	{
+		mbedtls_sha1_context sha1;
+
+		mbedtls_sha1_init(&sha1);
+		mbedtls_sha1_starts(&sha1);
+		bench_throughput("SHA-1", bench_sha1, &sha1);
+		mbedtls_sha1_free(&sha1);
+	}
+#endif
+
+#if defined(MBEDTLS_SHA256_C)
+	{
+		mbedtls_sha256_context sha256;
+		mbedtls_md_context_t md;
+		unsigned char key[32];
+
+		mbedtls_sha256_init(&sha256);
+		mbedtls_sha256_starts(&sha256, 0);
+		bench_throughput("SHA-256", bench_sha256, &sha256);
+		mbedtls_sha256_free(&sha256);
+
+		bench_entropy(NULL, key, sizeof(key));
+		mbedtls_md_init(&md);
+		if (mbedtls_md_setup(&md, mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), 1) == 0) {
+			mbedtls_md_hmac_starts(&md, key, sizeof(key));
+			bench_throughput("HMAC-SHA256", bench_hmac, &md);
+		}
+		mbedtls_md_free(&md);
+	}
+#endif
+
+#if defined(MBEDTLS_SHA512_C)
+	{
+		mbedtls_sha512_context sha512;
+
+		mbedtls_sha512_init(&sha512);
+		mbedtls_sha512_starts(&sha512, 0);
+		bench_throughput("SHA-512", bench_sha512, &sha512);
+		mbedtls_sha512_free(&sha512);
+	}
+#endif
+}
+
+static int bench_drbg_random(void *arg)
+{
+	return mbedtls_ctr_drbg_random(arg, g_block, BENCH_BLOCK_SIZE);
+}
+
+static void bench_drbg(void)
+{
+	printf("Random generator (%d byte requests)\n", BENCH_BLOCK_SIZE);
+	bench_throughput("CTR-DRBG", bench_drbg_random, &g_drbg);
+}
+
+/****************************************************************************
+ * Public key operations
+ ****************************************************************************/
+
+#if defined(MBEDTLS_RSA_C) && defined(MBEDTLS_PK_PARSE_C)
+struct bench_rsa_s {
+	mbedtls_rsa_context *rsa;
+	unsigned char in[512];
+	unsigned char out[512];
+};
+
+static int bench_rsa_public(void *arg)
+{
+	struct bench_rsa_s *ctx = arg;
+
+	return mbedtls_rsa_public(ctx->rsa, ctx->in, ctx->out);
+}
+
+static int bench_rsa_private(void *arg)
+{
+	struct bench_rsa_s *ctx = arg;
+
+	return mbedtls_rsa_private(ctx->rsa, mbedtls_ctr_drbg_random, &g_drbg, ctx->in, ctx->out);
+}
+
+struct bench_modexp_s {
+	mbedtls_mpi X;
+	mbedtls_mpi A;
+	mbedtls_mpi E;
+	mbedtls_mpi RR;
+	const mbedtls_mpi *N;
+};
+
+static int bench_modexp(void *arg)
+{
+	struct bench_modexp_s *ctx = arg;
+
+	return mbedtls_mpi_exp_mod(&ctx->X, &ctx->A, &ctx->E, ctx->N, &ctx->RR);
+}
+
+static void bench_rsa(void)
+{
+	mbedtls_pk_context pk;
+	struct bench_rsa_s *ctx;
+	struct bench_modexp_s mexp;
+	char name[32];
+	int ret;
+
+	ctx = (struct bench_rsa_s *)calloc(1, sizeof(struct bench_rsa_s));
+	if (ctx == NULL) {
+		printf("  RSA                      : out of memory\n");
+		return;
+	}
+
+	mbedtls_pk_init(&pk);
+	ret = mbedtls_pk_parse_key(&pk, (const unsigned char *)mbedtls_test_srv_key_rsa, mbedtls_test_srv_key_rsa_len, NULL, 0);
+	if (ret != 0 || mbedtls_pk_get_type(&pk) != MBEDTLS_PK_RSA) {
+		printf("  RSA                      : key parse FAILED (-0x%04x)\n", -ret);
+		goto out;
+	}
+
+	ctx->rsa = mbedtls_pk_rsa(pk);
+	bench_entropy(NULL, ctx->in, ctx->rsa->len);
+	ctx->in[0] = 0;				/* Keep the input below N */
+
+	snprintf(name, sizeof(name), "RSA-%d public", (int)(ctx->rsa->len * 8));
+	bench_rate(name, bench_rsa_public, ctx);
+	snprintf(name, sizeof(name), "RSA-%d private", (int)(ctx->rsa->len * 8));
+	bench_rate(name, bench_rsa_private, ctx);
+
+	/* Bare modular exponentiation with a full size exponent, the building
+	 * block of RSA and DHE, without CRT or blinding.
+	 */
+
+	mbedtls_mpi_init(&mexp.X);
+	mbedtls_mpi_init(&mexp.A);
+	mbedtls_mpi_init(&mexp.E);
+	mbedtls_mpi_init(&mexp.RR);
+	mexp.N = &ctx->rsa->N;
+	if (mbedtls_mpi_fill_random(&mexp.A, ctx->rsa->len - 1, mbedtls_ctr_drbg_random, &g_drbg) == 0 &&
+		mbedtls_mpi_fill_random(&mexp.E, ctx->rsa->len, mbedtls_ctr_drbg_random, &g_drbg) == 0) {
+		snprintf(name, sizeof(name), "bignum modexp %d", (int)(ctx->rsa->len * 8));
+		bench_rate(name, bench_modexp, &mexp);
+	}
+	mbedtls_mpi_free(&mexp.X);
+	mbedtls_mpi_free(&mexp.A);
+	mbedtls_mpi_free(&mexp.E);
+	mbedtls_mpi_free(&mexp.RR);
+
+out:
+	mbedtls_pk_free(&pk);
+	free(ctx);
+}
+#endif
+
+#if defined(MBEDTLS_ECDH_C) && defined(MBEDTLS_ECP_DP_SECP256R1_ENABLED)
+struct bench_ecdh_s {
+	mbedtls_ecp_group grp;
+	mbedtls_mpi d;
+	mbedtls_mpi z;
+	mbedtls_ecp_point Q;
+	mbedtls_ecp_point peer;
+};
+
+/* One ephemeral agreement: generate our key pair and derive the secret */
+
+static int bench_ecdhe(void *arg)
+{
+	struct bench_ecdh_s *ctx = arg;
+	int ret;
+
+	ret = mbedtls_ecdh_gen_public(&ctx->grp, &ctx->d, &ctx->Q, mbedtls_ctr_drbg_random, &g_drbg);
+	if (ret != 0) {
+		return ret;
+	}
+
+	return mbedtls_ecdh_compute_shared(&ctx->grp, &ctx->z, &ctx->peer, &ctx->d, mbedtls_ctr_drbg_random, &g_drbg);
+}
+
+static void bench_ecdh(void)
+{
+	struct bench_ecdh_s ctx;
+	int ret;
+
+	mbedtls_ecp_group_init(&ctx.grp);
+	mbedtls_mpi_init(&ctx.d);
+	mbedtls_mpi_init(&ctx.z);
+	mbedtls_ecp_point_init(&ctx.Q);
+	mbedtls_ecp_point_init(&ctx.peer);
+
+	ret = mbedtls_ecp_group_load(&ctx.grp, MBEDTLS_ECP_DP_SECP256R1);
+	if (ret == 0) {
+		ret = mbedtls_ecdh_gen_public(&ctx.grp, &ctx.d, &ctx.peer, mbedtls_ctr_drbg_random, &g_drbg);
+	}
+
+	if (ret == 0) {
+		bench_rate("ECDHE secp256r1", bench_ecdhe, &ctx);
+	} else {
+		printf("  %-24s : FAILED (-0x%04x)\n", "ECDHE secp256r1", -ret);
+	}
+
+	mbedtls_ecp_point_free(&ctx.peer);
+	mbedtls_ecp_point_free(&ctx.Q);
+	mbedtls_mpi_free(&ctx.z);
+	mbedtls_mpi_free(&ctx.d);
+	mbedtls_ecp_group_free(&ctx.grp);
+}
+#endif
+
+#if defined(MBEDTLS_ECDSA_C) && defined(MBEDTLS_ECP_DP_SECP256R1_ENABLED)
+struct bench_ecdsa_s {
+	mbedtls_ecdsa_context ecdsa;
+	unsigned char hash[32];
+	unsigned char sig[MBEDTLS_ECDSA_MAX_LEN];
+	size_t sig_len;
+};
+
+static int bench_ecdsa_sign(void *arg)
+{
+	struct bench_ecdsa_s *ctx = arg;
+
+	return mbedtls_ecdsa_write_signature(&ctx->ecdsa, MBEDTLS_MD_SHA256, ctx->hash, sizeof(ctx->hash), ctx->sig, &ctx->sig_len, mbedtls_ctr_drbg_random, &g_drbg);
+}
+
+static int bench_ecdsa_verify(void *arg)
+{
+	struct bench_ecdsa_s *ctx = arg;
+
+	return mbedtls_ecdsa_read_signature(&ctx->ecdsa, ctx->hash, sizeof(ctx->hash), ctx->sig, ctx->sig_len);
+}
+
+static void bench_ecdsa(void)
+{
+	struct bench_ecdsa_s *ctx;
+	int ret;
+
+	ctx = (struct bench_ecdsa_s *)calloc(1, sizeof(struct bench_ecdsa_s));
+	if (ctx == NULL) {
+		printf("  ECDSA                    : out of memory\n");
+		return;
+	}
+
+	mbedtls_ecdsa_init(&ctx->ecdsa);
+	bench_entropy(NULL, ctx->hash, sizeof(ctx->hash));
+
+	ret = mbedtls_ecdsa_genkey(&ctx->ecdsa, MBEDTLS_ECP_DP_SECP256R1, mbedtls_ctr_drbg_random, &g_drbg);
+	if (ret == 0) {
+		bench_rate("ECDSA secp256r1 sign", bench_ecdsa_sign, ctx);
+		bench_rate("ECDSA secp256r1 verify", bench_ecdsa_verify, ctx);
+	} else {
+		printf("  %-24s : FAILED (-0x%04x)\n", "ECDSA secp256r1", -ret);
+	}
+
+	mbedtls_ecdsa_free(&ctx->ecdsa);
+	free(ctx);
+}
+#endif
+
+static void bench_pk(void)
+{
+	printf("Public key operations\n");
+#if defined(MBEDTLS_RSA_C) && defined(MBEDTLS_PK_PARSE_C)
+	bench_rsa();
+#endif
+#if defined(MBEDTLS_ECDH_C) && defined(MBEDTLS_ECP_DP_SECP256R1_ENABLED)
+	bench_ecdh();
+#endif
+#if defined(MBEDTLS_ECDSA_C) && defined(MBEDTLS_ECP_DP_SECP256R1_ENABLED)
+	bench_ecdsa();
+#endif
+}
+
+/****************************************************************************
+ * Handshakes over the loopback BIO
+ ****************************************************************************/
+
+#if defined(MBEDTLS_SSL_CLI_C) && defined(MBEDTLS_SSL_SRV_C) && defined(MBEDTLS_X509_CRT_PARSE_C)
+static int bench_bio_send(void *arg, const unsigned char *buf, size_t len)
+{
+	struct bench_chan_s *chan = ((struct bench_peer_s *)arg)->tx;
+	size_t need = chan->datagram ? len + 2 : len;
+
+	if (chan->tail + need > BENCH_CHAN_SIZE) {
+		if (chan->datagram || chan->tail == BENCH_CHAN_SIZE) {
+			return MBEDTLS_ERR_SSL_WANT_WRITE;
+		}
+
+		len = BENCH_CHAN_SIZE - chan->tail;
+		need = len;
+	}
+
+	if (chan->datagram) {
+		chan->data[chan->tail++] = (unsigned char)(len >> 8);
+		chan->data[chan->tail++] = (unsigned char)len;
+	}
+
+	memcpy(&chan->data[chan->tail], buf, len);
+	chan->tail += len;
+	return (int)len;
+}
+
+static int bench_bio_recv(void *arg, unsigned char *buf, size_t len)
+{
+	struct bench_chan_s *chan = ((struct bench_peer_s *)arg)->rx;
+	size_t avail;
+
+	if (chan->head == chan->tail) {
+		return MBEDTLS_ERR_SSL_WANT_READ;
+	}
+
+	if (chan->datagram) {
+		avail = ((size_t)chan->data[chan->head] << 8) | chan->data[chan->head + 1];
+		chan->head += 2;
+		if (len > avail) {
+			len = avail;
+		}
+
+		/* Like UDP, the part of the datagram that does not fit is lost */
+
+		memcpy(buf, &chan->data[chan->head], len);
+		chan->head += avail;
+	} else {
+		avail = chan->tail - chan->head;
+		if (len > avail) {
+			len = avail;
+		}
+
+		memcpy(buf, &chan->data[chan->head], len);
+		chan->head += len;
+	}
+
+	if (chan->head == chan->tail) {
+		chan->head = 0;
+		chan->tail = 0;
+	}
+
+	return (int)len;
+}
+
+/* Step both endpoints in turn until both report the handshake as over.
+ * Heap usage is sampled after every step to find the peak.
+ */
+
+static int bench_handshake_run(mbedtls_ssl_context *cli, mbedtls_ssl_context *srv, long base, long *peak)
+{
+	int cli_ret = MBEDTLS_ERR_SSL_WANT_READ;
+	int srv_ret = MBEDTLS_ERR_SSL_WANT_READ;
+	int steps;
+	long used;
+
+	for (steps = 0; steps < BENCH_MAX_STEPS; steps++) {
+		if (cli->state != MBEDTLS_SSL_HANDSHAKE_OVER) {
+			cli_ret = mbedtls_ssl_handshake_step(cli);
+		}
+
+		used = bench_heap_used() - base;
+		if (used > *peak) {
+			*peak = used;
+		}
+
+		if (srv->state != MBEDTLS_SSL_HANDSHAKE_OVER) {
+			srv_ret = mbedtls_ssl_handshake_step(srv);
+		}
+
+		used = bench_heap_used() - base;
+		if (used > *peak) {
+			*peak = used;
+		}
+
+		if (cli_ret != 0 && cli_ret != MBEDTLS_ERR_SSL_WANT_READ && cli_ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+			return cli_ret;
+		}
+
+		if (srv_ret != 0 && srv_ret != MBEDTLS_ERR_SSL_WANT_READ && srv_ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+			return srv_ret;
+		}
+
+		if (cli->state == MBEDTLS_SSL_HANDSHAKE_OVER && srv->state == MBEDTLS_SSL_HANDSHAKE_OVER) {
+			return 0;
+		}
+	}
+
+	return MBEDTLS_ERR_SSL_TIMEOUT;
+}
+
+static void bench_handshake_one(const struct bench_handshake_s *hs)
+{
+	mbedtls_ssl_config cli_conf;
+	mbedtls_ssl_config srv_conf;
+	mbedtls_ssl_context cli;
+	mbedtls_ssl_context srv;
+	mbedtls_ssl_session session;
+	mbedtls_ssl_cache_context cache;
+	mbedtls_x509_crt crt;
+	mbedtls_pk_context key;
+#if defined(MBEDTLS_SSL_PROTO_DTLS) && defined(MBEDTLS_TIMING_C)
+	mbedtls_timing_delay_context cli_timer;
+	mbedtls_timing_delay_context srv_timer;
+#endif
+	struct bench_chan_s *chan;
+	struct bench_peer_s cli_peer;
+	struct bench_peer_s srv_peer;
+	int ciphersuites[2];
+	uint64_t start;
+	uint64_t full_usec = 0;
+	uint64_t resume_usec = 0;
+	long base;
+	long full_peak = 0;
+	long resume_peak = 0;
+	int i;
+	int ret;
+
+	chan = (struct bench_chan_s *)calloc(2, sizeof(struct bench_chan_s));
+	if (chan == NULL) {
+		printf("  %-24s : out of memory\n", hs->name);
+		return;
+	}
+
+	chan[0].datagram = chan[1].datagram = (hs->transport == MBEDTLS_SSL_TRANSPORT_DATAGRAM);
+	cli_peer.tx = &chan[0];
+	cli_peer.rx = &chan[1];
+	srv_peer.tx = &chan[1];
+	srv_peer.rx = &chan[0];
+
+	ciphersuites[0] = hs->ciphersuite;
+	ciphersuites[1] = 0;
+
+	mbedtls_ssl_config_init(&cli_conf);
+	mbedtls_ssl_config_init(&srv_conf);
+	mbedtls_ssl_init(&cli);
+	mbedtls_ssl_init(&srv);
+	mbedtls_ssl_session_init(&session);
+	mbedtls_ssl_cache_init(&cache);
+	mbedtls_x509_crt_init(&crt);
+	mbedtls_pk_init(&key);
+
+	ret = mbedtls_x509_crt_parse(&crt, (const unsigned char *)hs->crt, *hs->crt_len);
+	if (ret == 0) {
+		ret = mbedtls_pk_parse_key(&key, (const unsigned char *)hs->key, *hs->key_len, NULL, 0);
+	}
+
+	if (ret == 0) {
+		ret = mbedtls_ssl_config_defaults(&cli_conf, MBEDTLS_SSL_IS_CLIENT, hs->transport, MBEDTLS_SSL_PRESET_DEFAULT);
+	}
+
+	if (ret == 0) {
+		ret = mbedtls_ssl_config_defaults(&srv_conf, MBEDTLS_SSL_IS_SERVER, hs->transport, MBEDTLS_SSL_PRESET_DEFAULT);
+	}
+
+	if (ret != 0) {
+		goto out;
+	}
+
+	/* The test certificates may be outside of their validity period on a
+	 * board without RTC, so the chain is parsed but not enforced.
+	 */
+
+	mbedtls_ssl_conf_authmode(&cli_conf, MBEDTLS_SSL_VERIFY_OPTIONAL);
+	mbedtls_ssl_conf_ca_chain(&cli_conf, &crt, NULL);
+	mbedtls_ssl_conf_ciphersuites(&cli_conf, ciphersuites);
+	mbedtls_ssl_conf_rng(&cli_conf, mbedtls_ctr_drbg_random, &g_drbg);
+
+	mbedtls_ssl_conf_rng(&srv_conf, mbedtls_ctr_drbg_random, &g_drbg);
+	mbedtls_ssl_conf_session_cache(&srv_conf, &cache, mbedtls_ssl_cache_get, mbedtls_ssl_cache_set);
+	ret = mbedtls_ssl_conf_own_cert(&srv_conf, &crt, &key);
+	if (ret != 0) {
+		goto out;
+	}
+
+#if defined(MBEDTLS_SSL_PROTO_DTLS)
+	if (hs->transport == MBEDTLS_SSL_TRANSPORT_DATAGRAM) {
+		/* No loss on the loopback: avoid spurious retransmissions while a
+		 * slow public key operation runs, and skip the cookie exchange.
+		 */
+
+		mbedtls_ssl_conf_handshake_timeout(&cli_conf, 60000, 60000);
+		mbedtls_ssl_conf_handshake_timeout(&srv_conf, 60000, 60000);
+#if defined(MBEDTLS_SSL_DTLS_HELLO_VERIFY)
+		mbedtls_ssl_conf_dtls_cookies(&srv_conf, NULL, NULL, NULL);
+#endif
+	}
+#endif
+
+	base = bench_heap_used();
+
+	for (i = 0; i < CONFIG_EXAMPLES_TLS_BENCHMARK_HANDSHAKES * 2 && ret == 0; i++) {
+		int resume = (i & 1);
+		long peak = 0;
+
+		if ((ret = mbedtls_ssl_setup(&cli, &cli_conf)) != 0 || (ret = mbedtls_ssl_setup(&srv, &srv_conf)) != 0) {
+			break;
+		}
+
+		mbedtls_ssl_set_bio(&cli, &cli_peer, bench_bio_send, bench_bio_recv, NULL);
+		mbedtls_ssl_set_bio(&srv, &srv_peer, bench_bio_send, bench_bio_recv, NULL);
+#if defined(MBEDTLS_SSL_PROTO_DTLS) && defined(MBEDTLS_TIMING_C)
+		mbedtls_ssl_set_timer_cb(&cli, &cli_timer, mbedtls_timing_set_delay, mbedtls_timing_get_delay);
+		mbedtls_ssl_set_timer_cb(&srv, &srv_timer, mbedtls_timing_set_delay, mbedtls_timing_get_delay);
+#endif
+
+		if (resume) {
+			ret = mbedtls_ssl_set_session(&cli, &session);
+		}
+
+		start = bench_now_usec();
+		if (ret == 0) {
+			ret = bench_handshake_run(&cli, &srv, base, &peak);
+		}
+
+		if (resume) {
+			resume_usec += bench_now_usec() - start;
+			resume_peak = peak > resume_peak ? peak : resume_peak;
+		} else {
+			full_usec += bench_now_usec() - start;
+			full_peak = peak > full_peak ? peak : full_peak;
+			if (ret == 0) {
+				mbedtls_ssl_session_free(&session);
+				ret = mbedtls_ssl_get_session(&cli, &session);
+			}
+		}
+
+		mbedtls_ssl_free(&cli);
+		mbedtls_ssl_free(&srv);
+		mbedtls_ssl_init(&cli);
+		mbedtls_ssl_init(&srv);
+		chan[0].head = chan[0].tail = 0;
+		chan[1].head = chan[1].tail = 0;
+	}
+
+	if (ret == 0) {
+		full_usec /= CONFIG_EXAMPLES_TLS_BENCHMARK_HANDSHAKES;
+		resume_usec /= CONFIG_EXAMPLES_TLS_BENCHMARK_HANDSHAKES;
+		printf("  %-24s : full %5lu.%02lu ms, %6ld bytes peak | resumed %5lu.%02lu ms, %6ld bytes peak\n", hs->name,
+			   (unsigned long)(full_usec / 1000), (unsigned long)(full_usec % 1000 / 10), full_peak,
+			   (unsigned long)(resume_usec / 1000), (unsigned long)(resume_usec % 1000 / 10), resume_peak);
+	}
+
+out:
+	if (ret != 0) {
+		printf("  %-24s : FAILED (-0x%04x)\n", hs->name, -ret);
+	}
+
+	mbedtls_ssl_free(&cli);
+	mbedtls_ssl_free(&srv);
+	mbedtls_ssl_session_free(&session);
+	mbedtls_ssl_cache_free(&cache);
+	mbedtls_ssl_config_free(&cli_conf);
+	mbedtls_ssl_config_free(&srv_conf);
+	mbedtls_pk_free(&key);
+	mbedtls_x509_crt_free(&crt);
+	free(chan);
+}
+
+static void bench_handshake(void)
+{
+	static const struct bench_handshake_s handshakes[] = {
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED) && defined(MBEDTLS_GCM_C)
+		{"TLS ECDHE-ECDSA-GCM", MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256,
+		 mbedtls_test_srv_crt_ec, &mbedtls_test_srv_crt_ec_len, mbedtls_test_srv_key_ec, &mbedtls_test_srv_key_ec_len},
+#if defined(MBEDTLS_SSL_PROTO_DTLS)
+		{"DTLS ECDHE-ECDSA-GCM", MBEDTLS_SSL_TRANSPORT_DATAGRAM, MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256,
+		 mbedtls_test_srv_crt_ec, &mbedtls_test_srv_crt_ec_len, mbedtls_test_srv_key_ec, &mbedtls_test_srv_key_ec_len},
+#endif
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_RSA_ENABLED) && defined(MBEDTLS_GCM_C)
+		{"TLS RSA-GCM", MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_TLS_RSA_WITH_AES_128_GCM_SHA256,
+		 mbedtls_test_srv_crt_rsa, &mbedtls_test_srv_crt_rsa_len, mbedtls_test_srv_key_rsa, &mbedtls_test_srv_key_rsa_len},
+#if defined(MBEDTLS_SSL_PROTO_DTLS)
+		{"DTLS RSA-GCM", MBEDTLS_SSL_TRANSPORT_DATAGRAM, MBEDTLS_TLS_RSA_WITH_AES_128_GCM_SHA256,
+		 mbedtls_test_srv_crt_rsa, &mbedtls_test_srv_crt_rsa_len, mbedtls_test_srv_key_rsa, &mbedtls_test_srv_key_rsa_len},
+#endif
+#endif
+	};
+	unsigned int i;
+
+	printf("Handshakes over loopback (average of %d)\n", CONFIG_EXAMPLES_TLS_BENCHMARK_HANDSHAKES);
+	for (i = 0; i < sizeof(handshakes) / sizeof(handshakes[0]); i++) {
+		bench_handshake_one(&handshakes[i]);
+	}
+}
+#endif
+
+static pthread_addr_t tls_benchmark_cb(void *args)
+{
+	int groups = (int)(intptr_t)args;
+	int ret;
+
+	mbedtls_ctr_drbg_init(&g_drbg);
+	ret = mbedtls_ctr_drbg_seed(&g_drbg, bench_entropy, NULL, (const unsigned char *)"tls_benchmark", 13);
+	if (ret != 0) {
+		printf("tls_benchmark: ctr_drbg_seed failed -0x%04x\n", -ret);
+		return NULL;
+	}
+
+	memset(g_block, 0xa5, sizeof(g_block));
+
+	if (groups & BENCH_GROUP_CIPHER) {
+		bench_cipher();
+	}
+
+	if (groups & BENCH_GROUP_HASH) {
+		bench_hash();
+	}
+
+	if (groups & BENCH_GROUP_DRBG) {
+		bench_drbg();
+	}
+
+	if (groups & BENCH_GROUP_PK) {
+		bench_pk();
+	}
+
+#if defined(MBEDTLS_SSL_CLI_C) && defined(MBEDTLS_SSL_SRV_C) && defined(MBEDTLS_X509_CRT_PARSE_C)
+	if (groups & BENCH_GROUP_HANDSHAKE) {
+		bench_handshake();
+	}
+#endif
+
+	mbedtls_ctr_drbg_free(&g_drbg);
+	return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#if defined(CONFIG_BUILD_KERNEL) || defined(TLS_BENCHMARK_HOST)
+int main(int argc, FAR char *argv[])
+#else
+int tls_benchmark_main(int argc, char **argv)
+#endif
+{
+	pthread_t tid;
+	pthread_attr_t attr;
+#ifndef TLS_BENCHMARK_HOST
+	struct sched_param sparam;
+#endif
+	int groups = 0;
+	unsigned int j;
+	int i;
+	int r;
+
+	for (i = 1; i < argc; i++) {
+		for (j = 0; j < sizeof(g_groups) / sizeof(g_groups[0]); j++) {
+			if (strcmp(argv[i], g_groups[j].name) == 0) {
+				groups |= g_groups[j].mask;
+				break;
+			}
+		}
+
+		if (j == sizeof(g_groups) / sizeof(g_groups[0])) {
+			printf("Usage: %s [cipher|hash|drbg|pk|handshake ...]\n", argv[0]);
+			return -1;
+		}
+	}
+
+	if (groups == 0) {
+		groups = BENCH_GROUP_ALL;
+	}
+
+	/* Initialize the attribute variable */
+	if ((r = pthread_attr_init(&attr)) != 0) {
+		printf("%s: pthread_attr_init failed, status=%d\n", __func__, r);
+	}
+
+#ifndef TLS_BENCHMARK_HOST
+	/* 1. set a priority */
+	sparam.sched_priority = TLS_BENCHMARK_PRIORITY;
+	if ((r = pthread_attr_setschedparam(&attr, &sparam)) != 0) {
+		printf("%s: pthread_attr_setschedparam failed, status=%d\n", __func__, r);
+	}
+
+	if ((r = pthread_attr_setschedpolicy(&attr, TLS_BENCHMARK_SCHED_POLICY)) != 0) {
+		printf("%s: pthread_attr_setschedpolicy failed, status=%d\n", __func__, r);
+	}
+#endif
+
+	/* 2. set a stacksize */
+	if ((r = pthread_attr_setstacksize(&attr, CONFIG_EXAMPLES_TLS_BENCHMARK_STACKSIZE)) != 0) {
+		printf("%s: pthread_attr_setstacksize failed, status=%d\n", __func__, r);
+	}
+
+	/* 3. create pthread with entry function */
+	if ((r = pthread_create(&tid, &attr, tls_benchmark_cb, (void *)(intptr_t)groups)) != 0) {
+		printf("%s: pthread_create failed, status=%d\n", __func__, r);
+		return -1;
+	}
+
+	/* Wait for the threads to stop */
+	pthread_join(tid, NULL);
+
+	return 0;
+}
@@ -61,6 +61,8 @@ extern "C"
  * Included Files
  ****************************************************************************/
 
+#include <stddef.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -128,6 +130,22 @@ typedef struct cJSON_Hooks {
 	void (*free_fn)(void *ptr);
 } cJSON_Hooks;
 
+/* An arena hands out the nodes and strings of a parse from a caller's
+ * buffer and, once that is full, from heap blocks of 'grow' bytes.  All of
+ * them are freed at once by cJSON_ResetArena().  Set it up with
+ * cJSON_InitArena(); the fields are private.
+ */
+
+typedef struct cJSON_Arena {
+	char *buf;					/* Caller's buffer, used first */
+	size_t bufsize;
+	size_t grow;				/* Size of the heap blocks, 0 to never grow */
+	char *base;					/* Block being allocated from */
+	size_t size;
+	size_t used;
+	void *blocks;				/* Heap blocks, each linked to the previous */
+} cJSON_Arena;
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -142,6 +160,24 @@ void cJSON_InitHooks(cJSON_Hooks *hooks);
 
 cJSON *cJSON_Parse(const char *value);
 
+/* Set up an arena on 'buf' (may be NULL) that grows by heap blocks of
+ * 'grow' bytes (0 to fail when 'buf' is full), and free everything parsed
+ * into it.  cJSON_ResetArena() leaves the arena ready for the next parse.
+ */
+
+void cJSON_InitArena(cJSON_Arena *arena, void *buf, size_t size, size_t grow);
+void cJSON_ResetArena(cJSON_Arena *arena);
+
+/* Parse into an arena instead of one allocation per node and string.  The
+ * items must not be passed to cJSON_Delete() nor be given items from the
+ * heap; reset the arena when finished.  cJSON_ParseInSitu() also leaves
+ * the strings in 'value', unescaping them there, so the buffer is modified
+ * and must outlive the items.
+ */
+
+cJSON *cJSON_ParseArena(const char *value, cJSON_Arena *arena);
+cJSON *cJSON_ParseInSitu(char *value, cJSON_Arena *arena);
+
 /* Render a cJSON entity to text for transfer/storage. Free the char* when
  * finished.
  */
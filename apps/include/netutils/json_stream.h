@@ -0,0 +1,198 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * apps/include/netutils/json_stream.h
+ *
+ * Streaming JSON: a tokenizer that takes the input in chunks of any size
+ * and reports each token to a callback, and a writer that emits through
+ * a fixed buffer.  Neither allocates memory, so the memory used does not
+ * grow with the size of the document.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_INCLUDE_NETUTILS_JSON_STREAM_H
+#define __APPS_INCLUDE_NETUTILS_JSON_STREAM_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+// *INDENT-OFF*
+extern "C"
+{
+// *INDENT-ON*
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Deepest nesting of objects and arrays accepted by the tokenizer */
+
+#ifndef CONFIG_NETUTILS_JSON_STREAM_DEPTH
+#define CONFIG_NETUTILS_JSON_STREAM_DEPTH 32
+#endif
+
+/* Smallest token buffer of a tokenizer */
+
+#define JSON_STREAM_MINBUF 8
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Events reported by the tokenizer.  Keys, strings and numbers come with
+ * their text, unescaped and NUL terminated.  A string value longer than the
+ * token buffer comes as JSON_STRING_PART pieces followed by a JSON_STRING
+ * with the rest; a key or a number that long is an error.
+ */
+
+enum json_event_e {
+	JSON_OBJECT_BEGIN,
+	JSON_OBJECT_END,
+	JSON_ARRAY_BEGIN,
+	JSON_ARRAY_END,
+	JSON_KEY,
+	JSON_STRING,
+	JSON_STRING_PART,
+	JSON_NUMBER,
+	JSON_TRUE,
+	JSON_FALSE,
+	JSON_NULL
+};
+
+/* Called for each event.  'value' is NULL for the events without text.
+ * Return 0 to go on, or a negated errno to stop the tokenizer; that value
+ * is then returned by json_parser_feed().
+ */
+
+typedef int (*json_callback_t)(void *arg, int event, const char *value, size_t len);
+
+/* Takes the bytes of the writer buffer when it is full */
+
+typedef int (*json_flush_t)(void *arg, const char *data, size_t len);
+
+/* The state of a tokenizer.  The fields are private. */
+
+struct json_parser_s {
+	json_callback_t cb;
+	void *arg;
+	char *buf;					/* Token buffer */
+	size_t bufsize;
+	size_t len;					/* Bytes of the token in buf */
+	size_t offset;				/* Bytes of input taken so far */
+	int error;					/* Sticky error */
+	uint32_t ucs;				/* Code point of the \u escape being read */
+	uint16_t surrogate;			/* High surrogate waiting for its low half */
+	uint8_t state;
+	uint8_t iskey;				/* The string being read is a key */
+	uint8_t nhex;				/* Hex digits of the \u escape read so far */
+	uint8_t literal;			/* true, false or null being matched */
+	uint8_t litpos;
+	uint8_t depth;
+	uint32_t objects[(CONFIG_NETUTILS_JSON_STREAM_DEPTH + 31) / 32];	/* Bit set for an object level */
+};
+
+/* The state of a writer.  The fields are private. */
+
+struct json_writer_s {
+	json_flush_t flush;			/* NULL to write into buf only */
+	void *arg;
+	char *buf;
+	size_t size;
+	size_t len;					/* Bytes in buf */
+	size_t total;				/* Bytes written since json_writer_init() */
+	int error;					/* Sticky error */
+	int fd;						/* Descriptor of json_writer_init_fd() */
+	uint8_t depth;
+	uint8_t comma;				/* The next value needs a ',' before it */
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* Set up a tokenizer with a token buffer of at least JSON_STREAM_MINBUF
+ * bytes.  Returns 0 or -EINVAL.
+ */
+
+int json_parser_init(struct json_parser_s *p, char *buf, size_t size, json_callback_t cb, void *arg);
+
+/* Give the next 'len' bytes of the document to the tokenizer, which calls
+ * the callback for the tokens they complete.  Returns 0, -EINVAL for a
+ * syntax error, -E2BIG for a too deep nesting or a too long key or number,
+ * or the error returned by the callback.  Errors are sticky;
+ * json_parser_offset() tells where the input was rejected.
+ */
+
+int json_parser_feed(struct json_parser_s *p, const char *data, size_t len);
+
+/* Tell the tokenizer that the document ended.  Returns 0 if it was
+ * complete, or an error as json_parser_feed().
+ */
+
+int json_parser_finish(struct json_parser_s *p);
+
+/* Number of bytes of input taken by the tokenizer */
+
+size_t json_parser_offset(struct json_parser_s *p);
+
+/* Set up a writer.  json_writer_init() writes through 'flush' whenever
+ * 'buf' fills, or only into 'buf' when 'flush' is NULL.
+ * json_writer_init_fd() writes to a file or socket descriptor.
+ */
+
+void json_writer_init(struct json_writer_s *w, char *buf, size_t size, json_flush_t flush, void *arg);
+void json_writer_init_fd(struct json_writer_s *w, char *buf, size_t size, int fd);
+
+/* Write one token.  Commas and colons are added as needed.  Each returns 0
+ * or the first error of the writer: -ENOSPC when 'buf' of a writer without
+ * flush is full, or the error of the flush.  json_write_raw() writes a
+ * value already formatted, such as the text of a JSON_NUMBER.
+ */
+
+int json_write_object_begin(struct json_writer_s *w);
+int json_write_object_end(struct json_writer_s *w);
+int json_write_array_begin(struct json_writer_s *w);
+int json_write_array_end(struct json_writer_s *w);
+int json_write_key(struct json_writer_s *w, const char *key);
+int json_write_string(struct json_writer_s *w, const char *str);
+int json_write_stringn(struct json_writer_s *w, const char *str, size_t len);
+int json_write_int(struct json_writer_s *w, long value);
+int json_write_number(struct json_writer_s *w, double value);
+int json_write_bool(struct json_writer_s *w, int value);
+int json_write_null(struct json_writer_s *w);
+int json_write_raw(struct json_writer_s *w, const char *text, size_t len);
+
+/* Flush what is left of the document.  A writer without flush terminates
+ * 'buf' with a NUL.  Returns the length of the document, or an error: the
+ * writer's error, or -EINVAL if objects or arrays are still open.
+ */
+
+int json_writer_finish(struct json_writer_s *w);
+
+#ifdef __cplusplus
+// *INDENT-OFF*
+}
+// *INDENT-ON*
+#endif
+#endif							/* __APPS_INCLUDE_NETUTILS_JSON_STREAM_H */
@@ -59,6 +59,7 @@
 #include <limits.h>
 #include <ctype.h>
 #include <unistd.h>
+#include <stdint.h>
 
 #include <apps/netutils/cJSON.h>
 
@@ -66,6 +67,25 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Arena allocations are aligned for the double in cJSON.  A heap block of
+ * an arena starts with the link to the previous block.
+ */
+
+#define CJSON_ARENA_ALIGN   sizeof(double)
+#define CJSON_ARENA_ROUND(n) (((n) + CJSON_ARENA_ALIGN - 1) & ~(CJSON_ARENA_ALIGN - 1))
+#define CJSON_ARENA_HDRSIZE CJSON_ARENA_ROUND(sizeof(void *))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Where a parse takes its nodes and strings from */
+
+struct cjson_parser {
+	cJSON_Arena *arena;			/* Nodes and strings, or NULL for cJSON_malloc() */
+	int insitu;					/* Strings are unescaped in the input buffer */
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -81,11 +101,11 @@ static void (*cJSON_free)(void *ptr) = free;
  * Private Prototypes
  ****************************************************************************/
 
-static const char *parse_value(cJSON *item, const char *value);
+static const char *parse_value(struct cjson_parser *p, cJSON *item, const char *value);
 static char *print_value(cJSON *item, int depth, int fmt);
-static const char *parse_array(cJSON *item, const char *value);
+static const char *parse_array(struct cjson_parser *p, cJSON *item, const char *value);
 static char *print_array(cJSON *item, int depth, int fmt);
-static const char *parse_object(cJSON *item, const char *value);
+static const char *parse_object(struct cjson_parser *p, cJSON *item, const char *value);
 static char *print_object(cJSON *item, int depth, int fmt);
 
 /****************************************************************************
@@ -118,6 +138,58 @@ static cJSON *cJSON_New_Item(void)
 	return node;
 }
 
+/* Carve 'size' bytes out of an arena, adding a heap block when the arena
+ * is full and allowed to grow.
+ */
+
+static void *arena_alloc(cJSON_Arena *arena, size_t size)
+{
+	char *block;
+	size_t blksize;
+	void *mem;
+
+	size = CJSON_ARENA_ROUND(size);
+	if (size > arena->size - arena->used) {
+		if (arena->grow == 0) {
+			return 0;
+		}
+
+		blksize = size > arena->grow ? size : arena->grow;
+		block = (char *)cJSON_malloc(CJSON_ARENA_HDRSIZE + blksize);
+		if (!block) {
+			return 0;
+		}
+
+		*(void **)block = arena->blocks;
+		arena->blocks = block;
+		arena->base = block + CJSON_ARENA_HDRSIZE;
+		arena->size = blksize;
+		arena->used = 0;
+	}
+
+	mem = arena->base + arena->used;
+	arena->used += size;
+	return mem;
+}
+
+/* Constructor of the parsed nodes. */
+
+static cJSON *parser_new_item(struct cjson_parser *p)
+{
+	cJSON *node;
+
+	if (!p->arena) {
+		return cJSON_New_Item();
+	}
+
+	node = (cJSON *)arena_alloc(p->arena, sizeof(cJSON));
+	if (node) {
+		memset(node, 0, sizeof(cJSON));
+	}
+
+	return node;
+}
+
 static int cJSON_strcasecmp(const char *s1, const char *s2)
 {
 	if (!s1) {
@@ -237,9 +309,13 @@ static char *print_number(cJSON *item)
 	return str;
 }
 
-/* Parse the input text into an unescaped cstring, and populate item. */
+/* Parse the input text into an unescaped cstring, and populate item.  An
+ * in-situ parse unescapes the string over itself in the input: the result
+ * is never longer than the escaped text, and the closing quote leaves room
+ * for the terminator.
+ */
 
-static const char *parse_string(cJSON *item, const char *str)
+static const char *parse_string(struct cjson_parser *p, cJSON *item, const char *str)
 {
 	const char *ptr = str + 1;
 	char *ptr2;
@@ -255,19 +331,28 @@ static const char *parse_string(cJSON *item, const char *str)
 		return 0;
 	}
 
-	while (*ptr != '\"' && *ptr && ++len) {
-		/* Skip escaped quotes. */
+	if (p->insitu) {
+		out = (char *)ptr;
+	} else {
+		while (*ptr != '\"' && *ptr && ++len) {
+			/* Skip escaped quotes. */
 
-		if (*ptr++ == '\\') {
-			ptr++;
+			if (*ptr++ == '\\') {
+				ptr++;
+			}
 		}
-	}
 
-	/* This is how long we need for the string, roughly. */
+		/* This is how long we need for the string, roughly. */
 
-	out = (char *)cJSON_malloc(len + 1);
-	if (!out) {
-		return 0;
+		if (p->arena) {
+			out = (char *)arena_alloc(p->arena, len + 1);
+		} else {
+			out = (char *)cJSON_malloc(len + 1);
+		}
+
+		if (!out) {
+			return 0;
+		}
 	}
 
 	ptr = str + 1;
@@ -366,11 +451,13 @@ static const char *parse_string(cJSON *item, const char *str)
 		}
 	}
 
-	*ptr2 = 0;
+	/* Step over the closing quote before it may be overwritten */
+
 	if (*ptr == '\"') {
 		ptr++;
 	}
 
+	*ptr2 = 0;
 	item->valuestring = out;
 	item->type = cJSON_String;
 	return ptr;
@@ -477,7 +564,7 @@ static const char *skip(const char *in)
 
 /* Parser core - when encountering text, process appropriately. */
 
-static const char *parse_value(cJSON *item, const char *value)
+static const char *parse_value(struct cjson_parser *p, cJSON *item, const char *value)
 {
 	if (!value) {
 		/* Fail on null. */
@@ -502,7 +589,7 @@ static const char *parse_value(cJSON *item, const char *value)
 	}
 
 	if (*value == '\"') {
-		return parse_string(item, value);
+		return parse_string(p, item, value);
 	}
 
 	if (*value == '-' || (*value >= '0' && *value <= '9')) {
@@ -510,11 +597,11 @@ static const char *parse_value(cJSON *item, const char *value)
 	}
 
 	if (*value == '[') {
-		return parse_array(item, value);
+		return parse_array(p, item, value);
 	}
 
 	if (*value == '{') {
-		return parse_object(item, value);
+		return parse_object(p, item, value);
 	}
 
 	/* Failure. */
@@ -567,7 +654,7 @@ static char *print_value(cJSON *item, int depth, int fmt)
 
 /* Build an array from input text. */
 
-static const char *parse_array(cJSON *item, const char *value)
+static const char *parse_array(struct cjson_parser *p, cJSON *item, const char *value)
 {
 	cJSON *child;
 
@@ -586,7 +673,7 @@ static const char *parse_array(cJSON *item, const char *value)
 		return value + 1;
 	}
 
-	item->child = child = cJSON_New_Item();
+	item->child = child = parser_new_item(p);
 	if (!item->child) {
 		/* Memory fail */
 
@@ -595,14 +682,14 @@ static const char *parse_array(cJSON *item, const char *value)
 
 	/* Skip any spacing, get the value. */
 
-	value = skip(parse_value(child, skip(value)));
+	value = skip(parse_value(p, child, skip(value)));
 	if (!value) {
 		return 0;
 	}
 
 	while (*value == ',') {
 		cJSON *new_item;
-		if (!(new_item = cJSON_New_Item())) {
+		if (!(new_item = parser_new_item(p))) {
 			/* <emory fail */
 
 			return 0;
@@ -611,7 +698,7 @@ static const char *parse_array(cJSON *item, const char *value)
 		child->next = new_item;
 		new_item->prev = child;
 		child = new_item;
-		value = skip(parse_value(child, skip(value + 1)));
+		value = skip(parse_value(p, child, skip(value + 1)));
 		if (!value) {
 			/* Memory fail */
 
@@ -727,7 +814,7 @@ static char *print_array(cJSON *item, int depth, int fmt)
 
 /* Build an object from the text. */
 
-static const char *parse_object(cJSON *item, const char *value)
+static const char *parse_object(struct cjson_parser *p, cJSON *item, const char *value)
 {
 	cJSON *child;
 	if (*value != '{') {
@@ -745,12 +832,12 @@ static const char *parse_object(cJSON *item, const char *value)
 		return value + 1;
 	}
 
-	item->child = child = cJSON_New_Item();
+	item->child = child = parser_new_item(p);
 	if (!item->child) {
 		return 0;
 	}
 
-	value = skip(parse_string(child, skip(value)));
+	value = skip(parse_string(p, child, skip(value)));
 	if (!value) {
 		return 0;
 	}
@@ -764,14 +851,14 @@ static const char *parse_object(cJSON *item, const char *value)
 
 	/* Skip any spacing, get the value. */
 
-	value = skip(parse_value(child, skip(value + 1)));
+	value = skip(parse_value(p, child, skip(value + 1)));
 	if (!value) {
 		return 0;
 	}
 
 	while (*value == ',') {
 		cJSON *new_item;
-		if (!(new_item = cJSON_New_Item())) {
+		if (!(new_item = parser_new_item(p))) {
 			/* Memory fail */
 
 			return 0;
@@ -780,7 +867,7 @@ static const char *parse_object(cJSON *item, const char *value)
 		child->next = new_item;
 		new_item->prev = child;
 		child = new_item;
-		value = skip(parse_string(child, skip(value + 1)));
+		value = skip(parse_string(p, child, skip(value + 1)));
 		if (!value) {
 			return 0;
 		}
@@ -794,7 +881,7 @@ static const char *parse_object(cJSON *item, const char *value)
 
 		/* Skip any spacing, get the value. */
 
-		value = skip(parse_value(child, skip(value + 1)));
+		value = skip(parse_value(p, child, skip(value + 1)));
 		if (!value) {
 			return 0;
 		}
@@ -958,6 +1045,52 @@ static void suffix_object(cJSON *prev, cJSON *item)
 	item->prev = prev;
 }
 
+/* Parse a value into a new root taken from the parser.  On failure nodes
+ * from cJSON_malloc() are freed; those of an arena stay there until the
+ * arena is reset.
+ */
+
+static cJSON *parse_root(struct cjson_parser *p, const char *value, const char **return_parse_end, int require_null_terminated)
+{
+	const char *end;
+	cJSON *c = parser_new_item(p);
+
+	ep = 0;
+	if (!c) {
+		/* Memory fail */
+
+		return 0;
+	}
+
+	end = parse_value(p, c, skip(value));
+	if (!end) {
+		if (!p->arena) {
+			cJSON_Delete(c);
+		}
+
+		return 0;
+	}
+
+	/* if we require null-terminated JSON without appended garbage, skip and then check for a null terminator */
+	if (require_null_terminated) {
+		end = skip(end);
+		if (*end) {
+			if (!p->arena) {
+				cJSON_Delete(c);
+			}
+
+			ep = end;
+			return 0;
+		}
+	}
+
+	if (return_parse_end) {
+		*return_parse_end = end;
+	}
+
+	return c;
+}
+
 /* Utility for handling references. */
 
 static cJSON *create_reference(cJSON *item)
@@ -1025,56 +1158,92 @@ void cJSON_Delete(cJSON *c)
 
 cJSON *cJSON_ParseWithOpts(const char *value, const char **return_parse_end, int require_null_terminated)
 {
-	const char *end = 0;
+	struct cjson_parser p = { 0, 0 };
 
-	cJSON *c = cJSON_New_Item();
-	ep = 0;
-	if (!c) {
-		/* Memory fail */
+	return parse_root(&p, value, return_parse_end, require_null_terminated);
+}
 
-		return 0;
-	}
+/* Parse an object - create a new root, and populate. */
 
-	if (!parse_value(c, skip(value))) {
-		cJSON_Delete(c);
-		return 0;
+cJSON *cJSON_Parse(const char *value)
+{
+	struct cjson_parser p = { 0, 0 };
+
+	return parse_root(&p, value, 0, 0);
+}
+
+/* Set up an arena on a caller's buffer, a growing list of heap blocks, or
+ * both.
+ */
+
+void cJSON_InitArena(cJSON_Arena *arena, void *buf, size_t size, size_t grow)
+{
+	size_t pad = 0;
+
+	if (buf) {
+		pad = CJSON_ARENA_ROUND((uintptr_t)buf) - (uintptr_t)buf;
+	} else {
+		size = 0;
 	}
 
-	/* if we require null-terminated JSON without appended garbage, skip and then check for a null terminator */
-	if (require_null_terminated) {
-		end = skip(end);
-		if (*end) {
-			cJSON_Delete(c);
-			ep = end;
-			return 0;
-		}
+	if (pad > size) {
+		pad = size;
 	}
 
-	if (return_parse_end) {
-		*return_parse_end = end;
+	arena->buf = (char *)buf + pad;
+	arena->bufsize = size - pad;
+	arena->grow = grow;
+	arena->blocks = 0;
+	cJSON_ResetArena(arena);
+}
+
+/* Free the heap blocks of an arena, and with them every item parsed into
+ * it.  The caller's buffer is reused from its start.
+ */
+
+void cJSON_ResetArena(cJSON_Arena *arena)
+{
+	void *next;
+
+	while (arena->blocks) {
+		next = *(void **)arena->blocks;
+		cJSON_free(arena->blocks);
+		arena->blocks = next;
 	}
 
-	return c;
+	arena->base = arena->buf;
+	arena->size = arena->bufsize;
+	arena->used = 0;
 }
 
-/* Parse an object - create a new root, and populate. */
+/* Parse into an arena.  Strings are copied, so the input may go away. */
 
-cJSON *cJSON_Parse(const char *value)
+cJSON *cJSON_ParseArena(const char *value, cJSON_Arena *arena)
 {
-	cJSON *c = cJSON_New_Item();
-	ep = 0;
-	if (!c) {
-		/* Memory fail */
+	struct cjson_parser p;
 
+	if (!arena) {
 		return 0;
 	}
 
-	if (!parse_value(c, skip(value))) {
-		cJSON_Delete(c);
+	p.arena = arena;
+	p.insitu = 0;
+	return parse_root(&p, value, 0, 0);
+}
+
+/* Parse into an arena, leaving the strings in the input buffer. */
+
+cJSON *cJSON_ParseInSitu(char *value, cJSON_Arena *arena)
+{
+	struct cjson_parser p;
+
+	if (!arena) {
 		return 0;
 	}
 
-	return c;
+	p.arena = arena;
+	p.insitu = 1;
+	return parse_root(&p, value, 0, 0);
 }
 
 /* Render a cJSON item/entity/structure to text. */
@@ -0,0 +1,908 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * apps/netutils/json/json_stream.c
+ *
+ * The tokenizer is a state machine fed one byte at a time, so a token may
+ * be split anywhere between two chunks of input.  Only the text of the
+ * current key, string or number is kept, in the caller's token buffer;
+ * structure is tracked with one bit per nesting level.
+ *
+ * The writer keeps one flag per document instead of per level: a value
+ * written at any level needs a comma before the next one, and opening an
+ * object or an array clears it.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <math.h>
+
+#include <apps/netutils/json_stream.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define JSON_ISSPACE(c) ((c) == ' ' || (c) == '\t' || (c) == '\n' || (c) == '\r')
+#define JSON_ISDIGIT(c) ((c) >= '0' && (c) <= '9')
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* States of the tokenizer */
+
+enum json_state_e {
+	JSON_ST_VALUE,				/* A value is required */
+	JSON_ST_VALUE_OR_END,		/* After '[': a value or ']' */
+	JSON_ST_KEY,				/* After ',' in an object: a key is required */
+	JSON_ST_KEY_OR_END,			/* After '{': a key or '}' */
+	JSON_ST_COLON,				/* After a key */
+	JSON_ST_NEXT,				/* After a value: ',' or the end of its container */
+	JSON_ST_STRING,
+	JSON_ST_ESCAPE,				/* After '\' in a string */
+	JSON_ST_UNICODE,			/* In the hex digits of \u */
+	JSON_ST_NUMBER,
+	JSON_ST_LITERAL,			/* In true, false or null */
+	JSON_ST_DONE				/* The document is complete */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const char *const g_literals[] = { "true", "false", "null" };
+static const uint8_t g_literal_events[] = { JSON_TRUE, JSON_FALSE, JSON_NULL };
+
+static const char g_hexdigits[] = "0123456789abcdef";
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Report an event.  A callback may only stop the tokenizer with an error. */
+
+static int json_emit(struct json_parser_s *p, int event, const char *value, size_t len)
+{
+	int ret;
+
+	if (!p->cb) {
+		return 0;
+	}
+
+	ret = p->cb(p->arg, event, value, len);
+	if (ret > 0) {
+		ret = -ECANCELED;
+	}
+
+	return ret;
+}
+
+static int json_in_object(struct json_parser_s *p)
+{
+	unsigned int level = p->depth - 1;
+
+	return (p->objects[level / 32] >> (level % 32)) & 1;
+}
+
+/* A value is complete: go on with its container, or end the document */
+
+static int json_end_value(struct json_parser_s *p, int event, const char *value, size_t len)
+{
+	p->state = p->depth > 0 ? JSON_ST_NEXT : JSON_ST_DONE;
+	return json_emit(p, event, value, len);
+}
+
+static int json_open(struct json_parser_s *p, int isobject)
+{
+	unsigned int level = p->depth;
+
+	if (level >= CONFIG_NETUTILS_JSON_STREAM_DEPTH) {
+		return -E2BIG;
+	}
+
+	if (isobject) {
+		p->objects[level / 32] |= 1u << (level % 32);
+		p->state = JSON_ST_KEY_OR_END;
+	} else {
+		p->objects[level / 32] &= ~(1u << (level % 32));
+		p->state = JSON_ST_VALUE_OR_END;
+	}
+
+	p->depth++;
+	return json_emit(p, isobject ? JSON_OBJECT_BEGIN : JSON_ARRAY_BEGIN, NULL, 0);
+}
+
+static int json_close(struct json_parser_s *p, int isobject)
+{
+	if (p->depth == 0 || json_in_object(p) != isobject) {
+		return -EINVAL;
+	}
+
+	p->depth--;
+	return json_end_value(p, isobject ? JSON_OBJECT_END : JSON_ARRAY_END, NULL, 0);
+}
+
+/* Make room for 'n' more bytes of token text and its terminator.  Only a
+ * string value may be handed over in pieces.
+ */
+
+static int json_reserve(struct json_parser_s *p, size_t n)
+{
+	int ret;
+
+	if (p->len + n < p->bufsize) {
+		return 0;
+	}
+
+	if (p->state != JSON_ST_STRING || p->iskey) {
+		return -E2BIG;
+	}
+
+	p->buf[p->len] = '\0';
+	ret = json_emit(p, JSON_STRING_PART, p->buf, p->len);
+	p->len = 0;
+	return ret;
+}
+
+static int json_putc(struct json_parser_s *p, int c)
+{
+	int ret = json_reserve(p, 1);
+
+	if (ret == 0) {
+		p->buf[p->len++] = c;
+	}
+
+	return ret;
+}
+
+/* Add the code point of a \u escape as UTF-8, pairing surrogates */
+
+static int json_put_ucs(struct json_parser_s *p)
+{
+	uint32_t uc = p->ucs;
+	char utf8[4];
+	size_t n;
+	int ret;
+
+	if (uc >= 0xd800 && uc <= 0xdbff) {
+		if (p->surrogate) {
+			return -EINVAL;
+		}
+
+		p->surrogate = uc;
+		return 0;
+	}
+
+	if (uc >= 0xdc00 && uc <= 0xdfff) {
+		if (!p->surrogate) {
+			return -EINVAL;
+		}
+
+		uc = 0x10000 + ((uint32_t)(p->surrogate - 0xd800) << 10) + (uc - 0xdc00);
+		p->surrogate = 0;
+	} else if (p->surrogate) {
+		return -EINVAL;
+	}
+
+	if (uc < 0x80) {
+		utf8[0] = uc;
+		n = 1;
+	} else if (uc < 0x800) {
+		utf8[0] = 0xc0 | (uc >> 6);
+		utf8[1] = 0x80 | (uc & 0x3f);
+		n = 2;
+	} else if (uc < 0x10000) {
+		utf8[0] = 0xe0 | (uc >> 12);
+		utf8[1] = 0x80 | ((uc >> 6) & 0x3f);
+		utf8[2] = 0x80 | (uc & 0x3f);
+		n = 3;
+	} else {
+		utf8[0] = 0xf0 | (uc >> 18);
+		utf8[1] = 0x80 | ((uc >> 12) & 0x3f);
+		utf8[2] = 0x80 | ((uc >> 6) & 0x3f);
+		utf8[3] = 0x80 | (uc & 0x3f);
+		n = 4;
+	}
+
+	ret = json_reserve(p, n);
+	if (ret == 0) {
+		memcpy(p->buf + p->len, utf8, n);
+		p->len += n;
+	}
+
+	return ret;
+}
+
+static int json_end_string(struct json_parser_s *p)
+{
+	if (p->surrogate) {
+		return -EINVAL;
+	}
+
+	p->buf[p->len] = '\0';
+	if (p->iskey) {
+		p->state = JSON_ST_COLON;
+		return json_emit(p, JSON_KEY, p->buf, p->len);
+	}
+
+	return json_end_value(p, JSON_STRING, p->buf, p->len);
+}
+
+/* Check a number against -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)? */
+
+static int json_end_number(struct json_parser_s *p)
+{
+	const char *s = p->buf;
+	const char *end = p->buf + p->len;
+
+	if (s < end && *s == '-') {
+		s++;
+	}
+
+	if (s < end && *s == '0') {
+		s++;
+	} else if (s < end && JSON_ISDIGIT(*s)) {
+		while (s < end && JSON_ISDIGIT(*s)) {
+			s++;
+		}
+	} else {
+		return -EINVAL;
+	}
+
+	if (s < end && *s == '.') {
+		if (++s == end || !JSON_ISDIGIT(*s)) {
+			return -EINVAL;
+		}
+
+		while (s < end && JSON_ISDIGIT(*s)) {
+			s++;
+		}
+	}
+
+	if (s < end && (*s == 'e' || *s == 'E')) {
+		if (++s < end && (*s == '+' || *s == '-')) {
+			s++;
+		}
+
+		if (s == end || !JSON_ISDIGIT(*s)) {
+			return -EINVAL;
+		}
+
+		while (s < end && JSON_ISDIGIT(*s)) {
+			s++;
+		}
+	}
+
+	if (s != end) {
+		return -EINVAL;
+	}
+
+	p->buf[p->len] = '\0';
+	return json_end_value(p, JSON_NUMBER, p->buf, p->len);
+}
+
+static int json_begin_value(struct json_parser_s *p, int c)
+{
+	switch (c) {
+	case '{':
+		return json_open(p, 1);
+
+	case '[':
+		return json_open(p, 0);
+
+	case '"':
+		p->iskey = 0;
+		p->len = 0;
+		p->state = JSON_ST_STRING;
+		return 0;
+
+	case 't':
+	case 'f':
+	case 'n':
+		p->literal = c == 't' ? 0 : c == 'f' ? 1 : 2;
+		p->litpos = 1;
+		p->state = JSON_ST_LITERAL;
+		return 0;
+
+	default:
+		if (c == '-' || JSON_ISDIGIT(c)) {
+			p->len = 0;
+			p->state = JSON_ST_NUMBER;
+			return json_putc(p, c);
+		}
+
+		return -EINVAL;
+	}
+}
+
+static int json_hexval(int c)
+{
+	if (JSON_ISDIGIT(c)) {
+		return c - '0';
+	}
+
+	c |= 0x20;
+	if (c >= 'a' && c <= 'f') {
+		return c - 'a' + 10;
+	}
+
+	return -1;
+}
+
+/* Take one byte of input */
+
+static int json_parse_char(struct json_parser_s *p, int c)
+{
+	const char *literal;
+	int ret;
+	int v;
+
+	/* Bytes inside a token */
+
+	switch (p->state) {
+	case JSON_ST_STRING:
+		if (p->surrogate && c != '\\' && c != '"') {
+			return -EINVAL;
+		}
+
+		if (c == '"') {
+			return json_end_string(p);
+		}
+
+		if (c == '\\') {
+			p->state = JSON_ST_ESCAPE;
+			return 0;
+		}
+
+		if (c < 0x20) {
+			return -EINVAL;
+		}
+
+		return json_putc(p, c);
+
+	case JSON_ST_ESCAPE:
+		if (p->surrogate && c != 'u') {
+			return -EINVAL;
+		}
+
+		p->state = JSON_ST_STRING;
+		switch (c) {
+		case '"':
+		case '\\':
+		case '/':
+			return json_putc(p, c);
+
+		case 'b':
+			return json_putc(p, '\b');
+
+		case 'f':
+			return json_putc(p, '\f');
+
+		case 'n':
+			return json_putc(p, '\n');
+
+		case 'r':
+			return json_putc(p, '\r');
+
+		case 't':
+			return json_putc(p, '\t');
+
+		case 'u':
+			p->state = JSON_ST_UNICODE;
+			p->ucs = 0;
+			p->nhex = 0;
+			return 0;
+
+		default:
+			return -EINVAL;
+		}
+
+	case JSON_ST_UNICODE:
+		v = json_hexval(c);
+		if (v < 0) {
+			return -EINVAL;
+		}
+
+		p->ucs = (p->ucs << 4) | v;
+		if (++p->nhex < 4) {
+			return 0;
+		}
+
+		p->state = JSON_ST_STRING;
+		return json_put_ucs(p);
+
+	case JSON_ST_NUMBER:
+		if (JSON_ISDIGIT(c) || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+			return json_putc(p, c);
+		}
+
+		/* Any other byte ends the number and is taken below */
+
+		ret = json_end_number(p);
+		if (ret < 0) {
+			return ret;
+		}
+		break;
+
+	case JSON_ST_LITERAL:
+		literal = g_literals[p->literal];
+		if (c != literal[p->litpos]) {
+			return -EINVAL;
+		}
+
+		if (literal[++p->litpos] != '\0') {
+			return 0;
+		}
+
+		return json_end_value(p, g_literal_events[p->literal], NULL, 0);
+
+	default:
+		break;
+	}
+
+	/* Structure between the tokens */
+
+	if (JSON_ISSPACE(c)) {
+		return 0;
+	}
+
+	switch (p->state) {
+	case JSON_ST_VALUE_OR_END:
+		if (c == ']') {
+			return json_close(p, 0);
+		}
+
+		return json_begin_value(p, c);
+
+	case JSON_ST_VALUE:
+		return json_begin_value(p, c);
+
+	case JSON_ST_KEY_OR_END:
+		if (c == '}') {
+			return json_close(p, 1);
+		}
+
+		/* Fall through */
+
+	case JSON_ST_KEY:
+		if (c != '"') {
+			return -EINVAL;
+		}
+
+		p->iskey = 1;
+		p->len = 0;
+		p->state = JSON_ST_STRING;
+		return 0;
+
+	case JSON_ST_COLON:
+		if (c != ':') {
+			return -EINVAL;
+		}
+
+		p->state = JSON_ST_VALUE;
+		return 0;
+
+	case JSON_ST_NEXT:
+		if (c == ',') {
+			p->state = json_in_object(p) ? JSON_ST_KEY : JSON_ST_VALUE;
+			return 0;
+		}
+
+		if (c == '}' || c == ']') {
+			return json_close(p, c == '}');
+		}
+
+		return -EINVAL;
+
+	default:
+		/* Only white space may follow the document */
+
+		return -EINVAL;
+	}
+}
+
+/* Append bytes to the writer, flushing whenever its buffer is full.  A
+ * writer without flush keeps the last byte of its buffer for the NUL.
+ */
+
+static int json_wwrite(struct json_writer_s *w, const char *data, size_t len)
+{
+	size_t room;
+	size_t size;
+	int ret;
+
+	if (w->error) {
+		return w->error;
+	}
+
+	size = w->flush ? w->size : w->size - 1;
+	while (len > 0) {
+		room = size - w->len;
+		if (room == 0) {
+			if (!w->flush) {
+				w->error = -ENOSPC;
+				return w->error;
+			}
+
+			ret = w->flush(w->arg, w->buf, w->len);
+			if (ret < 0) {
+				w->error = ret;
+				return ret;
+			}
+
+			w->len = 0;
+			room = size;
+		}
+
+		if (room > len) {
+			room = len;
+		}
+
+		memcpy(w->buf + w->len, data, room);
+		w->len += room;
+		w->total += room;
+		data += room;
+		len -= room;
+	}
+
+	return 0;
+}
+
+/* Start a value, with the comma that separates it from the previous one */
+
+static int json_wvalue(struct json_writer_s *w)
+{
+	if (w->comma) {
+		w->comma = 0;
+		return json_wwrite(w, ",", 1);
+	}
+
+	return w->error;
+}
+
+static int json_wbegin(struct json_writer_s *w, const char *bracket)
+{
+	if (json_wvalue(w) < 0 || json_wwrite(w, bracket, 1) < 0) {
+		return w->error;
+	}
+
+	if (w->depth == UINT8_MAX) {
+		w->error = -E2BIG;
+		return w->error;
+	}
+
+	w->depth++;
+	return 0;
+}
+
+static int json_wend(struct json_writer_s *w, const char *bracket)
+{
+	if (w->depth == 0) {
+		if (w->error == 0) {
+			w->error = -EINVAL;
+		}
+
+		return w->error;
+	}
+
+	w->depth--;
+	w->comma = 1;
+	return json_wwrite(w, bracket, 1);
+}
+
+/* Write a string with quotes, escaping what JSON requires */
+
+static int json_wquoted(struct json_writer_s *w, const char *str, size_t len)
+{
+	const char *run = str;
+	const char *end = str + len;
+	char esc[6];
+	size_t n;
+
+	json_wwrite(w, "\"", 1);
+	for (; str < end; str++) {
+		unsigned char c = *str;
+
+		if (c >= 0x20 && c != '"' && c != '\\') {
+			continue;
+		}
+
+		json_wwrite(w, run, str - run);
+		run = str + 1;
+
+		esc[0] = '\\';
+		n = 2;
+		switch (c) {
+		case '"':
+		case '\\':
+			esc[1] = c;
+			break;
+
+		case '\b':
+			esc[1] = 'b';
+			break;
+
+		case '\f':
+			esc[1] = 'f';
+			break;
+
+		case '\n':
+			esc[1] = 'n';
+			break;
+
+		case '\r':
+			esc[1] = 'r';
+			break;
+
+		case '\t':
+			esc[1] = 't';
+			break;
+
+		default:
+			esc[1] = 'u';
+			esc[2] = '0';
+			esc[3] = '0';
+			esc[4] = g_hexdigits[c >> 4];
+			esc[5] = g_hexdigits[c & 15];
+			n = 6;
+			break;
+		}
+
+		json_wwrite(w, esc, n);
+	}
+
+	json_wwrite(w, run, end - run);
+	return json_wwrite(w, "\"", 1);
+}
+
+static int json_flush_fd(void *arg, const char *data, size_t len)
+{
+	struct json_writer_s *w = (struct json_writer_s *)arg;
+	ssize_t nwritten;
+
+	while (len > 0) {
+		nwritten = write(w->fd, data, len);
+		if (nwritten < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			return -errno;
+		}
+
+		data += nwritten;
+		len -= nwritten;
+	}
+
+	return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int json_parser_init(struct json_parser_s *p, char *buf, size_t size, json_callback_t cb, void *arg)
+{
+	if (!buf || size < JSON_STREAM_MINBUF) {
+		return -EINVAL;
+	}
+
+	memset(p, 0, sizeof(struct json_parser_s));
+	p->cb = cb;
+	p->arg = arg;
+	p->buf = buf;
+	p->bufsize = size;
+	p->state = JSON_ST_VALUE;
+	return 0;
+}
+
+int json_parser_feed(struct json_parser_s *p, const char *data, size_t len)
+{
+	size_t i;
+	int ret;
+
+	if (p->error) {
+		return p->error;
+	}
+
+	for (i = 0; i < len; i++) {
+		ret = json_parse_char(p, (unsigned char)data[i]);
+		if (ret < 0) {
+			p->error = ret;
+			return ret;
+		}
+
+		p->offset++;
+	}
+
+	return 0;
+}
+
+int json_parser_finish(struct json_parser_s *p)
+{
+	int ret;
+
+	if (p->error) {
+		return p->error;
+	}
+
+	/* Nothing follows a number at the top level to end it */
+
+	if (p->state == JSON_ST_NUMBER && p->depth == 0) {
+		ret = json_end_number(p);
+		if (ret < 0) {
+			p->error = ret;
+			return ret;
+		}
+	}
+
+	if (p->state != JSON_ST_DONE) {
+		p->error = -EINVAL;
+	}
+
+	return p->error;
+}
+
+size_t json_parser_offset(struct json_parser_s *p)
+{
+	return p->offset;
+}
+
+void json_writer_init(struct json_writer_s *w, char *buf, size_t size, json_flush_t flush, void *arg)
+{
+	memset(w, 0, sizeof(struct json_writer_s));
+	w->flush = flush;
+	w->arg = arg;
+	w->buf = buf;
+	w->size = size;
+	w->fd = -1;
+
+	if (!buf || size == 0) {
+		w->error = -EINVAL;
+	}
+}
+
+void json_writer_init_fd(struct json_writer_s *w, char *buf, size_t size, int fd)
+{
+	json_writer_init(w, buf, size, json_flush_fd, w);
+	w->fd = fd;
+}
+
+int json_write_object_begin(struct json_writer_s *w)
+{
+	return json_wbegin(w, "{");
+}
+
+int json_write_object_end(struct json_writer_s *w)
+{
+	return json_wend(w, "}");
+}
+
+int json_write_array_begin(struct json_writer_s *w)
+{
+	return json_wbegin(w, "[");
+}
+
+int json_write_array_end(struct json_writer_s *w)
+{
+	return json_wend(w, "]");
+}
+
+int json_write_key(struct json_writer_s *w, const char *key)
+{
+	json_wvalue(w);
+	json_wquoted(w, key, strlen(key));
+	return json_wwrite(w, ":", 1);
+}
+
+int json_write_string(struct json_writer_s *w, const char *str)
+{
+	return json_write_stringn(w, str, strlen(str));
+}
+
+int json_write_stringn(struct json_writer_s *w, const char *str, size_t len)
+{
+	json_wvalue(w);
+	w->comma = 1;
+	return json_wquoted(w, str, len);
+}
+
+int json_write_int(struct json_writer_s *w, long value)
+{
+	char text[24];
+
+	return json_write_raw(w, text, snprintf(text, sizeof(text), "%ld", value));
+}
+
+/* Use the shortest of 15 or 17 significant digits that reads back as the
+ * same double.  JSON has no infinities nor NaN; they are written as null.
+ */
+
+int json_write_number(struct json_writer_s *w, double value)
+{
+	char text[32];
+	int len;
+
+	if (isnan(value) || isinf(value)) {
+		return json_write_null(w);
+	}
+
+	len = snprintf(text, sizeof(text), "%.15g", value);
+	if (strtod(text, NULL) != value) {
+		len = snprintf(text, sizeof(text), "%.17g", value);
+	}
+
+	return json_write_raw(w, text, len);
+}
+
+int json_write_bool(struct json_writer_s *w, int value)
+{
+	return value ? json_write_raw(w, "true", 4) : json_write_raw(w, "false", 5);
+}
+
+int json_write_null(struct json_writer_s *w)
+{
+	return json_write_raw(w, "null", 4);
+}
+
+int json_write_raw(struct json_writer_s *w, const char *text, size_t len)
+{
+	json_wvalue(w);
+	w->comma = 1;
+	return json_wwrite(w, text, len);
+}
+
+int json_writer_finish(struct json_writer_s *w)
+{
+	int ret;
+
+	if (w->error) {
+		return w->error;
+	}
+
+	if (w->depth != 0) {
+		w->error = -EINVAL;
+		return w->error;
+	}
+
+	if (w->flush) {
+		if (w->len > 0) {
+			ret = w->flush(w->arg, w->buf, w->len);
+			if (ret < 0) {
+				w->error = ret;
+				return ret;
+			}
+
+			w->len = 0;
+		}
+	} else {
+		w->buf[w->len] = '\0';
+	}
+
+	return (int)w->total;
+}
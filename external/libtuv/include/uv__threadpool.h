@@ -41,7 +41,7 @@
 extern "C" {
 #endif
 
-void uv__work_submit(uv_loop_t *loop, struct uv__work *w, void (*work)(struct uv__work *w), void (*done)(struct uv__work *w, int status));
+void uv__work_submit(uv_loop_t *loop, struct uv__work *w, enum uv__work_kind kind, void (*work)(struct uv__work *w), void (*done)(struct uv__work *w, int status));
 
 void uv__work_done(uv_async_t *handle);
 
@@ -59,6 +59,27 @@ int uv_queue_work(uv_loop_t *loop, uv_work_t *req, uv_work_cb work_cb, uv_after_
 
 int uv_cancel(uv_req_t *req);
 
+/*
+ * The threadpool has a queue for CPU work (uv_queue_work()) and one for
+ * requests that block on storage or the network (uv_fs_*() and
+ * uv_getaddrinfo()), each with its own workers.
+ */
+#define UV_THREADPOOL_CPU     0
+#define UV_THREADPOOL_IO      1
+#define UV_THREADPOOL_NQUEUES 2
+
+typedef struct uv_threadpool_stats_s {
+	unsigned int nthreads;		/* workers of the queue */
+	unsigned int queued;		/* requests waiting for a worker now */
+	unsigned int max_queued;	/* most requests ever waiting at once */
+	unsigned long submitted;	/* requests posted to the queue */
+	unsigned long started;		/* requests taken by a worker */
+	unsigned long cancelled;	/* requests cancelled before they started */
+	uint64_t max_wait;			/* longest wait for a worker, in nanoseconds */
+} uv_threadpool_stats_t;
+
+int uv_threadpool_stats(int queue, uv_threadpool_stats_t *stats);
+
 /*
  * for embed systems that need cleanup before exit
  */
@@ -135,11 +135,21 @@ typedef struct {
 //-----------------------------------------------------------------------------
 // uv__work
 
+/* CPU work has one queue; slow I/O that blocks on storage or the network
+ * has a queue and threads of its own.
+ */
+enum uv__work_kind {
+	UV__WORK_CPU,
+	UV__WORK_SLOW_IO
+};
+
 struct uv__work {
 	void (*work)(struct uv__work *w);
 	void (*done)(struct uv__work *w, int status);
 	struct uv_loop_s *loop;
 	void *wq[2];
+	unsigned int queue;			/* index of the queue the work is posted to */
+	uint64_t time;				/* uv__hrtime() when it was posted */
 };
 
 //-----------------------------------------------------------------------------
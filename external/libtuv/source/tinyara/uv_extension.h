@@ -43,10 +43,17 @@
 // structure extension for nuttx
 //
 
+#ifdef CONFIG_FS_EPOLL
+#define UV_PLATFORM_LOOP_FIELDS                                               \
+  struct epoll_event *pevents;                                                \
+  int npevents;                                                               \
+ 
+#else
 #define UV_PLATFORM_LOOP_FIELDS                                               \
   struct pollfd pollfds[TUV_POLL_EVENTS_SIZE];                                \
   int npollfds;                                                               \
  
+#endif
 
 #ifndef UV_STREAM_PRIVATE_PLATFORM_FIELDS
 #define UV_STREAM_PRIVATE_PLATFORM_FIELDS	/* empty */
@@ -39,6 +39,7 @@
 
 #include <pthread.h>
 #include <poll.h>				// nuttx poll // kbuild
+#include <sys/epoll.h>
 #include <unistd.h>
 #include <errno.h>
 
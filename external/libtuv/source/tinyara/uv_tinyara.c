@@ -41,6 +41,27 @@
 
 //-----------------------------------------------------------------------------
 
+#ifdef CONFIG_FS_EPOLL
+void uv__platform_invalidate_fd(uv_loop_t *loop, int fd)
+{
+	struct epoll_event dummy;
+	int i;
+
+	/* Skip the events of 'fd' still to be dispatched by uv__io_poll() */
+
+	for (i = 0; i < loop->npevents; ++i) {
+		if (loop->pevents[i].data.fd == fd) {
+			loop->pevents[i].data.fd = -1;
+		}
+	}
+
+	/* The descriptor must leave the interest set before it is closed */
+
+	if (loop->backend_fd >= 0) {
+		epoll_ctl(loop->backend_fd, EPOLL_CTL_DEL, fd, &dummy);
+	}
+}
+#else
 void uv__platform_invalidate_fd(uv_loop_t *loop, int fd)
 {
 	int i;
@@ -52,6 +73,7 @@ void uv__platform_invalidate_fd(uv_loop_t *loop, int fd)
 		}
 	}
 }
+#endif
 
 int uv__nonblock(int fd, int set)
 {
@@ -43,6 +43,162 @@
 
 #include <uv.h>
 
+#ifdef CONFIG_FS_EPOLL
+
+/* The descriptors stay registered in the epoll interest set of the loop
+ * (loop->backend_fd) while they are watched, so a turn of the loop costs
+ * in proportion to the descriptors with events, not to all of them.
+ */
+
+void uv__io_poll(uv_loop_t *loop, int timeout)
+{
+	struct epoll_event events[TUV_POLL_EVENTS_SIZE];
+	struct epoll_event *pe;
+	struct epoll_event e;
+	QUEUE *q;
+	uv__io_t *w;
+	uint64_t base;
+	uint64_t diff;
+	int nevents;
+	int count;
+	int nfds;
+	int fd;
+	int op;
+	int i;
+
+	if (loop->nfds == 0) {
+		assert(QUEUE_EMPTY(&loop->watcher_queue));
+		return;
+	}
+
+	while (!QUEUE_EMPTY(&loop->watcher_queue)) {
+		q = QUEUE_HEAD(&loop->watcher_queue);
+		QUEUE_REMOVE(q);
+		QUEUE_INIT(q);
+
+		w = QUEUE_DATA(q, uv__io_t, watcher_queue);
+		assert(w->pevents != 0);
+		assert(w->fd >= 0);
+		assert(w->fd < (int)loop->nwatchers);
+
+		e.events = w->pevents;
+		e.data.fd = w->fd;
+
+		op = w->events == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+		if (epoll_ctl(loop->backend_fd, op, w->fd, &e) != 0) {
+			/* A descriptor that was stopped without being closed is still
+			 * in the interest set.
+			 */
+
+			if (get_errno() != EEXIST || epoll_ctl(loop->backend_fd, EPOLL_CTL_MOD, w->fd, &e) != 0) {
+				TDLOG("uv__io_poll epoll_ctl fd(%d) errno(%d)", w->fd, get_errno());
+				ABORT();
+			}
+		}
+
+		w->events = w->pevents;
+	}
+
+	assert(timeout >= -1);
+	base = loop->time;
+	count = 5;
+
+	for (;;) {
+		nfds = epoll_wait(loop->backend_fd, events, TUV_POLL_EVENTS_SIZE, timeout);
+
+		SAVE_ERRNO(uv__update_time(loop));
+
+		if (nfds == 0) {
+			assert(timeout != -1);
+			return;
+		}
+
+		if (nfds == -1) {
+			if (get_errno() != EINTR) {
+				TDLOG("uv__io_poll abort for errno(%d)", get_errno());
+				ABORT();
+			}
+			if (timeout == -1) {
+				continue;
+			}
+			if (timeout == 0) {
+				return;
+			}
+			goto update_timeout;
+		}
+
+		/* uv__platform_invalidate_fd() marks the events of descriptors
+		 * that a callback closes.
+		 */
+
+		loop->pevents = events;
+		loop->npevents = nfds;
+		nevents = 0;
+
+		for (i = 0; i < nfds; ++i) {
+			pe = &events[i];
+			fd = pe->data.fd;
+
+			if (fd == -1) {
+				continue;
+			}
+
+			assert(fd >= 0);
+			assert((unsigned)fd < loop->nwatchers);
+
+			w = loop->watchers[fd];
+			if (w == NULL) {
+				/* No longer watched: stop the events */
+
+				epoll_ctl(loop->backend_fd, EPOLL_CTL_DEL, fd, pe);
+				continue;
+			}
+
+			pe->events &= w->pevents | UV__POLLERR | UV__POLLHUP;
+
+			/* Let the watcher find the error with its read or write */
+
+			if (pe->events & (UV__POLLERR | UV__POLLHUP)) {
+				pe->events |= w->pevents & (UV__POLLIN | UV__POLLOUT);
+			}
+
+			if (pe->events != 0) {
+				w->cb(loop, w, pe->events);
+				++nevents;
+			}
+		}
+
+		loop->pevents = NULL;
+		loop->npevents = 0;
+
+		if (nevents != 0) {
+			if (nfds == TUV_POLL_EVENTS_SIZE && --count != 0) {
+				/* Poll for more events but don't block this time */
+
+				timeout = 0;
+				continue;
+			}
+			return;
+		}
+		if (timeout == 0) {
+			return;
+		}
+		if (timeout == -1) {
+			continue;
+		}
+update_timeout:
+		assert(timeout > 0);
+
+		diff = loop->time - base;
+		if (diff >= (uint64_t) timeout) {
+			return;
+		}
+		timeout -= diff;
+	}
+}
+
+#else							/* CONFIG_FS_EPOLL */
+
 static void uv__add_pollfd(uv_loop_t *loop, struct pollfd *pe)
 {
 	int i;
@@ -223,3 +379,5 @@ update_timeout:
 		timeout -= diff;
 	}
 }
+
+#endif							/* CONFIG_FS_EPOLL */
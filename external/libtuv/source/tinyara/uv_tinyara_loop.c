@@ -38,11 +38,26 @@
 
 int uv__platform_loop_init(uv_loop_t *loop)
 {
+#ifdef CONFIG_FS_EPOLL
+	loop->pevents = NULL;
+	loop->npevents = 0;
+	loop->backend_fd = epoll_create1(0);
+	if (loop->backend_fd == -1) {
+		return -get_errno();
+	}
+#else
 	loop->npollfds = 0;
+#endif
 	return 0;
 }
 
 void uv__platform_loop_delete(uv_loop_t *loop)
 {
+#ifdef CONFIG_FS_EPOLL
+	/* uv_loop_close() closes loop->backend_fd */
+
+	loop->npevents = 0;
+#else
 	loop->npollfds = 0;
+#endif
 }
@@ -36,20 +36,39 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <uv.h>
 
 //-----------------------------------------------------------------------------
-#define MAX_THREADPOOL_SIZE 4
+// Work goes to one of two queues, each with its own lock, condition and
+// workers.  CPU work and fast I/O run on the first; uv_fs_*() and
+// uv_getaddrinfo() block on flash or the network and run on the second,
+// so a slow write can never hold up the work queued behind it.
+
+#ifndef CONFIG_LIBTUV_THREADPOOL_CPU_THREADS
+#define CONFIG_LIBTUV_THREADPOOL_CPU_THREADS 1
+#endif
+
+#ifndef CONFIG_LIBTUV_THREADPOOL_IO_THREADS
+#define CONFIG_LIBTUV_THREADPOOL_IO_THREADS 1
+#endif
+
+struct uv__workq {
+	uv_mutex_t mutex;
+	uv_cond_t cond;
+	QUEUE wq;
+	uv_thread_t *threads;
+	unsigned int nthreads;
+	unsigned int idle;			/* workers waiting on cond */
+	int exiting;
+	uv_threadpool_stats_t stats;
+};
 
 static uv_once_t _once = UV_ONCE_INIT;
-static uv_cond_t _cond;
-static uv_mutex_t _mutex;
-static unsigned int _nthreads;
-static uv_thread_t *_threads;
-static uv_thread_t _default_threads[2];
-static QUEUE _exit_message;
-static QUEUE _wq;
+static uv_thread_t _cpu_threads[CONFIG_LIBTUV_THREADPOOL_CPU_THREADS];
+static uv_thread_t _io_threads[CONFIG_LIBTUV_THREADPOOL_IO_THREADS];
+static struct uv__workq _queues[UV_THREADPOOL_NQUEUES];
 static volatile int _initialized = 0;
 
 //-----------------------------------------------------------------------------
@@ -60,58 +79,92 @@ static void uv__cancelled(struct uv__work *w)
 	ABORT();
 }
 
+/* Hand a finished or cancelled request back to its loop.  The loop drains
+ * all of them in one uv__work_done(), so the loop is only woken for the
+ * first request of a batch: when loop->wq is not empty a wakeup is already
+ * pending and will see this one too.
+ */
+static void uv__work_complete(uv_loop_t *loop, struct uv__work *w, void (*work)(struct uv__work *w))
+{
+	int wakeup;
+
+	uv_mutex_lock(&loop->wq_mutex);
+	w->work = work;
+	wakeup = QUEUE_EMPTY(&loop->wq);
+	QUEUE_INSERT_TAIL(&loop->wq, &w->wq);
+	if (wakeup) {
+		uv_async_send(&loop->wq_async);
+	}
+	uv_mutex_unlock(&loop->wq_mutex);
+}
+
 /* To avoid deadlock with uv_cancel() it's crucial that the worker
- * never holds the global _mutex and the loop-local mutex at the same time.
+ * never holds a queue mutex and the loop-local mutex at the same time.
  */
 static void worker(void *arg)
 {
+	struct uv__workq *wq = (struct uv__workq *)arg;
 	struct uv__work *w;
+	uint64_t wait;
 	QUEUE *q;
 
-	(void)arg;
-
 	for (;;) {
-		uv_mutex_lock(&_mutex);
+		uv_mutex_lock(&wq->mutex);
 
-		while (QUEUE_EMPTY(&_wq)) {
-			uv_cond_wait(&_cond, &_mutex);
+		while (QUEUE_EMPTY(&wq->wq) && !wq->exiting) {
+			wq->idle++;
+			uv_cond_wait(&wq->cond, &wq->mutex);
+			wq->idle--;
 		}
 
-		q = QUEUE_HEAD(&_wq);
-
-		if (q == &_exit_message) {
-			uv_cond_signal(&_cond);
-		} else {
-			QUEUE_REMOVE(q);
-			QUEUE_INIT(q);		/* Signal uv_cancel() that the work req is
-								   executing. */
+		if (QUEUE_EMPTY(&wq->wq)) {
+			uv_mutex_unlock(&wq->mutex);
+			break;
 		}
 
-		uv_mutex_unlock(&_mutex);
+		q = QUEUE_HEAD(&wq->wq);
+		QUEUE_REMOVE(q);
+		QUEUE_INIT(q);			/* Signal uv_cancel() that the work req is
+								   executing. */
 
-		if (q == &_exit_message) {
-			break;
+		w = QUEUE_DATA(q, struct uv__work, wq);
+		wait = uv__hrtime() - w->time;
+		wq->stats.queued--;
+		wq->stats.started++;
+		if (wait > wq->stats.max_wait) {
+			wq->stats.max_wait = wait;
 		}
 
-		w = QUEUE_DATA(q, struct uv__work, wq);
+		uv_mutex_unlock(&wq->mutex);
+
 		w->work(w);
 
-		uv_mutex_lock(&w->loop->wq_mutex);
-		w->work = NULL;			/* Signal uv_cancel() that the work req is done
-								   executing. */
-		QUEUE_INSERT_TAIL(&w->loop->wq, &w->wq);
-		uv_async_send(&w->loop->wq_async);
-		uv_mutex_unlock(&w->loop->wq_mutex);
+		/* A NULL work signals uv_cancel() that the work req is done executing */
+
+		uv__work_complete(w->loop, w, NULL);
 	}
 }
 
-static void post(QUEUE *q)
+static void post(struct uv__workq *wq, struct uv__work *w)
 {
-	uv_mutex_lock(&_mutex);
-	QUEUE_INSERT_TAIL(&_wq, q);
-	uv_mutex_unlock(&_mutex);
+	int idle;
+
+	w->time = uv__hrtime();
+
+	uv_mutex_lock(&wq->mutex);
+	QUEUE_INSERT_TAIL(&wq->wq, &w->wq);
+	wq->stats.submitted++;
+	if (++wq->stats.queued > wq->stats.max_queued) {
+		wq->stats.max_queued = wq->stats.queued;
+	}
+	idle = wq->idle;
+	uv_mutex_unlock(&wq->mutex);
+
+	/* Busy workers find the request when they look for the next one */
 
-	uv_cond_signal(&_cond);
+	if (idle > 0) {
+		uv_cond_signal(&wq->cond);
+	}
 }
 
 #if defined(__TINYARA__)
@@ -122,76 +175,70 @@ __attribute__((destructor))
 static void cleanup(void)
 {
 #endif
+	struct uv__workq *wq;
 	unsigned int i;
+	unsigned int n;
 
 	if (_initialized == 0) {
 		return;
 	}
 
-	post(&_exit_message);
+	for (n = 0; n < UV_THREADPOOL_NQUEUES; n++) {
+		wq = &_queues[n];
 
-	for (i = 0; i < _nthreads; i++)
-		if (uv_thread_join(_threads + i)) {
-			ABORT();
-		}
+		uv_mutex_lock(&wq->mutex);
+		wq->exiting = 1;
+		uv_mutex_unlock(&wq->mutex);
+		uv_cond_broadcast(&wq->cond);
 
-	if (_threads != _default_threads) {
-		free(_threads);
-	}
+		for (i = 0; i < wq->nthreads; i++)
+			if (uv_thread_join(wq->threads + i)) {
+				ABORT();
+			}
 
-	uv_mutex_destroy(&_mutex);
-	uv_cond_destroy(&_cond);
+		uv_mutex_destroy(&wq->mutex);
+		uv_cond_destroy(&wq->cond);
+	}
 
-	_threads = NULL;
-	_nthreads = 0;
+	memset(_queues, 0, sizeof(_queues));
 	_initialized = 0;
 	_once = UV_ONCE_INIT;
 }
 
 static void init_once(void)
 {
+	struct uv__workq *wq;
 	unsigned int i;
-	const char *val;
+	unsigned int n;
 
 	assert(_initialized == 0);
 
-	_nthreads = ARRAY_SIZE(_default_threads);
-	val = getenv("UV_THREADPOOL_SIZE");
-	if (val != NULL) {
-		_nthreads = atoi(val);
-	}
-	if (_nthreads == 0) {
-		_nthreads = 1;
-	}
-	if (_nthreads > MAX_THREADPOOL_SIZE) {
-		_nthreads = MAX_THREADPOOL_SIZE;
-	}
+	_queues[UV_THREADPOOL_CPU].threads = _cpu_threads;
+	_queues[UV_THREADPOOL_CPU].nthreads = ARRAY_SIZE(_cpu_threads);
+	_queues[UV_THREADPOOL_IO].threads = _io_threads;
+	_queues[UV_THREADPOOL_IO].nthreads = ARRAY_SIZE(_io_threads);
 
-	_threads = _default_threads;
-	if (_nthreads > ARRAY_SIZE(_default_threads)) {
-		_threads = (uv_thread_t *)malloc(_nthreads * sizeof(_threads[0]));
-		if (_threads == NULL) {
-			_nthreads = ARRAY_SIZE(_default_threads);
-			_threads = _default_threads;
-		}
-	}
+	for (n = 0; n < UV_THREADPOOL_NQUEUES; n++) {
+		wq = &_queues[n];
+		wq->stats.nthreads = wq->nthreads;
 
-	if (uv_cond_init(&_cond)) {
-		TDLOG("init_once cond abort");
-		ABORT();
-	}
+		if (uv_cond_init(&wq->cond)) {
+			TDLOG("init_once cond abort");
+			ABORT();
+		}
 
-	if (uv_mutex_init(&_mutex)) {
-		TDLOG("init_once mutex abort");
-		ABORT();
-	}
+		if (uv_mutex_init(&wq->mutex)) {
+			TDLOG("init_once mutex abort");
+			ABORT();
+		}
 
-	QUEUE_INIT(&_wq);
+		QUEUE_INIT(&wq->wq);
 
-	for (i = 0; i < _nthreads; i++) {
-		if (uv_thread_create(_threads + i, worker, NULL)) {
-			TDLOG("init_once thread %d abort", i);
-			ABORT();
+		for (i = 0; i < wq->nthreads; i++) {
+			if (uv_thread_create(wq->threads + i, worker, wq)) {
+				TDLOG("init_once thread %d abort", i);
+				ABORT();
+			}
 		}
 	}
 
@@ -200,41 +247,40 @@ static void init_once(void)
 
 //-----------------------------------------------------------------------------
 
-void uv__work_submit(uv_loop_t *loop, struct uv__work *w, void (*work)(struct uv__work *w), void (*done)(struct uv__work *w, int status))
+void uv__work_submit(uv_loop_t *loop, struct uv__work *w, enum uv__work_kind kind, void (*work)(struct uv__work *w), void (*done)(struct uv__work *w, int status))
 {
 
 	uv_once(&_once, init_once);
 	w->loop = loop;
 	w->work = work;
 	w->done = done;
-	QUEUE_INIT(&w->wq);
-	post(&w->wq);
+	w->queue = (kind == UV__WORK_SLOW_IO) ? UV_THREADPOOL_IO : UV_THREADPOOL_CPU;
+	post(&_queues[w->queue], w);
 }
 
 static int uv__work_cancel(uv_loop_t *loop, uv_req_t *req, struct uv__work *w)
 {
+	struct uv__workq *wq = &_queues[w->queue];
 	int cancelled;
 
-	uv_mutex_lock(&_mutex);
+	uv_mutex_lock(&wq->mutex);
 	uv_mutex_lock(&w->loop->wq_mutex);
 
 	cancelled = !QUEUE_EMPTY(&w->wq) && w->work != NULL;
 	if (cancelled) {
 		QUEUE_REMOVE(&w->wq);
+		wq->stats.queued--;
+		wq->stats.cancelled++;
 	}
 
 	uv_mutex_unlock(&w->loop->wq_mutex);
-	uv_mutex_unlock(&_mutex);
+	uv_mutex_unlock(&wq->mutex);
 
 	if (!cancelled) {
 		return UV_EBUSY;
 	}
 
-	w->work = uv__cancelled;
-	uv_mutex_lock(&loop->wq_mutex);
-	QUEUE_INSERT_TAIL(&loop->wq, &w->wq);
-	uv_async_send(&loop->wq_async);
-	uv_mutex_unlock(&loop->wq_mutex);
+	uv__work_complete(loop, w, uv__cancelled);
 
 	return 0;
 }
@@ -300,7 +346,7 @@ int uv_queue_work(uv_loop_t *loop, uv_work_t *req, uv_work_cb work_cb, uv_after_
 	req->loop = loop;
 	req->work_cb = work_cb;
 	req->after_work_cb = after_work_cb;
-	uv__work_submit(loop, &req->work_req, uv__queue_work, uv__queue_done);
+	uv__work_submit(loop, &req->work_req, UV__WORK_CPU, uv__queue_work, uv__queue_done);
 	return 0;
 }
 
@@ -337,6 +383,24 @@ int uv_cancel(uv_req_t *req)
 	return uv__work_cancel(loop, req, wreq);
 }
 
+int uv_threadpool_stats(int queue, uv_threadpool_stats_t *stats)
+{
+	struct uv__workq *wq;
+
+	if (queue < 0 || queue >= UV_THREADPOOL_NQUEUES || stats == NULL) {
+		return UV_EINVAL;
+	}
+
+	uv_once(&_once, init_once);
+	wq = &_queues[queue];
+
+	uv_mutex_lock(&wq->mutex);
+	*stats = wq->stats;
+	uv_mutex_unlock(&wq->mutex);
+
+	return 0;
+}
+
 //-----------------------------------------------------------------------------
 #if defined(__TINYARA__)
 void uv_cleanup(void)
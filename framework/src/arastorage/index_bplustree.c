@@ -312,10 +312,12 @@ index_api_t index_bplustree = {
  ****************************************************************************/
 int compare(const void *p1, const void *p2)
 {
-	if (((pair_t *)p1)->key <= ((pair_t *)p2)->key) {
+	if (((pair_t *)p1)->key < ((pair_t *)p2)->key) {
 		return -1;
+	} else if (((pair_t *)p1)->key > ((pair_t *)p2)->key) {
+		return 1;
 	}
-	return 1;
+	return 0;
 }
 
 /****************************************************************************
@@ -1759,7 +1761,9 @@ static bsplit_status_t bucket_split(tree_t *tree, int key, int value, pair_t *pa
 	 */
 	bucket = bucket_read(tree, bucket_id);
 
-	/* Sort the key-value pairs in the bucket according to the keys and pick the median */
+	/* Sort the key-value pairs in the bucket according to the keys and pick the median.
+	 * The sort is stable so that the pairs of a duplicate key stay in insertion order.
+	 */
 	pair_t bucket_tuples[BUCKET_SIZE + 1];
 	for (i = 0; i < BUCKET_SIZE; i++) {
 		bucket_tuples[i].key = bucket->pairs[i].key;
@@ -1768,7 +1772,7 @@ static bsplit_status_t bucket_split(tree_t *tree, int key, int value, pair_t *pa
 	bucket_tuples[BUCKET_SIZE].key = key;
 	bucket_tuples[BUCKET_SIZE].value = value;
 
-	qsort(bucket_tuples, BUCKET_SIZE + 1, sizeof(pair_t), compare);
+	mergesort(bucket_tuples, BUCKET_SIZE + 1, sizeof(pair_t), compare);
 
 	median = bucket_tuples[(BUCKET_SIZE + 1) / 2].key;
 	/* Call tree_split before creating a new bucket and dividing the entries */
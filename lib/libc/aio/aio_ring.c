@@ -0,0 +1,106 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * libc/aio/aio_ring.c
+ *
+ * Access to the queues of a ring created by aio_ring_setup().
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <aio.h>
+#include <assert.h>
+
+#ifdef CONFIG_FS_AIO_RING
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_ring_getsqe
+ *
+ * Description:
+ *   Return the next free submission entry of 'ring' and queue it.  The
+ *   entry must be filled in before the next call to aio_ring_enter().
+ *
+ * Returned Value:
+ *   The entry, or NULL if the submission queue is full.
+ *
+ ****************************************************************************/
+
+FAR struct aio_sqe_s *aio_ring_getsqe(FAR struct aio_ring_s *ring)
+{
+	FAR struct aio_sqe_s *sqe;
+
+	DEBUGASSERT(ring);
+
+	if ((uint16_t)(ring->sq_tail - ring->sq_head) >= ring->entries) {
+		return NULL;
+	}
+
+	sqe = &ring->sq[ring->sq_tail & (ring->entries - 1)];
+	ring->sq_tail++;
+	return sqe;
+}
+
+/****************************************************************************
+ * Name: aio_ring_peekcqe
+ *
+ * Description:
+ *   Return the oldest completion entry of 'ring' without removing it.
+ *
+ * Returned Value:
+ *   The entry, or NULL if no completion is waiting.
+ *
+ ****************************************************************************/
+
+FAR struct aio_cqe_s *aio_ring_peekcqe(FAR struct aio_ring_s *ring)
+{
+	DEBUGASSERT(ring);
+
+	if (ring->cq_head == ring->cq_tail) {
+		return NULL;
+	}
+
+	return &ring->cq[ring->cq_head & (ring->entries - 1)];
+}
+
+/****************************************************************************
+ * Name: aio_ring_cqeseen
+ *
+ * Description:
+ *   Remove the entry returned by aio_ring_peekcqe(), making room for
+ *   another completion.
+ *
+ ****************************************************************************/
+
+void aio_ring_cqeseen(FAR struct aio_ring_s *ring)
+{
+	DEBUGASSERT(ring && ring->cq_head != ring->cq_tail);
+
+	ring->cq_head++;
+}
+
+#endif							/* CONFIG_FS_AIO_RING */
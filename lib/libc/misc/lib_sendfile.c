@@ -57,11 +57,15 @@
 #include <tinyara/config.h>
 
 #include <sys/sendfile.h>
+#include <sys/ioctl.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <errno.h>
 
+#include <tinyara/fs/ioctl.h>
+
 #include "lib_internal.h"
 
 #if CONFIG_NSOCKET_DESCRIPTORS > 0 || CONFIG_NFILE_DESCRIPTORS > 0
@@ -82,6 +86,83 @@
  * Private Functions
  ************************************************************************/
 
+/************************************************************************
+ * Name: sendfile_xip
+ *
+ * Description:
+ *   If infd is a file whose data can be addressed in place (a ROMFS file
+ *   on XIP media), write up to 'count' bytes to outfd straight from the
+ *   media, without reading them into an I/O buffer first.  Returns false
+ *   if the file cannot be addressed in place; otherwise, the number of
+ *   bytes transferred (or ERROR) is returned in 'pntransferred' and the
+ *   file position of infd is advanced by that number.
+ *
+ ************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+static bool sendfile_xip(int outfd, int infd, size_t count, FAR ssize_t *pntransferred)
+{
+	FAR uint8_t *base;
+	off_t pos;
+	off_t end;
+	size_t nbytes;
+	ssize_t nbyteswritten;
+	ssize_t ntransferred;
+
+	if (infd < 0 || infd >= CONFIG_NFILE_DESCRIPTORS) {
+		return false;
+	}
+
+	if (ioctl(infd, FIOC_MMAP, (unsigned long)((uintptr_t)&base)) < 0) {
+		return false;
+	}
+
+	/* Get the range of the file left to send */
+
+	pos = lseek(infd, 0, SEEK_CUR);
+	if (pos == (off_t)-1) {
+		return false;
+	}
+
+	end = lseek(infd, 0, SEEK_END);
+	if (lseek(infd, pos, SEEK_SET) == (off_t)-1 || end == (off_t)-1) {
+		return false;
+	}
+
+	nbytes = end > pos ? end - pos : 0;
+	if (nbytes > count) {
+		nbytes = count;
+	}
+
+	/* Write it, with the error handling of the copy loop below */
+
+	*pntransferred = 0;
+	for (ntransferred = 0; ntransferred < nbytes;) {
+		nbyteswritten = write(outfd, base + pos + ntransferred, nbytes - ntransferred);
+		if (nbyteswritten < 0) {
+#ifndef CONFIG_DISABLE_SIGNALS
+			if (errno == EINTR && ntransferred > 0) {
+				continue;
+			}
+#endif
+			*pntransferred = ERROR;
+			break;
+		}
+
+		ntransferred += nbyteswritten;
+	}
+
+	/* Advance the file position past the data sent, as read() would */
+
+	(void)lseek(infd, pos + ntransferred, SEEK_SET);
+	if (*pntransferred == 0) {
+		*pntransferred = ntransferred;
+	}
+
+	return true;
+}
+#endif
+
 /************************************************************************
  * Public Functions
  ************************************************************************/
@@ -138,6 +219,7 @@ ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
 	ssize_t nbytesread;
 	ssize_t nbyteswritten;
 	ssize_t ntransferred;
+	size_t nbytes;
 	bool endxfr;
 
 	/* Get the current file position. */
@@ -157,6 +239,14 @@ ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
 		}
 	}
 
+#if CONFIG_NFILE_DESCRIPTORS > 0
+	/* Files on XIP media need no I/O buffer */
+
+	if (sendfile_xip(outfd, infd, count, &ntransferred)) {
+		goto return_position;
+	}
+#endif
+
 	/* Allocate an I/O buffer */
 
 	iobuffer = (FAR void *)lib_malloc(CONFIG_LIB_SENDFILE_BUFSIZE);
@@ -170,10 +260,15 @@ ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
 	for (ntransferred = 0, endxfr = false; ntransferred < count && !endxfr;) {
 		/* Loop until the read side of the transfer comes to some conclusion */
 
+		nbytes = count - ntransferred;
+		if (nbytes > CONFIG_LIB_SENDFILE_BUFSIZE) {
+			nbytes = CONFIG_LIB_SENDFILE_BUFSIZE;
+		}
+
 		do {
-			/* Read a buffer of data from the infd */
+			/* Read a buffer of data from the infd, but not past 'count' */
 
-			nbytesread = read(infd, iobuffer, CONFIG_LIB_SENDFILE_BUFSIZE);
+			nbytesread = read(infd, iobuffer, nbytes);
 
 			/* Check for end of file */
 
@@ -268,6 +363,9 @@ ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
 
 	lib_free(iobuffer);
 
+#if CONFIG_NFILE_DESCRIPTORS > 0
+return_position:
+#endif
 	/* Return the current file position */
 
 	if (offset) {
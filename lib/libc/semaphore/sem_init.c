@@ -112,6 +112,10 @@ int sem_init(FAR sem_t *sem, int pshared, unsigned int value)
 		sem->holder.counts = 0;
 #endif
 #endif
+
+		/* No task is waiting yet */
+
+		dq_init(&sem->waitlist);
 		return OK;
 	} else {
 		set_errno(EINVAL);
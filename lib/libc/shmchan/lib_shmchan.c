@@ -0,0 +1,639 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * libc/shmchan/lib_shmchan.c
+ *
+ * Shared memory channels.  The region of a channel is the header, then a
+ * descriptor per buffer, then the buffers.  The state of buffer i is the
+ * sequence number in its descriptor, compared with the ring positions p
+ * that map to it (p & (nslots - 1) == i):
+ *
+ *   seq == p            Free for the producer reserving position p
+ *   seq == p + 1        Holds the message at position p
+ *   seq == p + nslots   Released, free for position p + nslots
+ *
+ * Producers claim positions by advancing 'tail' (with a compare and swap
+ * if there may be several of them) and the consumer reads them in order
+ * at 'head'.  This is the bounded queue of Dmitry Vyukov, with one
+ * consumer.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <tinyara/semaphore.h>
+#include <tinyara/shmchan.h>
+
+#include <sys/ipc.h>
+#ifdef CONFIG_MM_SHM
+#include <sys/shm.h>
+#endif
+
+#include "lib_internal.h"
+
+#ifdef CONFIG_LIBC_SHMCHAN
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SHMCH_MAGIC     0x53484d43	/* "SHMC" */
+#define SHMCH_MAXSLOTS  32768
+#define SHMCH_ALIGN(n)  (((n) + 7) & ~7)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct shmch_hdr_s {
+	uint32_t magic;				/* SHMCH_MAGIC once the region is set up */
+	key_t key;					/* Key of the channel */
+	uint16_t flags;				/* SHMCH_SPSC or SHMCH_MPSC */
+	uint16_t nslots;			/* Number of buffers, a power of two */
+	uint16_t nattach;			/* Tasks attached (without CONFIG_MM_SHM) */
+	uint32_t msgsize;			/* Size of each buffer */
+	volatile uint32_t tail;		/* Next position reserved by a producer */
+	volatile uint32_t head;		/* Next position received by the consumer */
+	volatile uint32_t rxwait;	/* The consumer sleeps on rxsem */
+	volatile uint32_t txwait;	/* Number of producers sleeping on txsem */
+	sem_t rxsem;				/* Wakes the consumer */
+	sem_t txsem;				/* Wakes the producers */
+};
+
+struct shmch_desc_s {
+	volatile uint32_t seq;		/* State of the buffer, see above */
+	uint32_t len;				/* Length of the message */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifndef CONFIG_MM_SHM
+/* Without shmget(), all the tasks share the user heap and the channels
+ * are found by their key in this table.
+ */
+
+static FAR struct shmch_hdr_s *g_shmch[CONFIG_LIBC_SHMCHAN_MAX];
+static sem_t g_shmchsem = SEM_INITIALIZER(1);
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shmch_dataoff
+ *
+ * Description:
+ *   Return the offset of the buffers in the region of a channel.
+ *
+ ****************************************************************************/
+
+static size_t shmch_dataoff(unsigned int nslots)
+{
+	return SHMCH_ALIGN(SHMCH_ALIGN(sizeof(struct shmch_hdr_s)) + nslots * sizeof(struct shmch_desc_s));
+}
+
+/****************************************************************************
+ * Name: shmch_attach
+ *
+ * Description:
+ *   Fill in the channel 'ch' for the region at 'hdr'.
+ *
+ ****************************************************************************/
+
+static void shmch_attach(FAR struct shmch_hdr_s *hdr, FAR struct shmch_s *ch)
+{
+	ch->hdr = hdr;
+	ch->desc = (FAR struct shmch_desc_s *)((FAR uint8_t *)hdr + SHMCH_ALIGN(sizeof(struct shmch_hdr_s)));
+	ch->data = (FAR uint8_t *)hdr + shmch_dataoff(hdr->nslots);
+}
+
+/****************************************************************************
+ * Name: shmch_setup
+ *
+ * Description:
+ *   Lay out a new region.
+ *
+ ****************************************************************************/
+
+static void shmch_setup(FAR struct shmch_hdr_s *hdr, key_t key, unsigned int nslots, size_t msgsize, int flags)
+{
+	FAR struct shmch_desc_s *desc;
+	unsigned int i;
+
+	memset(hdr, 0, sizeof(struct shmch_hdr_s));
+	hdr->key = key;
+	hdr->flags = flags;
+	hdr->nslots = nslots;
+	hdr->msgsize = msgsize;
+
+	sem_init(&hdr->rxsem, 1, 0);
+	sem_init(&hdr->txsem, 1, 0);
+	sem_setprotocol(&hdr->rxsem, SEM_PRIO_NONE);
+	sem_setprotocol(&hdr->txsem, SEM_PRIO_NONE);
+
+	desc = (FAR struct shmch_desc_s *)((FAR uint8_t *)hdr + SHMCH_ALIGN(sizeof(struct shmch_hdr_s)));
+	for (i = 0; i < nslots; i++) {
+		desc[i].seq = i;
+		desc[i].len = 0;
+	}
+
+	__atomic_store_n(&hdr->magic, SHMCH_MAGIC, __ATOMIC_RELEASE);
+}
+
+/****************************************************************************
+ * Name: shmch_tryreserve
+ *
+ * Description:
+ *   Claim the next position for a producer.  Returns false if the ring is
+ *   full.
+ *
+ ****************************************************************************/
+
+static bool shmch_tryreserve(FAR struct shmch_s *ch, FAR uint32_t *ppos)
+{
+	FAR struct shmch_hdr_s *hdr = ch->hdr;
+	FAR struct shmch_desc_s *desc;
+	uint32_t pos;
+	int32_t diff;
+
+	pos = __atomic_load_n(&hdr->tail, __ATOMIC_RELAXED);
+	for (;;) {
+		desc = &ch->desc[pos & (hdr->nslots - 1)];
+		diff = (int32_t)(__atomic_load_n(&desc->seq, __ATOMIC_ACQUIRE) - pos);
+		if (diff == 0) {
+			/* The buffer is free.  Claim the position. */
+
+			if (hdr->flags == SHMCH_SPSC) {
+				hdr->tail = pos + 1;
+				break;
+			}
+
+			if (__atomic_compare_exchange_n(&hdr->tail, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+				break;
+			}
+
+			/* Another producer took it; pos is the new tail */
+
+		} else if (diff < 0) {
+			/* The buffer still holds the message nslots positions back */
+
+			return false;
+		} else {
+			/* Another producer claimed it since tail was read */
+
+			pos = __atomic_load_n(&hdr->tail, __ATOMIC_RELAXED);
+		}
+	}
+
+	*ppos = pos;
+	return true;
+}
+
+/****************************************************************************
+ * Name: shmch_wait
+ *
+ * Description:
+ *   Sleep on a semaphore of the channel.  Returns false on errors other
+ *   than EINTR.
+ *
+ ****************************************************************************/
+
+static bool shmch_wait(FAR sem_t *sem)
+{
+	return sem_wait(sem) == OK || get_errno() == EINTR;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shmch_create
+ ****************************************************************************/
+
+int shmch_create(key_t key, unsigned int nslots, size_t msgsize, int flags, FAR struct shmch_s *ch)
+{
+	FAR struct shmch_hdr_s *hdr;
+	size_t size;
+	int errcode;
+#ifdef CONFIG_MM_SHM
+	int shmid;
+#else
+	int i;
+	int slot;
+#endif
+
+	DEBUGASSERT(ch);
+
+	if (key == IPC_PRIVATE || nslots < 2 || nslots > SHMCH_MAXSLOTS || (nslots & (nslots - 1)) != 0 || (flags != SHMCH_SPSC && flags != SHMCH_MPSC)) {
+		errcode = EINVAL;
+		goto errout;
+	}
+
+	if (msgsize == 0 || msgsize > (UINT32_MAX - shmch_dataoff(nslots)) / nslots - 8) {
+		errcode = EINVAL;
+		goto errout;
+	}
+
+	msgsize = SHMCH_ALIGN(msgsize);
+	size = shmch_dataoff(nslots) + nslots * msgsize;
+
+#ifdef CONFIG_MM_SHM
+	shmid = shmget(key, size, IPC_CREAT | IPC_EXCL | 0666);
+	if (shmid < 0) {
+		return ERROR;
+	}
+
+	hdr = (FAR struct shmch_hdr_s *)shmat(shmid, NULL, 0);
+	if (hdr == (FAR struct shmch_hdr_s *)-1) {
+		errcode = get_errno();
+		(void)shmctl(shmid, IPC_RMID, NULL);
+		goto errout;
+	}
+
+	ch->shmid = shmid;
+	shmch_setup(hdr, key, nslots, msgsize, flags);
+#else
+	while (sem_wait(&g_shmchsem) != OK) {
+		DEBUGASSERT(get_errno() == EINTR);
+	}
+
+	slot = -1;
+	for (i = 0; i < CONFIG_LIBC_SHMCHAN_MAX; i++) {
+		if (g_shmch[i] == NULL) {
+			if (slot < 0) {
+				slot = i;
+			}
+		} else if (g_shmch[i]->key == key) {
+			errcode = EEXIST;
+			goto errout_with_sem;
+		}
+	}
+
+	if (slot < 0) {
+		errcode = ENOSPC;
+		goto errout_with_sem;
+	}
+
+	hdr = (FAR struct shmch_hdr_s *)lib_umalloc(size);
+	if (!hdr) {
+		errcode = ENOMEM;
+		goto errout_with_sem;
+	}
+
+	shmch_setup(hdr, key, nslots, msgsize, flags);
+	hdr->nattach = 1;
+	g_shmch[slot] = hdr;
+	sem_post(&g_shmchsem);
+#endif
+
+	shmch_attach(hdr, ch);
+	return OK;
+
+#ifndef CONFIG_MM_SHM
+errout_with_sem:
+	sem_post(&g_shmchsem);
+#endif
+errout:
+	set_errno(errcode);
+	return ERROR;
+}
+
+/****************************************************************************
+ * Name: shmch_open
+ ****************************************************************************/
+
+int shmch_open(key_t key, FAR struct shmch_s *ch)
+{
+	FAR struct shmch_hdr_s *hdr = NULL;
+#ifdef CONFIG_MM_SHM
+	int shmid;
+#else
+	int i;
+#endif
+
+	DEBUGASSERT(ch);
+
+#ifdef CONFIG_MM_SHM
+	shmid = shmget(key, 0, 0);
+	if (shmid < 0) {
+		return ERROR;
+	}
+
+	hdr = (FAR struct shmch_hdr_s *)shmat(shmid, NULL, 0);
+	if (hdr == (FAR struct shmch_hdr_s *)-1) {
+		return ERROR;
+	}
+
+	/* The creator may not have laid out the region yet */
+
+	if (__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) != SHMCH_MAGIC) {
+		(void)shmdt(hdr);
+		set_errno(ENOENT);
+		return ERROR;
+	}
+
+	ch->shmid = shmid;
+#else
+	while (sem_wait(&g_shmchsem) != OK) {
+		DEBUGASSERT(get_errno() == EINTR);
+	}
+
+	for (i = 0; i < CONFIG_LIBC_SHMCHAN_MAX; i++) {
+		if (g_shmch[i] != NULL && g_shmch[i]->key == key) {
+			hdr = g_shmch[i];
+			hdr->nattach++;
+			break;
+		}
+	}
+
+	sem_post(&g_shmchsem);
+
+	if (!hdr) {
+		set_errno(ENOENT);
+		return ERROR;
+	}
+#endif
+
+	shmch_attach(hdr, ch);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: shmch_close
+ ****************************************************************************/
+
+int shmch_close(FAR struct shmch_s *ch)
+{
+	FAR struct shmch_hdr_s *hdr;
+#ifdef CONFIG_MM_SHM
+	struct shmid_ds ds;
+	bool last = false;
+#else
+	int i;
+#endif
+
+	DEBUGASSERT(ch && ch->hdr);
+
+	hdr = ch->hdr;
+	ch->hdr = NULL;
+
+#ifdef CONFIG_MM_SHM
+	/* The last task attached destroys the semaphores.  Clearing the magic
+	 * first turns away a shmch_open() that attaches meanwhile; if one
+	 * attached before, it is seen in the count and the channel stays.
+	 */
+
+	if (shmctl(ch->shmid, IPC_STAT, &ds) == OK && ds.shm_nattch == 1) {
+		__atomic_store_n(&hdr->magic, 0, __ATOMIC_SEQ_CST);
+		if (shmctl(ch->shmid, IPC_STAT, &ds) == OK && ds.shm_nattch == 1) {
+			sem_destroy(&hdr->rxsem);
+			sem_destroy(&hdr->txsem);
+			last = true;
+		} else {
+			__atomic_store_n(&hdr->magic, SHMCH_MAGIC, __ATOMIC_SEQ_CST);
+		}
+	}
+
+	if (shmdt(hdr) < 0) {
+		return ERROR;
+	}
+
+	if (last) {
+		(void)shmctl(ch->shmid, IPC_RMID, NULL);
+	}
+#else
+	while (sem_wait(&g_shmchsem) != OK) {
+		DEBUGASSERT(get_errno() == EINTR);
+	}
+
+	if (--hdr->nattach == 0) {
+		for (i = 0; i < CONFIG_LIBC_SHMCHAN_MAX; i++) {
+			if (g_shmch[i] == hdr) {
+				g_shmch[i] = NULL;
+				break;
+			}
+		}
+
+		sem_destroy(&hdr->rxsem);
+		sem_destroy(&hdr->txsem);
+		lib_ufree(hdr);
+	}
+
+	sem_post(&g_shmchsem);
+#endif
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: shmch_reserve
+ ****************************************************************************/
+
+FAR void *shmch_reserve(FAR struct shmch_s *ch, bool wait)
+{
+	FAR struct shmch_hdr_s *hdr = ch->hdr;
+	bool slept = false;
+	uint32_t pos;
+
+	DEBUGASSERT(hdr);
+
+	while (!shmch_tryreserve(ch, &pos)) {
+		if (!wait) {
+			set_errno(EAGAIN);
+			return NULL;
+		}
+
+		/* Announce the wait, then look again so that a release between
+		 * the two is not missed.
+		 */
+
+		__atomic_add_fetch(&hdr->txwait, 1, __ATOMIC_SEQ_CST);
+		if (shmch_tryreserve(ch, &pos)) {
+			__atomic_sub_fetch(&hdr->txwait, 1, __ATOMIC_SEQ_CST);
+			break;
+		}
+
+		if (!shmch_wait(&hdr->txsem)) {
+			__atomic_sub_fetch(&hdr->txwait, 1, __ATOMIC_SEQ_CST);
+			return NULL;
+		}
+
+		__atomic_sub_fetch(&hdr->txwait, 1, __ATOMIC_SEQ_CST);
+		slept = true;
+	}
+
+	/* A release wakes one producer.  Pass the wakeup on to the next one,
+	 * which sleeps again if the ring is full by now.
+	 */
+
+	if (slept && hdr->txwait) {
+		sem_post(&hdr->txsem);
+	}
+
+	return ch->data + (pos & (hdr->nslots - 1)) * hdr->msgsize;
+}
+
+/****************************************************************************
+ * Name: shmch_commit
+ ****************************************************************************/
+
+int shmch_commit(FAR struct shmch_s *ch, FAR void *buf, size_t len)
+{
+	FAR struct shmch_hdr_s *hdr = ch->hdr;
+	FAR struct shmch_desc_s *desc;
+	size_t offset;
+	uint32_t pos;
+
+	DEBUGASSERT(hdr);
+
+	offset = (FAR uint8_t *)buf - ch->data;
+	if ((FAR uint8_t *)buf < ch->data || offset % hdr->msgsize != 0 || offset / hdr->msgsize >= hdr->nslots || len > hdr->msgsize) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	/* A reserved buffer keeps the sequence number of its position, which
+	 * the tail has passed.  A free buffer's position is not claimed yet
+	 * and a committed one has moved on to the next position.
+	 */
+
+	desc = &ch->desc[offset / hdr->msgsize];
+	pos = __atomic_load_n(&desc->seq, __ATOMIC_ACQUIRE);
+	if ((pos & (hdr->nslots - 1)) != offset / hdr->msgsize || (int32_t)(__atomic_load_n(&hdr->tail, __ATOMIC_RELAXED) - pos) <= 0) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	desc->len = len;
+	__atomic_store_n(&desc->seq, pos + 1, __ATOMIC_RELEASE);
+
+	/* Wake the consumer only if it sleeps on this very message, i.e. the
+	 * ring was empty up to it.  The fence pairs with the one of the
+	 * consumer between setting rxwait and checking the buffer.
+	 */
+
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (hdr->rxwait && hdr->head == pos) {
+		sem_post(&hdr->rxsem);
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: shmch_receive
+ ****************************************************************************/
+
+FAR void *shmch_receive(FAR struct shmch_s *ch, FAR size_t *len, bool wait)
+{
+	FAR struct shmch_hdr_s *hdr = ch->hdr;
+	FAR struct shmch_desc_s *desc;
+	uint32_t pos;
+
+	DEBUGASSERT(hdr);
+
+	pos = hdr->head;
+	desc = &ch->desc[pos & (hdr->nslots - 1)];
+
+	while (__atomic_load_n(&desc->seq, __ATOMIC_ACQUIRE) != pos + 1) {
+		if (!wait) {
+			set_errno(EAGAIN);
+			return NULL;
+		}
+
+		hdr->rxwait = 1;
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+		if (__atomic_load_n(&desc->seq, __ATOMIC_ACQUIRE) != pos + 1 && !shmch_wait(&hdr->rxsem)) {
+			hdr->rxwait = 0;
+			return NULL;
+		}
+
+		hdr->rxwait = 0;
+	}
+
+	if (len) {
+		*len = desc->len;
+	}
+
+	return ch->data + (pos & (hdr->nslots - 1)) * hdr->msgsize;
+}
+
+/****************************************************************************
+ * Name: shmch_release
+ ****************************************************************************/
+
+int shmch_release(FAR struct shmch_s *ch)
+{
+	FAR struct shmch_hdr_s *hdr = ch->hdr;
+	FAR struct shmch_desc_s *desc;
+	uint32_t pos;
+
+	DEBUGASSERT(hdr);
+
+	pos = hdr->head;
+	desc = &ch->desc[pos & (hdr->nslots - 1)];
+	if (__atomic_load_n(&desc->seq, __ATOMIC_ACQUIRE) != pos + 1) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	__atomic_store_n(&desc->seq, pos + hdr->nslots, __ATOMIC_RELEASE);
+	hdr->head = pos + 1;
+
+	/* Wake a producer only if the ring was full, i.e. the producers may
+	 * sleep on this very buffer.  The fence pairs with the one of the
+	 * producers between counting themselves in txwait and looking at the
+	 * buffer again.
+	 */
+
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (hdr->txwait && (uint32_t)(hdr->tail - pos) >= hdr->nslots) {
+		sem_post(&hdr->txsem);
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: shmch_msgsize
+ ****************************************************************************/
+
+size_t shmch_msgsize(FAR struct shmch_s *ch)
+{
+	DEBUGASSERT(ch->hdr);
+
+	return ch->hdr->msgsize;
+}
+
+#endif							/* CONFIG_LIBC_SHMCHAN */
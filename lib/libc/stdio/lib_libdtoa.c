@@ -117,11 +117,7 @@
 
 static void zeroes(FAR struct lib_outstream_s *obj, int nzeroes)
 {
-	int i;
-
-	for (i = nzeroes; i > 0; i--) {
-		obj->put(obj, '0');
-	}
+	putpad(obj, '0', nzeroes);
 }
 
 /****************************************************************************
@@ -134,9 +130,7 @@ static void zeroes(FAR struct lib_outstream_s *obj, int nzeroes)
 
 static void lib_dtoa_string(FAR struct lib_outstream_s *obj, const char *str)
 {
-	while (*str) {
-		obj->put(obj, *str++);
-	}
+	lib_stream_puts(obj, str, strlen(str));
 }
 
 /****************************************************************************
@@ -0,0 +1,872 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * libc/stdio/lib_libgrisu.c
+ *
+ * Floating point formatting for lib_vsprintf() without big integers or heap
+ * allocations, selected with CONFIG_LIBC_DTOA_SHORTEST.  The shortest digit
+ * string that reads back as the same double is generated with the Grisu2
+ * algorithm (Florian Loitsch, "Printing Floating-Point Numbers Quickly and
+ * Accurately with Integers", PLDI 2010) using 64-bit integer arithmetic.
+ * The %e, %f and %g conversions then round that digit string to the
+ * requested precision.
+ *
+ * Like lib_libdtoa.c, this file is included by lib_libvsprintf.c.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* IEEE 754 double precision layout */
+
+#define DTOA_FRACTION_MASK  0x000fffffffffffffULL
+#define DTOA_HIDDEN_BIT     0x0010000000000000ULL
+#define DTOA_EXPONENT_MASK  0x7ff0000000000000ULL
+#define DTOA_SIGN_BIT       0x8000000000000000ULL
+#define DTOA_EXPONENT_SHIFT 52
+#define DTOA_EXPONENT_BIAS  (0x3ff + 52)
+#define DTOA_EXPONENT_MIN   (1 - DTOA_EXPONENT_BIAS)
+
+/* The cached powers of ten are 10^k for k = DTOA_CACHED_KMIN, +8, +16, ...
+ * log10(2) is used to find the one that scales a number into the range
+ * needed by dtoa_digitgen().
+ */
+
+#define DTOA_CACHED_KMIN    (-348)
+#define DTOA_CACHED_KSTEP   8
+#define DTOA_D_1_LOG2_10    0.30102999566398114
+
+/* Grisu2 never needs more than 17 digits; leave some slack */
+
+#define DTOA_BUFSIZE        24
+
+/* Words of the integers used to resolve ties exactly.  The largest is a
+ * 53-bit significand times 5^340 (subnormals) or 2^680 (huge values).
+ */
+
+#define DTOA_BIGWORDS       32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A "do it yourself" floating point number, f * 2^e */
+
+struct dtoa_diyfp_s {
+	uint64_t f;
+	int e;
+};
+
+/* An unsigned integer of up to DTOA_BIGWORDS 32-bit words, least
+ * significant word first.
+ */
+
+struct dtoa_bigint_s {
+	int nwords;
+	uint32_t word[DTOA_BIGWORDS];
+};
+
+/* A cached power of ten, normalized and rounded to 64 bits */
+
+struct dtoa_cachedpow_s {
+	uint64_t f;
+	int16_t e;
+};
+
+/****************************************************************************
+ * Private Constant Data
+ ****************************************************************************/
+
+static const struct dtoa_cachedpow_s g_dtoa_cachedpow[] = {
+	{0xfa8fd5a0081c0288ULL, -1220},		/* 1e-348 */
+	{0xbaaee17fa23ebf76ULL, -1193},		/* 1e-340 */
+	{0x8b16fb203055ac76ULL, -1166},		/* 1e-332 */
+	{0xcf42894a5dce35eaULL, -1140},		/* 1e-324 */
+	{0x9a6bb0aa55653b2dULL, -1113},		/* 1e-316 */
+	{0xe61acf033d1a45dfULL, -1087},		/* 1e-308 */
+	{0xab70fe17c79ac6caULL, -1060},		/* 1e-300 */
+	{0xff77b1fcbebcdc4fULL, -1034},		/* 1e-292 */
+	{0xbe5691ef416bd60cULL, -1007},		/* 1e-284 */
+	{0x8dd01fad907ffc3cULL, -980},		/* 1e-276 */
+	{0xd3515c2831559a83ULL, -954},		/* 1e-268 */
+	{0x9d71ac8fada6c9b5ULL, -927},		/* 1e-260 */
+	{0xea9c227723ee8bcbULL, -901},		/* 1e-252 */
+	{0xaecc49914078536dULL, -874},		/* 1e-244 */
+	{0x823c12795db6ce57ULL, -847},		/* 1e-236 */
+	{0xc21094364dfb5637ULL, -821},		/* 1e-228 */
+	{0x9096ea6f3848984fULL, -794},		/* 1e-220 */
+	{0xd77485cb25823ac7ULL, -768},		/* 1e-212 */
+	{0xa086cfcd97bf97f4ULL, -741},		/* 1e-204 */
+	{0xef340a98172aace5ULL, -715},		/* 1e-196 */
+	{0xb23867fb2a35b28eULL, -688},		/* 1e-188 */
+	{0x84c8d4dfd2c63f3bULL, -661},		/* 1e-180 */
+	{0xc5dd44271ad3cdbaULL, -635},		/* 1e-172 */
+	{0x936b9fcebb25c996ULL, -608},		/* 1e-164 */
+	{0xdbac6c247d62a584ULL, -582},		/* 1e-156 */
+	{0xa3ab66580d5fdaf6ULL, -555},		/* 1e-148 */
+	{0xf3e2f893dec3f126ULL, -529},		/* 1e-140 */
+	{0xb5b5ada8aaff80b8ULL, -502},		/* 1e-132 */
+	{0x87625f056c7c4a8bULL, -475},		/* 1e-124 */
+	{0xc9bcff6034c13053ULL, -449},		/* 1e-116 */
+	{0x964e858c91ba2655ULL, -422},		/* 1e-108 */
+	{0xdff9772470297ebdULL, -396},		/* 1e-100 */
+	{0xa6dfbd9fb8e5b88fULL, -369},		/* 1e-92 */
+	{0xf8a95fcf88747d94ULL, -343},		/* 1e-84 */
+	{0xb94470938fa89bcfULL, -316},		/* 1e-76 */
+	{0x8a08f0f8bf0f156bULL, -289},		/* 1e-68 */
+	{0xcdb02555653131b6ULL, -263},		/* 1e-60 */
+	{0x993fe2c6d07b7facULL, -236},		/* 1e-52 */
+	{0xe45c10c42a2b3b06ULL, -210},		/* 1e-44 */
+	{0xaa242499697392d3ULL, -183},		/* 1e-36 */
+	{0xfd87b5f28300ca0eULL, -157},		/* 1e-28 */
+	{0xbce5086492111aebULL, -130},		/* 1e-20 */
+	{0x8cbccc096f5088ccULL, -103},		/* 1e-12 */
+	{0xd1b71758e219652cULL, -77},		/* 1e-4 */
+	{0x9c40000000000000ULL, -50},		/* 1e4 */
+	{0xe8d4a51000000000ULL, -24},		/* 1e12 */
+	{0xad78ebc5ac620000ULL, 3},		/* 1e20 */
+	{0x813f3978f8940984ULL, 30},		/* 1e28 */
+	{0xc097ce7bc90715b3ULL, 56},		/* 1e36 */
+	{0x8f7e32ce7bea5c70ULL, 83},		/* 1e44 */
+	{0xd5d238a4abe98068ULL, 109},		/* 1e52 */
+	{0x9f4f2726179a2245ULL, 136},		/* 1e60 */
+	{0xed63a231d4c4fb27ULL, 162},		/* 1e68 */
+	{0xb0de65388cc8ada8ULL, 189},		/* 1e76 */
+	{0x83c7088e1aab65dbULL, 216},		/* 1e84 */
+	{0xc45d1df942711d9aULL, 242},		/* 1e92 */
+	{0x924d692ca61be758ULL, 269},		/* 1e100 */
+	{0xda01ee641a708deaULL, 295},		/* 1e108 */
+	{0xa26da3999aef774aULL, 322},		/* 1e116 */
+	{0xf209787bb47d6b85ULL, 348},		/* 1e124 */
+	{0xb454e4a179dd1877ULL, 375},		/* 1e132 */
+	{0x865b86925b9bc5c2ULL, 402},		/* 1e140 */
+	{0xc83553c5c8965d3dULL, 428},		/* 1e148 */
+	{0x952ab45cfa97a0b3ULL, 455},		/* 1e156 */
+	{0xde469fbd99a05fe3ULL, 481},		/* 1e164 */
+	{0xa59bc234db398c25ULL, 508},		/* 1e172 */
+	{0xf6c69a72a3989f5cULL, 534},		/* 1e180 */
+	{0xb7dcbf5354e9beceULL, 561},		/* 1e188 */
+	{0x88fcf317f22241e2ULL, 588},		/* 1e196 */
+	{0xcc20ce9bd35c78a5ULL, 614},		/* 1e204 */
+	{0x98165af37b2153dfULL, 641},		/* 1e212 */
+	{0xe2a0b5dc971f303aULL, 667},		/* 1e220 */
+	{0xa8d9d1535ce3b396ULL, 694},		/* 1e228 */
+	{0xfb9b7cd9a4a7443cULL, 720},		/* 1e236 */
+	{0xbb764c4ca7a44410ULL, 747},		/* 1e244 */
+	{0x8bab8eefb6409c1aULL, 774},		/* 1e252 */
+	{0xd01fef10a657842cULL, 800},		/* 1e260 */
+	{0x9b10a4e5e9913129ULL, 827},		/* 1e268 */
+	{0xe7109bfba19c0c9dULL, 853},		/* 1e276 */
+	{0xac2820d9623bf429ULL, 880},		/* 1e284 */
+	{0x80444b5e7aa7cf85ULL, 907},		/* 1e292 */
+	{0xbf21e44003acdd2dULL, 933},		/* 1e300 */
+	{0x8e679c2f5e44ff8fULL, 960},		/* 1e308 */
+	{0xd433179d9c8cb841ULL, 986},		/* 1e316 */
+	{0x9e19db92b4e31ba9ULL, 1013},		/* 1e324 */
+	{0xeb96bf6ebadf77d9ULL, 1039},		/* 1e332 */
+	{0xaf87023b9bf0ee6bULL, 1066},		/* 1e340 */
+};
+
+static const uint64_t g_dtoa_pow10[] = {
+	1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+	10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+	100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+	100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+	100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+#define DTOA_NPOW10 (sizeof(g_dtoa_pow10) / sizeof(g_dtoa_pow10[0]))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dtoa_mul
+ *
+ * Description:
+ *   Return the upper 64 bits of the 128-bit product of x and y, rounded.
+ *
+ ****************************************************************************/
+
+static struct dtoa_diyfp_s dtoa_mul(struct dtoa_diyfp_s x, struct dtoa_diyfp_s y)
+{
+	struct dtoa_diyfp_s r;
+	uint64_t a = x.f >> 32;
+	uint64_t b = x.f & 0xffffffff;
+	uint64_t c = y.f >> 32;
+	uint64_t d = y.f & 0xffffffff;
+	uint64_t bc = b * c;
+	uint64_t ad = a * d;
+	uint64_t tmp = ((b * d) >> 32) + (ad & 0xffffffff) + (bc & 0xffffffff);
+
+	tmp += 1U << 31;
+	r.f = a * c + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+	r.e = x.e + y.e + 64;
+	return r;
+}
+
+/****************************************************************************
+ * Name: dtoa_normalize
+ *
+ * Description:
+ *   Shift x left until its most significant bit is set.
+ *
+ ****************************************************************************/
+
+static struct dtoa_diyfp_s dtoa_normalize(struct dtoa_diyfp_s x)
+{
+	while ((x.f & 0xffc0000000000000ULL) == 0) {
+		x.f <<= 10;
+		x.e -= 10;
+	}
+
+	while ((x.f & DTOA_SIGN_BIT) == 0) {
+		x.f <<= 1;
+		x.e--;
+	}
+
+	return x;
+}
+
+/****************************************************************************
+ * Name: dtoa_cachedpow
+ *
+ * Description:
+ *   Return the cached power of ten c = 10^-k such that the binary exponent
+ *   of a normalized number with exponent 'e', multiplied by c, lies in
+ *   [-60, -32].
+ *
+ ****************************************************************************/
+
+static struct dtoa_diyfp_s dtoa_cachedpow(int e, FAR int *k)
+{
+	struct dtoa_diyfp_s c;
+	double dk = (-61 - e) * DTOA_D_1_LOG2_10 - DTOA_CACHED_KMIN - 1;
+	int ik = (int)dk;
+	int index;
+
+	if (dk - ik > 0.0) {
+		ik++;
+	}
+
+	index = (ik >> 3) + 1;
+	*k = -(DTOA_CACHED_KMIN + index * DTOA_CACHED_KSTEP);
+
+	c.f = g_dtoa_cachedpow[index].f;
+	c.e = g_dtoa_cachedpow[index].e;
+	return c;
+}
+
+/****************************************************************************
+ * Name: dtoa_round_weed
+ *
+ * Description:
+ *   Move the last generated digit down while that brings the result closer
+ *   to the exact value and keeps it inside the rounding interval.
+ *
+ ****************************************************************************/
+
+static uint64_t dtoa_round_weed(FAR char *buffer, int len, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w)
+{
+	while (rest < wp_w && delta - rest >= ten_kappa && (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+		buffer[len - 1]--;
+		rest += ten_kappa;
+	}
+
+	return rest;
+}
+
+/****************************************************************************
+ * Name: dtoa_lean
+ *
+ * Description:
+ *   Given the distances of the upper boundary from the digits ('rest') and
+ *   from the value ('wp_w'), tell whether the value lies above (1) or below
+ *   (-1) the digits, or whether it is too close to tell (0).  'err' is the
+ *   uncertainty of the scaled values.
+ *
+ ****************************************************************************/
+
+static int dtoa_lean(uint64_t rest, uint64_t wp_w, uint64_t err)
+{
+	if (rest > wp_w + err) {
+		return 1;
+	} else if (rest + err < wp_w) {
+		return -1;
+	}
+
+	return 0;
+}
+
+/****************************************************************************
+ * Name: dtoa_digitgen
+ *
+ * Description:
+ *   Generate the digits of the scaled upper boundary 'mp' until the
+ *   remainder falls within 'delta' of it.  Returns the number of digits,
+ *   with *k adjusted to the decimal exponent of the last one and *lean
+ *   telling on which side of the digits the value 'w' lies.
+ *
+ ****************************************************************************/
+
+static int dtoa_digitgen(struct dtoa_diyfp_s w, struct dtoa_diyfp_s mp, uint64_t delta, FAR char *buffer, FAR int *k, FAR int *lean)
+{
+	int shift = -mp.e;
+	uint64_t one = (uint64_t)1 << shift;
+	uint64_t wp_w = mp.f - w.f;
+	uint32_t p1 = (uint32_t)(mp.f >> shift);
+	uint64_t p2 = mp.f & (one - 1);
+	int kappa;
+	int len = 0;
+
+	/* Count the digits of the integral part */
+
+	for (kappa = 1; kappa < 10 && p1 >= g_dtoa_pow10[kappa]; kappa++) ;
+
+	/* Integral part */
+
+	while (kappa > 0) {
+		uint32_t div = (uint32_t)g_dtoa_pow10[kappa - 1];
+		uint32_t d = p1 / div;
+		uint64_t rest;
+
+		p1 %= div;
+		if (d || len) {
+			buffer[len++] = (char)('0' + d);
+		}
+
+		kappa--;
+		rest = ((uint64_t)p1 << shift) + p2;
+		if (rest <= delta) {
+			*k += kappa;
+			rest = dtoa_round_weed(buffer, len, delta, rest, g_dtoa_pow10[kappa] << shift, wp_w);
+			*lean = dtoa_lean(rest, wp_w, 2);
+			return len;
+		}
+	}
+
+	/* Fractional part */
+
+	for (;;) {
+		char d;
+
+		p2 *= 10;
+		delta *= 10;
+		d = (char)(p2 >> shift);
+		if (d || len) {
+			buffer[len++] = (char)('0' + d);
+		}
+
+		p2 &= one - 1;
+		kappa--;
+		if (p2 < delta) {
+			uint64_t unit = -kappa < (int)DTOA_NPOW10 ? g_dtoa_pow10[-kappa] : 0;
+
+			*k += kappa;
+			p2 = dtoa_round_weed(buffer, len, delta, p2, one, wp_w * unit);
+			*lean = dtoa_lean(p2, wp_w * unit, 2 * unit);
+			return len;
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: dtoa_decode
+ *
+ * Description:
+ *   Return the positive, finite double with the representation 'bits' as
+ *   f * 2^e, with the hidden bit in f unless it is subnormal.
+ *
+ ****************************************************************************/
+
+static struct dtoa_diyfp_s dtoa_decode(uint64_t bits)
+{
+	struct dtoa_diyfp_s v;
+	int biased = (int)((bits & DTOA_EXPONENT_MASK) >> DTOA_EXPONENT_SHIFT);
+
+	if (biased != 0) {
+		v.f = (bits & DTOA_FRACTION_MASK) | DTOA_HIDDEN_BIT;
+		v.e = biased - DTOA_EXPONENT_BIAS;
+	} else {
+		v.f = bits & DTOA_FRACTION_MASK;
+		v.e = DTOA_EXPONENT_MIN;
+	}
+
+	return v;
+}
+
+/****************************************************************************
+ * Name: dtoa_grisu2
+ *
+ * Description:
+ *   Convert the positive, finite, non-zero double with the representation
+ *   'bits' to the shortest digit string d1 d2 ... dn such that
+ *   0.d1d2...dn * 10^decpt reads back as the same double.  Returns n.
+ *   *lean is 1 if the double is above that decimal value, -1 if it is
+ *   below and 0 if it is (as far as can be told) equal.
+ *
+ ****************************************************************************/
+
+static int dtoa_grisu2(uint64_t bits, FAR char *buffer, FAR int *decpt, FAR int *lean)
+{
+	struct dtoa_diyfp_s v;
+	struct dtoa_diyfp_s w;
+	struct dtoa_diyfp_s mplus;
+	struct dtoa_diyfp_s mminus;
+	struct dtoa_diyfp_s c;
+	int len;
+	int k;
+
+	v = dtoa_decode(bits);
+
+	/* The boundaries halfway to the neighbouring doubles.  The lower one is
+	 * closer if v is a power of two, since the exponent changes there.
+	 */
+
+	mplus.f = (v.f << 1) + 1;
+	mplus.e = v.e - 1;
+	mplus = dtoa_normalize(mplus);
+
+	if (v.f == DTOA_HIDDEN_BIT) {
+		mminus.f = (v.f << 2) - 1;
+		mminus.e = v.e - 2;
+	} else {
+		mminus.f = (v.f << 1) - 1;
+		mminus.e = v.e - 1;
+	}
+
+	mminus.f <<= mminus.e - mplus.e;
+	mminus.e = mplus.e;
+
+	/* Scale everything by a power of ten and generate the digits of the
+	 * upper boundary, narrowed by one unit on each side for safety.
+	 */
+
+	c = dtoa_cachedpow(mplus.e, &k);
+	w = dtoa_mul(dtoa_normalize(v), c);
+	mplus = dtoa_mul(mplus, c);
+	mminus = dtoa_mul(mminus, c);
+	mplus.f--;
+	mminus.f++;
+
+	len = dtoa_digitgen(w, mplus, mplus.f - mminus.f, buffer, &k, lean);
+	*decpt = len + k;
+	return len;
+}
+
+/****************************************************************************
+ * Name: dtoa_big_*
+ *
+ * Description:
+ *   The few operations on big integers that dtoa_exactlean() needs.
+ *
+ ****************************************************************************/
+
+static void dtoa_big_set(FAR struct dtoa_bigint_s *b, uint64_t n)
+{
+	b->word[0] = (uint32_t)n;
+	b->word[1] = (uint32_t)(n >> 32);
+	b->nwords = b->word[1] != 0 ? 2 : 1;
+}
+
+static void dtoa_big_mul(FAR struct dtoa_bigint_s *b, uint32_t m)
+{
+	uint64_t carry = 0;
+	int i;
+
+	for (i = 0; i < b->nwords; i++) {
+		carry += (uint64_t)b->word[i] * m;
+		b->word[i] = (uint32_t)carry;
+		carry >>= 32;
+	}
+
+	if (carry != 0 && b->nwords < DTOA_BIGWORDS) {
+		b->word[b->nwords++] = (uint32_t)carry;
+	}
+}
+
+static void dtoa_big_pow5(FAR struct dtoa_bigint_s *b, int n)
+{
+	/* 5^13 is the largest power of five that fits in 32 bits */
+
+	for (; n >= 13; n -= 13) {
+		dtoa_big_mul(b, 1220703125);
+	}
+
+	if (n > 0) {
+		dtoa_big_mul(b, (uint32_t)(g_dtoa_pow10[n] >> n));
+	}
+}
+
+static void dtoa_big_shl(FAR struct dtoa_bigint_s *b, int n)
+{
+	int nw = n / 32;
+	int nb = n % 32;
+	int i;
+
+	if (b->nwords + nw + 1 > DTOA_BIGWORDS) {
+		return;
+	}
+
+	b->word[b->nwords + nw] = 0;
+	for (i = b->nwords - 1; i >= 0; i--) {
+		if (nb != 0) {
+			b->word[i + nw + 1] |= b->word[i] >> (32 - nb);
+		}
+
+		b->word[i + nw] = b->word[i] << nb;
+	}
+
+	for (i = 0; i < nw; i++) {
+		b->word[i] = 0;
+	}
+
+	b->nwords += nw + 1;
+	while (b->nwords > 1 && b->word[b->nwords - 1] == 0) {
+		b->nwords--;
+	}
+}
+
+static int dtoa_big_cmp(FAR const struct dtoa_bigint_s *a, FAR const struct dtoa_bigint_s *b)
+{
+	int i;
+
+	if (a->nwords != b->nwords) {
+		return a->nwords > b->nwords ? 1 : -1;
+	}
+
+	for (i = a->nwords - 1; i >= 0; i--) {
+		if (a->word[i] != b->word[i]) {
+			return a->word[i] > b->word[i] ? 1 : -1;
+		}
+	}
+
+	return 0;
+}
+
+/****************************************************************************
+ * Name: dtoa_exactlean
+ *
+ * Description:
+ *   Tell exactly whether the double with the representation 'bits' is
+ *   above (1), below (-1) or equal to (0) the decimal value
+ *   0.d1d2...dn * 10^decpt.  This is only needed for the rare ties that
+ *   lie within the uncertainty of Grisu2's lean.
+ *
+ ****************************************************************************/
+
+static int dtoa_exactlean(uint64_t bits, FAR const char *digits, int ndigits, int decpt)
+{
+	struct dtoa_bigint_s value;
+	struct dtoa_bigint_s decimal;
+	struct dtoa_diyfp_s v = dtoa_decode(bits);
+	uint64_t d = 0;
+	int q = decpt - ndigits;
+	int i;
+
+	for (i = 0; i < ndigits; i++) {
+		d = d * 10 + (uint64_t)(digits[i] - '0');
+	}
+
+	/* Compare f * 2^e with d * 10^q = d * 5^q * 2^q as integers */
+
+	dtoa_big_set(&value, v.f);
+	dtoa_big_set(&decimal, d);
+
+	if (q > 0) {
+		dtoa_big_pow5(&decimal, q);
+	} else {
+		dtoa_big_pow5(&value, -q);
+	}
+
+	if (v.e > q) {
+		dtoa_big_shl(&value, v.e - q);
+	} else {
+		dtoa_big_shl(&decimal, q - v.e);
+	}
+
+	return dtoa_big_cmp(&value, &decimal);
+}
+
+/****************************************************************************
+ * Name: dtoa_round
+ *
+ * Description:
+ *   Round the 'ndigits' digits in 'digits' to 'keep' digits and drop any
+ *   trailing zeros.  If the digits dropped are exactly "5", 'lean' tells
+ *   whether the value itself is above or below the digits; if Grisu2 could
+ *   not tell, the value 'bits' is compared with the digits exactly.  A true
+ *   tie, like 0.125 to two places, is rounded to even.  Returns the new
+ *   number of digits, zero if the result is zero; a carry out of the first
+ *   digit increments *decpt.
+ *
+ ****************************************************************************/
+
+static int dtoa_round(FAR char *digits, int ndigits, int keep, int lean, uint64_t bits, FAR int *decpt)
+{
+	bool up;
+
+	if (keep < 0) {
+		return 0;
+	}
+
+	if (keep < ndigits) {
+		if (digits[keep] != '5' || ndigits > keep + 1) {
+			up = digits[keep] >= '5';
+		} else {
+			if (lean == 0) {
+				lean = dtoa_exactlean(bits, digits, ndigits, *decpt);
+			}
+
+			if (lean != 0) {
+				up = lean > 0;
+			} else {
+				up = keep > 0 && ((digits[keep - 1] - '0') & 1) != 0;
+			}
+		}
+
+		if (up) {
+			while (keep > 0 && digits[keep - 1] == '9') {
+				keep--;
+			}
+
+			if (keep == 0) {
+				/* Carry out of the first digit: 99.9 becomes 100 */
+
+				digits[0] = '1';
+				(*decpt)++;
+				return 1;
+			}
+
+			digits[keep - 1]++;
+		}
+	} else {
+		keep = ndigits;
+	}
+
+	while (keep > 0 && digits[keep - 1] == '0') {
+		keep--;
+	}
+
+	return keep;
+}
+
+/****************************************************************************
+ * Name: dtoa_putdigits
+ *
+ * Description:
+ *   Output the digits at positions [first, first + count) of the number
+ *   whose 'ndigits' digits are in 'digits', with zeros outside of them.
+ *
+ ****************************************************************************/
+
+static void dtoa_putdigits(FAR struct lib_outstream_s *obj, FAR const char *digits, int ndigits, int first, int count)
+{
+	int n;
+
+	if (first < 0) {
+		n = -first < count ? -first : count;
+		putpad(obj, '0', n);
+		first += n;
+		count -= n;
+	}
+
+	if (count > 0 && first < ndigits) {
+		n = ndigits - first < count ? ndigits - first : count;
+		lib_stream_puts(obj, &digits[first], n);
+		first += n;
+		count -= n;
+	}
+
+	putpad(obj, '0', count);
+}
+
+/****************************************************************************
+ * Name: dtoa_putfixed
+ *
+ * Description:
+ *   Output the number in the %f style with 'prec' fractional digits.
+ *
+ ****************************************************************************/
+
+static void dtoa_putfixed(FAR struct lib_outstream_s *obj, FAR const char *digits, int ndigits, int decpt, int prec, uint8_t flags)
+{
+	if (ndigits == 0 || decpt <= 0) {
+		obj->put(obj, '0');
+	} else {
+		dtoa_putdigits(obj, digits, ndigits, 0, decpt);
+	}
+
+	if (prec > 0 || IS_ALTFORM(flags)) {
+		obj->put(obj, '.');
+		dtoa_putdigits(obj, digits, ndigits, decpt, prec);
+	}
+}
+
+/****************************************************************************
+ * Name: dtoa_putexp
+ *
+ * Description:
+ *   Output the number in the %e style with 'prec' fractional digits.
+ *
+ ****************************************************************************/
+
+static void dtoa_putexp(FAR struct lib_outstream_s *obj, FAR const char *digits, int ndigits, int expt, int prec, uint8_t flags, bool upper)
+{
+	char buf[6];
+	FAR char *ptr = &buf[sizeof(buf)];
+	unsigned int uexp = expt < 0 ? -expt : expt;
+
+	dtoa_putdigits(obj, digits, ndigits, 0, 1);
+	if (prec > 0 || IS_ALTFORM(flags)) {
+		obj->put(obj, '.');
+		dtoa_putdigits(obj, digits, ndigits, 1, prec);
+	}
+
+	/* The exponent has at least two digits */
+
+	ptr = cvt_dec32(ptr, uexp);
+	if (uexp < 10) {
+		*--ptr = '0';
+	}
+
+	*--ptr = expt < 0 ? '-' : '+';
+	*--ptr = upper ? 'E' : 'e';
+	lib_stream_puts(obj, ptr, &buf[sizeof(buf)] - ptr);
+}
+
+/****************************************************************************
+ * Name: lib_dtoa
+ *
+ * Description:
+ *   This is part of lib_vsprintf().  It handles the %e, %E, %f, %g and %G
+ *   floating point formats as described by the C standard, except that the
+ *   digits come from the shortest representation of the value:  beyond
+ *   its last digit, zeros are printed.
+ *
+ * Input Parameters:
+ *   obj   - The output stream object
+ *   fmt   - The format character
+ *   prec  - The precision.  The default of 6 is used if no precision was
+ *           given in the format.
+ *   flags - The ALTFORM, SHOWPLUS and HASDOT flags are supported.
+ *   value - The floating point value to convert.
+ *
+ ****************************************************************************/
+
+static void lib_dtoa(FAR struct lib_outstream_s *obj, int fmt, int prec, uint8_t flags, double value)
+{
+	union {
+		double d;
+		uint64_t u;
+	} bits;
+	char digits[DTOA_BUFSIZE];
+	bool upper = (fmt == 'E' || fmt == 'G');
+	int ndigits;
+	int decpt;
+	int lean = 0;
+
+	bits.d = value;
+
+#ifndef CONFIG_NOPRINTF_FIELDWIDTH
+	if (!IS_HASDOT(flags) || prec < 0) {
+		prec = 6;
+	}
+#endif
+
+	if ((bits.u & DTOA_SIGN_BIT) != 0) {
+		obj->put(obj, '-');
+	} else if (IS_SHOWPLUS(flags)) {
+		obj->put(obj, '+');
+	}
+
+	/* Special handling for NaN and Infinity */
+
+	if ((bits.u & DTOA_EXPONENT_MASK) == DTOA_EXPONENT_MASK) {
+		if ((bits.u & DTOA_FRACTION_MASK) != 0) {
+			lib_stream_puts(obj, upper ? "NAN" : "nan", 3);
+		} else {
+			lib_stream_puts(obj, upper ? "INF" : "inf", 3);
+		}
+
+		return;
+	}
+
+	/* Get the shortest digits, or a single zero digit for zero */
+
+	if ((bits.u & ~DTOA_SIGN_BIT) == 0) {
+		digits[0] = '0';
+		ndigits = 1;
+		decpt = 1;
+	} else {
+		ndigits = dtoa_grisu2(bits.u & ~DTOA_SIGN_BIT, digits, &decpt, &lean);
+	}
+
+	if (fmt == 'f') {
+		ndigits = dtoa_round(digits, ndigits, decpt + prec, lean, bits.u & ~DTOA_SIGN_BIT, &decpt);
+		dtoa_putfixed(obj, digits, ndigits, decpt, prec, flags);
+	} else if (fmt == 'e' || fmt == 'E') {
+		ndigits = dtoa_round(digits, ndigits, prec + 1, lean, bits.u & ~DTOA_SIGN_BIT, &decpt);
+		dtoa_putexp(obj, digits, ndigits, digits[0] == '0' ? 0 : decpt - 1, prec, flags, upper);
+	} else {
+		/* %g: With P significant digits and X the exponent of the rounded
+		 * value, use the %f style with P - 1 - X fractional digits if
+		 * P > X >= -4, and the %e style with P - 1 otherwise.  Trailing
+		 * zeros are removed unless the alternate form was requested.
+		 */
+
+		int expt;
+
+		if (prec == 0) {
+			prec = 1;
+		}
+
+		if (digits[0] != '0') {
+			ndigits = dtoa_round(digits, ndigits, prec, lean, bits.u & ~DTOA_SIGN_BIT, &decpt);
+			expt = decpt - 1;
+		} else {
+			expt = 0;
+		}
+
+		if (prec > expt && expt >= -4) {
+			prec = prec - 1 - expt;
+			if (!IS_ALTFORM(flags) && prec > ndigits - decpt) {
+				prec = ndigits - decpt > 0 ? ndigits - decpt : 0;
+			}
+
+			dtoa_putfixed(obj, digits, ndigits, decpt, prec, flags);
+		} else {
+			prec = prec - 1;
+			if (!IS_ALTFORM(flags) && prec > ndigits - 1) {
+				prec = ndigits - 1;
+			}
+
+			dtoa_putexp(obj, digits, ndigits, expt, prec, flags, upper);
+		}
+	}
+}
@@ -0,0 +1,63 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * libc/stdio/lib_libstreamputs.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <assert.h>
+
+#include <tinyara/streams.h>
+
+#include "lib_internal.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_stream_puts
+ *
+ * Description:
+ *  Put 'len' characters from 'buf' to an output stream.  Streams that
+ *  provide a puts method receive the whole run in one call; others get it
+ *  one character at a time through their put method.
+ *
+ ****************************************************************************/
+
+void lib_stream_puts(FAR struct lib_outstream_s *this, FAR const char *buf, int len)
+{
+	DEBUGASSERT(this && (buf || len <= 0));
+
+	if (len <= 0) {
+		return;
+	}
+
+	if (this->puts) {
+		this->puts(this, buf, len);
+	} else {
+		while (len-- > 0) {
+			this->put(this, *buf++);
+		}
+	}
+}
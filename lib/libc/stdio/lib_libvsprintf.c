@@ -116,6 +116,16 @@
 #define IS_NEGATE(f)             (((f) & FLAG_NEGATE) != 0)
 #define IS_SIGNED(f)             (((f) & (FLAG_SHOWPLUS|FLAG_NEGATE)) != 0)
 
+/* The size of a buffer that holds any conversion of an unsigned integer of
+ * type 't'.  Binary, with one digit per bit, is the longest.
+ */
+
+#define CVT_BUFSIZE(t)           (8 * sizeof(t))
+
+/* Padding is written from a constant string in pieces of this size */
+
+#define PAD_CHUNK                16
+
 /* If CONFIG_ARCH_ROMGETC is defined, then it is assumed that the format
  * string data cannot be accessed by simply de-referencing the format string
  * pointer.  This might be in the case in Harvard architectures where string
@@ -143,6 +153,16 @@
 #define FMT_PREV     src--		/* Backup to the previous character */
 #endif
 
+/* Runs of regular characters are written to the stream in one piece.  With
+ * line buffering, a run must end at a newline so that it can be flushed.
+ */
+
+#ifdef CONFIG_STDIO_LINEBUFFER
+#define FMT_ENDRUN(c) ((c) == '\n')
+#else
+#define FMT_ENDRUN(c) false
+#endif
+
 /****************************************************************************
  * Private Type Declarations
  ****************************************************************************/
@@ -167,6 +187,10 @@ static int getsizesize(uint8_t fmt, uint8_t flags, FAR void *p)
 #endif							/* CONFIG_NOPRINTF_FIELDWIDTH */
 #endif							/* CONFIG_PTR_IS_NOT_INT */
 /* Unsigned int to ASCII conversion */
+static FAR char *cvt_dec32(FAR char *end, uint32_t n);
+#ifdef CONFIG_HAVE_LONG_LONG
+static FAR char *cvt_dec64(FAR char *end, unsigned long long n);
+#endif
 static void utodec(FAR struct lib_outstream_s *obj, unsigned int n);
 static void utohex(FAR struct lib_outstream_s *obj, unsigned int n, uint8_t a);
 static void utooct(FAR struct lib_outstream_s *obj, unsigned int n);
@@ -206,6 +230,9 @@ static int getllusize(uint8_t fmt, FAR uint8_t flags, FAR unsigned long long lln
 #endif
 #endif
 
+#if !defined(CONFIG_NOPRINTF_FIELDWIDTH) || defined(CONFIG_LIBC_FLOATINGPOINT)
+static void putpad(FAR struct lib_outstream_s *obj, char ch, int npad);
+#endif
 #ifndef CONFIG_NOPRINTF_FIELDWIDTH
 static void prejustify(FAR struct lib_outstream_s *obj, uint8_t fmt, uint8_t flags, int fieldwidth, int valwidth);
 static void postjustify(FAR struct lib_outstream_s *obj, uint8_t fmt, uint8_t flags, int fieldwidth, int valwidth);
@@ -225,6 +252,26 @@ static void postjustify(FAR struct lib_outstream_s *obj, uint8_t fmt, uint8_t fl
 
 static const char g_nullstring[] = "(null)";
 
+/* "00" through "99", for converting decimal numbers two digits at a time */
+
+static const char g_digitpairs[200] = {
+	'0', '0', '0', '1', '0', '2', '0', '3', '0', '4', '0', '5', '0', '6', '0', '7', '0', '8', '0', '9',
+	'1', '0', '1', '1', '1', '2', '1', '3', '1', '4', '1', '5', '1', '6', '1', '7', '1', '8', '1', '9',
+	'2', '0', '2', '1', '2', '2', '2', '3', '2', '4', '2', '5', '2', '6', '2', '7', '2', '8', '2', '9',
+	'3', '0', '3', '1', '3', '2', '3', '3', '3', '4', '3', '5', '3', '6', '3', '7', '3', '8', '3', '9',
+	'4', '0', '4', '1', '4', '2', '4', '3', '4', '4', '4', '5', '4', '6', '4', '7', '4', '8', '4', '9',
+	'5', '0', '5', '1', '5', '2', '5', '3', '5', '4', '5', '5', '5', '6', '5', '7', '5', '8', '5', '9',
+	'6', '0', '6', '1', '6', '2', '6', '3', '6', '4', '6', '5', '6', '6', '6', '7', '6', '8', '6', '9',
+	'7', '0', '7', '1', '7', '2', '7', '3', '7', '4', '7', '5', '7', '6', '7', '7', '7', '8', '7', '9',
+	'8', '0', '8', '1', '8', '2', '8', '3', '8', '4', '8', '5', '8', '6', '8', '7', '8', '8', '8', '9',
+	'9', '0', '9', '1', '9', '2', '9', '3', '9', '4', '9', '5', '9', '6', '9', '7', '9', '8', '9', '9'
+};
+
+#if !defined(CONFIG_NOPRINTF_FIELDWIDTH) || defined(CONFIG_LIBC_FLOATINGPOINT)
+static const char g_spacepad[PAD_CHUNK] = "                ";
+static const char g_zeropad[PAD_CHUNK] = "0000000000000000";
+#endif
+
 /****************************************************************************
  * Private Variables
  ****************************************************************************/
@@ -236,8 +283,12 @@ static const char g_nullstring[] = "(null)";
 /* Include floating point functions */
 
 #ifdef CONFIG_LIBC_FLOATINGPOINT
+#ifdef CONFIG_LIBC_DTOA_SHORTEST
+#include "stdio/lib_libgrisu.c"
+#else
 #include "stdio/lib_libdtoa.c"
 #endif
+#endif
 
 /****************************************************************************
  * Name: ptohex
@@ -250,6 +301,8 @@ static void ptohex(FAR struct lib_outstream_s *obj, uint8_t flags, FAR void *p)
 		uint32_t dw;
 		FAR void *p;
 	} u;
+	char buf[2 * sizeof(void *)];
+	FAR char *ptr;
 	uint8_t bits;
 
 	/* Check for alternate form */
@@ -257,21 +310,18 @@ static void ptohex(FAR struct lib_outstream_s *obj, uint8_t flags, FAR void *p)
 	if (IS_ALTFORM(flags)) {
 		/* Prefix the number with "0x" */
 
-		obj->put(obj, '0');
-		obj->put(obj, 'x');
+		lib_stream_puts(obj, "0x", 2);
 	}
 
 	u.dw = 0;
 	u.p = p;
 
-	for (bits = 8 * sizeof(void *); bits > 0; bits -= 4) {
+	for (bits = 8 * sizeof(void *), ptr = buf; bits > 0; bits -= 4) {
 		uint8_t nibble = (uint8_t)((u.dw >> (bits - 4)) & 0xf);
-		if (nibble < 10) {
-			obj->put(obj, nibble + '0');
-		} else {
-			obj->put(obj, nibble + 'a' - 10);
-		}
+		*ptr++ = (char)(nibble < 10 ? nibble + '0' : nibble + 'a' - 10);
 	}
+
+	lib_stream_puts(obj, buf, ptr - buf);
 }
 
 /****************************************************************************
@@ -292,46 +342,93 @@ static int getpsize(uint8_t flags, FAR void *p)
 #endif							/* CONFIG_PTR_IS_NOT_INT */
 
 /****************************************************************************
- * Name: utodec
+ * Name: cvt_dec32
+ *
+ * Description:
+ *   Convert 'n' to decimal, two digits at a time, into the characters that
+ *   end at 'end'.  Returns a pointer to the first digit.
+ *
  ****************************************************************************/
 
-static void utodec(FAR struct lib_outstream_s *obj, unsigned int n)
+static FAR char *cvt_dec32(FAR char *end, uint32_t n)
 {
-	unsigned int remainder = n % 10;
-	unsigned int dividend = n / 10;
+	FAR const char *pair;
+
+	while (n >= 100) {
+		pair = &g_digitpairs[(n % 100) * 2];
+		n /= 100;
+		*--end = pair[1];
+		*--end = pair[0];
+	}
 
-	if (dividend) {
-		utodec(obj, dividend);
+	if (n >= 10) {
+		pair = &g_digitpairs[n * 2];
+		*--end = pair[1];
+		*--end = pair[0];
+	} else {
+		*--end = (char)(n + '0');
 	}
 
-	obj->put(obj, (remainder + (unsigned int)'0'));
+	return end;
 }
 
 /****************************************************************************
- * Name: utohex
+ * Name: cvt_dec64
+ *
+ * Description:
+ *   Like cvt_dec32() for a 64-bit value.  Nine digits are split off at a
+ *   time so that most of the work uses 32-bit division, which is far
+ *   cheaper than the 64-bit library division on 32-bit targets.
+ *
  ****************************************************************************/
 
-static void utohex(FAR struct lib_outstream_s *obj, unsigned int n, uint8_t a)
+#ifdef CONFIG_HAVE_LONG_LONG
+static FAR char *cvt_dec64(FAR char *end, unsigned long long n)
 {
-	bool nonzero = false;
-	uint8_t bits;
+	while (n > UINT32_MAX) {
+		unsigned long long quotient = n / 1000000000;
+		FAR char *start = end - 9;
 
-	for (bits = 8 * sizeof(unsigned int); bits > 0; bits -= 4) {
-		uint8_t nibble = (uint8_t)((n >> (bits - 4)) & 0xf);
-		if (nibble || nonzero) {
-			nonzero = true;
-
-			if (nibble < 10) {
-				obj->put(obj, nibble + '0');
-			} else {
-				obj->put(obj, nibble + a - 10);
-			}
+		end = cvt_dec32(end, (uint32_t)(n - quotient * 1000000000));
+		while (end > start) {
+			*--end = '0';
 		}
-	}
 
-	if (!nonzero) {
-		obj->put(obj, '0');
+		n = quotient;
 	}
+
+	return cvt_dec32(end, (uint32_t)n);
+}
+#endif
+
+/****************************************************************************
+ * Name: utodec
+ ****************************************************************************/
+
+static void utodec(FAR struct lib_outstream_s *obj, unsigned int n)
+{
+	char buf[CVT_BUFSIZE(unsigned int)];
+	FAR char *ptr = cvt_dec32(&buf[sizeof(buf)], n);
+
+	lib_stream_puts(obj, ptr, &buf[sizeof(buf)] - ptr);
+}
+
+/****************************************************************************
+ * Name: utohex
+ ****************************************************************************/
+
+static void utohex(FAR struct lib_outstream_s *obj, unsigned int n, uint8_t a)
+{
+	char buf[CVT_BUFSIZE(unsigned int)];
+	FAR char *ptr = &buf[sizeof(buf)];
+
+	do {
+		uint8_t nibble = (uint8_t)(n & 0xf);
+		*--ptr = (char)(nibble < 10 ? nibble + '0' : nibble + a - 10);
+		n >>= 4;
+	} while (n);
+
+	lib_stream_puts(obj, ptr, &buf[sizeof(buf)] - ptr);
 }
 
 /****************************************************************************
@@ -340,14 +437,15 @@ static void utohex(FAR struct lib_outstream_s *obj, unsigned int n, uint8_t a)
 
 static void utooct(FAR struct lib_outstream_s *obj, unsigned int n)
 {
-	unsigned int remainder = n & 0x7;
-	unsigned int dividend = n >> 3;
+	char buf[CVT_BUFSIZE(unsigned int)];
+	FAR char *ptr = &buf[sizeof(buf)];
 
-	if (dividend) {
-		utooct(obj, dividend);
-	}
+	do {
+		*--ptr = (char)((n & 0x7) + '0');
+		n >>= 3;
+	} while (n);
 
-	obj->put(obj, (remainder + (unsigned int)'0'));
+	lib_stream_puts(obj, ptr, &buf[sizeof(buf)] - ptr);
 }
 
 /****************************************************************************
@@ -356,14 +454,15 @@ static void utooct(FAR struct lib_outstream_s *obj, unsigned int n)
 
 static void utobin(FAR struct lib_outstream_s *obj, unsigned int n)
 {
-	unsigned int remainder = n & 1;
-	unsigned int dividend = n >> 1;
+	char buf[CVT_BUFSIZE(unsigned int)];
+	FAR char *ptr = &buf[sizeof(buf)];
 
-	if (dividend) {
-		utobin(obj, dividend);
-	}
+	do {
+		*--ptr = (char)((n & 1) + '0');
+		n >>= 1;
+	} while (n);
 
-	obj->put(obj, (remainder + (unsigned int)'0'));
+	lib_stream_puts(obj, ptr, &buf[sizeof(buf)] - ptr);
 }
 
 /****************************************************************************
@@ -419,8 +518,7 @@ static void utoascii(FAR struct lib_outstream_s *obj, uint8_t fmt, uint8_t flags
 		if (IS_ALTFORM(flags)) {
 			/* Prefix the number with "0x" */
 
-			obj->put(obj, '0');
-			obj->put(obj, 'x');
+			lib_stream_puts(obj, "0x", 2);
 		}
 
 		/* Convert the unsigned value to a string. */
@@ -544,14 +642,19 @@ static int getdblsize(uint8_t fmt, int trunc, uint8_t flags, double n)
 
 static void lutodec(FAR struct lib_outstream_s *obj, unsigned long n)
 {
-	unsigned int remainder = n % 10;
-	unsigned long dividend = n / 10;
+	char buf[CVT_BUFSIZE(unsigned long)];
+	FAR char *ptr;
 
-	if (dividend) {
-		lutodec(obj, dividend);
+#ifdef CONFIG_HAVE_LONG_LONG
+	if (sizeof(unsigned long) > sizeof(uint32_t)) {
+		ptr = cvt_dec64(&buf[sizeof(buf)], n);
+	} else
+#endif
+	{
+		ptr = cvt_dec32(&buf[sizeof(buf)], (uint32_t)n);
 	}
 
-	obj->put(obj, (remainder + (unsigned int)'0'));
+	lib_stream_puts(obj, ptr, &buf[sizeof(buf)] - ptr);
 }
 
 /****************************************************************************
@@ -560,25 +663,16 @@ static void lutodec(FAR struct lib_outstream_s *obj, unsigned long n)
 
 static void lutohex(FAR struct lib_outstream_s *obj, unsigned long n, uint8_t a)
 {
-	bool nonzero = false;
-	uint8_t bits;
+	char buf[CVT_BUFSIZE(unsigned long)];
+	FAR char *ptr = &buf[sizeof(buf)];
 
-	for (bits = 8 * sizeof(unsigned long); bits > 0; bits -= 4) {
-		uint8_t nibble = (uint8_t)((n >> (bits - 4)) & 0xf);
-		if (nibble || nonzero) {
-			nonzero = true;
+	do {
+		uint8_t nibble = (uint8_t)(n & 0xf);
+		*--ptr = (char)(nibble < 10 ? nibble + '0' : nibble + a - 10);
+		n >>= 4;
+	} while (n);
 
-			if (nibble < 10) {
-				obj->put(obj, nibble + '0');
-			} else {
-				obj->put(obj, nibble + a - 10);
-			}
-		}
-	}
-
-	if (!nonzero) {
-		obj->put(obj, '0');
-	}
+	lib_stream_puts(obj, ptr, &buf[sizeof(buf)] - ptr);
 }
 
 /****************************************************************************
@@ -587,14 +681,15 @@ static void lutohex(FAR struct lib_outstream_s *obj, unsigned long n, uint8_t a)
 
 static void lutooct(FAR struct lib_outstream_s *obj, unsigned long n)
 {
-	unsigned int remainder = n & 0x7;
-	unsigned long dividend = n >> 3;
+	char buf[CVT_BUFSIZE(unsigned long)];
+	FAR char *ptr = &buf[sizeof(buf)];
 
-	if (dividend) {
-		lutooct(obj, dividend);
-	}
+	do {
+		*--ptr = (char)((n & 0x7) + '0');
+		n >>= 3;
+	} while (n);
 
-	obj->put(obj, (remainder + (unsigned int)'0'));
+	lib_stream_puts(obj, ptr, &buf[sizeof(buf)] - ptr);
 }
 
 /****************************************************************************
@@ -603,14 +698,15 @@ static void lutooct(FAR struct lib_outstream_s *obj, unsigned long n)
 
 static void lutobin(FAR struct lib_outstream_s *obj, unsigned long n)
 {
-	unsigned int remainder = n & 1;
-	unsigned long dividend = n >> 1;
+	char buf[CVT_BUFSIZE(unsigned long)];
+	FAR char *ptr = &buf[sizeof(buf)];
 
-	if (dividend) {
-		lutobin(obj, dividend);
-	}
+	do {
+		*--ptr = (char)((n & 1) + '0');
+		n >>= 1;
+	} while (n);
 
-	obj->put(obj, (remainder + (unsigned int)'0'));
+	lib_stream_puts(obj, ptr, &buf[sizeof(buf)] - ptr);
 }
 
 /****************************************************************************
@@ -663,8 +759,7 @@ static void lutoascii(FAR struct lib_outstream_s *obj, uint8_t fmt, uint8_t flag
 		if (IS_ALTFORM(flags)) {
 			/* Prefix the number with "0x" */
 
-			obj->put(obj, '0');
-			obj->put(obj, 'x');
+			lib_stream_puts(obj, "0x", 2);
 		}
 
 		/* Convert the unsigned value to a string. */
@@ -773,14 +868,10 @@ static int getlusize(uint8_t fmt, uint8_t flags, unsigned long ln)
 
 static void llutodec(FAR struct lib_outstream_s *obj, unsigned long long n)
 {
-	unsigned int remainder = n % 10;
-	unsigned long long dividend = n / 10;
-
-	if (dividend) {
-		llutodec(obj, dividend);
-	}
+	char buf[CVT_BUFSIZE(unsigned long long)];
+	FAR char *ptr = cvt_dec64(&buf[sizeof(buf)], n);
 
-	obj->put(obj, (remainder + (unsigned int)'0'));
+	lib_stream_puts(obj, ptr, &buf[sizeof(buf)] - ptr);
 }
 
 /****************************************************************************
@@ -789,25 +880,16 @@ static void llutodec(FAR struct lib_outstream_s *obj, unsigned long long n)
 
 static void llutohex(FAR struct lib_outstream_s *obj, unsigned long long n, uint8_t a)
 {
-	bool nonzero = false;
-	uint8_t bits;
+	char buf[CVT_BUFSIZE(unsigned long long)];
+	FAR char *ptr = &buf[sizeof(buf)];
 
-	for (bits = 8 * sizeof(unsigned long long); bits > 0; bits -= 4) {
-		uint8_t nibble = (uint8_t)((n >> (bits - 4)) & 0xf);
-		if (nibble || nonzero) {
-			nonzero = true;
-
-			if (nibble < 10) {
-				obj->put(obj, (nibble + '0'));
-			} else {
-				obj->put(obj, (nibble + a - 10));
-			}
-		}
-	}
+	do {
+		uint8_t nibble = (uint8_t)(n & 0xf);
+		*--ptr = (char)(nibble < 10 ? nibble + '0' : nibble + a - 10);
+		n >>= 4;
+	} while (n);
 
-	if (!nonzero) {
-		obj->put(obj, '0');
-	}
+	lib_stream_puts(obj, ptr, &buf[sizeof(buf)] - ptr);
 }
 
 /****************************************************************************
@@ -816,14 +898,15 @@ static void llutohex(FAR struct lib_outstream_s *obj, unsigned long long n, uint
 
 static void llutooct(FAR struct lib_outstream_s *obj, unsigned long long n)
 {
-	unsigned int remainder = n & 0x7;
-	unsigned long long dividend = n >> 3;
+	char buf[CVT_BUFSIZE(unsigned long long)];
+	FAR char *ptr = &buf[sizeof(buf)];
 
-	if (dividend) {
-		llutooct(obj, dividend);
-	}
+	do {
+		*--ptr = (char)((n & 0x7) + '0');
+		n >>= 3;
+	} while (n);
 
-	obj->put(obj, (remainder + (unsigned int)'0'));
+	lib_stream_puts(obj, ptr, &buf[sizeof(buf)] - ptr);
 }
 
 /****************************************************************************
@@ -832,14 +915,15 @@ static void llutooct(FAR struct lib_outstream_s *obj, unsigned long long n)
 
 static void llutobin(FAR struct lib_outstream_s *obj, unsigned long long n)
 {
-	unsigned int remainder = n & 1;
-	unsigned long long dividend = n >> 1;
+	char buf[CVT_BUFSIZE(unsigned long long)];
+	FAR char *ptr = &buf[sizeof(buf)];
 
-	if (dividend) {
-		llutobin(obj, dividend);
-	}
+	do {
+		*--ptr = (char)((n & 1) + '0');
+		n >>= 1;
+	} while (n);
 
-	obj->put(obj, (remainder + (unsigned int)'0'));
+	lib_stream_puts(obj, ptr, &buf[sizeof(buf)] - ptr);
 }
 
 /****************************************************************************
@@ -892,8 +976,7 @@ static void llutoascii(FAR struct lib_outstream_s *obj, uint8_t fmt, uint8_t fla
 		if (IS_ALTFORM(flags)) {
 			/* Prefix the number with "0x" */
 
-			obj->put(obj, '0');
-			obj->put(obj, 'x');
+			lib_stream_puts(obj, "0x", 2);
 		}
 
 		/* Convert the unsigned value to a string. */
@@ -995,6 +1078,23 @@ static int getllusize(uint8_t fmt, uint8_t flags, unsigned long long lln)
 #endif							/* CONFIG_NOPRINTF_FIELDWIDTH */
 #endif							/* CONFIG_HAVE_LONG_LONG */
 
+/****************************************************************************
+ * Name: putpad
+ ****************************************************************************/
+
+#if !defined(CONFIG_NOPRINTF_FIELDWIDTH) || defined(CONFIG_LIBC_FLOATINGPOINT)
+static void putpad(FAR struct lib_outstream_s *obj, char ch, int npad)
+{
+	FAR const char *pad = (ch == '0') ? g_zeropad : g_spacepad;
+
+	while (npad > 0) {
+		int chunk = npad < PAD_CHUNK ? npad : PAD_CHUNK;
+		lib_stream_puts(obj, pad, chunk);
+		npad -= chunk;
+	}
+}
+#endif
+
 /****************************************************************************
  * Name: prejustify
  ****************************************************************************/
@@ -1002,7 +1102,6 @@ static int getllusize(uint8_t fmt, uint8_t flags, unsigned long long lln)
 #ifndef CONFIG_NOPRINTF_FIELDWIDTH
 static void prejustify(FAR struct lib_outstream_s *obj, uint8_t fmt, uint8_t flags, int fieldwidth, int valwidth)
 {
-	int i;
 
 	switch (fmt) {
 	default:
@@ -1011,9 +1110,7 @@ static void prejustify(FAR struct lib_outstream_s *obj, uint8_t fmt, uint8_t fla
 			valwidth++;
 		}
 
-		for (i = fieldwidth - valwidth; i > 0; i--) {
-			obj->put(obj, ' ');
-		}
+		putpad(obj, ' ', fieldwidth - valwidth);
 
 		if (IS_NEGATE(flags)) {
 			obj->put(obj, '-');
@@ -1031,9 +1128,7 @@ static void prejustify(FAR struct lib_outstream_s *obj, uint8_t fmt, uint8_t fla
 			valwidth++;
 		}
 
-		for (i = fieldwidth - valwidth; i > 0; i--) {
-			obj->put(obj, '0');
-		}
+		putpad(obj, '0', fieldwidth - valwidth);
 		break;
 
 	case FMT_LJUST:
@@ -1054,8 +1149,6 @@ static void prejustify(FAR struct lib_outstream_s *obj, uint8_t fmt, uint8_t fla
 #ifndef CONFIG_NOPRINTF_FIELDWIDTH
 static void postjustify(FAR struct lib_outstream_s *obj, uint8_t fmt, uint8_t flags, int fieldwidth, int valwidth)
 {
-	int i;
-
 	/* Apply field justification to the integer value. */
 
 	switch (fmt) {
@@ -1069,9 +1162,7 @@ static void postjustify(FAR struct lib_outstream_s *obj, uint8_t fmt, uint8_t fl
 			valwidth++;
 		}
 
-		for (i = fieldwidth - valwidth; i > 0; i--) {
-			obj->put(obj, ' ');
-		}
+		putpad(obj, ' ', fieldwidth - valwidth);
 		break;
 	}
 }
@@ -1104,9 +1195,24 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const char *src, va_list a
 		/* Just copy regular characters */
 
 		if (FMT_CHAR != '%') {
+#ifdef CONFIG_ARCH_ROMGETC
 			/* Output the character */
 
 			obj->put(obj, FMT_CHAR);
+#else
+			/* Output the whole run of regular characters up to the next
+			 * format specifier at once.  With line buffering, the run also
+			 * ends after a newline so that it can be flushed below.
+			 */
+
+			FAR const char *run = src;
+
+			while (src[1] != '\0' && src[1] != '%' && !FMT_ENDRUN(src[0])) {
+				src++;
+			}
+
+			lib_stream_puts(obj, run, src - run + 1);
+#endif
 
 			/* Flush the buffer if a newline is encountered */
 
@@ -1252,9 +1358,8 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const char *src, va_list a
 		/* Check for the string format. */
 
 		if (FMT_CHAR == 's') {
-#ifndef CONFIG_NOPRINTF_FIELDWIDTH
 			int swidth;
-#endif
+
 			/* Get the string to output */
 
 			ptmp = va_arg(ap, char *);
@@ -1266,16 +1371,13 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const char *src, va_list a
 			 * operations.
 			 */
 
-#ifndef CONFIG_NOPRINTF_FIELDWIDTH
 			swidth = strlen(ptmp);
+#ifndef CONFIG_NOPRINTF_FIELDWIDTH
 			prejustify(obj, fmt, 0, width, swidth);
 #endif
 			/* Concatenate the string into the output */
 
-			while (*ptmp) {
-				obj->put(obj, *ptmp);
-				ptmp++;
-			}
+			lib_stream_puts(obj, ptmp, swidth);
 
 			/* Perform left-justification operations. */
 
@@ -1466,11 +1568,15 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const char *src, va_list a
 		else if (strchr("eEfgG", FMT_CHAR)) {
 #ifndef CONFIG_NOPRINTF_FIELDWIDTH
 			double dblval = va_arg(ap, double);
-			int dblsize;
+			int dblsize = 0;
 
-			/* Get the width of the output */
+			/* Get the width of the output.  That takes a second conversion,
+			 * so skip it if there is no field width to fill.
+			 */
 
-			dblsize = getdblsize(FMT_CHAR, trunc, flags, dblval);
+			if (width > 0) {
+				dblsize = getdblsize(FMT_CHAR, trunc, flags, dblval);
+			}
 
 			/* Perform left field justification actions */
 
@@ -54,6 +54,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <string.h>
 #include <assert.h>
 
 #include "lib_internal.h"
@@ -84,6 +85,33 @@ static void memoutstream_putc(FAR struct lib_outstream_s *this, int ch)
 	}
 }
 
+/****************************************************************************
+ * Name: memoutstream_puts
+ ****************************************************************************/
+
+static void memoutstream_puts(FAR struct lib_outstream_s *this, FAR const char *buf, int len)
+{
+	FAR struct lib_memoutstream_s *mthis = (FAR struct lib_memoutstream_s *)this;
+	int nfree;
+
+	DEBUGASSERT(this);
+
+	/* Copy as much of the run as fits, silently dropping the rest just as
+	 * memoutstream_putc() does.
+	 */
+
+	nfree = (int)mthis->buflen - this->nput;
+	if (len > nfree) {
+		len = nfree;
+	}
+
+	if (len > 0) {
+		memcpy(&mthis->buffer[this->nput], buf, len);
+		this->nput += len;
+		mthis->buffer[this->nput] = '\0';
+	}
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -108,6 +136,7 @@ static void memoutstream_putc(FAR struct lib_outstream_s *this, int ch)
 void lib_memoutstream(FAR struct lib_memoutstream_s *outstream, FAR char *bufstart, int buflen)
 {
 	outstream->public.put = memoutstream_putc;
+	outstream->public.puts = memoutstream_puts;
 #ifdef CONFIG_STDIO_LINEBUFFER
 	outstream->public.flush = lib_noflush;
 #endif
@@ -54,6 +54,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdbool.h>
+#include <string.h>
 #include <fcntl.h>
 #include <assert.h>
 #include <errno.h>
@@ -92,6 +94,42 @@ static void stdoutstream_putc(FAR struct lib_outstream_s *this, int ch)
 	} while (get_errno() == EINTR);
 }
 
+/****************************************************************************
+ * Name: stdoutstream_puts
+ ****************************************************************************/
+
+static void stdoutstream_puts(FAR struct lib_outstream_s *this, FAR const char *buf, int len)
+{
+	FAR struct lib_stdoutstream_s *sthis = (FAR struct lib_stdoutstream_s *)this;
+#ifdef CONFIG_STDIO_LINEBUFFER
+	bool newline = memchr(buf, '\n', len) != NULL;
+#endif
+	ssize_t nwritten;
+
+	DEBUGASSERT(this && sthis->stream);
+
+	/* Loop until the whole run is buffered or an irrecoverable error occurs */
+
+	while (len > 0) {
+		nwritten = lib_fwrite(buf, len, sthis->stream);
+		if (nwritten > 0) {
+			this->nput += nwritten;
+			buf += nwritten;
+			len -= nwritten;
+		} else if (nwritten == 0 || get_errno() != EINTR) {
+			return;
+		}
+	}
+
+#ifdef CONFIG_STDIO_LINEBUFFER
+	/* Flush the buffer if the run held a newline, as fputc() would have */
+
+	if (newline) {
+		(void)lib_fflush(sthis->stream, true);
+	}
+#endif
+}
+
 /****************************************************************************
  * Name: stdoutstream_flush
  ****************************************************************************/
@@ -130,6 +168,7 @@ void lib_stdoutstream(FAR struct lib_stdoutstream_s *outstream, FAR FILE *stream
 	/* Select the put operation */
 
 	outstream->public.put = stdoutstream_putc;
+	outstream->public.puts = stdoutstream_puts;
 
 	/* Select the correct flush operation.  This flush is only called when
 	 * a newline is encountered in the output stream.  However, we do not
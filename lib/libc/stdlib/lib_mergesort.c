@@ -0,0 +1,356 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * libc/stdlib/lib_mergesort.c
+ *
+ * A stable sort with the interface of the BSD mergesort():  Runs of
+ * MSORT_RUN elements are insertion sorted and then merged bottom-up.  A
+ * merge copies the shorter of its two runs to a buffer of nmemb / 2
+ * elements.  If that buffer cannot be allocated, the runs are merged in
+ * place by rotations instead, which needs more element moves but no
+ * memory, so that the sort never fails for lack of memory.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "lib_internal.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Runs of up to MSORT_RUN elements are sorted by insertion */
+
+#define MSORT_RUN 16
+
+#define MSORT_ELEM(s, i) ((s)->base + (i) * (s)->size)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct msort_s {
+	FAR char *base;				/* The array */
+	FAR char *buffer;			/* nmemb / 2 elements, or NULL */
+	size_t size;				/* The size of one element */
+	bool words;					/* Elements are whole, aligned longs */
+	CODE int (*compar)(FAR const void *, FAR const void *);
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void msort_swap(FAR struct msort_s *s, size_t i, size_t j)
+{
+	size_t n;
+
+	if (s->words) {
+		FAR long *pi = (FAR long *)MSORT_ELEM(s, i);
+		FAR long *pj = (FAR long *)MSORT_ELEM(s, j);
+
+		for (n = s->size / sizeof(long); n > 0; n--) {
+			long t = *pi;
+			*pi++ = *pj;
+			*pj++ = t;
+		}
+	} else {
+		FAR char *pi = MSORT_ELEM(s, i);
+		FAR char *pj = MSORT_ELEM(s, j);
+
+		for (n = s->size; n > 0; n--) {
+			char t = *pi;
+			*pi++ = *pj;
+			*pj++ = t;
+		}
+	}
+}
+
+/* Compare elements i and j of the array */
+
+static int msort_cmp(FAR struct msort_s *s, size_t i, size_t j)
+{
+	return s->compar(MSORT_ELEM(s, i), MSORT_ELEM(s, j));
+}
+
+/****************************************************************************
+ * Name: msort_insertion
+ *
+ * Description:
+ *   Sort the 'n' elements from 'lo' by insertion.  An element only moves
+ *   past elements that are greater, which keeps equal elements in order.
+ *
+ ****************************************************************************/
+
+static void msort_insertion(FAR struct msort_s *s, size_t lo, size_t n)
+{
+	size_t i;
+	size_t j;
+
+	for (i = lo + 1; i < lo + n; i++) {
+		for (j = i; j > lo && msort_cmp(s, j - 1, j) > 0; j--) {
+			msort_swap(s, j - 1, j);
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: msort_merge_buffered
+ *
+ * Description:
+ *   Merge the sorted runs of 'nl' elements at 'lo' and of 'nr' elements
+ *   after it, copying the shorter run to the buffer.  Where elements are
+ *   equal, the one from the left run goes first.
+ *
+ ****************************************************************************/
+
+static void msort_merge_buffered(FAR struct msort_s *s, size_t lo, size_t nl, size_t nr)
+{
+	FAR char *left = MSORT_ELEM(s, lo);
+	FAR char *right = left + nl * s->size;
+	FAR char *buf = s->buffer;
+	size_t size = s->size;
+
+	if (nl <= nr) {
+		/* Merge forwards from the buffered left run */
+
+		FAR char *bufend = buf + nl * size;
+		FAR char *end = right + nr * size;
+		FAR char *out = left;
+
+		memcpy(buf, left, nl * size);
+		while (buf < bufend && right < end) {
+			if (s->compar(right, buf) < 0) {
+				memcpy(out, right, size);
+				right += size;
+			} else {
+				memcpy(out, buf, size);
+				buf += size;
+			}
+
+			out += size;
+		}
+
+		memcpy(out, buf, bufend - buf);
+	} else {
+		/* Merge backwards from the buffered right run */
+
+		FAR char *bufend = buf + nr * size;
+		FAR char *out = right + nr * size;
+
+		memcpy(buf, right, nr * size);
+		while (bufend > buf && right > left) {
+			out -= size;
+			if (s->compar(right - size, bufend - size) > 0) {
+				right -= size;
+				memcpy(out, right, size);
+			} else {
+				bufend -= size;
+				memcpy(out, bufend, size);
+			}
+		}
+
+		memcpy(left, buf, bufend - buf);
+	}
+}
+
+/****************************************************************************
+ * Name: msort_rotate
+ *
+ * Description:
+ *   Exchange the 'nl' elements at 'lo' with the 'nr' elements after them,
+ *   keeping the order within each group, by three reversals.
+ *
+ ****************************************************************************/
+
+static void msort_reverse(FAR struct msort_s *s, size_t lo, size_t hi)
+{
+	while (lo + 1 < hi) {
+		msort_swap(s, lo++, --hi);
+	}
+}
+
+static void msort_rotate(FAR struct msort_s *s, size_t lo, size_t nl, size_t nr)
+{
+	msort_reverse(s, lo, lo + nl);
+	msort_reverse(s, lo + nl, lo + nl + nr);
+	msort_reverse(s, lo, lo + nl + nr);
+}
+
+/****************************************************************************
+ * Name: msort_merge_inplace
+ *
+ * Description:
+ *   Merge like msort_merge_buffered() without a buffer:  Split the longer
+ *   run in half, split the other run where the middle element would go,
+ *   rotate the two middle pieces into place and merge the two halves.  The
+ *   first half is merged recursively and the second one iteratively, so
+ *   the recursion is at most about 2 * log2(nl + nr) deep.
+ *
+ ****************************************************************************/
+
+static void msort_merge_inplace(FAR struct msort_s *s, size_t lo, size_t nl, size_t nr)
+{
+	while (nl > 0 && nr > 0) {
+		size_t mid = lo + nl;
+		size_t cutl;
+		size_t cutr;
+		size_t first;
+		size_t last;
+
+		if (nl + nr == 2) {
+			if (msort_cmp(s, mid, lo) < 0) {
+				msort_swap(s, lo, mid);
+			}
+
+			return;
+		}
+
+		if (nl >= nr) {
+			/* cutr is the first element of the right run not less than
+			 * the middle element of the left run.
+			 */
+
+			cutl = nl / 2;
+			first = 0;
+			last = nr;
+			while (first < last) {
+				size_t probe = first + (last - first) / 2;
+
+				if (msort_cmp(s, mid + probe, lo + cutl) < 0) {
+					first = probe + 1;
+				} else {
+					last = probe;
+				}
+			}
+
+			cutr = first;
+		} else {
+			/* cutl is the first element of the left run greater than the
+			 * middle element of the right run.
+			 */
+
+			cutr = nr / 2;
+			first = 0;
+			last = nl;
+			while (first < last) {
+				size_t probe = first + (last - first) / 2;
+
+				if (msort_cmp(s, lo + probe, mid + cutr) <= 0) {
+					first = probe + 1;
+				} else {
+					last = probe;
+				}
+			}
+
+			cutl = first;
+		}
+
+		msort_rotate(s, lo + cutl, nl - cutl, cutr);
+		msort_merge_inplace(s, lo, cutl, cutr);
+
+		lo += cutl + cutr;
+		nl -= cutl;
+		nr -= cutr;
+	}
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mergesort
+ *
+ * Description:
+ *   Sort the 'nmemb' elements of 'size' bytes at 'base' in the order given
+ *   by 'compar', like qsort(), but keep elements that compare equal in
+ *   their original order.
+ *
+ * Returned Value:
+ *   Zero on success.  -1 with errno set to EINVAL if 'size' is zero.
+ *
+ ****************************************************************************/
+
+int mergesort(FAR void *base, size_t nmemb, size_t size, CODE int (*compar)(FAR const void *, FAR const void *))
+{
+	struct msort_s s;
+	size_t width;
+	size_t lo;
+	size_t n;
+
+	if (size == 0) {
+		set_errno(EINVAL);
+		return -1;
+	}
+
+	if (nmemb < 2) {
+		return 0;
+	}
+
+	s.base = (FAR char *)base;
+	s.size = size;
+	s.words = ((uintptr_t)base % sizeof(long)) == 0 && (size % sizeof(long)) == 0;
+	s.compar = compar;
+	s.buffer = NULL;
+
+	if (nmemb > MSORT_RUN) {
+		s.buffer = (FAR char *)lib_malloc((nmemb / 2) * size);
+	}
+
+	for (lo = 0; lo < nmemb; lo += MSORT_RUN) {
+		n = nmemb - lo < MSORT_RUN ? nmemb - lo : MSORT_RUN;
+		msort_insertion(&s, lo, n);
+	}
+
+	for (width = MSORT_RUN; width < nmemb; width *= 2) {
+		for (lo = 0; lo + width < nmemb; lo += 2 * width) {
+			n = nmemb - lo - width < width ? nmemb - lo - width : width;
+
+			/* Nothing to do if the runs are already in order */
+
+			if (msort_cmp(&s, lo + width - 1, lo + width) <= 0) {
+				continue;
+			}
+
+			if (s.buffer != NULL) {
+				msort_merge_buffered(&s, lo, width, n);
+			} else {
+				msort_merge_inplace(&s, lo, width, n);
+			}
+		}
+	}
+
+	if (s.buffer != NULL) {
+		lib_free(s.buffer);
+	}
+
+	return 0;
+}
@@ -64,13 +64,47 @@
 #include <tinyara/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <assert.h>
 
 /****************************************************************************
  * Preprocessor Definitions
  ****************************************************************************/
 
-#define min(a, b)  (a) < (b) ? a : b
+#define min(a, b)  ((a) < (b) ? (a) : (b))
+
+/* Partitions of up to QSORT_INSERTION elements are insertion sorted.  The
+ * pivot is the median of three elements, or above QSORT_NINTHER elements
+ * Tukey's ninther, the median of three medians of three.
+ */
+
+#define QSORT_INSERTION  12
+#define QSORT_NINTHER    40
+
+/* If partitioning did not exchange any elements, the input may well be
+ * sorted already.  Both partitions are then insertion sorted, giving up
+ * after QSORT_PARTIAL moves.
+ */
+
+#define QSORT_PARTIAL    8
+
+/* The partition that is not sorted next is pushed on an explicit stack.
+ * Since that is always the larger one, the stack never holds more than
+ * log2(nmemb) partitions.
+ */
+
+#define QSORT_STACKSIZE  (8 * sizeof(size_t))
+
+/* How elements are swapped:  One long at a time if they are exactly one
+ * long (SWAP_WORD), several longs if they are a multiple of its size and
+ * aligned (SWAP_WORDS), otherwise byte by byte (SWAP_BYTES).
+ */
+
+#define SWAP_WORD        0
+#define SWAP_WORDS       1
+#define SWAP_BYTES       2
 
 #define swapcode(TYPE, parmi, parmj, n) \
 	do { \
@@ -86,10 +120,10 @@
 
 #define SWAPINIT(a, size) \
 	swaptype = ((char *)a - (char *)0) % sizeof(long) || \
-	size % sizeof(long) ? 2 : size == sizeof(long) ? 0 : 1;
+	size % sizeof(long) ? SWAP_BYTES : size == sizeof(long) ? SWAP_WORD : SWAP_WORDS;
 
 #define swap(a, b) \
-	if (swaptype == 0) { \
+	if (swaptype == SWAP_WORD) { \
 		long t = *(long *)(a); \
 		*(long *)(a) = *(long *)(b); \
 		*(long *)(b) = t; \
@@ -99,25 +133,38 @@
 
 #define vecswap(a, b, n) if ((n) > 0) swapfunc(a, b, n, swaptype)
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A partition that remains to be sorted */
+
+struct qsort_part_s {
+	char *base;
+	size_t nmemb;
+	int depth;					/* Partitioning steps left before heapsort */
+};
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
-static inline void swapfunc(char *a, char *b, int n, int swaptype);
+static inline void swapfunc(char *a, char *b, size_t n, int swaptype);
 static inline char *med3(char *a, char *b, char *c, int (*compar)(const void *, const void *));
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static inline void swapfunc(char *a, char *b, int n, int swaptype)
+static inline void swapfunc(char *a, char *b, size_t n, int swaptype)
 {
-	if (swaptype <= 1) {
+	if (swaptype <= SWAP_WORDS) {
 		swapcode(long, a, b, n);
 	} else {
 		swapcode(char, a, b, n);
 	}
 }
+
 static inline char *med3(char *a, char *b, char *c, int (*compar)(const void *, const void *))
 {
 	return compar(a, b) < 0 ? (compar(b, c) < 0 ? b : (compar(a, c) < 0 ? c : a))
@@ -125,62 +172,119 @@ static inline char *med3(char *a, char *b, char *c, int (*compar)(const void *,
 }
 
 /****************************************************************************
- * Public Function
+ * Name: qsort_insertion
+ *
+ * Description:
+ *   Sort a partition by insertion.  Returns false if that takes more than
+ *   'limit' moves, leaving the partition unsorted.
+ *
  ****************************************************************************/
 
+static bool qsort_insertion(char *base, size_t nmemb, size_t size, int swaptype, int (*compar)(const void *, const void *), size_t limit)
+{
+	char *pm;
+	char *pl;
+
+	for (pm = base + size; pm < base + nmemb * size; pm += size) {
+		for (pl = pm; pl > base && compar(pl - size, pl) > 0; pl -= size) {
+			if (limit-- == 0) {
+				return false;
+			}
+
+			swap(pl, pl - size);
+		}
+	}
+
+	return true;
+}
+
 /****************************************************************************
- * Name: qsort
+ * Name: qsort_heapsort
  *
  * Description:
- *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ *   Sort a partition with heapsort.  This is only used for partitions on
+ *   which quicksort keeps choosing bad pivots, so that the sort as a whole
+ *   remains O(n log n) for any input.
  *
  ****************************************************************************/
 
-void qsort(void *base, size_t nmemb, size_t size, int (*compar)(const void *, const void *))
+static void qsort_siftdown(char *base, size_t root, size_t nmemb, size_t size, int swaptype, int (*compar)(const void *, const void *))
 {
-	char *pa, *pb, *pc, *pd, *pl, *pm, *pn;
-	int d, r, swaptype, swap_cnt;
+	size_t child;
 
-loop:
-	SWAPINIT(base, size);
-	swap_cnt = 0;
-	if (nmemb < 7) {
-		for (pm = (char *)base + size; pm < (char *)base + nmemb * size; pm += size) {
-			for (pl = pm; pl > (char *)base && compar(pl - size, pl) > 0; pl -= size) {
-				swap(pl, pl - size);
-			}
+	while ((child = 2 * root + 1) < nmemb) {
+		if (child + 1 < nmemb && compar(base + child * size, base + (child + 1) * size) < 0) {
+			child++;
 		}
-		return;
-	}
 
-	pm = (char *)base + (nmemb / 2) * size;
-	if (nmemb > 7) {
-		pl = base;
-		pn = (char *)base + (nmemb - 1) * size;
-		if (nmemb > 40) {
-			d = (nmemb / 8) * size;
-			pl = med3(pl, pl + d, pl + 2 * d, compar);
-			pm = med3(pm - d, pm, pm + d, compar);
-			pn = med3(pn - 2 * d, pn - d, pn, compar);
+		if (compar(base + root * size, base + child * size) >= 0) {
+			break;
 		}
-		pm = med3(pl, pm, pn, compar);
+
+		swap(base + root * size, base + child * size);
+		root = child;
+	}
+}
+
+static void qsort_heapsort(char *base, size_t nmemb, size_t size, int swaptype, int (*compar)(const void *, const void *))
+{
+	size_t i;
+
+	for (i = nmemb / 2; i-- > 0;) {
+		qsort_siftdown(base, i, nmemb, size, swaptype, compar);
+	}
+
+	for (i = nmemb - 1; i > 0; i--) {
+		swap(base, base + i * size);
+		qsort_siftdown(base, 0, i, size, swaptype, compar);
+	}
+}
+
+/****************************************************************************
+ * Name: qsort_partition
+ *
+ * Description:
+ *   Bentley and McIlroy's three-way partitioning:  Move the elements that
+ *   compare less than the pivot to the front of the partition, those that
+ *   compare greater to the back and those that compare equal in between.
+ *   The elements that remain to be sorted are returned as the partitions
+ *   at 'base' with *nleft elements and at *right with *nright elements.
+ *   Returns false if no elements had to be exchanged.
+ *
+ ****************************************************************************/
+
+static bool qsort_partition(char *base, size_t nmemb, size_t size, int swaptype, int (*compar)(const void *, const void *), size_t *nleft, char **right, size_t *nright)
+{
+	bool swapped = false;
+	char *pa, *pb, *pc, *pd, *pl, *pm, *pn;
+	size_t d, r;
+	int cmp;
+
+	pl = base;
+	pm = base + (nmemb / 2) * size;
+	pn = base + (nmemb - 1) * size;
+	if (nmemb > QSORT_NINTHER) {
+		d = (nmemb / 8) * size;
+		pl = med3(pl, pl + d, pl + 2 * d, compar);
+		pm = med3(pm - d, pm, pm + d, compar);
+		pn = med3(pn - 2 * d, pn - d, pn, compar);
 	}
+
+	pm = med3(pl, pm, pn, compar);
 	swap(base, pm);
-	pa = pb = (char *)base + size;
+	pa = pb = base + size;
 
-	pc = pd = (char *)base + (nmemb - 1) * size;
+	pc = pd = base + (nmemb - 1) * size;
 	for (;;) {
-		while (pb <= pc && (r = compar(pb, base)) <= 0) {
-			if (r == 0) {
-				swap_cnt = 1;
+		while (pb <= pc && (cmp = compar(pb, base)) <= 0) {
+			if (cmp == 0) {
 				swap(pa, pb);
 				pa += size;
 			}
 			pb += size;
 		}
-		while (pb <= pc && (r = compar(pc, base)) >= 0) {
-			if (r == 0) {
-				swap_cnt = 1;
+		while (pb <= pc && (cmp = compar(pc, base)) >= 0) {
+			if (cmp == 0) {
 				swap(pc, pd);
 				pd -= size;
 			}
@@ -192,38 +296,116 @@ loop:
 		}
 
 		swap(pb, pc);
-		swap_cnt = 1;
+		swapped = true;
 		pb += size;
 		pc -= size;
 	}
 
-	if (swap_cnt == 0) {
-		/* Switch to insertion sort */
+	/* Move the elements equal to the pivot from both ends to the middle */
 
-		for (pm = (char *)base + size; pm < (char *)base + nmemb * size; pm += size) {
-			for (pl = pm; pl > (char *)base && compar(pl - size, pl) > 0; pl -= size) {
-				swap(pl, pl - size);
-			}
-		}
+	pn = base + nmemb * size;
+	r = min(pa - base, pb - pa);
+	vecswap(base, pb - r, r);
+	r = min(pd - pc, pn - pd - size);
+	vecswap(pb, pn - r, r);
+
+	*nleft = (pb - pa) / size;
+	*nright = (pd - pc) / size;
+	*right = pn - (pd - pc);
+	return swapped;
+}
+
+/****************************************************************************
+ * Public Function
+ ****************************************************************************/
 
+/****************************************************************************
+ * Name: qsort
+ *
+ * Description:
+ *   Introsort:  Quicksort with the partitioning of Bentley & McIlroy's
+ *   "Engineering a Sort Function", which switches to heapsort for any
+ *   partition that is still unsorted after 2 * log2(nmemb) partitioning
+ *   steps (Musser, "Introspective Sorting and Selection Algorithms").
+ *   Small partitions are insertion sorted, and so are partitions that look
+ *   sorted already.  Nothing is sorted recursively, and the stack use is
+ *   bounded.
+ *
+ ****************************************************************************/
+
+void qsort(void *base, size_t nmemb, size_t size, int (*compar)(const void *, const void *))
+{
+	struct qsort_part_s stack[QSORT_STACKSIZE];
+	char *pl = (char *)base;
+	char *pr;
+	size_t nl;
+	size_t nr;
+	int swaptype;
+	int depth;
+	int sp = 0;
+
+	if (nmemb < 2 || size == 0) {
 		return;
 	}
 
-	pn = (char *)base + nmemb * size;
-	r = min(pa - (char *)base, pb - pa);
-	vecswap(base, pb - r, r);
-	r = min(pd - pc, pn - pd - size);
-	vecswap(pb, pn - r, r);
+	SWAPINIT(base, size);
 
-	if ((r = pb - pa) > size) {
-		qsort(base, r / size, size, compar);
+	for (depth = 0, nl = nmemb; nl > 1; nl >>= 1) {
+		depth += 2;
 	}
 
-	if ((r = pd - pc) > size) {
-		/* Iterate rather than recurse to save stack space */
+	/* Partition, unless the partition is small or quicksort is doing badly
+	 * on it.  If partitioning exchanged nothing and both partitions can be
+	 * insertion sorted with a few moves, they are done.
+	 */
+
+	for (;;) {
+		if (nmemb <= QSORT_INSERTION) {
+			qsort_insertion(pl, nmemb, size, swaptype, compar, SIZE_MAX);
+		} else if (depth == 0) {
+			qsort_heapsort(pl, nmemb, size, swaptype, compar);
+		} else if (qsort_partition(pl, nmemb, size, swaptype, compar, &nl, &pr, &nr) ||
+				   !qsort_insertion(pl, nl, size, swaptype, compar, QSORT_PARTIAL) ||
+				   !qsort_insertion(pr, nr, size, swaptype, compar, QSORT_PARTIAL)) {
+			depth--;
+
+			/* Continue with the smaller partition and push the larger one */
+
+			if (nl < nr) {
+				if (nr > 1) {
+					DEBUGASSERT(sp < QSORT_STACKSIZE);
+					stack[sp].base = pr;
+					stack[sp].nmemb = nr;
+					stack[sp].depth = depth;
+					sp++;
+				}
+
+				nmemb = nl;
+			} else {
+				if (nl > 1) {
+					DEBUGASSERT(sp < QSORT_STACKSIZE);
+					stack[sp].base = pl;
+					stack[sp].nmemb = nl;
+					stack[sp].depth = depth;
+					sp++;
+				}
+
+				pl = pr;
+				nmemb = nr;
+			}
+
+			if (nmemb > 1) {
+				continue;
+			}
+		}
+
+		if (sp == 0) {
+			break;
+		}
 
-		base = pn - r;
-		nmemb = r / size;
-		goto loop;
+		sp--;
+		pl = stack[sp].base;
+		nmemb = stack[sp].nmemb;
+		depth = stack[sp].depth;
 	}
 }
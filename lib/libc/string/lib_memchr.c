@@ -58,6 +58,10 @@
 
 #include <string.h>
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+#include "lib_word.h"
+#endif
+
 /****************************************************************************
  * Global Functions
  ****************************************************************************/
@@ -81,6 +85,32 @@ FAR void *memchr(FAR const void *s, int c, size_t n)
 	FAR const unsigned char *p = (FAR const unsigned char *)s;
 
 	if (s) {
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+		/* Test bytes up to a word boundary, then skip the words that do
+		 * not hold 'c':  A word holds 'c' if it has a zero byte once every
+		 * byte is XOR-ed with 'c'.
+		 */
+
+		if (n >= 2 * LIB_WORDSIZE) {
+			lib_word_t mask = LIB_WORD_REPEAT(c);
+			FAR const lib_word_t *wp;
+
+			for (; LIB_UNALIGNED(p); p++, n--) {
+				if (*p == (unsigned char)c) {
+					return (FAR void *)p;
+				}
+			}
+
+			for (wp = (FAR const lib_word_t *)p; n >= LIB_WORDSIZE; wp++, n -= LIB_WORDSIZE) {
+				if (LIB_WORD_HASZERO(*wp ^ mask)) {
+					break;
+				}
+			}
+
+			p = (FAR const unsigned char *)wp;
+		}
+#endif
+
 		while (n--) {
 			if (*p == (unsigned char)c) {
 				return (FAR void *)p;
@@ -62,6 +62,10 @@
 #include <sys/types.h>
 #include <string.h>
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+#include "lib_word.h"
+#endif
+
 /************************************************************
  * Global Functions
  ************************************************************/
@@ -72,6 +76,30 @@ int memcmp(FAR const void *s1, FAR const void *s2, size_t n)
 	unsigned char *p1 = (unsigned char *)s1;
 	unsigned char *p2 = (unsigned char *)s2;
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+	/* Skip the equal words when both can be aligned together.  The bytes
+	 * of the first differing word are then compared one at a time.
+	 */
+
+	if (n >= 2 * LIB_WORDSIZE && !LIB_MISALIGNED(p1, p2)) {
+		while (LIB_UNALIGNED(p1)) {
+			if (*p1 != *p2) {
+				return *p1 < *p2 ? -1 : 1;
+			}
+
+			p1++;
+			p2++;
+			n--;
+		}
+
+		while (n >= LIB_WORDSIZE && *(lib_word_t *)p1 == *(lib_word_t *)p2) {
+			p1 += LIB_WORDSIZE;
+			p2 += LIB_WORDSIZE;
+			n -= LIB_WORDSIZE;
+		}
+	}
+#endif
+
 	while (n-- > 0) {
 		if (*p1 < *p2) {
 			return -1;
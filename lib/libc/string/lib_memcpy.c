@@ -62,6 +62,10 @@
 #include <sys/types.h>
 #include <string.h>
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+#include "lib_word.h"
+#endif
+
 /****************************************************************************
  * Global Functions
  ****************************************************************************/
@@ -75,6 +79,73 @@ FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
 {
 	FAR unsigned char *pout = (FAR unsigned char *)dest;
 	FAR unsigned char *pin = (FAR unsigned char *)src;
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+	if (n >= 2 * LIB_WORDSIZE) {
+		FAR lib_word_t *wout;
+		FAR const lib_word_t *win;
+
+		/* Bring the destination to a word boundary */
+
+		while (LIB_UNALIGNED(pout)) {
+			*pout++ = *pin++;
+			n--;
+		}
+
+		wout = (FAR lib_word_t *)pout;
+
+		if (!LIB_UNALIGNED(pin)) {
+			/* Both are aligned:  Copy four words per iteration, then single
+			 * words.
+			 */
+
+			win = (FAR const lib_word_t *)pin;
+			while (n >= 4 * LIB_WORDSIZE) {
+				wout[0] = win[0];
+				wout[1] = win[1];
+				wout[2] = win[2];
+				wout[3] = win[3];
+				wout += 4;
+				win += 4;
+				n -= 4 * LIB_WORDSIZE;
+			}
+
+			while (n >= LIB_WORDSIZE) {
+				*wout++ = *win++;
+				n -= LIB_WORDSIZE;
+			}
+
+			pin = (FAR unsigned char *)win;
+		} else {
+			/* Only the destination is aligned:  Read aligned source words
+			 * and merge each two neighbours into one destination word.
+			 * Every source word read holds at least one byte that is
+			 * copied, so this never reads outside of the source words.
+			 */
+
+			unsigned int shift = ((uintptr_t)pin & LIB_WORDMASK) * CHAR_BIT;
+			lib_word_t w0;
+			lib_word_t w1;
+
+			win = (FAR const lib_word_t *)((uintptr_t)pin & ~(uintptr_t)LIB_WORDMASK);
+			w0 = *win++;
+			while (n >= LIB_WORDSIZE) {
+				w1 = *win++;
+#ifdef CONFIG_ENDIAN_BIG
+				*wout++ = (w0 << shift) | (w1 >> (LIB_WORDBITS - shift));
+#else
+				*wout++ = (w0 >> shift) | (w1 << (LIB_WORDBITS - shift));
+#endif
+				w0 = w1;
+				pin += LIB_WORDSIZE;
+				n -= LIB_WORDSIZE;
+			}
+		}
+
+		pout = (FAR unsigned char *)wout;
+	}
+#endif
+
 	while (n-- > 0) {
 		*pout++ = *pin++;
 	}
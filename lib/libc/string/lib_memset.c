@@ -82,7 +82,7 @@
 #ifndef CONFIG_ARCH_MEMSET
 void *memset(void *s, int c, size_t n)
 {
-#ifdef CONFIG_MEMSET_OPTSPEED
+#if defined(CONFIG_MEMSET_OPTSPEED) || defined(CONFIG_LIBC_STRING_OPTSPEED)
 	/* This version is optimized for speed (you could do better
 	 * still by exploiting processor caching or memory burst
 	 * knowledge.)
@@ -119,7 +119,16 @@ void *memset(void *s, int c, size_t n)
 				n -= 2;
 			}
 #ifndef CONFIG_MEMSET_64BIT
-			/* Loop while there are at least 32-bits left to be written */
+			/* Write 128-bits per iteration, then the remaining 32-bit words */
+
+			while (n >= 16) {
+				((uint32_t *)addr)[0] = val32;
+				((uint32_t *)addr)[1] = val32;
+				((uint32_t *)addr)[2] = val32;
+				((uint32_t *)addr)[3] = val32;
+				addr += 16;
+				n -= 16;
+			}
 
 			while (n >= 4) {
 				*(uint32_t *)addr = val32;
@@ -58,6 +58,10 @@
 
 #include <string.h>
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+#include "lib_word.h"
+#endif
+
 /****************************************************************************
  * Global Functions
  ****************************************************************************/
@@ -80,8 +84,30 @@
 FAR char *strchr(FAR const char *s, int c)
 {
 	if (s) {
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+		/* Test bytes up to a word boundary, then skip the words that hold
+		 * neither 'c' nor the terminator.
+		 */
+
+		lib_word_t mask = LIB_WORD_REPEAT(c);
+		FAR const lib_word_t *ws;
+
+		for (; LIB_UNALIGNED(s); s++) {
+			if (*s == (char)c) {
+				return (FAR char *)s;
+			}
+
+			if (!*s) {
+				return NULL;
+			}
+		}
+
+		for (ws = (FAR const lib_word_t *)s; !LIB_WORD_HASZERO(*ws) && !LIB_WORD_HASZERO(*ws ^ mask); ws++);
+		s = (FAR const char *)ws;
+#endif
+
 		for (;; s++) {
-			if (*s == c) {
+			if (*s == (char)c) {
 				return (FAR char *)s;
 			}
 
@@ -58,6 +58,10 @@
 
 #include <string.h>
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+#include "lib_word.h"
+#endif
+
 /****************************************************************************
  * Public Functions
  *****************************************************************************/
@@ -66,6 +70,35 @@
 int strcmp(const char *cs, const char *ct)
 {
 	register signed char result;
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+	/* When both strings can be aligned together, skip the equal words that
+	 * hold no terminator.  The bytes from the first word that differs or
+	 * ends the strings on are compared below.
+	 */
+
+	if (!LIB_MISALIGNED(cs, ct)) {
+		const lib_word_t *w1;
+		const lib_word_t *w2;
+
+		for (; LIB_UNALIGNED(cs); cs++, ct++) {
+			if ((result = *cs - *ct) != 0 || !*cs) {
+				return result;
+			}
+		}
+
+		w1 = (const lib_word_t *)cs;
+		w2 = (const lib_word_t *)ct;
+		while (*w1 == *w2 && !LIB_WORD_HASZERO(*w1)) {
+			w1++;
+			w2++;
+		}
+
+		cs = (const char *)w1;
+		ct = (const char *)w2;
+	}
+#endif
+
 	for (;;) {
 		if ((result = *cs - *ct++) != 0 || !*cs++) {
 			break;
@@ -58,6 +58,10 @@
 #include <sys/types.h>
 #include <string.h>
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+#include "lib_word.h"
+#endif
+
 /****************************************************************************
  * Global Functions
  ****************************************************************************/
@@ -66,7 +70,26 @@
 size_t strlen(const char *s)
 {
 	const char *sc;
-	for (sc = s; *sc != '\0'; ++sc);
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+	const lib_word_t *ws;
+
+	/* Test bytes up to a word boundary, then whole words for a zero byte.
+	 * An aligned word never crosses a page, so reading the whole of the
+	 * word holding the terminator is safe.
+	 */
+
+	for (sc = s; LIB_UNALIGNED(sc); ++sc) {
+		if (*sc == '\0') {
+			return sc - s;
+		}
+	}
+
+	for (ws = (const lib_word_t *)sc; !LIB_WORD_HASZERO(*ws); ws++);
+	sc = (const char *)ws;
+#else
+	sc = s;
+#endif
+	for (; *sc != '\0'; ++sc);
 	return sc - s;
 }
 #endif
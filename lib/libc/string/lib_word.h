@@ -0,0 +1,86 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * libc/string/lib_word.h
+ *
+ * Helpers for the word-at-a-time versions of the string functions that are
+ * selected with CONFIG_LIBC_STRING_OPTSPEED.  A word is an unsigned long,
+ * the widest type that every supported target loads in one access.
+ *
+ ****************************************************************************/
+
+#ifndef __LIBC_STRING_LIB_WORD_H
+#define __LIBC_STRING_LIB_WORD_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <limits.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LIB_WORDSIZE        sizeof(lib_word_t)
+#define LIB_WORDMASK        (LIB_WORDSIZE - 1)
+#define LIB_WORDBITS        (LIB_WORDSIZE * CHAR_BIT)
+
+/* True if 'p' is not on a word boundary, or if 'p' and 'q' cannot be
+ * brought to a word boundary together.
+ */
+
+#define LIB_UNALIGNED(p)    (((uintptr_t)(p) & LIB_WORDMASK) != 0)
+#define LIB_MISALIGNED(p, q) ((((uintptr_t)(p) ^ (uintptr_t)(q)) & LIB_WORDMASK) != 0)
+
+/* 0x0101...01 and 0x8080...80 */
+
+#define LIB_WORD_ONES       ((lib_word_t)-1 / 0xff)
+#define LIB_WORD_HIGHS      (LIB_WORD_ONES << 7)
+
+/* The byte 'c' repeated in every byte of a word */
+
+#define LIB_WORD_REPEAT(c)  (LIB_WORD_ONES * (unsigned char)(c))
+
+/* Non-zero if any byte of 'w' is zero.  A byte of (w - 0x01..01) only has
+ * its top bit set without the byte of w having it set if that byte of w
+ * was zero, or if a borrow came from a zero byte below it.  So the result
+ * is exact about whether there is a zero byte, though not about which
+ * bytes above the first zero byte are zero.
+ */
+
+#define LIB_WORD_HASZERO(w) (((w) - LIB_WORD_ONES) & ~(w) & LIB_WORD_HIGHS)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The word type.  Word accesses alias the byte arrays being processed, so
+ * tell GCC not to assume that they don't.
+ */
+
+#ifdef __GNUC__
+typedef unsigned long __attribute__((__may_alias__)) lib_word_t;
+#else
+typedef unsigned long lib_word_t;
+#endif
+
+#endif							/* __LIBC_STRING_LIB_WORD_H */
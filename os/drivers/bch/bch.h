@@ -69,21 +69,55 @@
 #define bchlib_semgive(d)	sem_post(&(d)->sem)	/* To match bchlib_semtake */
 #define MAX_OPENCNT			(255)				/* Limit of uint8_t */
 
+/* Number of sectors in the cache and the most sectors read at once when
+ * the sectors are accessed in sequence.
+ */
+#ifndef CONFIG_BCH_NCACHESECTORS
+#define CONFIG_BCH_NCACHESECTORS 1
+#endif
+
+#ifndef CONFIG_BCH_READAHEAD
+#define CONFIG_BCH_READAHEAD 1
+#endif
+
+#if CONFIG_BCH_READAHEAD > CONFIG_BCH_NCACHESECTORS
+#define BCH_READAHEAD CONFIG_BCH_NCACHESECTORS
+#else
+#define BCH_READAHEAD CONFIG_BCH_READAHEAD
+#endif
+
+#define BCH_NOSECTOR		((size_t)-1)		/* Unused cache entry */
+
+/* A dirty sector that fails to be written this many times in a row is
+ * dropped from the cache, after the last error has been returned.
+ */
+#define BCH_MAXWRFAILS		3
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
+struct bchlib_cache_s
+{
+	size_t sector;				/* The sector in the buffer or BCH_NOSECTOR */
+	uint32_t lru;				/* Value of lrucount at the last access */
+	bool dirty;					/* true: Data has been written to the buffer */
+	uint8_t nfails;				/* Failed write-backs in a row */
+	FAR uint8_t *buffer;		/* One sector of bchlib_s::buffer */
+};
+
 struct bchlib_s
 {
 	FAR struct inode *inode;	/* I-node of the block driver */
 	uint32_t sectsize;			/* The size of one sector on the device */
 	size_t nsectors;			/* Number of sectors supported by the device */
-	size_t sector;				/* The current sector in the buffer */
+	size_t nextsector;			/* The sector after the last one read */
 	sem_t sem;					/* For atomic accesses to this structure */
+	uint32_t lrucount;			/* Counts accesses to the cache */
 	uint8_t refs;				/* Number of references */
-	bool dirty;					/* true: Data has been written to the buffer */
 	bool readonly;				/* true: Only read operations are supported */
 	bool unlinked;				/* true: The driver has been unlinked */
-	FAR uint8_t *buffer;		/* One sector buffer */
+	FAR uint8_t *buffer;		/* Buffer of all of the cached sectors */
+	struct bchlib_cache_s cache[CONFIG_BCH_NCACHESECTORS];
 
 #if defined(CONFIG_BCH_ENCRYPTION)
 	uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];	/* Encryption key */
@@ -107,8 +141,19 @@ EXTERN const struct file_operations bch_fops;
  * Public Function Prototypes
  ****************************************************************************/
 EXTERN void bchlib_semtake(FAR struct bchlib_s *bch);
-EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch);
-EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN int  bchlib_flushcache(FAR struct bchlib_s *bch);
+EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector,
+							  FAR struct bchlib_cache_s **entry);
+#if defined(CONFIG_BCH_ENCRYPTION)
+EXTERN int  bchlib_newsector(FAR struct bchlib_s *bch, size_t sector,
+							 FAR struct bchlib_cache_s **entry);
+EXTERN void bchlib_decrypt(FAR struct bchlib_s *bch, FAR uint8_t *buffer,
+						   size_t sector, size_t nsectors);
+#endif
+EXTERN void bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector,
+							  size_t nsectors);
+EXTERN void bchlib_overlay(FAR struct bchlib_s *bch, FAR uint8_t *buffer,
+						   size_t sector, size_t nsectors);
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -150,14 +150,18 @@ static int bch_close(FAR struct file *filep)
 {
 	FAR struct inode *inode = filep->f_inode;
 	FAR struct bchlib_s *bch;
+	int flushret;
 	int ret = OK;
 
 	DEBUGASSERT(inode && inode->i_private);
 	bch = (FAR struct bchlib_s *)inode->i_private;
 
-	/* Flush any dirty pages remaining in the cache */
+	/*
+	 * Flush any dirty pages remaining in the cache.  The device is closed
+	 * even if this fails, but the error is returned.
+	 */
 	bchlib_semtake(bch);
-	(void)bchlib_flushsector(bch);
+	flushret = bchlib_flushcache(bch);
 
 	/*
 	 * Decrement the reference count (I don't use bchlib_decref() because I
@@ -185,13 +189,13 @@ static int bch_close(FAR struct file *filep)
 			DEBUGASSERT(ret >= 0);
 			if (ret >= 0) {
 				/* Return without releasing the stale semaphore */
-				return OK;
+				return flushret;
 			}
 		}
 	}
 
 	bchlib_semgive(bch);
-	return ret;
+	return ret < 0 ? ret : flushret;
 }
 
 /****************************************************************************
@@ -331,6 +335,12 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
 		bchlib_semgive(bch);
 	}
+	/* Is this a request to write back the dirty cached sectors? */
+	else if (cmd == BIOC_FLUSH) {
+		bchlib_semtake(bch);
+		ret = bchlib_flushcache(bch);
+		bchlib_semgive(bch);
+	}
 #ifdef CONFIG_BCH_ENCRYPTION
 	/* Is this a request to set the encryption key? */
 	else if (cmd == DIOC_SETKEY) {
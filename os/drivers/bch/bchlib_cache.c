@@ -57,6 +57,8 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -88,16 +90,16 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  * Name: bch_cypher
  ****************************************************************************/
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, size_t sector, FAR uint8_t *data, int encrypt)
 {
 	int blocks = bch->sectsize / 16;
-	FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+	FAR uint32_t *buffer = (FAR uint32_t *)data;
 	int i;
 
 	for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t)) {
 		uint32_t T[4];
 		uint32_t X[4] = {
-			bch->sector, 0, 0, i
+			sector, 0, 0, i
 		};
 
 		aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -115,19 +117,16 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 #endif
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-/****************************************************************************
- * Name: bchlib_flushsector
+ * Name: bchlib_flushentry
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
- *
- * Assumptions:
- *   Caller must assume mutual exclusion
+ *   Write one cached sector to the media if it is dirty.  A sector that
+ *   fails to be written is kept to be written again, until it has failed
+ *   BCH_MAXWRFAILS times; then it is dropped so that it does not hold its
+ *   cache entry forever.  The error is returned either way.
  *
  ****************************************************************************/
-int bchlib_flushsector(FAR struct bchlib_s *bch)
+static int bchlib_flushentry(FAR struct bchlib_s *bch, FAR struct bchlib_cache_s *entry)
 {
 	FAR struct inode *inode;
 	ssize_t ret = OK;
@@ -136,65 +135,306 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
 	 * Check if the sector has been modified and is out of synch with the
 	 * media.
 	 */
-	if (bch->dirty) {
+	if (entry->dirty) {
 		inode = bch->inode;
 
 #if defined(CONFIG_BCH_ENCRYPTION)
 		/* Encrypt data as necessary */
-		bch_cypher(bch, CYPHER_ENCRYPT);
+		bch_cypher(bch, entry->sector, entry->buffer, CYPHER_ENCRYPT);
 #endif
 
 		/* Write the sector to the media */
-		ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
-		if (ret < 0) {
-			fdbg("Write failed: %d\n");
-		}
+		ret = inode->u.i_bops->write(inode, entry->buffer, entry->sector, 1);
 
 #if defined(CONFIG_BCH_ENCRYPTION)
 		/*
 		 * Computation overhead to save memory for extra sector buffer
 		 * TODO: Add configuration switch for extra sector buffer
 		 */
-		bch_cypher(bch, CYPHER_DECRYPT);
+		bch_cypher(bch, entry->sector, entry->buffer, CYPHER_DECRYPT);
 #endif
 
+		if (ret < 0) {
+			fdbg("Write failed: %d\n", ret);
+			if (++entry->nfails >= BCH_MAXWRFAILS) {
+				fdbg("Dropped sector %lu\n", (unsigned long)entry->sector);
+				entry->sector = BCH_NOSECTOR;
+				entry->dirty = false;
+				entry->nfails = 0;
+			}
+
+			return (int)ret;
+		}
+
 		/* The sector is now in sync with the media */
-		bch->dirty = false;
+		entry->dirty = false;
+		entry->nfails = 0;
 	}
 
 	return (int)ret;
 }
 
+/****************************************************************************
+ * Name: bchlib_lookup
+ *
+ * Description:
+ *   Return the cache entry holding 'sector' or NULL if it is not cached
+ *
+ ****************************************************************************/
+static FAR struct bchlib_cache_s *bchlib_lookup(FAR struct bchlib_s *bch, size_t sector)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_BCH_NCACHESECTORS; i++) {
+		if (bch->cache[i].sector == sector) {
+			return &bch->cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+/****************************************************************************
+ * Name: bchlib_evict
+ *
+ * Description:
+ *   Free 'count' adjacent cache entries for new sectors and return the
+ *   index of the first one.  The entries chosen are those whose most
+ *   recently used member was used longest ago.  Dirty entries are written
+ *   back first; if one cannot be written, the entries are all kept and the
+ *   negated errno is returned.
+ *
+ ****************************************************************************/
+static int bchlib_evict(FAR struct bchlib_s *bch, int count)
+{
+	uint32_t oldest = 0;
+	uint32_t age;
+	int first = 0;
+	int ret;
+	int i;
+	int j;
+
+	for (i = 0; i + count <= CONFIG_BCH_NCACHESECTORS; i++) {
+		/* The age of a window is that of its most recently used entry */
+		age = UINT32_MAX;
+		for (j = i; j < i + count; j++) {
+			if (bch->cache[j].sector == BCH_NOSECTOR) {
+				continue;
+			}
+
+			if (bch->lrucount - bch->cache[j].lru < age) {
+				age = bch->lrucount - bch->cache[j].lru;
+			}
+		}
+
+		if (i == 0 || age > oldest) {
+			oldest = age;
+			first = i;
+		}
+	}
+
+	for (j = first; j < first + count; j++) {
+		ret = bchlib_flushentry(bch, &bch->cache[j]);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	for (j = first; j < first + count; j++) {
+		bch->cache[j].sector = BCH_NOSECTOR;
+	}
+
+	return first;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+/****************************************************************************
+ * Name: bchlib_flushcache
+ *
+ * Description:
+ *   Flush the current contents of all dirty sector buffers
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+int bchlib_flushcache(FAR struct bchlib_s *bch)
+{
+	int ret = OK;
+	int err;
+	int i;
+
+	for (i = 0; i < CONFIG_BCH_NCACHESECTORS; i++) {
+		err = bchlib_flushentry(bch, &bch->cache[i]);
+		if (err < 0 && ret == OK) {
+			ret = err;
+		}
+	}
+
+	return ret;
+}
+
 /****************************************************************************
  * Name: bchlib_readsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Return the cache entry holding 'sector', reading it from the media if
+ *   it is not cached.  A miss just after the last sector read is taken as
+ *   a sequential access and the following sectors, up to BCH_READAHEAD in
+ *   total, are read with the same request.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
  *
  ****************************************************************************/
-int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
+int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector, FAR struct bchlib_cache_s **entry)
 {
 	FAR struct inode *inode;
-	ssize_t ret = OK;
-
-	if (bch->sector != sector) {
-		inode = bch->inode;
+	FAR struct bchlib_cache_s *cache;
+	ssize_t ret;
+	int count;
+	int first;
+	int i;
 
-		(void)bchlib_flushsector(bch);
-		bch->sector = (size_t)-1;
+	cache = bchlib_lookup(bch, sector);
+	if (cache != NULL) {
+		cache->lru = ++bch->lrucount;
+		*entry = cache;
+		return OK;
+	}
 
-		ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
-		if (ret < 0) {
-			fdbg("Read failed: %d\n");
+	/* Read ahead only the uncached sectors following this one */
+	count = 1;
+	if (sector == bch->nextsector) {
+		while (count < BCH_READAHEAD && sector + count < bch->nsectors &&
+			   bchlib_lookup(bch, sector + count) == NULL) {
+			count++;
 		}
-		bch->sector = sector;
+	}
+
+	inode = bch->inode;
+	first = bchlib_evict(bch, count);
+	if (first < 0) {
+		return first;
+	}
+
+	ret = inode->u.i_bops->read(inode, bch->cache[first].buffer, sector, count);
+	if (ret < 0) {
+		fdbg("Read failed: %d\n", ret);
+		return (int)ret;
+	}
+
+	bch->lrucount++;
+	for (i = 0; i < count; i++) {
+		cache = &bch->cache[first + i];
+		cache->sector = sector + i;
+		cache->lru = bch->lrucount;
 #if defined(CONFIG_BCH_ENCRYPTION)
-		bch_cypher(bch, CYPHER_DECRYPT);
+		bch_cypher(bch, cache->sector, cache->buffer, CYPHER_DECRYPT);
 #endif
 	}
-	return (int)ret;
+
+	bch->nextsector = sector + count;
+	*entry = &bch->cache[first];
+	return OK;
 }
 
+#if defined(CONFIG_BCH_ENCRYPTION)
+/****************************************************************************
+ * Name: bchlib_newsector
+ *
+ * Description:
+ *   Return a cache entry for 'sector' without reading it from the media,
+ *   for a sector that is about to be overwritten completely.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+int bchlib_newsector(FAR struct bchlib_s *bch, size_t sector, FAR struct bchlib_cache_s **entry)
+{
+	FAR struct bchlib_cache_s *cache;
+	int first;
+
+	cache = bchlib_lookup(bch, sector);
+	if (cache == NULL) {
+		first = bchlib_evict(bch, 1);
+		if (first < 0) {
+			return first;
+		}
+
+		cache = &bch->cache[first];
+		cache->sector = sector;
+	}
+
+	cache->lru = ++bch->lrucount;
+	*entry = cache;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_decrypt
+ *
+ * Description:
+ *   Decrypt 'nsectors' sectors read directly from the media into 'buffer'
+ *
+ ****************************************************************************/
+void bchlib_decrypt(FAR struct bchlib_s *bch, FAR uint8_t *buffer, size_t sector, size_t nsectors)
+{
+	while (nsectors-- > 0) {
+		bch_cypher(bch, sector++, buffer, CYPHER_DECRYPT);
+		buffer += bch->sectsize;
+	}
+}
+#endif
+
+/****************************************************************************
+ * Name: bchlib_invalidate
+ *
+ * Description:
+ *   Drop the cached copies of 'nsectors' sectors from 'sector' after they
+ *   were written directly to the media.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+void bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector, size_t nsectors)
+{
+	FAR struct bchlib_cache_s *cache;
+	int i;
+
+	for (i = 0; i < CONFIG_BCH_NCACHESECTORS; i++) {
+		cache = &bch->cache[i];
+		if (cache->sector != BCH_NOSECTOR && cache->sector >= sector && cache->sector - sector < nsectors) {
+			cache->sector = BCH_NOSECTOR;
+			cache->dirty = false;
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: bchlib_overlay
+ *
+ * Description:
+ *   Copy the dirty cached sectors among the 'nsectors' sectors from
+ *   'sector' over the stale data read directly from the media to 'buffer'.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+void bchlib_overlay(FAR struct bchlib_s *bch, FAR uint8_t *buffer, size_t sector, size_t nsectors)
+{
+	FAR struct bchlib_cache_s *cache;
+	int i;
+
+	for (i = 0; i < CONFIG_BCH_NCACHESECTORS; i++) {
+		cache = &bch->cache[i];
+		if (cache->dirty && cache->sector >= sector && cache->sector - sector < nsectors) {
+			memcpy(buffer + (cache->sector - sector) * bch->sectsize, cache->buffer, bch->sectsize);
+		}
+	}
+}
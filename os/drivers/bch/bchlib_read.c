@@ -95,6 +95,7 @@
 ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t len)
 {
 	FAR struct bchlib_s *bch = (FAR struct bchlib_s *)handle;
+	FAR struct bchlib_cache_s *entry;
 	size_t		nsectors;
 	size_t		sector;
 	uint16_t	sectoffset;
@@ -120,8 +121,11 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
 
 	bytesread = 0;
 	if (sectoffset > 0) {
-		/* Read the sector into the sector buffer */
-		bchlib_readsector(bch, sector);
+		/* Read the sector into the sector cache */
+		ret = bchlib_readsector(bch, sector, &entry);
+		if (ret < 0) {
+			return ret;
+		}
 
 		/* Copy the tail end of the sector to the user buffer */
 		if (sectoffset + len > bch->sectsize) {
@@ -130,7 +134,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
 			nbytes = len;
 		}
 
-		memcpy(buffer, &bch->buffer[sectoffset], nbytes);
+		memcpy(buffer, &entry->buffer[sectoffset], nbytes);
 
 		/* Adjust pointers and counts */
 		sector++;
@@ -146,7 +150,8 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
 
 	/*
 	 * Then read all of the full sectors following the partial sector directly
-	 * into the user buffer.
+	 * into the user buffer.  Sectors that are dirty in the cache are newer
+	 * than the media, so they are copied over what was read.
 	 */
 	if (len >= bch->sectsize) {
 		nsectors = len / bch->sectsize;
@@ -157,15 +162,23 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
 		ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
 						sector, nsectors);
 		if (ret < 0) {
-			fdbg("ERROR: Read failed: %d\n");
+			fdbg("ERROR: Read failed: %d\n", ret);
 			return ret;
 		}
 
+#if defined(CONFIG_BCH_ENCRYPTION)
+		bchlib_decrypt(bch, (FAR uint8_t *)buffer, sector, nsectors);
+#endif
+		bchlib_overlay(bch, (FAR uint8_t *)buffer, sector, nsectors);
+
 		/* Adjust pointers and counts */
 		sector    += nsectors;
 		nbytes     = nsectors * bch->sectsize;
 		bytesread += nbytes;
 
+		/* A partial sector read next continues the sequence */
+		bch->nextsector = sector;
+
 		if (sector >= bch->nsectors) {
 			return bytesread;
 		}
@@ -176,11 +189,14 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
 
 	/* Then read any partial final sector */
 	if (len > 0) {
-		/* Read the sector into the sector buffer */
-		bchlib_readsector(bch, sector);
+		/* Read the sector into the sector cache */
+		ret = bchlib_readsector(bch, sector, &entry);
+		if (ret < 0) {
+			return bytesread > 0 ? bytesread : ret;
+		}
 
 		/* Copy the head end of the sector to the user buffer */
-		memcpy(buffer, bch->buffer, len);
+		memcpy(buffer, entry->buffer, len);
 
 		/* Adjust counts */
 		bytesread += len;
@@ -87,6 +87,7 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
 	FAR struct bchlib_s *bch;
 	struct geometry geo;
 	int ret;
+	int i;
 
 	DEBUGASSERT(blkdev);
 
@@ -128,17 +129,25 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
 	sem_init(&bch->sem, 0, 1);
 	bch->nsectors = geo.geo_nsectors;
 	bch->sectsize = geo.geo_sectorsize;
-	bch->sector   = (size_t)-1;
+	bch->nextsector = BCH_NOSECTOR;
 	bch->readonly = readonly;
 
-	/* Allocate the sector I/O buffer */
-	bch->buffer = (FAR uint8_t *)kmm_malloc(bch->sectsize);
+	/* Allocate the sector I/O buffers of the cache */
+	bch->buffer = (FAR uint8_t *)kmm_malloc(bch->sectsize * CONFIG_BCH_NCACHESECTORS);
 	if (!bch->buffer) {
 		fdbg("ERROR: Failed to allocate sector buffer\n");
 		ret = -ENOMEM;
 		goto errout_with_bch;
 	}
 
+	for (i = 0; i < CONFIG_BCH_NCACHESECTORS; i++) {
+		bch->cache[i].sector = BCH_NOSECTOR;
+		bch->cache[i].dirty  = false;
+		bch->cache[i].nfails = 0;
+		bch->cache[i].lru    = 0;
+		bch->cache[i].buffer = bch->buffer + i * bch->sectsize;
+	}
+
 	*handle = bch;
 	return OK;
 
@@ -88,7 +88,7 @@ int bchlib_teardown(FAR void *handle)
 	}
 
 	/* Flush any pending data to the block driver */
-	bchlib_flushsector(bch);
+	bchlib_flushcache(bch);
 
 	/* Close the block driver */
 	(void)close_blockdriver(bch->inode);
@@ -82,6 +82,7 @@
 ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, size_t len)
 {
 	FAR struct bchlib_s *bch = (FAR struct bchlib_s *)handle;
+	FAR struct bchlib_cache_s *entry;
 	size_t   nsectors;
 	size_t   sector;
 	uint16_t sectoffset;
@@ -106,8 +107,11 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 
 	byteswritten = 0;
 	if (sectoffset > 0) {
-		/* Read the full sector into the sector buffer */
-		bchlib_readsector(bch, sector);
+		/* Read the full sector into the sector cache */
+		ret = bchlib_readsector(bch, sector, &entry);
+		if (ret < 0) {
+			return ret;
+		}
 
 		/* Copy the tail end of the sector from the user buffer */
 		if (sectoffset + len > bch->sectsize) {
@@ -116,16 +120,12 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 			nbytes = len;
 		}
 
-		memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-		bch->dirty = true;
+		memcpy(&entry->buffer[sectoffset], buffer, nbytes);
+		entry->dirty = true;
 
 		/* Adjust pointers and counts */
 		sector++;
 
-		if (sector >= bch->nsectors) {
-			return nbytes;
-		}
-
 		byteswritten  = nbytes;
 		buffer       += nbytes;
 		len          -= nbytes;
@@ -133,15 +133,28 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 
 	/*
 	 * Then write all of the full sectors following the partial sector
-	 * directly from the user buffer.
+	 * directly from the user buffer.  With encryption, the data has to be
+	 * encrypted in a sector buffer, so the sectors go through the cache.
 	 */
-	if (len >= bch->sectsize) {
+	if (len >= bch->sectsize && sector < bch->nsectors) {
 		nsectors = len / bch->sectsize;
 		if (sector + nsectors > bch->nsectors) {
 			nsectors = bch->nsectors - sector;
 		}
 
-		/* Write the contiguous sectors */
+#if defined(CONFIG_BCH_ENCRYPTION)
+		for (nbytes = 0; nbytes < nsectors; nbytes++) {
+			ret = bchlib_newsector(bch, sector + nbytes, &entry);
+			if (ret < 0) {
+				byteswritten += nbytes * bch->sectsize;
+				return byteswritten > 0 ? byteswritten : ret;
+			}
+
+			memcpy(entry->buffer, buffer + nbytes * bch->sectsize, bch->sectsize);
+			entry->dirty = true;
+		}
+#else
+		/* Write the contiguous sectors and drop any older cached copies */
 		ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
 				sector, nsectors);
 		if (ret < 0) {
@@ -149,39 +162,41 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 			return ret;
 		}
 
+		bchlib_invalidate(bch, sector, nsectors);
+#endif
+
 		/* Adjust pointers and counts */
 		sector       += nsectors;
 		nbytes        = nsectors * bch->sectsize;
 		byteswritten += nbytes;
-
-		if (sector >= bch->nsectors) {
-			return byteswritten;
-		}
-
-		buffer    += nbytes;
-		len       -= nbytes;
+		buffer       += nbytes;
+		len          -= nbytes;
 	}
 
 	/* Then write any partial final sector */
-	if (len > 0) {
-		/* Read the sector into the sector buffer */
-		bchlib_readsector(bch, sector);
+	if (len > 0 && sector < bch->nsectors) {
+		/* Read the sector into the sector cache */
+		ret = bchlib_readsector(bch, sector, &entry);
+		if (ret < 0) {
+			return byteswritten > 0 ? byteswritten : ret;
+		}
 
 		/* Copy the head end of the sector from the user buffer */
-		memcpy(bch->buffer, buffer, len);
-		bch->dirty = true;
+		memcpy(entry->buffer, buffer, len);
+		entry->dirty = true;
 
 		/* Adjust counts */
 		byteswritten += len;
 	}
 
+#ifndef CONFIG_BCH_WRITEBACK
 	/* Finally, flush any cached writes to the device as well */
-	ret = bchlib_flushsector(bch);
+	ret = bchlib_flushcache(bch);
 	if (ret < 0) {
 		fdbg("ERROR: Flush failed: %d\n", ret);
 		return ret;
 	}
+#endif
 
 	return byteswritten;
 }
-
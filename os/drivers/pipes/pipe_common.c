@@ -129,6 +129,161 @@ static void pipecommon_semtake(sem_t *sem)
 	}
 }
 
+/****************************************************************************
+ * Name: pipecommon_wakeup
+ *
+ * Description:
+ *   Wake up all of the threads waiting on the reader or writer semaphore.
+ *
+ ****************************************************************************/
+
+static void pipecommon_wakeup(sem_t *sem)
+{
+	int sval;
+
+	while (sem_getvalue(sem, &sval) == 0 && sval < 0) {
+		sem_post(sem);
+	}
+}
+
+/****************************************************************************
+ * Name: pipecommon_nbytes
+ *
+ * Description:
+ *   Return the number of bytes in the pipe buffer.  One byte of the buffer
+ *   is always left unused so that a full buffer can be told from an empty
+ *   one.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_nbytes(FAR struct pipe_dev_s *dev)
+{
+	if (dev->d_wrndx >= dev->d_rdndx) {
+		return dev->d_wrndx - dev->d_rdndx;
+	}
+
+	return PIPE_BUFSIZE(dev) + dev->d_wrndx - dev->d_rdndx;
+}
+
+/****************************************************************************
+ * Name: pipecommon_copyin
+ *
+ * Description:
+ *   Copy as many of the 'len' bytes at 'buffer' into the pipe buffer as
+ *   fit.  The free space is at most two segments, one up to the end of the
+ *   buffer and one from its start.  Returns the number of bytes copied.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_copyin(FAR struct pipe_dev_s *dev, FAR const char *buffer, size_t len)
+{
+	size_t bufsize = PIPE_BUFSIZE(dev);
+	size_t nfree = bufsize - 1 - pipecommon_nbytes(dev);
+	size_t wrndx = dev->d_wrndx;
+	size_t first;
+
+	if (len > nfree) {
+		len = nfree;
+	}
+
+	first = bufsize - wrndx;
+	if (first > len) {
+		first = len;
+	}
+
+	memcpy(&dev->d_buffer[wrndx], buffer, first);
+	memcpy(dev->d_buffer, buffer + first, len - first);
+
+	wrndx += len;
+	if (wrndx >= bufsize) {
+		wrndx -= bufsize;
+	}
+
+	dev->d_wrndx = wrndx;
+	return len;
+}
+
+/****************************************************************************
+ * Name: pipecommon_copyout
+ *
+ * Description:
+ *   Remove up to 'len' bytes from the pipe buffer and copy them to
+ *   'buffer', in at most two segments.  Returns the number of bytes copied.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_copyout(FAR struct pipe_dev_s *dev, FAR char *buffer, size_t len)
+{
+	size_t bufsize = PIPE_BUFSIZE(dev);
+	size_t nbytes = pipecommon_nbytes(dev);
+	size_t rdndx = dev->d_rdndx;
+	size_t first;
+
+	if (len > nbytes) {
+		len = nbytes;
+	}
+
+	first = bufsize - rdndx;
+	if (first > len) {
+		first = len;
+	}
+
+	memcpy(buffer, &dev->d_buffer[rdndx], first);
+	memcpy(buffer + first, dev->d_buffer, len - first);
+
+	rdndx += len;
+	if (rdndx >= bufsize) {
+		rdndx -= bufsize;
+	}
+
+	dev->d_rdndx = rdndx;
+	return len;
+}
+
+/****************************************************************************
+ * Name: pipecommon_grow
+ *
+ * Description:
+ *   Make room for 'len' more bytes by doubling the size of the pipe buffer,
+ *   up to PIPE_MAXSIZE bytes.  The buffered data moves to the start of the
+ *   new buffer.  Nothing changes if the buffer cannot be allocated; the
+ *   writer then waits for the reader as it does with a fixed size buffer.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_PIPE_GROW
+static void pipecommon_grow(FAR struct pipe_dev_s *dev, size_t len)
+{
+	size_t nbytes = pipecommon_nbytes(dev);
+	size_t bufsize = dev->d_bufsize;
+	FAR uint8_t *buffer;
+
+	while (bufsize - 1 - nbytes < len && bufsize < PIPE_MAXSIZE) {
+		bufsize *= 2;
+		if (bufsize > PIPE_MAXSIZE) {
+			bufsize = PIPE_MAXSIZE;
+		}
+	}
+
+	if (bufsize == dev->d_bufsize) {
+		return;
+	}
+
+	buffer = (FAR uint8_t *)kmm_malloc(bufsize);
+	if (buffer == NULL) {
+		return;
+	}
+
+	(void)pipecommon_copyout(dev, (FAR char *)buffer, nbytes);
+	kmm_free(dev->d_buffer);
+
+	dev->d_buffer = buffer;
+	dev->d_bufsize = bufsize;
+	dev->d_rdndx = 0;
+	dev->d_wrndx = nbytes;
+}
+#endif
+
 /****************************************************************************
  * Name: pipecommon_pollnotify
  ****************************************************************************/
@@ -144,7 +299,7 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev, pollevent_t events
 			fds->revents |= (fds->events & eventset);
 			if (fds->revents != 0) {
 				fvdbg("Report events: %02x\n", fds->revents);
-				sem_post(fds->sem);
+				poll_notify(fds);
 			}
 		}
 	}
@@ -207,7 +362,6 @@ int pipecommon_open(FAR struct file *filep)
 {
 	struct inode *inode = filep->f_inode;
 	struct pipe_dev_s *dev = inode->i_private;
-	int sval;
 	int ret;
 
 	DEBUGASSERT(dev);
@@ -234,6 +388,9 @@ int pipecommon_open(FAR struct file *filep)
 			(void)sem_post(&dev->d_bfsem);
 			return -ENOMEM;
 		}
+#ifdef HAVE_PIPE_GROW
+		dev->d_bufsize = CONFIG_DEV_PIPE_SIZE;
+#endif
 	}
 
 	/* Increment the reference count on the pipe instance */
@@ -250,9 +407,7 @@ int pipecommon_open(FAR struct file *filep)
 		 */
 
 		if (dev->d_nwriters == 1) {
-			while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0) {
-				sem_post(&dev->d_rdsem);
-			}
+			pipecommon_wakeup(&dev->d_rdsem);
 		}
 	}
 
@@ -304,7 +459,6 @@ int pipecommon_close(FAR struct file *filep)
 {
 	struct inode *inode = filep->f_inode;
 	struct pipe_dev_s *dev = inode->i_private;
-	int sval;
 
 	DEBUGASSERT(dev && dev->d_refs > 0);
 
@@ -332,9 +486,7 @@ int pipecommon_close(FAR struct file *filep)
 			 */
 
 			if (--dev->d_nwriters <= 0) {
-				while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0) {
-					sem_post(&dev->d_rdsem);
-				}
+				pipecommon_wakeup(&dev->d_rdsem);
 			}
 		}
 	}
@@ -381,11 +533,7 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 {
 	struct inode *inode = filep->f_inode;
 	struct pipe_dev_s *dev = inode->i_private;
-#ifdef CONFIG_DEV_PIPEDUMP
-	FAR uint8_t *start = (uint8_t *)buffer;
-#endif
-	ssize_t nread = 0;
-	int sval;
+	ssize_t nread;
 	int ret;
 
 	DEBUGASSERT(dev);
@@ -431,27 +579,18 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
 	/* Then return whatever is available in the pipe (which is at least one byte) */
 
-	nread = 0;
-	while (nread < len && dev->d_wrndx != dev->d_rdndx) {
-		*buffer++ = dev->d_buffer[dev->d_rdndx];
-		if (++dev->d_rdndx >= CONFIG_DEV_PIPE_SIZE) {
-			dev->d_rdndx = 0;
-		}
-		nread++;
-	}
+	nread = pipecommon_copyout(dev, buffer, len);
 
 	/* Notify all waiting writers that bytes have been removed from the buffer */
 
-	while (sem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0) {
-		sem_post(&dev->d_wrsem);
-	}
+	pipecommon_wakeup(&dev->d_wrsem);
 
 	/* Notify all poll/select waiters that they can write to the FIFO */
 
 	pipecommon_pollnotify(dev, POLLOUT);
 
 	sem_post(&dev->d_bfsem);
-	pipe_dumpbuffer("From PIPE:", start, nread);
+	pipe_dumpbuffer("From PIPE:", (uint8_t *)buffer, nread);
 	return nread;
 }
 
@@ -465,8 +604,6 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer, size_t
 	struct pipe_dev_s *dev = inode->i_private;
 	ssize_t nwritten = 0;
 	ssize_t last;
-	int nxtwrndx;
-	int sval;
 
 	DEBUGASSERT(dev);
 	pipe_dumpbuffer("To PIPE:", (uint8_t *)buffer, len);
@@ -487,81 +624,72 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer, size_t
 	 * of taking semaphores so that pipes can be written from interupt handlers
 	 */
 
-	DEBUGASSERT(up_interrupt_context() == false)
+	DEBUGASSERT(up_interrupt_context() == false);
 
 	/* Make sure that we have exclusive access to the device structure */
 	if (sem_wait(&dev->d_bfsem) < 0) {
 		return ERROR;
 	}
 
-	/* Loop until all of the bytes have been written */
+	/* Loop until all of the bytes have been written.  Each pass copies as
+	 * much as fits in the buffer.
+	 */
 
 	last = 0;
 	for (;;) {
-		/* Calculate the write index AFTER the next byte is written */
-
-		nxtwrndx = dev->d_wrndx + 1;
-		if (nxtwrndx >= CONFIG_DEV_PIPE_SIZE) {
-			nxtwrndx = 0;
+#ifdef HAVE_PIPE_GROW
+		pipecommon_grow(dev, len - nwritten);
+#endif
+		nwritten += pipecommon_copyin(dev, buffer + nwritten, len - nwritten);
+		if (nwritten >= len) {
+			break;
 		}
 
-		/* Would the next write overflow the circular buffer? */
-
-		if (nxtwrndx != dev->d_rdndx) {
-			/* No... copy the byte */
-
-			dev->d_buffer[dev->d_wrndx] = *buffer++;
-			dev->d_wrndx = nxtwrndx;
-
-			/* Is the write complete? */
+		/* The buffer is full.  Was anything written since the readers were
+		 * last notified?
+		 */
 
-			if (++nwritten >= len) {
-				/* Yes.. Notify all of the waiting readers that more data is available */
+		if (last < nwritten) {
+			/* Yes.. Notify all of the waiting readers that more data is available */
 
-				while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0) {
-					sem_post(&dev->d_rdsem);
-				}
+			pipecommon_wakeup(&dev->d_rdsem);
+			pipecommon_pollnotify(dev, POLLIN);
+		}
+		last = nwritten;
 
-				/* Notify all poll/select waiters that they can write to the FIFO */
+		/* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
 
-				pipecommon_pollnotify(dev, POLLIN);
+		if (filep->f_oflags & O_NONBLOCK) {
+			if (nwritten == 0) {
+				nwritten = -EAGAIN;
+			}
+			sem_post(&dev->d_bfsem);
+			return nwritten;
+		}
 
-				/* Return the number of bytes written */
+		/* There is more to be written.. wait for data to be removed from the pipe */
 
-				sem_post(&dev->d_bfsem);
-				return len;
-			}
-		} else {
-			/* There is not enough room for the next byte. Was anything written in this pass? */
+		sched_lock();
+		sem_post(&dev->d_bfsem);
+		pipecommon_semtake(&dev->d_wrsem);
+		sched_unlock();
+		pipecommon_semtake(&dev->d_bfsem);
+	}
 
-			if (last < nwritten) {
-				/* Yes.. Notify all of the waiting readers that more data is available */
+	/* The write is complete.  Notify all of the waiting readers that more data
+	 * is available.
+	 */
 
-				while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0) {
-					sem_post(&dev->d_rdsem);
-				}
-			}
-			last = nwritten;
+	pipecommon_wakeup(&dev->d_rdsem);
 
-			/* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
+	/* Notify all poll/select waiters that they can read from the FIFO */
 
-			if (filep->f_oflags & O_NONBLOCK) {
-				if (nwritten == 0) {
-					nwritten = -EAGAIN;
-				}
-				sem_post(&dev->d_bfsem);
-				return nwritten;
-			}
+	pipecommon_pollnotify(dev, POLLIN);
 
-			/* There is more to be written.. wait for data to be removed from the pipe */
+	/* Return the number of bytes written */
 
-			sched_lock();
-			sem_post(&dev->d_bfsem);
-			pipecommon_semtake(&dev->d_wrsem);
-			sched_unlock();
-			pipecommon_semtake(&dev->d_bfsem);
-		}
-	}
+	sem_post(&dev->d_bfsem);
+	return len;
 }
 
 /****************************************************************************
@@ -574,7 +702,7 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
 	FAR struct inode *inode = filep->f_inode;
 	FAR struct pipe_dev_s *dev = inode->i_private;
 	pollevent_t eventset;
-	pipe_ndx_t nbytes;
+	size_t nbytes;
 	int ret = OK;
 	int i;
 
@@ -610,16 +738,12 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
 		 * First, determine how many bytes are in the buffer
 		 */
 
-		if (dev->d_wrndx >= dev->d_rdndx) {
-			nbytes = dev->d_wrndx - dev->d_rdndx;
-		} else {
-			nbytes = (CONFIG_DEV_PIPE_SIZE - 1) + dev->d_wrndx - dev->d_rdndx;
-		}
+		nbytes = pipecommon_nbytes(dev);
 
 		/* Notify the POLLOUT event if the pipe is not full */
 
 		eventset = 0;
-		if (nbytes < (CONFIG_DEV_PIPE_SIZE - 1)) {
+		if (nbytes < PIPE_BUFSIZE(dev) - 1) {
 			eventset |= POLLOUT;
 		}
 
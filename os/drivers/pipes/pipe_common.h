@@ -68,6 +68,10 @@
 #define CONFIG_DEV_PIPE_SIZE 1024
 #endif
 
+#ifndef CONFIG_DEV_PIPE_MAXSIZE
+#define CONFIG_DEV_PIPE_MAXSIZE 0
+#endif
+
 #if CONFIG_DEV_PIPE_SIZE > 0
 
 /****************************************************************************
@@ -97,15 +101,30 @@
 #define PIPE_UNLINK(f)      do { (f) |= PIPE_FLAG_UNLINKED; } while (0)
 #define PIPE_IS_UNLINKED(f) (((f) & PIPE_FLAG_UNLINKED) != 0)
 
+/* A pipe buffer starts with CONFIG_DEV_PIPE_SIZE bytes.  If
+ * CONFIG_DEV_PIPE_MAXSIZE is larger, the buffer grows on demand up to that
+ * size and the current size is kept in d_bufsize.
+ */
+
+#if CONFIG_DEV_PIPE_MAXSIZE > CONFIG_DEV_PIPE_SIZE
+#define HAVE_PIPE_GROW      1
+#define PIPE_MAXSIZE        CONFIG_DEV_PIPE_MAXSIZE
+#define PIPE_BUFSIZE(d)     ((d)->d_bufsize)
+#else
+#undef  HAVE_PIPE_GROW
+#define PIPE_MAXSIZE        CONFIG_DEV_PIPE_SIZE
+#define PIPE_BUFSIZE(d)     CONFIG_DEV_PIPE_SIZE
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
-/* Make the buffer index as small as possible for the configured pipe size */
+/* Make the buffer index as small as possible for the largest pipe size */
 
-#if CONFIG_DEV_PIPE_SIZE > 65535
+#if PIPE_MAXSIZE > 65535
 typedef uint32_t pipe_ndx_t;	/* 32-bit index */
-#elif CONFIG_DEV_PIPE_SIZE > 255
+#elif PIPE_MAXSIZE > 255
 typedef uint16_t pipe_ndx_t;	/* 16-bit index */
 #else
 typedef uint8_t pipe_ndx_t;		/*  8-bit index */
@@ -122,6 +141,9 @@ struct pipe_dev_s {
 	sem_t d_wrsem;				/* Full buffer - Writer waits for data read */
 	pipe_ndx_t d_wrndx;			/* Index in d_buffer to save next byte written */
 	pipe_ndx_t d_rdndx;			/* Index in d_buffer to return the next byte read */
+#ifdef HAVE_PIPE_GROW
+	pipe_ndx_t d_bufsize;		/* Size of d_buffer */
+#endif
 	uint8_t d_refs;				/* References counts on pipe (limited to 255) */
 	uint8_t d_nwriters;			/* Number of reference counts for write access */
 	uint8_t d_pipeno;			/* Pipe minor number */
@@ -873,6 +873,28 @@ int rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock, size_t nblocks, FAR
 		return ret;
 }
 
+/****************************************************************************
+ * Name: rwb_flush
+ *
+ * Description:
+ *   Write the contents of the write buffer to the media now
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+int rwb_flush(FAR struct rwbuffer_s *rwb)
+{
+	if (rwb->wrmaxblocks > 0) {
+		rwb_semtake(&rwb->wrsem);
+		rwb_wrcanceltimeout(rwb);
+		rwb_wrflush(rwb);
+		rwb_semgive(&rwb->wrsem);
+	}
+
+	return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: rwb_readbytes
  *
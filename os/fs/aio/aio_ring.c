@@ -0,0 +1,630 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/aio/aio_ring.c
+ *
+ * Batched asynchronous I/O.  aio_ring_setup() creates a ring: queues of
+ * submission and completion entries shared with the caller, and a file
+ * descriptor that represents them.  aio_ring_enter() takes the entries the
+ * caller has filled, offers each to its driver with FIOC_AIOSUBMIT and
+ * queues the rest for a single work item on the low priority work queue,
+ * which performs them in order.  Every completion is posted to the
+ * completion queue, wakes a caller waiting in aio_ring_enter() and
+ * notifies poll().
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <queue.h>
+#include <semaphore.h>
+#include <aio.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <arch/irq.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/wqueue.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/ioctl.h>
+
+#ifdef CONFIG_FS_AIO_RING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_AIO_RING_MAXENTRIES
+#define CONFIG_FS_AIO_RING_MAXENTRIES 64
+#endif
+
+#ifndef CONFIG_FS_AIO_RING_NPOLLWAITERS
+#define CONFIG_FS_AIO_RING_NPOLLWAITERS 2
+#endif
+
+#define AIO_RING_DEVFMT "/dev/aioring%u"
+#define AIO_RING_DEVNAMELEN 20
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct aio_ringdev_s {
+	FAR struct aio_ring_s *ring;	/* The queues shared with the caller */
+	sem_t exclsem;				/* Serializes aio_ring_enter() */
+	sem_t waitsem;				/* Posted on completion if 'waiting' */
+	volatile bool waiting;		/* A thread waits on waitsem */
+	volatile bool queued;		/* The work item is queued or running */
+	volatile uint16_t inflight;	/* Requests not yet completed */
+	uint8_t crefs;				/* Number of open references */
+	sq_queue_t pending;			/* Requests for the work item */
+	sq_queue_t freereqs;		/* Unused requests */
+	struct work_s work;			/* Performs pending requests */
+#ifndef CONFIG_DISABLE_POLL
+	FAR struct pollfd *fds[CONFIG_FS_AIO_RING_NPOLLWAITERS];
+#endif
+	struct aio_request_s reqs[1];	/* One per ring entry, allocated with the device */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int aio_ring_open(FAR struct file *filep);
+static int aio_ring_close(FAR struct file *filep);
+#ifndef CONFIG_DISABLE_POLL
+static int aio_ring_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_aio_ringops = {
+	aio_ring_open,				/* open */
+	aio_ring_close,				/* close */
+	NULL,						/* read */
+	NULL,						/* write */
+	NULL,						/* seek */
+	NULL,						/* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+	aio_ring_poll,				/* poll */
+#endif
+	NULL						/* unlink */
+};
+
+/* Used to give each ring a unique, temporary device name */
+
+static unsigned int g_aio_ringno;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_ring_semtake
+ ****************************************************************************/
+
+static void aio_ring_semtake(FAR sem_t *sem)
+{
+	while (sem_wait(sem) != 0) {
+		ASSERT(get_errno() == EINTR);
+	}
+}
+
+/****************************************************************************
+ * Name: aio_ring_pollnotify
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static void aio_ring_pollnotify(FAR struct aio_ringdev_s *dev, pollevent_t eventset)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_FS_AIO_RING_NPOLLWAITERS; i++) {
+		FAR struct pollfd *fds = dev->fds[i];
+		if (fds) {
+			fds->revents |= (fds->events & eventset);
+			if (fds->revents != 0) {
+				poll_notify(fds);
+			}
+		}
+	}
+}
+#else
+#define aio_ring_pollnotify(dev, eventset)
+#endif
+
+/****************************************************************************
+ * Name: aio_ring_perform
+ *
+ * Description:
+ *   Perform one request on the work queue.  Returns the number of bytes
+ *   transferred or a negated errno value.
+ *
+ ****************************************************************************/
+
+static ssize_t aio_ring_perform(FAR struct aio_request_s *req)
+{
+	ssize_t ret;
+
+	switch (req->op) {
+	case AIO_RING_READ:
+		ret = file_pread(req->filep, req->buf, req->nbytes, req->offset);
+		break;
+
+	case AIO_RING_WRITE:
+		if ((req->filep->f_oflags & O_APPEND) != 0) {
+			ret = file_write(req->filep, req->buf, req->nbytes);
+		} else {
+			ret = file_pwrite(req->filep, req->buf, req->nbytes, req->offset);
+		}
+		break;
+
+	case AIO_RING_FSYNC:
+		ret = file_fsync(req->filep);
+		break;
+
+	default:
+		return -EINVAL;
+	}
+
+	return ret < 0 ? -get_errno() : ret;
+}
+
+/****************************************************************************
+ * Name: aio_ring_worker
+ *
+ * Description:
+ *   Perform the pending requests of a ring, one after another, until none
+ *   is left.
+ *
+ ****************************************************************************/
+
+static void aio_ring_worker(FAR void *arg)
+{
+	FAR struct aio_ringdev_s *dev = (FAR struct aio_ringdev_s *)arg;
+	FAR struct aio_request_s *req;
+	irqstate_t flags;
+
+	for (;;) {
+		flags = irqsave();
+		req = (FAR struct aio_request_s *)sq_remfirst(&dev->pending);
+		if (req == NULL) {
+			/* Done.  The ring may be freed as soon as this is seen */
+
+			dev->queued = false;
+			if (dev->waiting) {
+				dev->waiting = false;
+				sem_post(&dev->waitsem);
+			}
+
+			irqrestore(flags);
+			return;
+		}
+
+		irqrestore(flags);
+		aio_ring_complete(req, aio_ring_perform(req));
+	}
+}
+
+/****************************************************************************
+ * Name: aio_ring_submit
+ *
+ * Description:
+ *   Start one request.  Returns true if it must be performed on the work
+ *   queue.
+ *
+ ****************************************************************************/
+
+static bool aio_ring_submit(FAR struct aio_request_s *req, FAR const struct aio_sqe_s *sqe)
+{
+	FAR struct inode *inode;
+
+	req->op = sqe->op;
+	req->offset = sqe->offset;
+	req->buf = (FAR void *)sqe->buf;
+	req->nbytes = sqe->nbytes;
+	req->udata = sqe->udata;
+
+	if (req->op == AIO_RING_NOP) {
+		aio_ring_complete(req, 0);
+		return false;
+	}
+
+	if (req->op != AIO_RING_READ && req->op != AIO_RING_WRITE && req->op != AIO_RING_FSYNC) {
+		aio_ring_complete(req, -EINVAL);
+		return false;
+	}
+
+	/* Look the file up now, in the caller's file list */
+
+	req->filep = fs_getfilep(sqe->fd);
+	if (req->filep == NULL) {
+		aio_ring_complete(req, -EBADF);
+		return false;
+	}
+
+	/* Offer the request to the driver */
+
+	inode = req->filep->f_inode;
+	if (inode && inode->u.i_ops && inode->u.i_ops->ioctl && inode->u.i_ops->ioctl(req->filep, FIOC_AIOSUBMIT, (unsigned long)((uintptr_t)req)) == OK) {
+		return false;
+	}
+
+	return true;
+}
+
+/****************************************************************************
+ * Name: aio_ring_open
+ ****************************************************************************/
+
+static int aio_ring_open(FAR struct file *filep)
+{
+	FAR struct aio_ringdev_s *dev = filep->f_inode->i_private;
+
+	aio_ring_semtake(&dev->exclsem);
+	dev->crefs++;
+	sem_post(&dev->exclsem);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: aio_ring_close
+ *
+ * Description:
+ *   On the last close, wait for the requests in flight and free the ring.
+ *
+ ****************************************************************************/
+
+static int aio_ring_close(FAR struct file *filep)
+{
+	FAR struct aio_ringdev_s *dev = filep->f_inode->i_private;
+	irqstate_t flags;
+
+	aio_ring_semtake(&dev->exclsem);
+	if (--dev->crefs > 0) {
+		sem_post(&dev->exclsem);
+		return OK;
+	}
+
+	flags = irqsave();
+	while (dev->inflight > 0 || dev->queued) {
+		dev->waiting = true;
+		aio_ring_semtake(&dev->waitsem);
+	}
+
+	irqrestore(flags);
+
+	sem_destroy(&dev->waitsem);
+	sem_destroy(&dev->exclsem);
+	kumm_free(dev->ring);
+	kmm_free(dev);
+	filep->f_inode->i_private = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: aio_ring_poll
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static int aio_ring_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
+{
+	FAR struct aio_ringdev_s *dev = filep->f_inode->i_private;
+	FAR struct aio_ring_s *ring = dev->ring;
+	pollevent_t eventset;
+	irqstate_t flags;
+	int i;
+
+	flags = irqsave();
+	if (setup) {
+		for (i = 0; i < CONFIG_FS_AIO_RING_NPOLLWAITERS; i++) {
+			if (!dev->fds[i]) {
+				dev->fds[i] = fds;
+				fds->priv = &dev->fds[i];
+				break;
+			}
+		}
+
+		if (i >= CONFIG_FS_AIO_RING_NPOLLWAITERS) {
+			fds->priv = NULL;
+			irqrestore(flags);
+			return -EBUSY;
+		}
+
+		/* Readable if completions are waiting, writable if the submission
+		 * queue has room.
+		 */
+
+		eventset = 0;
+		if (ring->cq_head != ring->cq_tail) {
+			eventset |= POLLIN;
+		}
+
+		if ((uint16_t)(ring->sq_tail - ring->sq_head) < ring->entries) {
+			eventset |= POLLOUT;
+		}
+
+		if (eventset) {
+			aio_ring_pollnotify(dev, eventset);
+		}
+	} else if (fds->priv) {
+		*(FAR struct pollfd **)fds->priv = NULL;
+		fds->priv = NULL;
+	}
+
+	irqrestore(flags);
+	return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_ring_complete
+ *
+ * Description:
+ *   Post the result of a request to the completion queue of its ring.
+ *
+ ****************************************************************************/
+
+void aio_ring_complete(FAR struct aio_request_s *req, ssize_t result)
+{
+	FAR struct aio_ringdev_s *dev = (FAR struct aio_ringdev_s *)req->ring;
+	FAR struct aio_ring_s *ring = dev->ring;
+	FAR struct aio_cqe_s *cqe;
+	irqstate_t flags;
+
+	flags = irqsave();
+
+	/* aio_ring_enter() keeps a completion entry free for every request in
+	 * flight, so the completion queue cannot overflow.
+	 */
+
+	DEBUGASSERT((uint16_t)(ring->cq_tail - ring->cq_head) < ring->entries);
+	cqe = &ring->cq[ring->cq_tail & (ring->entries - 1)];
+	cqe->udata = req->udata;
+	cqe->result = result;
+	ring->cq_tail++;
+
+	sq_addlast((FAR sq_entry_t *)req, &dev->freereqs);
+	dev->inflight--;
+
+	aio_ring_pollnotify(dev, POLLIN);
+
+	if (dev->waiting) {
+		dev->waiting = false;
+		sem_post(&dev->waitsem);
+	}
+
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: aio_ring_setup
+ *
+ * Description:
+ *   Create a ring with 'entries' submission and completion entries.
+ *
+ * Input Parameters:
+ *   entries - The queue size, a power of two up to
+ *             CONFIG_FS_AIO_RING_MAXENTRIES
+ *   ring    - The location to return the shared queues
+ *
+ * Returned Value:
+ *   A file descriptor for the ring, to be used with aio_ring_enter(),
+ *   poll() and close().  On failure, -1 is returned and the errno is set.
+ *
+ ****************************************************************************/
+
+int aio_ring_setup(unsigned int entries, FAR struct aio_ring_s **ring)
+{
+	FAR struct aio_ringdev_s *dev;
+	FAR struct aio_ring_s *shared;
+	char devname[AIO_RING_DEVNAMELEN];
+	irqstate_t flags;
+	unsigned int i;
+	int errcode;
+	int fd;
+	int ret;
+
+	if (ring == NULL || entries == 0 || entries > CONFIG_FS_AIO_RING_MAXENTRIES || (entries & (entries - 1)) != 0) {
+		errcode = EINVAL;
+		goto errout;
+	}
+
+	dev = (FAR struct aio_ringdev_s *)kmm_zalloc(sizeof(struct aio_ringdev_s) + (entries - 1) * sizeof(struct aio_request_s));
+	if (dev == NULL) {
+		errcode = ENOMEM;
+		goto errout;
+	}
+
+	/* The queues are in user memory so that the caller can reach them */
+
+	shared = (FAR struct aio_ring_s *)kumm_zalloc(sizeof(struct aio_ring_s) + entries * (sizeof(struct aio_sqe_s) + sizeof(struct aio_cqe_s)));
+	if (shared == NULL) {
+		errcode = ENOMEM;
+		goto errout_with_dev;
+	}
+
+	shared->entries = entries;
+	shared->sq = (FAR struct aio_sqe_s *)(shared + 1);
+	shared->cq = (FAR struct aio_cqe_s *)(shared->sq + entries);
+
+	dev->ring = shared;
+	sem_init(&dev->exclsem, 0, 1);
+	sem_init(&dev->waitsem, 0, 0);
+	sq_init(&dev->pending);
+	sq_init(&dev->freereqs);
+	for (i = 0; i < entries; i++) {
+		dev->reqs[i].ring = dev;
+		sq_addlast((FAR sq_entry_t *)&dev->reqs[i], &dev->freereqs);
+	}
+
+	/* Like pipe(), register a driver, open it and remove its name again.
+	 * The inode lives on until the descriptor is closed.
+	 */
+
+	flags = irqsave();
+	i = g_aio_ringno++;
+	irqrestore(flags);
+
+	snprintf(devname, AIO_RING_DEVNAMELEN, AIO_RING_DEVFMT, i);
+	ret = register_driver(devname, &g_aio_ringops, 0666, (FAR void *)dev);
+	if (ret < 0) {
+		errcode = -ret;
+		goto errout_with_shared;
+	}
+
+	fd = open(devname, O_RDWR);
+	unregister_driver(devname);
+	if (fd < 0) {
+		errcode = get_errno();
+		goto errout_with_shared;
+	}
+
+	*ring = shared;
+	return fd;
+
+errout_with_shared:
+	sem_destroy(&dev->waitsem);
+	sem_destroy(&dev->exclsem);
+	kumm_free(shared);
+
+errout_with_dev:
+	kmm_free(dev);
+
+errout:
+	set_errno(errcode);
+	return ERROR;
+}
+
+/****************************************************************************
+ * Name: aio_ring_enter
+ *
+ * Description:
+ *   Submit up to 'to_submit' filled submission entries, then wait until at
+ *   least 'min_complete' completion entries are waiting to be read.
+ *   Entries are taken only while the completion queue has room for their
+ *   results.
+ *
+ * Input Parameters:
+ *   fd           - The ring descriptor returned by aio_ring_setup()
+ *   to_submit    - The most submission entries to take
+ *   min_complete - The number of completion entries to wait for.  It is
+ *                  reduced to the number that can still arrive.
+ *
+ * Returned Value:
+ *   The number of submission entries taken.  On failure, -1 is returned
+ *   and the errno is set.
+ *
+ ****************************************************************************/
+
+int aio_ring_enter(int fd, unsigned int to_submit, unsigned int min_complete)
+{
+	FAR struct aio_ringdev_s *dev;
+	FAR struct aio_ring_s *ring;
+	FAR struct aio_request_s *req;
+	FAR struct file *filep;
+	irqstate_t flags;
+	unsigned int submitted;
+	bool needwork = false;
+
+	filep = fs_getfilep(fd);
+	if (filep == NULL) {
+		return ERROR;
+	}
+
+	if (filep->f_inode == NULL || filep->f_inode->u.i_ops != &g_aio_ringops) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	dev = (FAR struct aio_ringdev_s *)filep->f_inode->i_private;
+	ring = dev->ring;
+
+	aio_ring_semtake(&dev->exclsem);
+
+	for (submitted = 0; submitted < to_submit && ring->sq_head != ring->sq_tail; submitted++) {
+		flags = irqsave();
+		if (dev->inflight + (uint16_t)(ring->cq_tail - ring->cq_head) >= ring->entries) {
+			/* No room for the result */
+
+			irqrestore(flags);
+			break;
+		}
+
+		req = (FAR struct aio_request_s *)sq_remfirst(&dev->freereqs);
+		DEBUGASSERT(req != NULL);
+		dev->inflight++;
+		irqrestore(flags);
+
+		if (aio_ring_submit(req, &ring->sq[ring->sq_head & (ring->entries - 1)])) {
+			flags = irqsave();
+			sq_addlast((FAR sq_entry_t *)req, &dev->pending);
+			irqrestore(flags);
+			needwork = true;
+		}
+
+		ring->sq_head++;
+	}
+
+	/* One work item performs all of the pending requests */
+
+	flags = irqsave();
+	if (needwork && !dev->queued) {
+		dev->queued = true;
+		work_queue(LPWORK, &dev->work, aio_ring_worker, dev, 0);
+	}
+
+	/* Wait for completions that can still arrive */
+
+	if (min_complete > dev->inflight + (uint16_t)(ring->cq_tail - ring->cq_head)) {
+		min_complete = dev->inflight + (uint16_t)(ring->cq_tail - ring->cq_head);
+	}
+
+	while ((uint16_t)(ring->cq_tail - ring->cq_head) < min_complete) {
+		dev->waiting = true;
+		if (sem_wait(&dev->waitsem) < 0) {
+			/* Interrupted by a signal */
+
+			dev->waiting = false;
+			break;
+		}
+	}
+
+	irqrestore(flags);
+
+	sem_post(&dev->exclsem);
+	return submitted;
+}
+
+#endif							/* CONFIG_FS_AIO_RING */
@@ -46,6 +46,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <semaphore.h>
+#include <assert.h>
 #include <debug.h>
 #include <errno.h>
 
@@ -54,7 +56,7 @@
 #include <tinyara/fs/ioctl.h>
 #include <tinyara/fs/mtd.h>
 #if defined(CONFIG_FTL_READAHEAD) || defined(CONFIG_FTL_WRITEBUFFER)
-#include <tinyara/drivers/rwbuffer.h>
+#include <tinyara/rwbuffer.h>
 #endif
 
 /****************************************************************************
@@ -65,10 +67,31 @@
 #  define FTL_HAVE_RWBUFFER 1
 #endif
 
+/* Number of erase blocks cached for writing.  With no cache, every partial
+ * erase block write reads, erases and programs the whole erase block.
+ */
+
+#ifndef CONFIG_FTL_NEBCACHE
+#  define CONFIG_FTL_NEBCACHE 0
+#endif
+
+#if defined(CONFIG_FS_WRITABLE) && CONFIG_FTL_NEBCACHE > 0
+#  define FTL_HAVE_EBCACHE 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef FTL_HAVE_EBCACHE
+struct ftl_eblock_s {
+	off_t                 eraseblock; /* The erase block cached or -1 */
+	uint32_t              lru;     /* Value of lrucount at the last access */
+	bool                  dirty;   /* true: Not yet written to the device */
+	FAR uint8_t          *buffer;  /* One erase block of ftl_struct_s::eblock */
+};
+#endif
+
 struct ftl_struct_s {
 	FAR struct mtd_dev_s *mtd;     /* Contained MTD interface */
 	struct mtd_geometry_s geo;     /* Device geometry */
@@ -77,7 +100,13 @@ struct ftl_struct_s {
 #endif
 	uint16_t              blkper;  /* R/W blocks per erase block */
 #ifdef CONFIG_FS_WRITABLE
-	FAR uint8_t          *eblock;  /* One, in-memory erase block */
+	FAR uint8_t          *eblock;  /* One, in-memory erase block per cache entry */
+	struct ftl_wrstats_s  stats;   /* Write statistics */
+#endif
+#ifdef FTL_HAVE_EBCACHE
+	sem_t                 exclsem; /* Exclusive access to the cache */
+	uint32_t              lrucount; /* Counts accesses to the cache */
+	struct ftl_eblock_s   cache[CONFIG_FTL_NEBCACHE];
 #endif
 };
 
@@ -91,6 +120,7 @@ static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer, off_t startblock,
 static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer, size_t start_sector, unsigned int nsectors);
 #ifdef CONFIG_FS_WRITABLE
 static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer, off_t startblock, size_t nblocks);
+static int     ftl_sync(FAR struct ftl_struct_s *dev);
 static ssize_t ftl_write(FAR struct inode *inode, const unsigned char *buffer, size_t start_sector, unsigned int nsectors);
 #endif
 static int     ftl_geometry(FAR struct inode *inode, struct geometry *geometry);
@@ -143,9 +173,80 @@ static int ftl_open(FAR struct inode *inode)
 static int ftl_close(FAR struct inode *inode)
 {
 	fvdbg("Entry\n");
+
+#ifdef CONFIG_FS_WRITABLE
+	/* Write back the data still buffered for this device */
+
+	DEBUGASSERT(inode && inode->i_private);
+	return ftl_sync((FAR struct ftl_struct_s *)inode->i_private);
+#else
 	return OK;
+#endif
+}
+
+/****************************************************************************
+ * Name: ftl_semtake
+ ****************************************************************************/
+
+#ifdef FTL_HAVE_EBCACHE
+static void ftl_semtake(FAR struct ftl_struct_s *dev)
+{
+	while (sem_wait(&dev->exclsem) != 0) {
+		/* The only case that an error should occur here is if the wait was
+		 * awakened by a signal.
+		 */
+
+		ASSERT(get_errno() == EINTR);
+	}
 }
 
+#define ftl_semgive(d) sem_post(&(d)->exclsem)
+#endif
+
+/****************************************************************************
+ * Name: ftl_overlay
+ *
+ * Description:
+ *   Copy the dirty cached data over the stale data of the blocks from
+ *   'startblock' just read from the device.
+ *
+ ****************************************************************************/
+
+#ifdef FTL_HAVE_EBCACHE
+static void ftl_overlay(FAR struct ftl_struct_s *dev, FAR uint8_t *buffer, off_t startblock, size_t nblocks)
+{
+	FAR struct ftl_eblock_s *entry;
+	off_t first;
+	off_t last;
+	int i;
+
+	for (i = 0; i < CONFIG_FTL_NEBCACHE; i++) {
+		entry = &dev->cache[i];
+		if (!entry->dirty) {
+			continue;
+		}
+
+		/* The overlap of the erase block with the blocks read */
+
+		first = entry->eraseblock * dev->blkper;
+		last  = first + dev->blkper;
+		if (first < startblock) {
+			first = startblock;
+		}
+
+		if (last > startblock + (off_t)nblocks) {
+			last = startblock + nblocks;
+		}
+
+		if (first < last) {
+			memcpy(buffer + (first - startblock) * dev->geo.blocksize,
+				   entry->buffer + (first & (dev->blkper - 1)) * dev->geo.blocksize,
+				   (last - first) * dev->geo.blocksize);
+		}
+	}
+}
+#endif
+
 /****************************************************************************
  * Name: ftl_reload
  *
@@ -164,6 +265,15 @@ static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer, off_t startblock,
 	if (nread != nblocks) {
 		dbg("ERROR: Read %d blocks starting at block %d failed: %d\n", nblocks, startblock, nread);
 	}
+#ifdef FTL_HAVE_EBCACHE
+	else {
+		/* The cache holds newer data than the device */
+
+		ftl_semtake(dev);
+		ftl_overlay(dev, buffer, startblock, nblocks);
+		ftl_semgive(dev);
+	}
+#endif
 
 	return nread;
 }
@@ -192,6 +302,193 @@ static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
 #endif
 }
 
+/****************************************************************************
+ * Name: ftl_program
+ *
+ * Description: Erase one erase block and program it with 'buffer'
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static int ftl_program(FAR struct ftl_struct_s *dev, off_t rwblock, FAR const uint8_t *buffer)
+{
+	off_t  eraseblock;
+	size_t nxfrd;
+	int    ret;
+
+	/* Erase the erase block */
+
+	eraseblock = rwblock / dev->blkper;
+	ret        = MTD_ERASE(dev->mtd, eraseblock, 1);
+	if (ret < 0) {
+		dbg("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
+		return ret;
+	}
+
+	dev->stats.nerased++;
+
+	/* Write the full erase block back to flash */
+
+	fvdbg("Write %d bytes into erase block=%d at offset=0\n",
+		  dev->geo.erasesize, eraseblock);
+
+	nxfrd = MTD_BWRITE(dev->mtd, rwblock, dev->blkper, buffer);
+	if (nxfrd != dev->blkper) {
+		dbg("ERROR: Write erase block %d failed: %d\n", rwblock, nxfrd);
+		return -EIO;
+	}
+
+	dev->stats.nprogrammed += dev->blkper;
+	return OK;
+}
+#endif
+
+#ifdef FTL_HAVE_EBCACHE
+/****************************************************************************
+ * Name: ftl_writeback
+ *
+ * Description: Write one cached erase block to the device if it is dirty
+ *
+ ****************************************************************************/
+
+static int ftl_writeback(FAR struct ftl_struct_s *dev, FAR struct ftl_eblock_s *entry)
+{
+	int ret;
+
+	if (!entry->dirty) {
+		return OK;
+	}
+
+	ret = ftl_program(dev, entry->eraseblock * dev->blkper, entry->buffer);
+	if (ret < 0) {
+		return ret;
+	}
+
+	entry->dirty = false;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_getblock
+ *
+ * Description:
+ *   Return the cache entry of 'eraseblock', reading the erase block from
+ *   the device if it is not cached.  The entry replaced is an unused one
+ *   or else the least recently used one, which is written back first.
+ *
+ ****************************************************************************/
+
+static int ftl_getblock(FAR struct ftl_struct_s *dev, off_t eraseblock, FAR struct ftl_eblock_s **entry)
+{
+	FAR struct ftl_eblock_s *victim = NULL;
+	FAR struct ftl_eblock_s *cache;
+	size_t nxfrd;
+	int ret;
+	int i;
+
+	for (i = 0; i < CONFIG_FTL_NEBCACHE; i++) {
+		cache = &dev->cache[i];
+		if (cache->eraseblock == eraseblock) {
+			cache->lru = ++dev->lrucount;
+			*entry = cache;
+			return OK;
+		}
+
+		/* Prefer an unused entry, then the one used longest ago */
+
+		if (victim == NULL) {
+			victim = cache;
+		} else if (victim->eraseblock < 0) {
+			continue;
+		} else if (cache->eraseblock < 0 || dev->lrucount - cache->lru > dev->lrucount - victim->lru) {
+			victim = cache;
+		}
+	}
+
+	ret = ftl_writeback(dev, victim);
+	if (ret < 0) {
+		return ret;
+	}
+
+	victim->eraseblock = -1;
+	nxfrd = MTD_BREAD(dev->mtd, eraseblock * dev->blkper, dev->blkper, victim->buffer);
+	if (nxfrd != dev->blkper) {
+		dbg("ERROR: Read erase block %d failed: %d\n", eraseblock, nxfrd);
+		return -EIO;
+	}
+
+	victim->eraseblock = eraseblock;
+	victim->lru        = ++dev->lrucount;
+	*entry = victim;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_flush
+ *
+ * Description:
+ *   Write the specified number of sectors.  Partial erase blocks are
+ *   merged in the erase block cache and reach the device when they are
+ *   replaced or synchronized.  Whole erase blocks that are not cached are
+ *   written directly.
+ *
+ ****************************************************************************/
+
+static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer, off_t startblock, size_t nblocks)
+{
+	struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
+	FAR struct ftl_eblock_s *entry;
+	off_t  mask;
+	off_t  eraseblock;
+	off_t  offset;
+	size_t remaining;
+	size_t count;
+	int    ret = OK;
+	int    i;
+
+	mask = dev->blkper - 1;
+
+	ftl_semtake(dev);
+	for (remaining = nblocks; remaining > 0; remaining -= count) {
+		eraseblock = startblock / dev->blkper;
+		offset     = startblock & mask;
+		count      = dev->blkper - offset;
+		if (count > remaining) {
+			count = remaining;
+		}
+
+		entry = NULL;
+		for (i = 0; i < CONFIG_FTL_NEBCACHE; i++) {
+			if (dev->cache[i].eraseblock == eraseblock) {
+				entry = &dev->cache[i];
+				break;
+			}
+		}
+
+		if (entry == NULL && count == dev->blkper) {
+			ret = ftl_program(dev, startblock, buffer);
+		} else {
+			ret = ftl_getblock(dev, eraseblock, &entry);
+			if (ret == OK) {
+				fvdbg("Copy %d blocks into erase block=%d at block=%d\n", count, eraseblock, offset);
+				memcpy(entry->buffer + offset * dev->geo.blocksize, buffer, count * dev->geo.blocksize);
+				entry->dirty = true;
+			}
+		}
+
+		if (ret < 0) {
+			break;
+		}
+
+		startblock += count;
+		buffer     += count * dev->geo.blocksize;
+	}
+
+	ftl_semgive(dev);
+	return ret < 0 ? ret : nblocks;
+}
+
+#elif defined(CONFIG_FS_WRITABLE)
 /****************************************************************************
  * Name: ftl_flush
  *
@@ -199,14 +496,12 @@ static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
  *
  ****************************************************************************/
 
-#ifdef CONFIG_FS_WRITABLE
 static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer, off_t startblock, size_t nblocks)
 {
 	struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
 	off_t  alignedblock;
 	off_t  mask;
 	off_t  rwblock;
-	off_t  eraseblock;
 	off_t  offset;
 	size_t remaining;
 	size_t nxfrd;
@@ -238,15 +533,6 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer, off_t startb
 			return -EIO;
 		}
 
-		/* Then erase the erase block */
-
-		eraseblock = rwblock / dev->blkper;
-		ret        = MTD_ERASE(dev->mtd, eraseblock, 1);
-		if (ret < 0) {
-			dbg("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
-			return ret;
-		}
-
 		/* Copy the user data at the end of the buffered erase block */
 
 		offset = (startblock & mask) * dev->geo.blocksize;
@@ -257,16 +543,15 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer, off_t startb
 			nbytes = dev->geo.erasesize - offset;
 		}
 
-		fvdbg("Copy %d bytes into erase block=%d at offset=%d\n", nbytes, eraseblock, offset);
+		fvdbg("Copy %d bytes into erase block=%d at offset=%d\n", nbytes, rwblock / dev->blkper, offset);
 
 		memcpy(dev->eblock + offset, buffer, nbytes);
 
-		/* And write the erase block back to flash */
+		/* Then erase the erase block and write it back to flash */
 
-		nxfrd = MTD_BWRITE(dev->mtd, rwblock, dev->blkper, dev->eblock);
-		if (nxfrd != dev->blkper) {
-			dbg("ERROR: Write erase block %d failed: %d\n", rwblock, nxfrd);
-			return -EIO;
+		ret = ftl_program(dev, rwblock, dev->eblock);
+		if (ret < 0) {
+			return ret;
 		}
 
 		/* Then update for amount written */
@@ -283,26 +568,13 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer, off_t startb
 	/* How handle full erase pages in the middle */
 
 	while (remaining >= dev->blkper) {
-		/* Erase the erase block */
+		/* Erase the erase block and write a full erase block back to flash */
 
-		eraseblock = alignedblock / dev->blkper;
-		ret        = MTD_ERASE(dev->mtd, eraseblock, 1);
+		ret = ftl_program(dev, alignedblock, buffer);
 		if (ret < 0) {
-			dbg("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
 			return ret;
 		}
 
-		/* Write a full erase back to flash */
-
-		fvdbg("Write %d bytes into erase block=%d at offset=0\n",
-			  dev->geo.erasesize, alignedblock);
-
-		nxfrd = MTD_BWRITE(dev->mtd, alignedblock, dev->blkper, buffer);
-		if (nxfrd != dev->blkper) {
-			dbg("ERROR: Write erase block %d failed: %d\n", alignedblock, nxfrd);
-			return -EIO;
-		}
-
 		/* Then update for amount written */
 
 		alignedblock += dev->blkper;
@@ -321,27 +593,17 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer, off_t startb
 			return -EIO;
 		}
 
-		/* Then erase the erase block */
-
-		eraseblock = alignedblock / dev->blkper;
-		ret        = MTD_ERASE(dev->mtd, eraseblock, 1);
-		if (ret < 0) {
-			dbg("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
-			return ret;
-		}
-
 		/* Copy the user data at the beginning the buffered erase block */
 
 		nbytes = remaining * dev->geo.blocksize;
 		fvdbg("Copy %d bytes into erase block=%d at offset=0\n", nbytes, alignedblock);
 		memcpy(dev->eblock, buffer, nbytes);
 
-		/* And write the erase back to flash */
+		/* Then erase the erase block and write it back to flash */
 
-		nxfrd = MTD_BWRITE(dev->mtd, alignedblock, dev->blkper, dev->eblock);
-		if (nxfrd != dev->blkper) {
-			dbg("ERROR: Write erase block %d failed: %d\n", alignedblock, nxfrd);
-			return -EIO;
+		ret = ftl_program(dev, alignedblock, dev->eblock);
+		if (ret < 0) {
+			return ret;
 		}
 	}
 
@@ -349,6 +611,44 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer, off_t startb
 }
 #endif
 
+/****************************************************************************
+ * Name: ftl_sync
+ *
+ * Description:
+ *   Write all data buffered in the write buffer and in the erase block
+ *   cache to the device
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static int ftl_sync(FAR struct ftl_struct_s *dev)
+{
+	int ret = OK;
+#ifdef FTL_HAVE_EBCACHE
+	int err;
+	int i;
+#endif
+
+#ifdef CONFIG_FTL_WRITEBUFFER
+	(void)rwb_flush(&dev->rwb);
+#endif
+
+#ifdef FTL_HAVE_EBCACHE
+	ftl_semtake(dev);
+	for (i = 0; i < CONFIG_FTL_NEBCACHE; i++) {
+		err = ftl_writeback(dev, &dev->cache[i]);
+		if (err < 0 && ret == OK) {
+			ret = err;
+		}
+	}
+
+	ftl_semgive(dev);
+#endif
+
+	return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: ftl_write
  *
@@ -365,6 +665,7 @@ static ssize_t ftl_write(FAR struct inode *inode, const unsigned char *buffer, s
 
 	DEBUGASSERT(inode && inode->i_private);
 	dev = (struct ftl_struct_s *)inode->i_private;
+	dev->stats.nwritten += nsectors;
 #ifdef CONFIG_FTL_WRITEBUFFER
 	return rwb_write(&dev->rwb, start_sector, nsectors, buffer);
 #else
@@ -424,9 +725,36 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 
 	fvdbg("Entry\n");
 	DEBUGASSERT(inode && inode->i_private);
+	dev = (struct ftl_struct_s *)inode->i_private;
+
+#ifdef CONFIG_FS_WRITABLE
+	/* Write back any buffered data */
+
+	if (cmd == BIOC_FLUSH) {
+		return ftl_sync(dev);
+	}
 
-	/* Only one block driver ioctl command is supported by this driver (and
-	 * that command is just passed on to the MTD driver in a slightly
+	/* Report how many blocks were programmed for the blocks written */
+
+	if (cmd == BIOC_GETWRSTATS) {
+		FAR struct ftl_wrstats_s *stats = (FAR struct ftl_wrstats_s *)((uintptr_t)arg);
+
+		if (stats == NULL) {
+			return -EINVAL;
+		}
+
+		*stats = dev->stats;
+		stats->amplification = 0;
+		if (stats->nwritten > 0) {
+			stats->amplification = (uint32_t)(((uint64_t)stats->nprogrammed * 100) / stats->nwritten);
+		}
+
+		return OK;
+	}
+#endif
+
+	/* Only one other block driver ioctl command is supported by this driver
+	 * (and that command is just passed on to the MTD driver in a slightly
 	 * different form).
 	 */
 
@@ -451,7 +779,6 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 	 * to the MTD driver (unchanged).
 	 */
 
-	dev = (struct ftl_struct_s *)inode->i_private;
 	ret = MTD_IOCTL(dev->mtd, cmd, arg);
 	if (ret < 0) {
 		dbg("ERROR: MTD ioctl(%04x) failed: %d\n", cmd, ret);
@@ -482,6 +809,9 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
 	struct ftl_struct_s *dev;
 	char devname[16];
 	int ret = -ENOMEM;
+#ifdef FTL_HAVE_EBCACHE
+	int i;
+#endif
 
 	/* Sanity check */
 
@@ -491,7 +821,7 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
 
 	/* Allocate a FTL device structure */
 
-	dev = (struct ftl_struct_s *)kmm_malloc(sizeof(struct ftl_struct_s));
+	dev = (struct ftl_struct_s *)kmm_zalloc(sizeof(struct ftl_struct_s));
 	if (dev) {
 		/* Initialize the FTL device structure */
 
@@ -509,10 +839,19 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
 			return ret;
 		}
 
-		/* Allocate one, in-memory erase block buffer */
+		/* Get the number of R/W blocks per erase block */
 
-#ifdef CONFIG_FS_WRITABLE
+		dev->blkper = dev->geo.erasesize / dev->geo.blocksize;
+		DEBUGASSERT(dev->blkper * dev->geo.blocksize == dev->geo.erasesize);
+
+		/* Allocate one, in-memory erase block buffer for each cache entry */
+
+#ifdef FTL_HAVE_EBCACHE
+		dev->eblock  = (FAR uint8_t *)kmm_malloc(dev->geo.erasesize * CONFIG_FTL_NEBCACHE);
+#elif defined(CONFIG_FS_WRITABLE)
 		dev->eblock  = (FAR uint8_t *)kmm_malloc(dev->geo.erasesize);
+#endif
+#ifdef CONFIG_FS_WRITABLE
 		if (!dev->eblock) {
 			dbg("ERROR: Failed to allocate an erase block buffer\n");
 			kmm_free(dev);
@@ -520,10 +859,13 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
 		}
 #endif
 
-		/* Get the number of R/W blocks per erase block */
-
-		dev->blkper = dev->geo.erasesize / dev->geo.blocksize;
-		DEBUGASSERT(dev->blkper * dev->geo.blocksize == dev->geo.erasesize);
+#ifdef FTL_HAVE_EBCACHE
+		sem_init(&dev->exclsem, 0, 1);
+		for (i = 0; i < CONFIG_FTL_NEBCACHE; i++) {
+			dev->cache[i].eraseblock = -1;
+			dev->cache[i].buffer     = dev->eblock + i * dev->geo.erasesize;
+		}
+#endif
 
 		/* Configure read-ahead/write buffering */
 
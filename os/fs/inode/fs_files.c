@@ -130,12 +130,28 @@ static int _files_close(FAR struct file *filep)
 	/* Check if the struct file is open (i.e., assigned an inode) */
 
 	if (inode) {
+		/* Drivers must not keep the poll of an epoll set past the close */
+
+		epoll_purge(filep);
+
+#ifdef CONFIG_FS_WRITEBEHIND
+		/* Write the buffered data first.  Its error is returned, but the
+		 * file is closed anyway.  Callers holding the list semaphore drain
+		 * the buffer before taking it, so little is left to write here.
+		 */
+
+		ret = wrbehind_close(filep);
+#endif
+
 		/* Close the file, driver, or mountpoint. */
 
 		if (inode->u.i_ops && inode->u.i_ops->close) {
 			/* Perform the close operation */
 
-			ret = inode->u.i_ops->close(filep);
+			int status = inode->u.i_ops->close(filep);
+			if (ret == OK) {
+				ret = status;
+			}
 		}
 
 		/* And release the inode */
@@ -233,6 +249,10 @@ int file_dup(FAR struct file *filep, int minfd)
 		return ERROR;
 	}
 
+	/* The new descriptor writes through: write the buffered data first */
+
+	wrbehind_drain(filep);
+
 	/* Increment the reference count on the contained inode */
 
 	inode_addref(filep->f_inode);
@@ -303,6 +323,17 @@ int file_dup2(FAR struct file *filep1, FAR struct file *filep2)
 	list = sched_getfiles();
 	DEBUGASSERT(list);
 
+	/* Write the buffered data of both files before taking the list
+	 * semaphore, which other descriptors of the task need.  The new
+	 * descriptor writes through.
+	 */
+
+	if (filep2->f_inode) {
+		wrbehind_drain(filep2);
+	}
+
+	wrbehind_drain(filep1);
+
 	_files_semtake(list);
 
 	/* If there is already an inode contained in the new file structure,
@@ -326,6 +357,9 @@ int file_dup2(FAR struct file *filep1, FAR struct file *filep2)
 	filep2->f_oflags = filep1->f_oflags;
 	filep2->f_pos = filep1->f_pos;
 	filep2->f_inode = inode;
+#ifdef CONFIG_FS_WRITEBEHIND
+	filep2->f_wb = NULL;
+#endif
 
 	/* Call the open method on the file, driver, mountpoint so that it
 	 * can maintain the correct open counts.
@@ -396,6 +430,9 @@ int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
 			list->fl_files[i].f_pos = pos;
 			list->fl_files[i].f_inode = inode;
 			list->fl_files[i].f_priv = NULL;
+#ifdef CONFIG_FS_WRITEBEHIND
+			list->fl_files[i].f_wb = NULL;
+#endif
 			_files_semgive(list);
 			return i;
 		}
@@ -432,6 +469,12 @@ int files_close(int fd)
 		return -EBADF;
 	}
 
+	/* Write the buffered data before taking the list semaphore, which
+	 * other descriptors of the task need.  An error is kept for the close.
+	 */
+
+	wrbehind_drain(&list->fl_files[fd]);
+
 	/* Perform the protected close operation */
 
 	_files_semtake(list);
@@ -58,6 +58,7 @@
 
 #include <assert.h>
 #include <semaphore.h>
+#include <string.h>
 #include <errno.h>
 
 #include <tinyara/kmalloc.h>
@@ -88,12 +89,40 @@ struct inode_sem_s {
 	int16_t count;				/* Number of counts held */
 };
 
+#if CONFIG_FS_INODE_CACHE > 0
+/* One remembered inode_search().  'node' is NULL for a path that was not
+ * found; 'peer' and 'parent' are remembered either way because
+ * inode_reserve() inserts new nodes there.
+ */
+
+struct inode_cache_s {
+	uint32_t hash;				/* Hash of path[], 0 if the entry is unused */
+	FAR struct inode *node;		/* The node found, or NULL */
+	FAR struct inode *peer;		/* The peer to the left of the node */
+	FAR struct inode *parent;	/* The parent of the node */
+	uint16_t consumed;			/* Length of the path resolved by the tree */
+	char path[CONFIG_FS_INODE_CACHE_PATHLEN];	/* The full path searched */
+};
+#endif
+
 /****************************************************************************
  * Private Variables
  ****************************************************************************/
 
 static struct inode_sem_s g_inode_sem;
 
+#if CONFIG_FS_INODE_CACHE > 0
+static struct inode_cache_s g_inode_cache[CONFIG_FS_INODE_CACHE];
+
+/* Set when the tree changes while g_inode_sem is held.  Callers may still
+ * be adjusting the new or removed nodes after inode_reserve() or
+ * inode_remove() return, so the cache is cleared again when the semaphore
+ * is released.
+ */
+
+static bool g_inode_cache_changed;
+#endif
+
 /****************************************************************************
  * Public Variables
  ****************************************************************************/
@@ -168,6 +197,127 @@ static int _inode_compare(FAR const char *fname, FAR struct inode *node)
 	}
 }
 
+/****************************************************************************
+ * Name: inode_walk
+ *
+ * Description:
+ *   Search the inode tree for 'path'.  See inode_search().
+ *
+ ****************************************************************************/
+
+static FAR struct inode *inode_walk(FAR const char **path, FAR struct inode **peer, FAR struct inode **parent, FAR const char **relpath)
+{
+	FAR const char *name = *path + 1;	/* Skip over leading '/' */
+	FAR struct inode *node = root_inode;
+	FAR struct inode *left = NULL;
+	FAR struct inode *above = NULL;
+
+	while (node) {
+		int result = _inode_compare(name, node);
+
+		/* Case 1:  The name is less than the name of the node.
+		 * Since the names are ordered, these means that there
+		 * is no peer node with this name and that there can be
+		 * no match in the fileystem.
+		 */
+
+		if (result < 0) {
+			node = NULL;
+			break;
+		}
+
+		/* Case 2: the name is greater than the name of the node.
+		 * In this case, the name may still be in the list to the
+		 * "right"
+		 */
+
+		else if (result > 0) {
+			left = node;
+			node = node->i_peer;
+		}
+
+		/* The names match */
+
+		else {
+			/* Now there are three more possibilities:
+			 *   (1) This is the node that we are looking for or,
+			 *   (2) The node we are looking for is "below" this one.
+			 *   (3) This node is a mountpoint and will absorb all request
+			 *       below this one
+			 */
+
+			name = inode_nextname(name);
+			if (!*name || INODE_IS_MOUNTPT(node)) {
+				/* Either (1) we are at the end of the path, so this must be the
+				 * node we are looking for or else (2) this node is a mountpoint
+				 * and will handle the remaining part of the pathname
+				 */
+
+				if (relpath) {
+					*relpath = name;
+				}
+				break;
+			} else {
+				/* More to go, keep looking at the next level "down" */
+
+				above = node;
+				left = NULL;
+				node = node->i_child;
+			}
+		}
+	}
+
+	/* node is null.  This can happen in one of four cases:
+	 * With node = NULL
+	 *   (1) We went left past the final peer:  The new node
+	 *       name is larger than any existing node name at
+	 *       that level.
+	 *   (2) We broke out in the middle of the list of peers
+	 *       because the name was not found in the ordered
+	 *       list.
+	 *   (3) We went down past the final parent:  The new node
+	 *       name is "deeper" than anything that we currently
+	 *       have in the tree.
+	 * with node != NULL
+	 *   (4) When the node matching the full path is found
+	 */
+
+	if (peer) {
+		*peer = left;
+	}
+
+	if (parent) {
+		*parent = above;
+	}
+
+	*path = name;
+	return node;
+}
+
+/****************************************************************************
+ * Name: inode_cache_hash
+ *
+ * Description:
+ *   Return the FNV-1a hash of 'path' and its length in 'len'.  Zero marks
+ *   an unused cache entry, so it is never returned.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_INODE_CACHE > 0
+static uint32_t inode_cache_hash(FAR const char *path, FAR size_t *len)
+{
+	FAR const char *ptr = path;
+	uint32_t hash = 2166136261u;
+
+	while (*ptr) {
+		hash = (hash ^ (uint8_t)*ptr++) * 16777619u;
+	}
+
+	*len = ptr - path;
+	return hash != 0 ? hash : 1;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -264,6 +414,13 @@ void inode_semgive(void)
 	/* Yes.. then we can really release the semaphore */
 
 	else {
+#if CONFIG_FS_INODE_CACHE > 0
+		if (g_inode_cache_changed) {
+			memset(g_inode_cache, 0, sizeof(g_inode_cache));
+			g_inode_cache_changed = false;
+		}
+#endif
+
 		g_inode_sem.holder = NO_HOLDER;
 		g_inode_sem.count = 0;
 		sem_post(&g_inode_sem.sem);
@@ -284,81 +441,49 @@ void inode_semgive(void)
 
 FAR struct inode *inode_search(FAR const char **path, FAR struct inode **peer, FAR struct inode **parent, FAR const char **relpath)
 {
-	FAR const char *name = *path + 1;	/* Skip over leading '/' */
-	FAR struct inode *node = root_inode;
-	FAR struct inode *left = NULL;
-	FAR struct inode *above = NULL;
-
-	while (node) {
-		int result = _inode_compare(name, node);
-
-		/* Case 1:  The name is less than the name of the node.
-		 * Since the names are ordered, these means that there
-		 * is no peer node with this name and that there can be
-		 * no match in the fileystem.
-		 */
-
-		if (result < 0) {
-			node = NULL;
-			break;
+#if CONFIG_FS_INODE_CACHE > 0
+	FAR struct inode_cache_s *entry;
+	FAR const char *start = *path;
+	FAR struct inode *node;
+	FAR struct inode *left;
+	FAR struct inode *above;
+	uint32_t hash;
+	size_t len;
+
+	hash = inode_cache_hash(start, &len);
+	entry = &g_inode_cache[hash % CONFIG_FS_INODE_CACHE];
+
+	if (entry->hash == hash && len < CONFIG_FS_INODE_CACHE_PATHLEN && strcmp(entry->path, start) == 0) {
+		/* Hit.  Return exactly what the walk returned the last time */
+
+		node = entry->node;
+		*path = start + entry->consumed;
+		if (node && relpath) {
+			*relpath = *path;
 		}
 
-		/* Case 2: the name is greater than the name of the node.
-		 * In this case, the name may still be in the list to the
-		 * "right"
-		 */
-
-		else if (result > 0) {
-			left = node;
-			node = node->i_peer;
+		if (peer) {
+			*peer = entry->peer;
 		}
 
-		/* The names match */
-
-		else {
-			/* Now there are three more possibilities:
-			 *   (1) This is the node that we are looking for or,
-			 *   (2) The node we are looking for is "below" this one.
-			 *   (3) This node is a mountpoint and will absorb all request
-			 *       below this one
-			 */
+		if (parent) {
+			*parent = entry->parent;
+		}
 
-			name = inode_nextname(name);
-			if (!*name || INODE_IS_MOUNTPT(node)) {
-				/* Either (1) we are at the end of the path, so this must be the
-				 * node we are looking for or else (2) this node is a mountpoint
-				 * and will handle the remaining part of the pathname
-				 */
+		return node;
+	}
 
-				if (relpath) {
-					*relpath = name;
-				}
-				break;
-			} else {
-				/* More to go, keep looking at the next level "down" */
+	node = inode_walk(path, &left, &above, relpath);
 
-				above = node;
-				left = NULL;
-				node = node->i_child;
-			}
-		}
+	if (len < CONFIG_FS_INODE_CACHE_PATHLEN) {
+		entry->hash = hash;
+		entry->node = node;
+		entry->peer = left;
+		entry->parent = above;
+		entry->consumed = *path - start;
+		memcpy(entry->path, start, len + 1);
 	}
 
-	/* node is null.  This can happen in one of four cases:
-	 * With node = NULL
-	 *   (1) We went left past the final peer:  The new node
-	 *       name is larger than any existing node name at
-	 *       that level.
-	 *   (2) We broke out in the middle of the list of peers
-	 *       because the name was not found in the ordered
-	 *       list.
-	 *   (3) We went down past the final parent:  The new node
-	 *       name is "deeper" than anything that we currently
-	 *       have in the tree.
-	 * with node != NULL
-	 *   (4) When the node matching the full path is found
-	 */
-
 	if (peer) {
 		*peer = left;
 	}
@@ -367,10 +492,32 @@ FAR struct inode *inode_search(FAR const char **path, FAR struct inode **peer, F
 		*parent = above;
 	}
 
-	*path = name;
 	return node;
+#else
+	return inode_walk(path, peer, parent, relpath);
+#endif
 }
 
+/****************************************************************************
+ * Name: inode_cache_invalidate
+ *
+ * Description:
+ *   Forget all cached path lookups.  Called whenever the inode tree is
+ *   changed.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_INODE_CACHE > 0
+void inode_cache_invalidate(void)
+{
+	memset(g_inode_cache, 0, sizeof(g_inode_cache));
+	g_inode_cache_changed = true;
+}
+#endif
+
 /****************************************************************************
  * Name: inode_free
  *
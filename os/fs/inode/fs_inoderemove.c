@@ -113,6 +113,8 @@ FAR struct inode *inode_unlink(FAR const char *path)
 
 	node = inode_search(&name, &peer, &parent, (const char **)NULL);
 	if (node) {
+		inode_cache_invalidate();
+
 		/* If peer is non-null, then remove the node from the right of
 		 * of that peer node.
 		 */
@@ -126,6 +126,8 @@ static FAR struct inode *inode_alloc(FAR const char *name)
 
 static void inode_insert(FAR struct inode *node, FAR struct inode *peer, FAR struct inode *parent)
 {
+	inode_cache_invalidate();
+
 	/* If peer is non-null, then new node simply goes to the right
 	 * of that peer node.
 	 */
@@ -69,6 +69,16 @@
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_FS_INODE_CACHE
+#define CONFIG_FS_INODE_CACHE 0
+#endif
+
+#ifndef CONFIG_FS_INODE_CACHE_PATHLEN
+#define CONFIG_FS_INODE_CACHE_PATHLEN 32
+#endif
+
 /* Inode i_flag values */
 
 #define FSNODEFLAG_TYPE_MASK       0x00000007	/* Isolates type field        */
@@ -186,6 +196,24 @@ void inode_semgive(void);
 
 FAR struct inode *inode_search(FAR const char **path, FAR struct inode **peer, FAR struct inode **parent, FAR const char **relpath);
 
+/****************************************************************************
+ * Name: inode_cache_invalidate
+ *
+ * Description:
+ *   Forget all cached path lookups.  Called whenever the inode tree is
+ *   changed.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_INODE_CACHE > 0
+void inode_cache_invalidate(void);
+#else
+#define inode_cache_invalidate()
+#endif
+
 /****************************************************************************
  * Name: inode_free
  *
@@ -349,6 +377,47 @@ int files_close(int fd);
 
 void files_release(int fd);
 
+/* fs_poll.c ****************************************************************/
+/****************************************************************************
+ * Name: poll_fdsetup / file_poll
+ *
+ * Description:
+ *   Set up (or tear down) the poll of one file or socket descriptor, or of
+ *   an open file.  Used by poll() and by epoll, which keeps the poll set up
+ *   across waits and tears it down through the file, whatever the
+ *   descriptor refers to by then.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_DISABLE_POLL) && CONFIG_NFILE_DESCRIPTORS > 0
+int poll_fdsetup(int fd, FAR struct pollfd *fds, bool setup);
+int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
+#endif
+
+/* fs_writebehind.c *********************************************************/
+/****************************************************************************
+ * Name: wrbehind_open, wrbehind_write, wrbehind_drain, wrbehind_sync,
+ *       wrbehind_close
+ *
+ * Description:
+ *   The write-behind buffer of a file opened with O_WRBEHIND.  open()
+ *   attaches the buffer and write() goes through wrbehind_write() while
+ *   filep->f_wb is set.  Other operations on the file first write the
+ *   buffered data with wrbehind_drain(), fsync() with wrbehind_sync() and
+ *   close() with wrbehind_close(), which also free the buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITEBEHIND
+void wrbehind_open(FAR struct file *filep);
+ssize_t wrbehind_write(FAR struct file *filep, FAR const void *buf, size_t nbytes);
+void wrbehind_drain(FAR struct file *filep);
+int wrbehind_sync(FAR struct file *filep);
+int wrbehind_close(FAR struct file *filep);
+#else
+#define wrbehind_drain(filep)
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
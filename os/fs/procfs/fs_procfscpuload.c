@@ -86,7 +86,13 @@
  * to handle the longest line generated by this logic.
  */
 
+#ifdef CONFIG_SCHED_CPUTIME
+/* The load, the interrupt time and one line per latency bucket */
+
+#define CPULOAD_LINELEN (48 + 24 * CLOCK_SCHEDLAT_NBUCKETS)
+#else
 #define CPULOAD_LINELEN 16
+#endif
 
 /****************************************************************************
  * Private Types
@@ -261,6 +267,32 @@ static ssize_t cpuload_read(FAR struct file *filep, FAR char *buffer, size_t buf
 
 		linesize = snprintf(attr->line, CPULOAD_LINELEN, "%3d.%01d%%", intpart, fracpart);
 
+#ifdef CONFIG_SCHED_CPUTIME
+		{
+			struct schedlat_s schedlat;
+			int i;
+
+			/* Append the time spent in interrupt handlers and the
+			 * histogram of the waits to run.
+			 */
+
+			clock_schedlatency(&schedlat);
+			linesize += snprintf(&attr->line[linesize], CPULOAD_LINELEN - linesize, "\nIrqTime: %lu.%06lu\n", (unsigned long)(schedlat.irqtime / 1000000), (unsigned long)(schedlat.irqtime % 1000000));
+
+			for (i = 0; i < CLOCK_SCHEDLAT_NBUCKETS && linesize < CPULOAD_LINELEN; i++) {
+				if (i < CLOCK_SCHEDLAT_NBUCKETS - 1) {
+					linesize += snprintf(&attr->line[linesize], CPULOAD_LINELEN - linesize, "Wait <%luus: %lu\n", 1UL << i, (unsigned long)schedlat.count[i]);
+				} else {
+					linesize += snprintf(&attr->line[linesize], CPULOAD_LINELEN - linesize, "Wait >=%luus: %lu\n", 1UL << (i - 1), (unsigned long)schedlat.count[i]);
+				}
+			}
+
+			if (linesize > CPULOAD_LINELEN - 1) {
+				linesize = CPULOAD_LINELEN - 1;
+			}
+		}
+#endif
+
 		/* Save the linesize in case we are re-entered with f_pos > 0 */
 
 		attr->linesize = linesize;
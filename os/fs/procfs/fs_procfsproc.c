@@ -111,6 +111,12 @@ enum proc_node_e {
 	PROC_LOADAVG,				/* Average CPU utilization */
 #endif
 	PROC_STACK,					/* Task stack info */
+#ifdef CONFIG_SCHED_IOACCOUNT
+	PROC_IO,					/* Task I/O counters */
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+	PROC_CPUTIME,				/* Task CPU time */
+#endif
 	PROC_GROUP,					/* Group directory */
 	PROC_GROUP_STATUS,			/* Task group status */
 	PROC_GROUP_FD				/* Group file descriptors */
@@ -156,6 +162,12 @@ static ssize_t proc_cmdline(FAR struct proc_file_s *procfile, FAR struct tcb_s *
 static ssize_t proc_loadavg(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
 #endif
 static ssize_t proc_stack(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
+#ifdef CONFIG_SCHED_IOACCOUNT
+static ssize_t proc_io(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+static ssize_t proc_cputime(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
+#endif
 static ssize_t proc_groupstatus(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
 static ssize_t proc_groupfd(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
 
@@ -227,6 +239,18 @@ static const struct proc_node_s g_stack = {
 	"stack", "stack", (uint8_t)PROC_STACK, DTYPE_FILE	/* Task stack info */
 };
 
+#ifdef CONFIG_SCHED_IOACCOUNT
+static const struct proc_node_s g_io = {
+	"io", "io", (uint8_t)PROC_IO, DTYPE_FILE	/* Task I/O counters */
+};
+#endif
+
+#ifdef CONFIG_SCHED_CPUTIME
+static const struct proc_node_s g_cputime = {
+	"cputime", "cputime", (uint8_t)PROC_CPUTIME, DTYPE_FILE	/* Task CPU time */
+};
+#endif
+
 static const struct proc_node_s g_group = {
 	"group", "group", (uint8_t)PROC_GROUP, DTYPE_DIRECTORY	/* Group directory */
 };
@@ -248,6 +272,12 @@ static FAR const struct proc_node_s *const g_nodeinfo[] = {
 	&g_loadavg,					/* Average CPU utilization */
 #endif
 	&g_stack,					/* Task stack info */
+#ifdef CONFIG_SCHED_IOACCOUNT
+	&g_io,						/* Task I/O counters */
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+	&g_cputime,					/* Task CPU time */
+#endif
 	&g_group,					/* Group directory */
 	&g_groupstatus,				/* Task group status */
 	&g_groupfd					/* Group file descriptors */
@@ -264,6 +294,12 @@ static const struct proc_node_s *const g_level0info[] = {
 	&g_loadavg,					/* Average CPU utilization */
 #endif
 	&g_stack,					/* Task stack info */
+#ifdef CONFIG_SCHED_IOACCOUNT
+	&g_io,						/* Task I/O counters */
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+	&g_cputime,					/* Task CPU time */
+#endif
 	&g_group,					/* Group directory */
 };
 
@@ -597,6 +633,112 @@ static ssize_t proc_stack(FAR struct proc_file_s *procfile, FAR struct tcb_s *tc
 	return totalsize;
 }
 
+/****************************************************************************
+ * Name: proc_io
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IOACCOUNT
+static ssize_t proc_io(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset)
+{
+	FAR const struct task_ioacct_s *ioacct = &tcb->ioacct;
+	const struct {
+		FAR const char *name;
+		uint32_t value;
+	} counters[] = {
+		{ "ReadCalls:",  ioacct->rcalls    },
+		{ "ReadBytes:",  ioacct->rbytes    },
+		{ "WriteCalls:", ioacct->wcalls    },
+		{ "WriteBytes:", ioacct->wbytes    },
+		{ "RecvCalls:",  ioacct->recvcalls },
+		{ "RecvBytes:",  ioacct->recvbytes },
+		{ "SendCalls:",  ioacct->sendcalls },
+		{ "SendBytes:",  ioacct->sendbytes },
+		{ "MtdBlocks:",  ioacct->mtdblocks },
+		{ "MtdErases:",  ioacct->mtderases },
+	};
+	size_t remaining;
+	size_t linesize;
+	size_t copysize;
+	size_t totalsize;
+	int i;
+
+	remaining = buflen;
+	totalsize = 0;
+
+	for (i = 0; i < sizeof(counters) / sizeof(counters[0]); i++) {
+		linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n", counters[i].name, (unsigned long)counters[i].value);
+		copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+		totalsize += copysize;
+		buffer += copysize;
+		remaining -= copysize;
+
+		if (totalsize >= buflen) {
+			break;
+		}
+	}
+
+	return totalsize;
+}
+#endif
+
+/****************************************************************************
+ * Name: proc_cputime
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUTIME
+static ssize_t proc_cputime(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset)
+{
+	struct cputime_s cputime;
+	const struct {
+		FAR const char *name;
+		FAR const uint64_t *usec;		/* A time, or NULL */
+		FAR const uint32_t *count;		/* Otherwise a count */
+	} fields[] = {
+		{ "RunTime:",   &cputime.runtime,  NULL            },
+		{ "IrqTime:",   &cputime.irqtime,  NULL            },
+		{ "WaitTime:",  &cputime.waittime, NULL            },
+		{ "MaxWait:",   &cputime.maxwait,  NULL            },
+		{ "Voluntary:", NULL,              &cputime.nvcsw  },
+		{ "Preempted:", NULL,              &cputime.nivcsw },
+	};
+	size_t remaining;
+	size_t linesize;
+	size_t copysize;
+	size_t totalsize;
+	int i;
+
+	if (clock_cputime(tcb->pid, &cputime) < 0) {
+		return 0;
+	}
+
+	remaining = buflen;
+	totalsize = 0;
+
+	/* Times are shown in seconds */
+
+	for (i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+		if (fields[i].usec != NULL) {
+			linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu.%06lu\n", fields[i].name, (unsigned long)(*fields[i].usec / 1000000), (unsigned long)(*fields[i].usec % 1000000));
+		} else {
+			linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n", fields[i].name, (unsigned long)*fields[i].count);
+		}
+
+		copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+		totalsize += copysize;
+		buffer += copysize;
+		remaining -= copysize;
+
+		if (totalsize >= buflen) {
+			break;
+		}
+	}
+
+	return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_groupstatus
  ****************************************************************************/
@@ -966,6 +1108,18 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 		ret = proc_stack(procfile, tcb, buffer, buflen, filep->f_pos);
 		break;
 
+#ifdef CONFIG_SCHED_IOACCOUNT
+	case PROC_IO:				/* Task I/O counters */
+		ret = proc_io(procfile, tcb, buffer, buflen, filep->f_pos);
+		break;
+#endif
+
+#ifdef CONFIG_SCHED_CPUTIME
+	case PROC_CPUTIME:			/* Task CPU time */
+		ret = proc_cputime(procfile, tcb, buffer, buflen, filep->f_pos);
+		break;
+#endif
+
 	case PROC_GROUP_STATUS:	/* Task group status */
 		ret = proc_groupstatus(procfile, tcb, buffer, buflen, filep->f_pos);
 		break;
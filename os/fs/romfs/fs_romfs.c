@@ -305,18 +305,10 @@ static int romfs_close(FAR struct file *filep)
 	 */
 
 	/* Deallocate the memory structures created when the open method
-	 * was called.
-	 *
-	 * Free the sector buffer that was used to manage partial sector
-	 * accesses.
+	 * was called.  Partial sector accesses use the sector cache of the
+	 * mountpoint, so there is no sector buffer to free.
 	 */
 
-	if (!rm->rm_xipbase && rf->rf_buffer) {
-		kmm_free(rf->rf_buffer);
-	}
-
-	/* Then free the file structure itself. */
-
 	kmm_free(rf);
 	filep->f_priv = NULL;
 	return ret;
@@ -901,6 +893,14 @@ static int romfs_bind(FAR struct inode *blkdriver, FAR const void *data, FAR voi
 		goto errout_with_buffer;
 	}
 
+#ifdef CONFIG_FS_ROMFS_INDEX
+	/* Index the directory entries.  Lookups walk the directories if this
+	 * fails.
+	 */
+
+	(void)romfs_buildindex(rm);
+#endif
+
 	/* Mounted! */
 
 	*handle = (void *)rm;
@@ -908,9 +908,7 @@ static int romfs_bind(FAR struct inode *blkdriver, FAR const void *data, FAR voi
 	return OK;
 
 errout_with_buffer:
-	if (!rm->rm_xipbase) {
-		kmm_free(rm->rm_buffer);
-	}
+	romfs_freebuffers(rm);
 
 errout_with_sem:
 	sem_destroy(&rm->rm_sem);
@@ -971,10 +969,7 @@ static int romfs_unbind(FAR void *handle, FAR struct inode **blkdriver)
 
 		/* Release the mountpoint private data */
 
-		if (!rm->rm_xipbase && rm->rm_buffer) {
-			kmm_free(rm->rm_buffer);
-		}
-
+		romfs_freebuffers(rm);
 		sem_destroy(&rm->rm_sem);
 		kmm_free(rm);
 		return OK;
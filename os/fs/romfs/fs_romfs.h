@@ -142,6 +142,14 @@
 
 #define ROMF_MAX_LINKS 64
 
+#ifndef CONFIG_FS_ROMFS_CACHE_SECTORS
+#define CONFIG_FS_ROMFS_CACHE_SECTORS 1
+#endif
+
+/* Empty bucket or end of a hash chain of the name index */
+
+#define ROMFS_INDEX_NONE 0xffff
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -152,6 +160,24 @@
  */
 
 struct romfs_file_s;
+
+#ifdef CONFIG_FS_ROMFS_INDEX
+/* An entry of the name index built at mount time.  The values are those
+ * found by a walk of the directory: 'offset' is the file header of the
+ * entry and the others come from the header it links to.
+ */
+
+struct romfs_index_s {
+	uint32_t ri_parent;			/* Offset of the first entry of the directory */
+	uint32_t ri_offset;			/* Offset of the file header */
+	uint32_t ri_next;			/* Offset of the next header + mode bits */
+	uint32_t ri_infosize;		/* First entry (directory) or size (file) */
+	uint32_t ri_hash;			/* Hash of ri_parent and of the name */
+	uint16_t ri_chain;			/* Next entry in the hash bucket */
+	uint16_t ri_namelen;		/* Length of the name */
+};
+#endif
+
 struct romfs_mountpt_s {
 	struct inode
 		*rm_blkdriver;				/* The block driver inode that hosts the FAT32 fs */
@@ -166,7 +192,20 @@ struct romfs_mountpt_s {
 	uint32_t rm_volsize;		/* Size of the ROMFS volume */
 	uint32_t rm_cachesector;	/* Current sector in the rm_buffer */
 	uint8_t *rm_xipbase;		/* Base address of directly accessible media */
-	uint8_t *rm_buffer;			/* Device sector buffer, allocated if rm_xipbase==0 */
+	uint8_t *rm_buffer;			/* Current device sector (in rm_cache if rm_xipbase==0) */
+	uint8_t *rm_cache;			/* Sector cache, allocated if rm_xipbase==0 */
+
+	/* The sectors in rm_cache, most recently used first */
+
+	uint8_t *rm_cachebuf[CONFIG_FS_ROMFS_CACHE_SECTORS];
+	uint32_t rm_cachetag[CONFIG_FS_ROMFS_CACHE_SECTORS];
+
+#ifdef CONFIG_FS_ROMFS_INDEX
+	struct romfs_index_s *rm_index;	/* Name index, or NULL */
+	uint16_t *rm_buckets;		/* Hash buckets of the name index */
+	uint16_t rm_nindex;			/* Number of entries in rm_index */
+	uint16_t rm_nbuckets;		/* Number of buckets, a power of 2 */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -179,7 +218,7 @@ struct romfs_file_s {
 	uint32_t rf_startoffset;	/* Offset to the start of the file data */
 	uint32_t rf_size;			/* Size of the file in bytes */
 	uint32_t rf_cachesector;	/* Current sector in the rf_buffer */
-	uint8_t *rf_buffer;			/* File sector buffer, allocated if rm_xipbase==0 */
+	uint8_t *rf_buffer;			/* Current sector, on the media or in rm_cache */
 };
 
 /* This structure is used internally for describing the result of
@@ -228,6 +267,10 @@ EXTERN int romfs_finddirentry(struct romfs_mountpt_s *rm, struct romfs_dirinfo_s
 EXTERN int romfs_parsedirentry(struct romfs_mountpt_s *rm, uint32_t offset, uint32_t *poffset, uint32_t *pnext, uint32_t *pinfo, uint32_t *psize);
 EXTERN int romfs_parsefilename(struct romfs_mountpt_s *rm, uint32_t offset, char *pname);
 EXTERN int romfs_datastart(struct romfs_mountpt_s *rm, uint32_t offset, uint32_t *start);
+EXTERN void romfs_freebuffers(struct romfs_mountpt_s *rm);
+#ifdef CONFIG_FS_ROMFS_INDEX
+EXTERN int romfs_buildindex(struct romfs_mountpt_s *rm);
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
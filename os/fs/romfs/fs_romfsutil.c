@@ -134,6 +134,28 @@ static uint32_t romfs_devread32(struct romfs_mountpt_s *rm, int ndx)
 #endif
 }
 
+/****************************************************************************
+ * Name: romfs_setdirinfo
+ *
+ * Desciption:
+ *   Save the values of the path segment found at offset
+ *
+ ****************************************************************************/
+
+static void romfs_setdirinfo(struct romfs_dirinfo_s *dirinfo, uint32_t offset, uint32_t next, uint32_t info, uint32_t size)
+{
+	if (IS_DIRECTORY(next)) {
+		dirinfo->rd_dir.fr_firstoffset = info;
+		dirinfo->rd_dir.fr_curroffset = info;
+		dirinfo->rd_size = 0;
+	} else {
+		dirinfo->rd_dir.fr_curroffset = offset;
+		dirinfo->rd_size = size;
+	}
+
+	dirinfo->rd_next = next;
+}
+
 /****************************************************************************
  * Name: romfs_checkentry
  *
@@ -180,16 +202,7 @@ static inline int romfs_checkentry(struct romfs_mountpt_s *rm, uint32_t offset,
 		if (memcmp(entryname, name, entrylen) == 0 && strlen(name) == entrylen) {
 			/* Found it -- save the component info and return success */
 
-			if (IS_DIRECTORY(next)) {
-				dirinfo->rd_dir.fr_firstoffset = info;
-				dirinfo->rd_dir.fr_curroffset = info;
-				dirinfo->rd_size = 0;
-			} else {
-				dirinfo->rd_dir.fr_curroffset = offset;
-				dirinfo->rd_size = size;
-			}
-
-			dirinfo->rd_next = next;
+			romfs_setdirinfo(dirinfo, offset, next, info, size);
 			return OK;
 		}
 	}
@@ -199,6 +212,48 @@ static inline int romfs_checkentry(struct romfs_mountpt_s *rm, uint32_t offset,
 	return -ENOENT;
 }
 
+/****************************************************************************
+ * Name: romfs_cacheread
+ *
+ * Desciption:
+ *   Return the buffer holding the specified sector in the sector cache of
+ *   a non-XIP mount, reading the sector over the least recently used one
+ *   if it is not cached.  The buffer is valid until the next call.
+ *
+ ****************************************************************************/
+
+static int romfs_cacheread(struct romfs_mountpt_s *rm, uint32_t sector, uint8_t **pbuffer)
+{
+	uint8_t *buffer;
+	int ret;
+	int i;
+
+	for (i = 0; i < CONFIG_FS_ROMFS_CACHE_SECTORS - 1; i++) {
+		if (rm->rm_cachetag[i] == sector) {
+			break;
+		}
+	}
+
+	buffer = rm->rm_cachebuf[i];
+	if (rm->rm_cachetag[i] != sector) {
+		ret = romfs_hwread(rm, buffer, sector, 1);
+		if (ret < 0) {
+			rm->rm_cachetag[i] = (uint32_t)-1;
+			return ret;
+		}
+	}
+
+	/* Make it the most recently used sector */
+
+	memmove(&rm->rm_cachebuf[1], &rm->rm_cachebuf[0], i * sizeof(uint8_t *));
+	memmove(&rm->rm_cachetag[1], &rm->rm_cachetag[0], i * sizeof(uint32_t));
+	rm->rm_cachebuf[0] = buffer;
+	rm->rm_cachetag[0] = sector;
+
+	*pbuffer = buffer;
+	return OK;
+}
+
 /****************************************************************************
  * Name: romfs_devcacheread
  *
@@ -214,33 +269,29 @@ int16_t romfs_devcacheread(struct romfs_mountpt_s *rm, uint32_t offset)
 	int ret;
 
 	/* rm->rm_cachesector holds the current sector that is buffer in or referenced
-	 * by rm->tm_buffer. If the requested sector is the same as this sector,
-	 * then we do nothing.
+	 * by rm->tm_buffer.  In non-XIP mode the sector may have been replaced in
+	 * the sector cache since, so the cache is always checked.
 	 */
 
 	sector = SEC_NSECTORS(rm, offset);
-	if (rm->rm_cachesector != sector) {
-		/* Check the access mode */
-
-		if (rm->rm_xipbase) {
-			/* In XIP mode, rf_buffer is just an offset pointer into the device
-			 * address space.
-			 */
+	if (rm->rm_xipbase) {
+		/* In XIP mode, rf_buffer is just an offset pointer into the device
+		 * address space.
+		 */
 
-			rm->rm_buffer = rm->rm_xipbase + SEC_ALIGN(rm, offset);
-		} else {
-			/* In non-XIP mode, we will have to read the new sector. */
+		rm->rm_buffer = rm->rm_xipbase + SEC_ALIGN(rm, offset);
+	} else {
+		/* In non-XIP mode, we may have to read the new sector. */
 
-			ret = romfs_hwread(rm, rm->rm_buffer, sector, 1);
-			if (ret < 0) {
-				return (int16_t)ret;
-			}
+		ret = romfs_cacheread(rm, sector, &rm->rm_buffer);
+		if (ret < 0) {
+			return (int16_t)ret;
 		}
+	}
 
-		/* Update the cached sector number */
+	/* Update the cached sector number */
 
-		rm->rm_cachesector = sector;
-	}
+	rm->rm_cachesector = sector;
 
 	/* Return the offset */
 
@@ -289,6 +340,71 @@ static int romfs_followhardlinks(struct romfs_mountpt_s *rm, uint32_t offset, ui
 	return -ELOOP;
 }
 
+/****************************************************************************
+ * Name: romfs_hash
+ *
+ * Desciption:
+ *   FNV-1a hash of a name in the directory whose first entry is at parent
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_INDEX
+static uint32_t romfs_hash(uint32_t parent, const char *name, int namelen)
+{
+	uint32_t hash = 2166136261u ^ parent;
+
+	while (namelen-- > 0) {
+		hash ^= (uint8_t)*name++;
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+/****************************************************************************
+ * Name: romfs_searchindex
+ *
+ * Desciption:
+ *   Look up entryname in the directory beginning at
+ *   dirinfo->fr_firstoffset using the index built at mount time.
+ *
+ ****************************************************************************/
+
+static int romfs_searchindex(struct romfs_mountpt_s *rm, const char *entryname, int entrylen, struct romfs_dirinfo_s *dirinfo)
+{
+	char name[NAME_MAX + 1];
+	struct romfs_index_s *entry;
+	uint32_t parent;
+	uint32_t hash;
+	uint16_t i;
+	int ret;
+
+	parent = dirinfo->rd_dir.fr_firstoffset;
+	hash = romfs_hash(parent, entryname, entrylen);
+
+	for (i = rm->rm_buckets[hash & (rm->rm_nbuckets - 1)]; i != ROMFS_INDEX_NONE; i = entry->ri_chain) {
+		entry = &rm->rm_index[i];
+		if (entry->ri_hash != hash || entry->ri_parent != parent || entry->ri_namelen != entrylen) {
+			continue;
+		}
+
+		/* The hash only narrows the search, the name is in the image */
+
+		ret = romfs_parsefilename(rm, entry->ri_offset, name);
+		if (ret < 0) {
+			return ret;
+		}
+
+		if (memcmp(entryname, name, entrylen) == 0) {
+			romfs_setdirinfo(dirinfo, entry->ri_offset, entry->ri_next, entry->ri_infosize, entry->ri_infosize);
+			return OK;
+		}
+	}
+
+	return -ENOENT;
+}
+#endif
+
 /****************************************************************************
  * Name: romfs_searchdir
  *
@@ -305,6 +421,12 @@ static inline int romfs_searchdir(struct romfs_mountpt_s *rm, const char *entryn
 	int16_t ndx;
 	int ret;
 
+#ifdef CONFIG_FS_ROMFS_INDEX
+	if (rm->rm_index) {
+		return romfs_searchindex(rm, entryname, entrylen, dirinfo);
+	}
+#endif
+
 	/* Then loop through the current directory until the directory
 	 * with the matching name is found.  Or until all of the entries
 	 * the directory have been examined.
@@ -437,7 +559,7 @@ int romfs_filecacheread(struct romfs_mountpt_s *rm, struct romfs_file_s *rf, uin
 	 * then we do nothing.
 	 */
 
-	if (rf->rf_cachesector != sector) {
+	if (rf->rf_cachesector != sector || !rm->rm_xipbase) {
 		/* Check the access mode */
 
 		if (rm->rm_xipbase) {
@@ -448,12 +570,13 @@ int romfs_filecacheread(struct romfs_mountpt_s *rm, struct romfs_file_s *rf, uin
 			rf->rf_buffer = rm->rm_xipbase + sector * rm->rm_hwsectorsize;
 			fvdbg("XIP buffer: %p\n", rf->rf_buffer);
 		} else {
-			/* In non-XIP mode, we will have to read the new sector. */
+			/* In non-XIP mode, the sector comes from the sector cache shared
+			 * by all files, where another file may have replaced it.
+			 */
 
-			fvdbg("Calling romfs_hwread\n");
-			ret = romfs_hwread(rm, rf->rf_buffer, sector, 1);
+			ret = romfs_cacheread(rm, sector, &rf->rf_buffer);
 			if (ret < 0) {
-				fdbg("romfs_hwread failed: %d\n", ret);
+				fdbg("romfs_cacheread failed: %d\n", ret);
 				return ret;
 			}
 		}
@@ -482,6 +605,7 @@ int romfs_hwconfigure(struct romfs_mountpt_s *rm)
 	struct inode *inode = rm->rm_blkdriver;
 	struct geometry geo;
 	int ret;
+	int i;
 
 	/* Get the underlying device geometry */
 
@@ -522,13 +646,19 @@ int romfs_hwconfigure(struct romfs_mountpt_s *rm)
 		}
 	}
 
-	/* Allocate the device cache buffer for normal sector accesses */
+	/* Allocate the sector cache for normal sector accesses */
 
-	rm->rm_buffer = (uint8_t *)kmm_malloc(rm->rm_hwsectorsize);
-	if (!rm->rm_buffer) {
+	rm->rm_cache = (uint8_t *)kmm_malloc(CONFIG_FS_ROMFS_CACHE_SECTORS * rm->rm_hwsectorsize);
+	if (!rm->rm_cache) {
 		return -ENOMEM;
 	}
 
+	for (i = 0; i < CONFIG_FS_ROMFS_CACHE_SECTORS; i++) {
+		rm->rm_cachebuf[i] = rm->rm_cache + i * rm->rm_hwsectorsize;
+		rm->rm_cachetag[i] = (uint32_t)-1;
+	}
+
+	rm->rm_buffer = rm->rm_cachebuf[0];
 	return OK;
 }
 
@@ -600,16 +730,10 @@ int romfs_fileconfigure(struct romfs_mountpt_s *rm, struct romfs_file_s *rf)
 		rf->rf_cachesector = 0;
 		rf->rf_buffer = rm->rm_xipbase;
 	} else {
-		/* Nothing in the cache buffer */
+		/* Partial sector accesses go through the sector cache */
 
 		rf->rf_cachesector = (uint32_t)-1;
-
-		/* Create a file buffer to support partial sector accesses */
-
-		rf->rf_buffer = (uint8_t *)kmm_malloc(rm->rm_hwsectorsize);
-		if (!rf->rf_buffer) {
-			return -ENOMEM;
-		}
+		rf->rf_buffer = NULL;
 	}
 
 	return OK;
@@ -784,6 +908,13 @@ int romfs_parsedirentry(struct romfs_mountpt_s *rm, uint32_t offset, uint32_t *p
 		return ret;
 	}
 
+	/* The header linked to may be in another sector */
+
+	ndx = romfs_devcacheread(rm, *poffset);
+	if (ndx < 0) {
+		return ndx;
+	}
+
 	/* Because everything is chunked and aligned to 16-bit boundaries,
 	 * we know that most the basic node info fits into the sector.  The
 	 * associated name may not, however.
@@ -908,3 +1039,187 @@ int romfs_datastart(struct romfs_mountpt_s *rm, uint32_t offset, uint32_t *start
 
 	return -EINVAL;				/* Won't get here */
 }
+
+/****************************************************************************
+ * Name: romfs_buildindex
+ *
+ * Desciption:
+ *   Index every entry of the file system by the hash of its name and of
+ *   its directory, so that romfs_finddirentry() does not walk the
+ *   directories.  Without the index (no memory, or too many entries), the
+ *   directories are walked as before.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_INDEX
+int romfs_buildindex(struct romfs_mountpt_s *rm)
+{
+	char name[NAME_MAX + 1];
+	struct romfs_index_s *index = NULL;
+	struct romfs_index_s *entry;
+	uint16_t *buckets;
+	uint32_t nbuckets;
+	uint32_t offset;
+	uint32_t linkoffset;
+	uint32_t raw;
+	uint32_t next;
+	uint32_t info;
+	uint32_t size;
+	uint32_t dir;
+	uint16_t nalloc = 0;
+	uint16_t nindex = 0;
+	uint16_t walked = 0;
+	int16_t ndx;
+	int ret;
+	int i;
+
+	/* Walk the directories breadth first.  The index itself is the queue
+	 * of the directories to walk: the entries after 'walked' that are
+	 * directories.  "." and ".." (a directory, not a hardlink, in the root
+	 * directory made by genromfs) and hardlinks to directories are indexed
+	 * but not walked, which keeps the walk from looping.
+	 */
+
+	dir = rm->rm_rootoffset;
+	for (;;) {
+		for (offset = dir; offset != 0; offset = raw & RFNEXT_OFFSETMASK) {
+			ndx = romfs_devcacheread(rm, offset);
+			if (ndx < 0) {
+				ret = ndx;
+				goto errout;
+			}
+
+			raw = romfs_devread32(rm, ndx + ROMFS_FHDR_NEXT);
+
+			ret = romfs_parsedirentry(rm, offset, &linkoffset, &next, &info, &size);
+			if (ret < 0) {
+				goto errout;
+			}
+
+			if (!IS_DIRECTORY(next) && !IS_FILE(next)) {
+				continue;
+			}
+
+			ret = romfs_parsefilename(rm, offset, name);
+			if (ret < 0) {
+				goto errout;
+			}
+
+			if (nindex == nalloc) {
+				if (nalloc >= ROMFS_INDEX_NONE / 2) {
+					ret = -EFBIG;
+					goto errout;
+				}
+
+				nalloc = nalloc ? 2 * nalloc : 16;
+				entry = (struct romfs_index_s *)kmm_realloc(index, nalloc * sizeof(struct romfs_index_s));
+				if (!entry) {
+					ret = -ENOMEM;
+					goto errout;
+				}
+
+				index = entry;
+			}
+
+			/* ri_chain tells the walk below whether to walk the directory
+			 * until the hash chains are linked.
+			 */
+
+			entry = &index[nindex++];
+			entry->ri_parent = dir;
+			entry->ri_offset = offset;
+			entry->ri_next = next;
+			entry->ri_infosize = IS_DIRECTORY(next) ? info : size;
+			entry->ri_namelen = strlen(name);
+			entry->ri_hash = romfs_hash(dir, name, entry->ri_namelen);
+			entry->ri_chain = IS_DIRECTORY(next) && !IS_HARDLINK(raw) && strcmp(name, ".") != 0 && strcmp(name, "..") != 0;
+		}
+
+		/* Then the next directory not walked yet */
+
+		while (walked < nindex && !index[walked].ri_chain) {
+			walked++;
+		}
+
+		if (walked == nindex) {
+			break;
+		}
+
+		dir = index[walked++].ri_infosize;
+	}
+
+	if (nindex == 0) {
+		ret = -ENOENT;
+		goto errout;
+	}
+
+	/* Link the hash chains, in directory order so that the first of two
+	 * entries with the same name is found as by the directory walk.
+	 */
+
+	nbuckets = 1;
+	while (nbuckets < nindex) {
+		nbuckets <<= 1;
+	}
+
+	buckets = (uint16_t *)kmm_malloc(nbuckets * sizeof(uint16_t));
+	if (!buckets) {
+		ret = -ENOMEM;
+		goto errout;
+	}
+
+	memset(buckets, 0xff, nbuckets * sizeof(uint16_t));
+	for (i = nindex - 1; i >= 0; i--) {
+		entry = &index[i];
+		entry->ri_chain = buckets[entry->ri_hash & (nbuckets - 1)];
+		buckets[entry->ri_hash & (nbuckets - 1)] = i;
+	}
+
+	entry = (struct romfs_index_s *)kmm_realloc(index, nindex * sizeof(struct romfs_index_s));
+	rm->rm_index = entry ? entry : index;
+	rm->rm_buckets = buckets;
+	rm->rm_nindex = nindex;
+	rm->rm_nbuckets = nbuckets;
+
+	fvdbg("Indexed %d entries in %d buckets\n", nindex, nbuckets);
+	return OK;
+
+errout:
+	fdbg("No index: %d\n", ret);
+	if (index) {
+		kmm_free(index);
+	}
+
+	return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: romfs_freebuffers
+ *
+ * Desciption:
+ *   Free the sector cache and the index of the mountpoint
+ *
+ ****************************************************************************/
+
+void romfs_freebuffers(struct romfs_mountpt_s *rm)
+{
+	if (!rm->rm_xipbase && rm->rm_cache) {
+		kmm_free(rm->rm_cache);
+	}
+
+	rm->rm_cache = NULL;
+	rm->rm_buffer = NULL;
+
+#ifdef CONFIG_FS_ROMFS_INDEX
+	if (rm->rm_index) {
+		kmm_free(rm->rm_index);
+		kmm_free(rm->rm_buckets);
+	}
+
+	rm->rm_index = NULL;
+	rm->rm_buckets = NULL;
+	rm->rm_nindex = 0;
+	rm->rm_nbuckets = 0;
+#endif
+}
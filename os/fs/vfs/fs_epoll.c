@@ -0,0 +1,982 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/vfs/fs_epoll.c
+ *
+ * Persistent interest sets.  poll() sets up the poll of every descriptor
+ * on each call and tears it down again, and its caller then scans all of
+ * the descriptors for events.  An epoll interest set sets up the poll of a
+ * descriptor once, in epoll_ctl(), with a struct pollfd of its own whose
+ * callback queues the descriptor on the ready list of the set.  A wait
+ * then costs in proportion to the number of ready descriptors rather than
+ * the number of descriptors in the set.
+ *
+ * Drivers report events with poll_notify().  Drivers that still post the
+ * poll semaphore directly work as well; their events are found by a scan
+ * of the set when the semaphore is posted with nothing on the ready list.
+ *
+ * A level triggered descriptor stays reported until the next wait, which
+ * sets its poll up again so that the driver reports it once more if it is
+ * still ready.  A descriptor queued that way may be reported although its
+ * data has been read in the meantime, so readers must expect EAGAIN.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/epoll.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <queue.h>
+#include <semaphore.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <arch/irq.h>
+#include <tinyara/clock.h>
+#include <tinyara/cancelpt.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/semaphore.h>
+#include <tinyara/fs/fs.h>
+
+#ifdef CONFIG_NET_LWIP
+#include <net/lwip/sockets.h>
+#endif
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_EPOLL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_NSOCKET_DESCRIPTORS
+#define CONFIG_NSOCKET_DESCRIPTORS 0
+#endif
+
+#define EPOLL_NFDS (CONFIG_NFILE_DESCRIPTORS + CONFIG_NSOCKET_DESCRIPTORS)
+
+#define EPOLL_DEVFMT "/dev/epoll%u"
+#define EPOLL_DEVNAMELEN 16
+
+/* The poll events of the requested events.  Errors and hangups are
+ * reported whether requested or not, as by Linux.
+ */
+
+#define EPOLL_POLLEVENTS(events) \
+	((pollevent_t)(((events) & (POLLIN | POLLOUT)) | POLLERR | POLLHUP))
+
+#define EPOLL_ENTRY(fds) \
+	((FAR struct epoll_entry_s *)((FAR char *)(fds) - offsetof(struct epoll_entry_s, pfd)))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The states of a descriptor in an interest set */
+
+enum epoll_state_e {
+	EPOLL_IDLE = 0,				/* Poll set up, no event yet */
+	EPOLL_READY,				/* On the ready list */
+	EPOLL_REPORTED,				/* On the reported list until the next wait */
+	EPOLL_DISABLED				/* Not waiting for events */
+};
+
+struct epoll_entry_s {
+	dq_entry_t node;			/* On the ready or the reported list */
+	struct pollfd pfd;			/* Kept set up with the driver */
+	FAR struct epoll_s *ep;		/* The set containing the descriptor */
+	FAR void *obj;				/* The struct file or struct socket polled */
+	epoll_data_t data;			/* Returned with the events */
+	uint32_t events;			/* Requested events and EPOLLET/EPOLLONESHOT */
+	volatile uint8_t state;		/* See enum epoll_state_e */
+	bool armed;					/* The poll is set up */
+};
+
+struct epoll_s {
+	dq_entry_t node;			/* In g_epollsets */
+	sem_t exclsem;				/* Serializes epoll_ctl() and epoll_wait();
+								 * not held while waiting for events */
+	sem_t fdsem;				/* Protects fds[] and the polls; never held
+								 * while waiting for events */
+	sem_t waitsem;				/* The poll semaphore of all descriptors */
+	volatile uint8_t nwaiting;	/* Threads waiting on waitsem */
+	uint8_t crefs;				/* Open references and epoll_wait() calls */
+	dq_queue_t ready;			/* Descriptors with events to report */
+	dq_queue_t reported;		/* Descriptors to set up again */
+	FAR struct epoll_entry_s *fds[EPOLL_NFDS];	/* Indexed by descriptor */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int epoll_open(FAR struct file *filep);
+static int epoll_close(FAR struct file *filep);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_epollops = {
+	epoll_open,					/* open */
+	epoll_close,				/* close */
+	NULL,						/* read */
+	NULL,						/* write */
+	NULL,						/* seek */
+	NULL,						/* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+	NULL,						/* poll */
+#endif
+	NULL						/* unlink */
+};
+
+/* Used to give each set a unique, temporary device name */
+
+static unsigned int g_epollno;
+
+/* Every set, for epoll_purge() */
+
+static dq_queue_t g_epollsets;
+static sem_t g_epollsem = SEM_INITIALIZER(1);
+
+/* The number of descriptors in all sets, so that closing a file that no
+ * set contains does not search the sets.
+ */
+
+static volatile unsigned int g_epollnentries;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_semtake
+ ****************************************************************************/
+
+static void epoll_semtake(FAR sem_t *sem)
+{
+	while (sem_wait(sem) != 0) {
+		ASSERT(get_errno() == EINTR);
+	}
+}
+
+/****************************************************************************
+ * Name: epoll_count
+ *
+ * Description:
+ *   Add 'delta' to the number of descriptors in all sets.
+ *
+ ****************************************************************************/
+
+static void epoll_count(int delta)
+{
+	irqstate_t flags;
+
+	flags = irqsave();
+	g_epollnentries += delta;
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_callback
+ *
+ * Description:
+ *   The poll_notify() callback of every descriptor in a set:  Queue the
+ *   descriptor as ready and wake up the waiter.  May run in an interrupt
+ *   handler.
+ *
+ ****************************************************************************/
+
+static void epoll_callback(FAR struct pollfd *fds)
+{
+	FAR struct epoll_entry_s *entry = EPOLL_ENTRY(fds);
+	FAR struct epoll_s *ep = entry->ep;
+	irqstate_t flags;
+
+	flags = irqsave();
+	if (entry->state == EPOLL_IDLE && fds->revents != 0) {
+		entry->state = EPOLL_READY;
+		dq_addlast(&entry->node, &ep->ready);
+		if (ep->nwaiting > 0) {
+			sem_post(&ep->waitsem);
+		}
+	}
+
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_scan
+ *
+ * Description:
+ *   Queue every descriptor with events that has not been queued.  Needed
+ *   only for drivers that post the poll semaphore instead of calling
+ *   poll_notify().  Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void epoll_scan(FAR struct epoll_s *ep)
+{
+	FAR struct epoll_entry_s *entry;
+	int fd;
+
+	for (fd = 0; fd < EPOLL_NFDS; fd++) {
+		entry = ep->fds[fd];
+		if (entry && entry->state == EPOLL_IDLE && entry->pfd.revents != 0) {
+			entry->state = EPOLL_READY;
+			dq_addlast(&entry->node, &ep->ready);
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: epoll_getobj
+ *
+ * Description:
+ *   Return the open file or socket that the descriptor 'fd' of the calling
+ *   task refers to.  The poll is set up and torn down through it, so that
+ *   the set never depends on what the descriptor refers to later.
+ *
+ ****************************************************************************/
+
+static FAR void *epoll_getobj(int fd)
+{
+	FAR struct file *filep;
+
+	if (fd >= CONFIG_NFILE_DESCRIPTORS) {
+#ifdef CONFIG_NET_LWIP
+		return get_socket(fd);
+#else
+		set_errno(EBADF);
+		return NULL;
+#endif
+	}
+
+	filep = fs_getfilep(fd);
+	if (filep && filep->f_inode == NULL) {
+		set_errno(EBADF);
+		return NULL;
+	}
+
+	return filep;
+}
+
+/****************************************************************************
+ * Name: epoll_poll
+ *
+ * Description:
+ *   Set up or tear down the poll of a descriptor with its driver.
+ *
+ ****************************************************************************/
+
+static int epoll_poll(FAR struct epoll_entry_s *entry, bool setup)
+{
+	if (entry->pfd.fd >= CONFIG_NFILE_DESCRIPTORS) {
+#ifdef CONFIG_NET_LWIP
+		return lwip_sock_poll((FAR struct socket *)entry->obj, &entry->pfd, setup);
+#else
+		return -EBADF;
+#endif
+	}
+
+	return file_poll((FAR struct file *)entry->obj, &entry->pfd, setup);
+}
+
+/****************************************************************************
+ * Name: epoll_arm
+ *
+ * Description:
+ *   Set up the poll of a descriptor.  The driver reports events that are
+ *   already pending right away.
+ *
+ ****************************************************************************/
+
+static int epoll_arm(FAR struct epoll_entry_s *entry)
+{
+	int ret;
+
+	entry->pfd.revents = 0;
+	entry->state = EPOLL_IDLE;
+	ret = epoll_poll(entry, true);
+	entry->armed = ret >= 0;
+	if (ret < 0) {
+		entry->state = EPOLL_DISABLED;
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: epoll_disarm
+ *
+ * Description:
+ *   Take a descriptor off the lists and tear down its poll.
+ *
+ ****************************************************************************/
+
+static void epoll_disarm(FAR struct epoll_s *ep, FAR struct epoll_entry_s *entry)
+{
+	irqstate_t flags;
+	uint8_t state;
+
+	flags = irqsave();
+	state = entry->state;
+	if (state == EPOLL_READY) {
+		dq_rem(&entry->node, &ep->ready);
+	} else if (state == EPOLL_REPORTED) {
+		dq_rem(&entry->node, &ep->reported);
+	}
+
+	entry->state = EPOLL_DISABLED;
+	irqrestore(flags);
+
+	if (entry->armed) {
+		(void)epoll_poll(entry, false);
+		entry->armed = false;
+	}
+}
+
+/****************************************************************************
+ * Name: epoll_rearm
+ *
+ * Description:
+ *   Set up the descriptors reported by the last wait again:  A level
+ *   triggered descriptor that is still ready is queued again, and an
+ *   EPOLLONESHOT descriptor is disabled.  Called with fdsem held.
+ *
+ ****************************************************************************/
+
+static void epoll_rearm(FAR struct epoll_s *ep)
+{
+	FAR struct epoll_entry_s *entry;
+	irqstate_t flags;
+
+	for (;;) {
+		flags = irqsave();
+		entry = (FAR struct epoll_entry_s *)dq_remfirst(&ep->reported);
+		irqrestore(flags);
+		if (entry == NULL) {
+			break;
+		}
+
+		if (entry->armed) {
+			(void)epoll_poll(entry, false);
+			entry->armed = false;
+		}
+
+		if (entry->events & EPOLLONESHOT) {
+			entry->state = EPOLL_DISABLED;
+		} else if (epoll_arm(entry) < 0) {
+			/* The driver cannot set up the poll again.  Report an error
+			 * until the descriptor is removed from the set.
+			 */
+
+			flags = irqsave();
+			entry->pfd.revents = POLLERR;
+			entry->state = EPOLL_READY;
+			dq_addlast(&entry->node, &ep->ready);
+			irqrestore(flags);
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: epoll_collect
+ *
+ * Description:
+ *   Move up to 'maxevents' ready descriptors to 'events'.  Called with
+ *   interrupts disabled.
+ *
+ ****************************************************************************/
+
+static int epoll_collect(FAR struct epoll_s *ep, FAR struct epoll_event *events, int maxevents)
+{
+	FAR struct epoll_entry_s *entry;
+	int nevents = 0;
+
+	while (nevents < maxevents) {
+		entry = (FAR struct epoll_entry_s *)dq_remfirst(&ep->ready);
+		if (entry == NULL) {
+			break;
+		}
+
+		events[nevents].events = entry->pfd.revents;
+		events[nevents].data = entry->data;
+		nevents++;
+
+		if ((entry->events & (EPOLLET | EPOLLONESHOT)) == EPOLLET) {
+			/* Stay set up; the driver reports the next event */
+
+			entry->pfd.revents = 0;
+			entry->state = EPOLL_IDLE;
+		} else {
+			entry->state = EPOLL_REPORTED;
+			dq_addlast(&entry->node, &ep->reported);
+		}
+	}
+
+	return nevents;
+}
+
+/****************************************************************************
+ * Name: epoll_getset
+ *
+ * Description:
+ *   Return the interest set of the descriptor 'epfd'.
+ *
+ ****************************************************************************/
+
+static FAR struct epoll_s *epoll_getset(int epfd)
+{
+	FAR struct file *filep;
+
+	filep = fs_getfilep(epfd);
+	if (filep == NULL) {
+		return NULL;
+	}
+
+	if (filep->f_inode == NULL || filep->f_inode->u.i_ops != &g_epollops) {
+		set_errno(EINVAL);
+		return NULL;
+	}
+
+	return (FAR struct epoll_s *)filep->f_inode->i_private;
+}
+
+/****************************************************************************
+ * Name: epoll_open
+ ****************************************************************************/
+
+static int epoll_open(FAR struct file *filep)
+{
+	FAR struct epoll_s *ep = filep->f_inode->i_private;
+
+	epoll_semtake(&ep->exclsem);
+	ep->crefs++;
+	sem_post(&ep->exclsem);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_release
+ *
+ * Description:
+ *   Drop a reference to the set.  On the last one, tear down the poll of
+ *   every descriptor in the set and free the set.  Called with exclsem
+ *   held, which is released.
+ *
+ ****************************************************************************/
+
+static void epoll_release(FAR struct epoll_s *ep)
+{
+	int fd;
+
+	if (--ep->crefs > 0) {
+		sem_post(&ep->exclsem);
+		return;
+	}
+
+	sem_post(&ep->exclsem);
+
+	/* Once off the list, nothing else can reach the set */
+
+	epoll_semtake(&g_epollsem);
+	dq_rem(&ep->node, &g_epollsets);
+	sem_post(&g_epollsem);
+
+	for (fd = 0; fd < EPOLL_NFDS; fd++) {
+		if (ep->fds[fd]) {
+			epoll_disarm(ep, ep->fds[fd]);
+			kmm_free(ep->fds[fd]);
+			epoll_count(-1);
+		}
+	}
+
+	sem_destroy(&ep->waitsem);
+	sem_destroy(&ep->fdsem);
+	sem_destroy(&ep->exclsem);
+	kmm_free(ep);
+}
+
+/****************************************************************************
+ * Name: epoll_close
+ *
+ * Description:
+ *   Drop the reference of the descriptor.  The set is freed once neither a
+ *   descriptor nor an epoll_wait() call refers to it.
+ *
+ ****************************************************************************/
+
+static int epoll_close(FAR struct file *filep)
+{
+	FAR struct epoll_s *ep = filep->f_inode->i_private;
+
+	epoll_semtake(&ep->exclsem);
+	epoll_release(ep);
+	filep->f_inode->i_private = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_create1
+ *
+ * Description:
+ *   Create an empty interest set.
+ *
+ * Input Parameters:
+ *   flags - Zero or EPOLL_CLOEXEC
+ *
+ * Returned Value:
+ *   A descriptor for the set, to be used with epoll_ctl(), epoll_wait()
+ *   and close().  On failure, -1 is returned and the errno is set.
+ *
+ ****************************************************************************/
+
+int epoll_create1(int flags)
+{
+	FAR struct epoll_s *ep;
+	char devname[EPOLL_DEVNAMELEN];
+	irqstate_t irqflags;
+	unsigned int devno;
+	int errcode;
+	int fd;
+	int ret;
+
+	if ((flags & ~EPOLL_CLOEXEC) != 0) {
+		errcode = EINVAL;
+		goto errout;
+	}
+
+	ep = (FAR struct epoll_s *)kmm_zalloc(sizeof(struct epoll_s));
+	if (ep == NULL) {
+		errcode = ENOMEM;
+		goto errout;
+	}
+
+	/* waitsem is used for signaling and should not have priority
+	 * inheritance enabled.
+	 */
+
+	sem_init(&ep->exclsem, 0, 1);
+	sem_init(&ep->fdsem, 0, 1);
+	sem_init(&ep->waitsem, 0, 0);
+	sem_setprotocol(&ep->waitsem, SEM_PRIO_NONE);
+	dq_init(&ep->ready);
+	dq_init(&ep->reported);
+
+	/* Like pipe(), register a driver, open it and remove its name again.
+	 * The inode lives on until the descriptor is closed.
+	 */
+
+	irqflags = irqsave();
+	devno = g_epollno++;
+	irqrestore(irqflags);
+
+	snprintf(devname, EPOLL_DEVNAMELEN, EPOLL_DEVFMT, devno);
+	ret = register_driver(devname, &g_epollops, 0666, (FAR void *)ep);
+	if (ret < 0) {
+		errcode = -ret;
+		goto errout_with_ep;
+	}
+
+	fd = open(devname, O_RDWR);
+	unregister_driver(devname);
+	if (fd < 0) {
+		errcode = get_errno();
+		goto errout_with_ep;
+	}
+
+	epoll_semtake(&g_epollsem);
+	dq_addlast(&ep->node, &g_epollsets);
+	sem_post(&g_epollsem);
+	return fd;
+
+errout_with_ep:
+	sem_destroy(&ep->waitsem);
+	sem_destroy(&ep->fdsem);
+	sem_destroy(&ep->exclsem);
+	kmm_free(ep);
+
+errout:
+	set_errno(errcode);
+	return ERROR;
+}
+
+/****************************************************************************
+ * Name: epoll_create
+ *
+ * Description:
+ *   Create an empty interest set.  'size' is a hint that is not needed.
+ *
+ ****************************************************************************/
+
+int epoll_create(int size)
+{
+	if (size <= 0) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	return epoll_create1(0);
+}
+
+/****************************************************************************
+ * Name: epoll_ctl
+ *
+ * Description:
+ *   Add a descriptor to an interest set, change its events or remove it.
+ *
+ * Input Parameters:
+ *   epfd - The descriptor of the set
+ *   op   - EPOLL_CTL_ADD, EPOLL_CTL_MOD or EPOLL_CTL_DEL
+ *   fd   - The file or socket descriptor
+ *   ev   - The events to wait for and the data to return with them.
+ *          Not used by EPOLL_CTL_DEL.
+ *
+ * Returned Value:
+ *   Zero on success.  On failure, -1 is returned and the errno is set:
+ *
+ *   EBADF  - 'epfd' or 'fd' is not a valid descriptor
+ *   EEXIST - EPOLL_CTL_ADD of a descriptor already in the set
+ *   ENOENT - EPOLL_CTL_MOD or EPOLL_CTL_DEL of a descriptor not in the set
+ *   EINVAL - 'epfd' is not an interest set, 'fd' is 'epfd' or 'op' is
+ *            not supported
+ *   ENOMEM - No memory for the descriptor
+ *   ENOSYS - The driver of 'fd' does not support poll()
+ *
+ ****************************************************************************/
+
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
+{
+	FAR struct epoll_entry_s *entry;
+	FAR struct epoll_s *ep;
+	int errcode;
+	int ret;
+
+	ep = epoll_getset(epfd);
+	if (ep == NULL) {
+		return ERROR;
+	}
+
+	if ((unsigned int)fd >= EPOLL_NFDS) {
+		set_errno(EBADF);
+		return ERROR;
+	}
+
+	if (fd == epfd || (op != EPOLL_CTL_DEL && ev == NULL)) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	epoll_semtake(&ep->exclsem);
+	epoll_semtake(&ep->fdsem);
+	entry = ep->fds[fd];
+
+	switch (op) {
+	case EPOLL_CTL_ADD:
+		if (entry) {
+			errcode = EEXIST;
+			goto errout;
+		}
+
+		entry = (FAR struct epoll_entry_s *)kmm_zalloc(sizeof(struct epoll_entry_s));
+		if (entry == NULL) {
+			errcode = ENOMEM;
+			goto errout;
+		}
+
+		entry->obj = epoll_getobj(fd);
+		if (entry->obj == NULL) {
+			errcode = get_errno();
+			kmm_free(entry);
+			goto errout;
+		}
+
+		entry->ep = ep;
+		entry->data = ev->data;
+		entry->events = ev->events;
+		entry->pfd.fd = fd;
+		entry->pfd.sem = &ep->waitsem;
+		entry->pfd.events = EPOLL_POLLEVENTS(ev->events);
+		entry->pfd.cb = epoll_callback;
+
+		ep->fds[fd] = entry;
+		ret = epoll_arm(entry);
+		if (ret < 0) {
+			ep->fds[fd] = NULL;
+			kmm_free(entry);
+			errcode = -ret;
+			goto errout;
+		}
+
+		epoll_count(1);
+		break;
+
+	case EPOLL_CTL_MOD:
+		if (entry == NULL) {
+			errcode = ENOENT;
+			goto errout;
+		}
+
+		epoll_disarm(ep, entry);
+		entry->data = ev->data;
+		entry->events = ev->events;
+		entry->pfd.events = EPOLL_POLLEVENTS(ev->events);
+
+		/* On failure, the descriptor stays in the set without events */
+
+		ret = epoll_arm(entry);
+		if (ret < 0) {
+			errcode = -ret;
+			goto errout;
+		}
+		break;
+
+	case EPOLL_CTL_DEL:
+		if (entry == NULL) {
+			errcode = ENOENT;
+			goto errout;
+		}
+
+		epoll_disarm(ep, entry);
+		ep->fds[fd] = NULL;
+		kmm_free(entry);
+		epoll_count(-1);
+		break;
+
+	default:
+		errcode = EINVAL;
+		goto errout;
+	}
+
+	sem_post(&ep->fdsem);
+	sem_post(&ep->exclsem);
+	return OK;
+
+errout:
+	sem_post(&ep->fdsem);
+	sem_post(&ep->exclsem);
+	set_errno(errcode);
+	return ERROR;
+}
+
+/****************************************************************************
+ * Name: epoll_wait
+ *
+ * Description:
+ *   Wait for events of the descriptors in an interest set.
+ *
+ * Input Parameters:
+ *   epfd      - The descriptor of the set
+ *   events    - The location to return the events
+ *   maxevents - The number of entries of 'events'
+ *   timeout   - The longest wait in milliseconds.  Zero returns right away
+ *               and a negative value waits without a time limit.
+ *
+ * Returned Value:
+ *   The number of entries filled in 'events', zero if the time ran out.
+ *   On failure, -1 is returned and the errno is set:
+ *
+ *   EBADF  - 'epfd' is not a valid descriptor
+ *   EINVAL - 'epfd' is not an interest set or 'maxevents' is not positive
+ *   EINTR  - A signal was received before any event
+ *
+ ****************************************************************************/
+
+int epoll_wait(int epfd, FAR struct epoll_event *events, int maxevents, int timeout)
+{
+	FAR struct epoll_s *ep;
+	struct timespec abstime;
+	irqstate_t flags;
+	bool posted;
+	int ret = OK;
+
+	/* epoll_wait() is a cancellation point */
+
+	(void)enter_cancellation_point();
+
+	ep = epoll_getset(epfd);
+	if (ep == NULL) {
+		leave_cancellation_point();
+		return ERROR;
+	}
+
+	if (events == NULL || maxevents <= 0) {
+		leave_cancellation_point();
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	/* The call holds a reference, so that a close() while it waits does
+	 * not free the set.
+	 */
+
+	epoll_semtake(&ep->exclsem);
+	ep->crefs++;
+
+	/* Level triggered descriptors reported last time are reported again if
+	 * they are still ready.
+	 */
+
+	epoll_semtake(&ep->fdsem);
+	epoll_rearm(ep);
+	sem_post(&ep->fdsem);
+
+	if (timeout > 0) {
+		(void)clock_gettime(CLOCK_REALTIME, &abstime);
+		abstime.tv_sec += timeout / MSEC_PER_SEC;
+		abstime.tv_nsec += (timeout % MSEC_PER_SEC) * NSEC_PER_MSEC;
+		if (abstime.tv_nsec >= NSEC_PER_SEC) {
+			abstime.tv_sec++;
+			abstime.tv_nsec -= NSEC_PER_SEC;
+		}
+	}
+
+	/* Interrupts are re-enabled while waiting */
+
+	flags = irqsave();
+	for (;;) {
+		/* Posts that epoll_callback() did not make come from drivers that
+		 * do not call poll_notify().
+		 */
+
+		posted = false;
+		while (sem_trywait(&ep->waitsem) == 0) {
+			posted = true;
+		}
+
+		if (posted) {
+			epoll_scan(ep);
+		}
+
+		if (!dq_empty(&ep->ready) || timeout == 0) {
+			break;
+		}
+
+		/* epoll_ctl(), close() and other waiters may use the set while
+		 * this thread sleeps.
+		 */
+
+		ep->nwaiting++;
+		sem_post(&ep->exclsem);
+
+		if (timeout > 0) {
+			ret = sem_timedwait(&ep->waitsem, &abstime);
+		} else {
+			ret = sem_wait(&ep->waitsem);
+		}
+
+		if (ret < 0) {
+			ret = get_errno();
+		}
+
+		ep->nwaiting--;
+		epoll_semtake(&ep->exclsem);
+
+		if (ret != OK) {
+			ret = ret == ETIMEDOUT ? OK : -ret;
+			break;
+		}
+
+		if (dq_empty(&ep->ready)) {
+			epoll_scan(ep);
+		}
+	}
+
+	if (ret >= 0) {
+		ret = epoll_collect(ep, events, maxevents);
+	} else if (!dq_empty(&ep->ready)) {
+		/* Events arrived along with the signal */
+
+		ret = epoll_collect(ep, events, maxevents);
+	}
+
+	irqrestore(flags);
+
+	epoll_release(ep);
+	leave_cancellation_point();
+
+	if (ret < 0) {
+		set_errno(-ret);
+		return ERROR;
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: epoll_purge
+ *
+ * Description:
+ *   Remove an open file or socket that is being closed from every set, so
+ *   that no driver keeps the poll of a set past the close and a descriptor
+ *   number reused later is not confused with it.
+ *
+ * Input Parameters:
+ *   obj - The struct file or struct socket being closed
+ *
+ ****************************************************************************/
+
+void epoll_purge(FAR void *obj)
+{
+	FAR struct epoll_entry_s *entry;
+	FAR struct epoll_s *ep;
+	int fd;
+
+	/* Most files are closed while no set contains any descriptor */
+
+	if (g_epollnentries == 0) {
+		return;
+	}
+
+	epoll_semtake(&g_epollsem);
+	for (ep = (FAR struct epoll_s *)dq_peek(&g_epollsets); ep; ep = (FAR struct epoll_s *)dq_next(&ep->node)) {
+		epoll_semtake(&ep->fdsem);
+		for (fd = 0; fd < EPOLL_NFDS; fd++) {
+			entry = ep->fds[fd];
+			if (entry && entry->obj == obj) {
+				epoll_disarm(ep, entry);
+				ep->fds[fd] = NULL;
+				kmm_free(entry);
+				epoll_count(-1);
+			}
+		}
+
+		sem_post(&ep->fdsem);
+	}
+
+	sem_post(&g_epollsem);
+}
+
+#endif							/* CONFIG_FS_EPOLL */
@@ -122,7 +122,15 @@ int file_fsync(FAR struct file *filep)
 		goto errout;
 	}
 
-	/* Yes, then tell the mountpoint to sync this file */
+	/* Write the buffered data, then tell the mountpoint to sync this file */
+
+#ifdef CONFIG_FS_WRITEBEHIND
+	ret = wrbehind_sync(filep);
+	if (ret < 0) {
+		ret = -ret;
+		goto errout;
+	}
+#endif
 
 	ret = inode->u.i_mops->sync(filep);
 	if (ret >= 0) {
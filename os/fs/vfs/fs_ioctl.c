@@ -147,6 +147,7 @@ int ioctl(int fd, int req, unsigned long arg)
 	if (inode && inode->u.i_ops && inode->u.i_ops->ioctl) {
 		/* Yes, then let it perform the ioctl */
 
+		wrbehind_drain(filep);
 		ret = (int)inode->u.i_ops->ioctl(filep, req, arg);
 		if (ret < 0) {
 			err = -ret;
@@ -97,6 +97,10 @@ off_t file_seek(FAR struct file *filep, off_t offset, int whence)
 	DEBUGASSERT(filep);
 	inode = filep->f_inode;
 
+	/* Buffered data is written at the current position */
+
+	wrbehind_drain(filep);
+
 	/* Invoke the file seek method if available */
 
 	if (inode && inode->u.i_ops && inode->u.i_ops->seek) {
@@ -234,6 +234,16 @@ int open(const char *path, int oflags, ...)
 		goto errout_with_fd;
 	}
 
+#ifdef CONFIG_FS_WRITEBEHIND
+	/* Buffer the writes of a file system file opened for O_WRBEHIND.  The
+	 * flag is ignored for drivers and for O_SYNC files.
+	 */
+
+	if ((oflags & (O_WRBEHIND | O_WROK | O_SYNC)) == (O_WRBEHIND | O_WROK) && INODE_IS_MOUNTPT(inode)) {
+		wrbehind_open(filep);
+	}
+#endif
+
 	leave_cancellation_point();
 	return fd;
 
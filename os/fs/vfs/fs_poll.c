@@ -122,11 +122,10 @@ static int poll_semtake(FAR sem_t *sem)
  ****************************************************************************/
 
 #if CONFIG_NFILE_DESCRIPTORS > 0
-static int poll_fdsetup(int fd, FAR struct pollfd *fds, bool setup)
+int poll_fdsetup(int fd, FAR struct pollfd *fds, bool setup)
 {
 	FAR struct file *filep;
-	FAR struct inode *inode;
-	int ret = -ENOSYS;
+	int ret;
 
 	/* Check for a valid file descriptor */
 
@@ -156,6 +155,22 @@ static int poll_fdsetup(int fd, FAR struct pollfd *fds, bool setup)
 		return ERROR;
 	}
 
+	return file_poll(filep, fds, setup);
+}
+
+/****************************************************************************
+ * Name: file_poll
+ *
+ * Description:
+ *   Like poll_fdsetup(), but for an open file instead of a descriptor.
+ *
+ ****************************************************************************/
+
+int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
+{
+	FAR struct inode *inode;
+	int ret = -ENOSYS;
+
 	/* Is a driver registered? Does it support the poll method?
 	 * If not, return -ENOSYS
 	 */
@@ -194,6 +209,9 @@ static inline int poll_setup(FAR struct pollfd *fds, nfds_t nfds, sem_t *sem)
 		fds[i].sem = sem;
 		fds[i].revents = 0;
 		fds[i].priv = NULL;
+#ifdef CONFIG_FS_EPOLL
+		fds[i].cb = NULL;
+#endif
 
 		/* Check for invalid descriptors. "If the value of fd is less than 0,
 		 * events shall be ignored, and revents shall be set to 0 in that entry
@@ -280,6 +298,25 @@ static inline int poll_teardown(FAR struct pollfd *fds, nfds_t nfds, int *count,
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: poll_notify
+ *
+ * Description:
+ *   Report the events set in fds->revents to the waiter on 'fds'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_EPOLL
+void poll_notify(FAR struct pollfd *fds)
+{
+	if (fds->cb) {
+		fds->cb(fds);
+	} else {
+		poll_semgive(fds->sem);
+	}
+}
+#endif
+
 /****************************************************************************
  * Name: poll
  *
@@ -63,6 +63,7 @@
 #include <sched.h>
 #include <errno.h>
 #include <tinyara/cancelpt.h>
+#include <tinyara/sched.h>
 
 #include "inode/inode.h"
 
@@ -117,6 +118,7 @@ ssize_t file_read(FAR struct file *filep, FAR void *buf, size_t nbytes)
 		 * signature and position in the operations vtable.
 		 */
 
+		wrbehind_drain(filep);
 		ret = (int)inode->u.i_ops->read(filep, (char *)buf, (size_t)nbytes);
 	}
 
@@ -129,6 +131,8 @@ ssize_t file_read(FAR struct file *filep, FAR void *buf, size_t nbytes)
 
 	/* Otherwise, return the number of bytes read */
 
+	sched_ioaccount(rcalls, 1);
+	sched_ioaccount(rbytes, ret);
 	return ret;
 }
 
@@ -63,6 +63,7 @@
 #include <assert.h>
 
 #include <tinyara/cancelpt.h>
+#include <tinyara/sched.h>
 #include <sys/socket.h>
 
 #include "inode/inode.h"
@@ -106,14 +107,23 @@ ssize_t file_write(FAR struct file *filep, FAR const void *buf, size_t nbytes)
 		goto errout;
 	}
 
-	/* Yes, then let the driver perform the write */
+	/* Yes, then let the driver perform the write, or buffer it */
 
-	ret = inode->u.i_ops->write(filep, buf, nbytes);
+#ifdef CONFIG_FS_WRITEBEHIND
+	if (filep->f_wb) {
+		ret = wrbehind_write(filep, buf, nbytes);
+	} else
+#endif
+	{
+		ret = inode->u.i_ops->write(filep, buf, nbytes);
+	}
 	if (ret < 0) {
 		err = -ret;
 		goto errout;
 	}
 
+	sched_ioaccount(wcalls, 1);
+	sched_ioaccount(wbytes, ret);
 	return ret;
 
 errout:
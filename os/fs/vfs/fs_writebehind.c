@@ -0,0 +1,640 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/vfs/fs_writebehind.c
+ *
+ * Write-behind buffering of files opened with O_WRBEHIND.  write() copies
+ * the data into a RAM buffer of the file and returns; a worker on the long
+ * running, low priority work queue writes the buffer to the file system in
+ * chunks of CONFIG_FS_WRITEBEHIND_CHUNK bytes at chunk aligned offsets of
+ * the file, so that a flash file system sees few, large, aligned writes
+ * instead of one write per call.  A partial chunk is written once it has
+ * waited CONFIG_FS_WRITEBEHIND_DELAY milliseconds.
+ *
+ * The buffer is a ring indexed by the file offset modulo its size, which
+ * is a multiple of the chunk size, so a chunk never wraps around the end
+ * of the ring.  Two semaphores protect a buffer: exclsem protects the
+ * ring indexes and is only held to copy data in or out of the ring, and
+ * flushsem serializes the writes of the file system so that write() can
+ * still append to the ring while a chunk is being written.
+ *
+ * The buffered data is written before any other operation on the file:
+ * read(), lseek(), ioctl(), fsync(), dup() and close().  Data buffered in
+ * one descriptor is not seen by other descriptors of the same file until
+ * it is written, as with a stdio stream.
+ *
+ * Dirty memory is bounded twice: a writer that finds the ring of its file
+ * full writes the aligned chunks itself, and a writer that would take the
+ * total of all buffered data above CONFIG_FS_WRITEBEHIND_MAXDIRTY writes
+ * through.  An error of a write performed by the worker discards the
+ * buffered data of the file and is returned by the next write(), fsync()
+ * or close() of the descriptor.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <queue.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <arch/irq.h>
+#include <tinyara/clock.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/wqueue.h>
+#include <tinyara/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_WRITEBEHIND
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_WRITEBEHIND_BUFSIZE
+#define CONFIG_FS_WRITEBEHIND_BUFSIZE 4096
+#endif
+
+#ifndef CONFIG_FS_WRITEBEHIND_CHUNK
+#define CONFIG_FS_WRITEBEHIND_CHUNK 1024
+#endif
+
+#ifndef CONFIG_FS_WRITEBEHIND_MAXDIRTY
+#define CONFIG_FS_WRITEBEHIND_MAXDIRTY 16384
+#endif
+
+#ifndef CONFIG_FS_WRITEBEHIND_DELAY
+#define CONFIG_FS_WRITEBEHIND_DELAY 100
+#endif
+
+#if CONFIG_FS_WRITEBEHIND_CHUNK <= 0 || CONFIG_FS_WRITEBEHIND_BUFSIZE < 2 * CONFIG_FS_WRITEBEHIND_CHUNK
+#error CONFIG_FS_WRITEBEHIND_BUFSIZE must hold two chunks at least
+#endif
+
+#if (CONFIG_FS_WRITEBEHIND_BUFSIZE % CONFIG_FS_WRITEBEHIND_CHUNK) != 0
+#error CONFIG_FS_WRITEBEHIND_BUFSIZE must be a multiple of CONFIG_FS_WRITEBEHIND_CHUNK
+#endif
+
+#define WB_BUFSIZE   CONFIG_FS_WRITEBEHIND_BUFSIZE
+#define WB_CHUNK     CONFIG_FS_WRITEBEHIND_CHUNK
+#define WB_DELAY     MSEC2TICK(CONFIG_FS_WRITEBEHIND_DELAY)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct wrbehind_s {
+	dq_entry_t node;			/* In g_wbdirty while the worker must visit it */
+	FAR struct file *filep;		/* The file written */
+	sem_t exclsem;				/* Protects the ring indexes and 'error' */
+	sem_t flushsem;				/* Serializes the writes of the file system */
+	uint16_t head;				/* Ring index of the next byte written */
+	uint16_t tail;				/* Ring index of the next byte flushed */
+	uint16_t count;				/* Number of bytes in the ring */
+	uint8_t error;				/* Deferred error of the worker, or 0 */
+	bool queued;				/* In g_wbdirty */
+	bool closing;				/* Being closed, not queued again */
+	clock_t stamp;				/* When the oldest byte was buffered */
+	uint8_t buf[WB_BUFSIZE];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The worker and the buffers it must visit.  These, the number of bytes
+ * buffered in all files and the buffer being flushed by the worker are
+ * protected by disabling interrupts.
+ */
+
+static struct work_s g_wbwork;
+static bool g_wbpending;		/* g_wbwork is queued */
+static clock_t g_wbdue;			/* When the queued g_wbwork runs */
+static dq_queue_t g_wbdirty;
+static size_t g_wbnbytes;
+
+/* close() waits on g_wbdone while the worker flushes its buffer */
+
+static FAR struct wrbehind_s *g_wbactive;
+static uint8_t g_wbnwait;
+static sem_t g_wbdone = SEM_INITIALIZER(0);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void wb_semtake(FAR sem_t *sem)
+{
+	while (sem_wait(sem) != 0) {
+		/* The only case that an error should occur here is if the wait
+		 * was awakened by a signal.
+		 */
+
+		ASSERT(get_errno() == EINTR);
+	}
+}
+
+/****************************************************************************
+ * Name: wb_schedule
+ *
+ * Description:
+ *   Make sure that the worker runs within 'delay' ticks.
+ *
+ ****************************************************************************/
+
+static void wb_worker(FAR void *arg);
+
+static void wb_schedule(clock_t delay)
+{
+	irqstate_t flags;
+	clock_t due;
+
+	flags = irqsave();
+	due = clock_systimer() + delay;
+	if (g_wbpending) {
+		if ((int32_t)(due - g_wbdue) >= 0) {
+			/* It already runs sooner */
+
+			irqrestore(flags);
+			return;
+		}
+
+		work_cancel(LPWORK_LONG, &g_wbwork);
+	}
+
+	g_wbpending = true;
+	g_wbdue = due;
+	work_queue(LPWORK_LONG, &g_wbwork, wb_worker, NULL, delay);
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: wb_append
+ *
+ * Description:
+ *   Copy as much of 'buf' as fits into the ring, within the limit of dirty
+ *   memory, and queue the buffer for the worker.  Returns the number of
+ *   bytes copied.
+ *
+ ****************************************************************************/
+
+static size_t wb_append(FAR struct wrbehind_s *wb, FAR const uint8_t *buf, size_t nbytes)
+{
+	irqstate_t flags;
+	clock_t delay;
+	size_t part;
+	size_t n;
+
+	wb_semtake(&wb->exclsem);
+
+	/* An empty ring restarts at the file position so that the chunks of
+	 * the ring are aligned with the chunks of the file.
+	 */
+
+	if (wb->count == 0) {
+		wb->head = wb->tail = (uint16_t)(wb->filep->f_pos % WB_BUFSIZE);
+		wb->stamp = clock_systimer();
+	}
+
+	n = WB_BUFSIZE - wb->count;
+	if (n > nbytes) {
+		n = nbytes;
+	}
+
+	flags = irqsave();
+	if (g_wbnbytes + n > CONFIG_FS_WRITEBEHIND_MAXDIRTY) {
+		n = g_wbnbytes < CONFIG_FS_WRITEBEHIND_MAXDIRTY ? CONFIG_FS_WRITEBEHIND_MAXDIRTY - g_wbnbytes : 0;
+	}
+
+	g_wbnbytes += n;
+	irqrestore(flags);
+
+	if (n == 0) {
+		sem_post(&wb->exclsem);
+		return 0;
+	}
+
+	part = WB_BUFSIZE - wb->head;
+	if (part > n) {
+		part = n;
+	}
+
+	memcpy(&wb->buf[wb->head], buf, part);
+	memcpy(wb->buf, buf + part, n - part);
+	wb->head = (uint16_t)((wb->head + n) % WB_BUFSIZE);
+	wb->count += n;
+
+	/* Flush at once if a whole chunk is buffered, otherwise when the oldest
+	 * byte has waited long enough.
+	 */
+
+	delay = wb->count >= WB_CHUNK ? 0 : WB_DELAY - (clock_systimer() - wb->stamp);
+	if ((int32_t)delay < 0) {
+		delay = 0;
+	}
+
+	sem_post(&wb->exclsem);
+
+	flags = irqsave();
+	if (!wb->queued) {
+		dq_addlast(&wb->node, &g_wbdirty);
+		wb->queued = true;
+	}
+
+	irqrestore(flags);
+	wb_schedule(delay);
+	return n;
+}
+
+/****************************************************************************
+ * Name: wb_flush
+ *
+ * Description:
+ *   Write the buffered data to the file system, one aligned chunk per
+ *   write.  A partial chunk left at the end is only written if 'all' is
+ *   true.  On an error the chunk that failed and the data after it stay
+ *   buffered, to be written again later, and the negated errno is
+ *   returned.  The caller holds flushsem.
+ *
+ ****************************************************************************/
+
+static int wb_flush(FAR struct wrbehind_s *wb, bool all)
+{
+	FAR struct inode *inode = wb->filep->f_inode;
+	irqstate_t flags;
+	ssize_t ret;
+	size_t count;
+	size_t tail;
+	size_t n;
+
+	for (;;) {
+		/* The bytes between tail and head stay in the ring until they are
+		 * written, so write() only ever copies into free space.
+		 */
+
+		wb_semtake(&wb->exclsem);
+		count = wb->count;
+		tail = wb->tail;
+		sem_post(&wb->exclsem);
+
+		if (count == 0) {
+			return OK;
+		}
+
+		n = WB_CHUNK - (tail % WB_CHUNK);
+		if (n > count) {
+			if (!all) {
+				return OK;
+			}
+
+			n = count;
+		}
+
+		ret = inode->u.i_ops->write(wb->filep, (FAR const char *)&wb->buf[tail], n);
+		if (ret <= 0) {
+			/* The file position is where the chunk starts.  Writing the
+			 * data after it would leave a hole, keep it all.
+			 */
+
+			ret = ret == 0 ? -EIO : ret;
+			fdbg("write-behind of %u bytes failed: %d\n", (unsigned int)n, (int)ret);
+			return (int)ret;
+		}
+
+		wb_semtake(&wb->exclsem);
+		wb->tail = (uint16_t)((wb->tail + ret) % WB_BUFSIZE);
+		wb->count -= ret;
+		sem_post(&wb->exclsem);
+
+		flags = irqsave();
+		g_wbnbytes -= ret;
+		irqrestore(flags);
+	}
+}
+
+/****************************************************************************
+ * Name: wb_worker
+ *
+ * Description:
+ *   Write the complete chunks of every queued buffer, and the partial
+ *   chunks that have waited long enough.  Buffers left with data are
+ *   queued again.
+ *
+ ****************************************************************************/
+
+static void wb_worker(FAR void *arg)
+{
+	FAR struct wrbehind_s *wb;
+	FAR dq_entry_t *node;
+	irqstate_t flags;
+	clock_t now;
+	clock_t delay;
+	clock_t next;
+	bool requeue;
+	int count;
+	int ret;
+
+	flags = irqsave();
+	g_wbpending = false;
+	count = 0;
+	for (node = dq_peek(&g_wbdirty); node != NULL; node = dq_next(node)) {
+		count++;
+	}
+
+	irqrestore(flags);
+
+	now = clock_systimer();
+	next = WB_DELAY;
+	requeue = false;
+
+	while (count-- > 0) {
+		flags = irqsave();
+		wb = (FAR struct wrbehind_s *)dq_remfirst(&g_wbdirty);
+		if (wb == NULL) {
+			irqrestore(flags);
+			break;
+		}
+
+		wb->queued = false;
+		g_wbactive = wb;
+		irqrestore(flags);
+
+		/* close() does not free the buffer while it is active */
+
+		wb_semtake(&wb->flushsem);
+		ret = wb_flush(wb, (int32_t)(now - wb->stamp) >= (int32_t)WB_DELAY);
+		if (ret < 0) {
+			wb_semtake(&wb->exclsem);
+			wb->error = (uint8_t)-ret;
+			sem_post(&wb->exclsem);
+		}
+
+		sem_post(&wb->flushsem);
+
+		flags = irqsave();
+		if (wb->count > 0 && !wb->queued && !wb->closing) {
+			dq_addlast(&wb->node, &g_wbdirty);
+			wb->queued = true;
+			requeue = true;
+
+			delay = WB_DELAY - (now - wb->stamp);
+			if ((int32_t)delay > 0 && delay < next) {
+				next = delay;
+			}
+		}
+
+		g_wbactive = NULL;
+		while (g_wbnwait > 0) {
+			g_wbnwait--;
+			sem_post(&g_wbdone);
+		}
+
+		irqrestore(flags);
+	}
+
+	if (requeue) {
+		wb_schedule(next);
+	}
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wrbehind_open
+ *
+ * Description:
+ *   Attach a write-behind buffer to a file opened with O_WRBEHIND.  The
+ *   file is written through if there is no memory for the buffer.
+ *
+ ****************************************************************************/
+
+void wrbehind_open(FAR struct file *filep)
+{
+	FAR struct wrbehind_s *wb;
+
+	wb = (FAR struct wrbehind_s *)kmm_zalloc(sizeof(struct wrbehind_s));
+	if (wb == NULL) {
+		fdbg("no memory, writing through\n");
+		return;
+	}
+
+	wb->filep = filep;
+	sem_init(&wb->exclsem, 0, 1);
+	sem_init(&wb->flushsem, 0, 1);
+	filep->f_wb = wb;
+}
+
+/****************************************************************************
+ * Name: wrbehind_write
+ *
+ * Description:
+ *   The write() of a file with a write-behind buffer.  Writes of a whole
+ *   buffer or more, and writes beyond the limit of dirty memory, are
+ *   written through after the buffered data.
+ *
+ ****************************************************************************/
+
+ssize_t wrbehind_write(FAR struct file *filep, FAR const void *buf, size_t nbytes)
+{
+	FAR struct wrbehind_s *wb = filep->f_wb;
+	FAR const uint8_t *src = (FAR const uint8_t *)buf;
+	size_t done;
+	ssize_t ret;
+	int err;
+
+	/* Report the error of a write performed by the worker */
+
+	wb_semtake(&wb->exclsem);
+	err = wb->error;
+	wb->error = 0;
+	sem_post(&wb->exclsem);
+
+	if (err != 0) {
+		return -err;
+	}
+
+	done = 0;
+	if (nbytes < WB_BUFSIZE) {
+		done = wb_append(wb, src, nbytes);
+		if (done < nbytes) {
+			/* The ring is full: write its complete chunks and try again */
+
+			wb_semtake(&wb->flushsem);
+			ret = wb_flush(wb, false);
+			sem_post(&wb->flushsem);
+			if (ret < 0) {
+				return done > 0 ? (ssize_t)done : ret;
+			}
+
+			done += wb_append(wb, src + done, nbytes - done);
+		}
+
+		if (done == nbytes) {
+			return nbytes;
+		}
+	}
+
+	/* Write the rest through, after the buffered data */
+
+	wb_semtake(&wb->flushsem);
+	ret = wb_flush(wb, true);
+	if (ret >= 0) {
+		ret = filep->f_inode->u.i_ops->write(filep, (FAR const char *)src + done, nbytes - done);
+	}
+
+	sem_post(&wb->flushsem);
+
+	if (ret < 0) {
+		return done > 0 ? (ssize_t)done : ret;
+	}
+
+	return done + ret;
+}
+
+/****************************************************************************
+ * Name: wrbehind_drain
+ *
+ * Description:
+ *   Write all of the buffered data of the file before another operation on
+ *   it.  An error is kept to be returned by the next write(), fsync() or
+ *   close().
+ *
+ ****************************************************************************/
+
+void wrbehind_drain(FAR struct file *filep)
+{
+	FAR struct wrbehind_s *wb = filep->f_wb;
+	int ret;
+
+	if (wb == NULL) {
+		return;
+	}
+
+	wb_semtake(&wb->flushsem);
+	ret = wb_flush(wb, true);
+	if (ret < 0) {
+		wb_semtake(&wb->exclsem);
+		wb->error = (uint8_t)-ret;
+		sem_post(&wb->exclsem);
+	}
+
+	sem_post(&wb->flushsem);
+}
+
+/****************************************************************************
+ * Name: wrbehind_sync
+ *
+ * Description:
+ *   Write all of the buffered data of the file and return the first error
+ *   of its writes since the last call, as a negated errno.
+ *
+ ****************************************************************************/
+
+int wrbehind_sync(FAR struct file *filep)
+{
+	FAR struct wrbehind_s *wb = filep->f_wb;
+	int ret;
+
+	if (wb == NULL) {
+		return OK;
+	}
+
+	wb_semtake(&wb->flushsem);
+	ret = wb_flush(wb, true);
+	sem_post(&wb->flushsem);
+
+	wb_semtake(&wb->exclsem);
+	if (wb->error != 0) {
+		ret = -(int)wb->error;
+		wb->error = 0;
+	}
+
+	sem_post(&wb->exclsem);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: wrbehind_close
+ *
+ * Description:
+ *   Write all of the buffered data of the file and free the buffer, before
+ *   the file is closed.  Returns the pending error as wrbehind_sync().
+ *   Data that still cannot be written is discarded.
+ *
+ ****************************************************************************/
+
+int wrbehind_close(FAR struct file *filep)
+{
+	FAR struct wrbehind_s *wb = filep->f_wb;
+	irqstate_t flags;
+	int ret;
+
+	if (wb == NULL) {
+		return OK;
+	}
+
+	/* Take the buffer from the worker, and wait if it is flushing it */
+
+	flags = irqsave();
+	wb->closing = true;
+	if (wb->queued) {
+		dq_rem(&wb->node, &g_wbdirty);
+		wb->queued = false;
+	}
+
+	while (g_wbactive == wb) {
+		g_wbnwait++;
+		irqrestore(flags);
+		wb_semtake(&g_wbdone);
+		flags = irqsave();
+	}
+
+	irqrestore(flags);
+
+	ret = wrbehind_sync(filep);
+
+	/* Data that could not be written is lost with the buffer; the error
+	 * has been returned.
+	 */
+
+	flags = irqsave();
+	g_wbnbytes -= wb->count;
+	irqrestore(flags);
+
+	sem_destroy(&wb->exclsem);
+	sem_destroy(&wb->flushsem);
+	kmm_free(wb);
+	filep->f_wb = NULL;
+	return ret;
+}
+
+#endif							/* CONFIG_FS_WRITEBEHIND */
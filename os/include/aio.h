@@ -187,4 +187,78 @@ int lio_listio(int mode, FAR struct aiocb *const list[], int nent, FAR struct si
 #endif
 
 #endif							/* CONFIG_FS_AIO */
+
+/****************************************************************************
+ * Batched Asynchronous I/O
+ *
+ * A non-standard interface for queueing many transfers with one call.  A
+ * ring is a submission queue (SQ) and a completion queue (CQ) shared
+ * between the caller and the OS.  The caller fills SQ entries and passes
+ * them to the OS with aio_ring_enter().  The OS posts one CQ entry per SQ
+ * entry when the transfer completes.  The ring file descriptor is
+ * readable (POLLIN) while CQ entries are waiting.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_AIO_RING
+
+/* Submission queue entry operations */
+
+#define AIO_RING_NOP    0		/* Complete with result 0 */
+#define AIO_RING_READ   1		/* pread() */
+#define AIO_RING_WRITE  2		/* pwrite(), or write() if O_APPEND */
+#define AIO_RING_FSYNC  3		/* fsync() */
+
+/* A submission queue entry */
+
+struct aio_sqe_s {
+	uint8_t op;					/* AIO_RING_* operation */
+	int fd;						/* File descriptor */
+	off_t offset;				/* File offset */
+	FAR volatile void *buf;		/* Location of buffer */
+	size_t nbytes;				/* Length of transfer */
+	FAR void *udata;			/* Returned in the completion entry */
+};
+
+/* A completion queue entry */
+
+struct aio_cqe_s {
+	FAR void *udata;			/* From the submission entry */
+	ssize_t result;				/* Bytes transferred or a negated errno value */
+};
+
+/* The shared state of a ring.  Both queues have 'entries' entries.  The
+ * head and tail indices run freely and are masked with entries - 1.  The
+ * caller owns sq_tail and cq_head, the OS owns sq_head and cq_tail.
+ */
+
+struct aio_ring_s {
+	uint16_t entries;			/* Entries per queue, a power of two */
+	volatile uint16_t sq_head;	/* Next entry taken by the OS */
+	volatile uint16_t sq_tail;	/* Next entry filled by the caller */
+	volatile uint16_t cq_head;	/* Next entry read by the caller */
+	volatile uint16_t cq_tail;	/* Next entry posted by the OS */
+	FAR struct aio_sqe_s *sq;	/* Submission queue */
+	FAR struct aio_cqe_s *cq;	/* Completion queue */
+};
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+int aio_ring_setup(unsigned int entries, FAR struct aio_ring_s **ring);
+int aio_ring_enter(int fd, unsigned int to_submit, unsigned int min_complete);
+FAR struct aio_sqe_s *aio_ring_getsqe(FAR struct aio_ring_s *ring);
+FAR struct aio_cqe_s *aio_ring_peekcqe(FAR struct aio_ring_s *ring);
+void aio_ring_cqeseen(FAR struct aio_ring_s *ring);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif							/* CONFIG_FS_AIO_RING */
 #endif							/* __INCLUDE_AIO_H */
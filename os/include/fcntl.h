@@ -92,6 +92,7 @@
 #define O_SYNC      (1 << 7)	/* Synchronize output on write */
 #define O_DSYNC     O_SYNC		/* Equivalent to OSYNC in TinyAra */
 #define O_BINARY    (1 << 8)	/* Open the file in binary (untranslated) mode. */
+#define O_WRBEHIND  (1 << 9)	/* Buffer writes in RAM, write them later (non-standard) */
 
 /* Unsupported, but required open flags */
 
@@ -104,7 +105,7 @@
  * this bit number may be used within TinyAra for other, internal purposes.
  */
 
-#define _O_MAXBIT   8
+#define _O_MAXBIT   9
 
 /* Synonyms historically used as F_SETFL flags (BSD). */
 
@@ -240,6 +240,7 @@ int lwip_write(int s, const void *dataptr, size_t size);
 int lwip_select(int maxfdp1, fd_set *readset, fd_set *writeset, fd_set *exceptset, struct timeval *timeout);
 #endif
 int lwip_poll(int fd, struct pollfd *fds, bool setup);
+int lwip_sock_poll(struct socket *sock, struct pollfd *fds, bool setup);
 int lwip_ioctl(int s, long cmd, void *argp);
 int lwip_fcntl(int s, int cmd, int val);
 
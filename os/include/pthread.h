@@ -282,7 +282,11 @@ struct pthread_cond_s {
 	sem_t sem;
 };
 typedef struct pthread_cond_s pthread_cond_t;
+#ifdef CONFIG_PRIORITY_INHERITANCE
 #define PTHREAD_COND_INITIALIZER { {0, 0xffff} }
+#else
+#define PTHREAD_COND_INITIALIZER { SEM_INITIALIZER(0) }
+#endif
 
 /**
  * @ingroup PTHREAD_KERNEL
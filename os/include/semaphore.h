@@ -69,6 +69,7 @@
 
 #include <stdint.h>
 #include <limits.h>
+#include <queue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -125,6 +126,12 @@ struct sem_s {
 	struct semholder_s holder;	/* Single holder */
 #endif
 #endif
+
+	/* Tasks blocked on this semaphore, highest priority first. Only the
+	 * kernel touches this list.
+	 */
+
+	dq_queue_t waitlist;
 };
 
 typedef struct sem_s sem_t;
@@ -136,12 +143,12 @@ typedef struct sem_s sem_t;
  */
 #ifdef CONFIG_PRIORITY_INHERITANCE
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-#define SEM_INITIALIZER(c) {(c), 0, NULL} /* semcount, flags, hhead */
+#define SEM_INITIALIZER(c) {(c), 0, NULL, {NULL, NULL}} /* semcount, flags, hhead, waitlist */
 #else
-#define SEM_INITIALIZER(c) {(c), 0, SEMHOLDER_INITIALIZER} /* semcount, flags, holder */
+#define SEM_INITIALIZER(c) {(c), 0, SEMHOLDER_INITIALIZER, {NULL, NULL}} /* semcount, flags, holder, waitlist */
 #endif
 #else
-#define SEM_INITIALIZER(c) {(c)}	/* semcount */
+#define SEM_INITIALIZER(c) {(c), {NULL, NULL}}	/* semcount, waitlist */
 #endif
 
 /****************************************************************************
@@ -464,6 +464,18 @@ int mkstemp(FAR char *path_template);
  * @since Tizen RT v1.0
  */
 void qsort(void *base, size_t nmemb, size_t size, int (*compar)(const void *, const void *));
+/**
+ * @ingroup STDLIB_LIBC
+ * @brief sort an array like qsort(), keeping elements that compare equal in their original order
+ *
+ * @param[in,out] base The array to sort
+ * @param[in] nmemb Number of elements
+ * @param[in] size Size of one element
+ * @param[in] compar Comparison function
+ * @return 0 on success. On failure, -1 is returned and errno is set to EINVAL.
+ * @since Tizen RT v1.1
+ */
+int mergesort(FAR void *base, size_t nmemb, size_t size, CODE int (*compar)(FAR const void *, FAR const void *));
 
 /* Binary search */
 /**
@@ -0,0 +1,140 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * include/sys/epoll.h
+ *
+ * Interest sets of file and socket descriptors that persist across waits,
+ * with the interface of the Linux epoll().
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_EPOLL_H
+#define __INCLUDE_SYS_EPOLL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <poll.h>
+
+#ifdef CONFIG_FS_EPOLL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Events are the poll() events.  EPOLLET and EPOLLONESHOT select how an
+ * event is reported; they are never returned.
+ */
+
+#define EPOLLIN         POLLIN
+#define EPOLLPRI        POLLPRI
+#define EPOLLOUT        POLLOUT
+#define EPOLLRDNORM     POLLRDNORM
+#define EPOLLRDBAND     POLLRDBAND
+#define EPOLLWRNORM     POLLWRNORM
+#define EPOLLWRBAND     POLLWRBAND
+#define EPOLLERR        POLLERR
+#define EPOLLHUP        POLLHUP
+
+#define EPOLLONESHOT    (1u << 30)	/* Disable the descriptor after one event */
+#define EPOLLET         (1u << 31)	/* Report only new events */
+
+/* Operations of epoll_ctl() */
+
+#define EPOLL_CTL_ADD   1
+#define EPOLL_CTL_DEL   2
+#define EPOLL_CTL_MOD   3
+
+/* Flags of epoll_create1() */
+
+#define EPOLL_CLOEXEC   0		/* Descriptors are not inherited anyway */
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+typedef union epoll_data {
+	FAR void *ptr;
+	int fd;
+	uint32_t u32;
+} epoll_data_t;
+
+struct epoll_event {
+	uint32_t events;			/* Events requested, or events that occurred */
+	epoll_data_t data;			/* Returned with the events of the descriptor */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: epoll_create / epoll_create1
+ *
+ * Description:
+ *   Create an empty interest set and return a descriptor for it.  'size'
+ *   is only checked to be positive.  Close the descriptor to free the set.
+ *
+ ****************************************************************************/
+
+int epoll_create(int size);
+int epoll_create1(int flags);
+
+/****************************************************************************
+ * Name: epoll_ctl
+ *
+ * Description:
+ *   Add 'fd' to, modify it in or delete it from the interest set 'epfd'.
+ *   The poll of 'fd' is set up on EPOLL_CTL_ADD and stays set up until
+ *   EPOLL_CTL_DEL, so a descriptor must be deleted before it is closed.
+ *
+ ****************************************************************************/
+
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev);
+
+/****************************************************************************
+ * Name: epoll_wait
+ *
+ * Description:
+ *   Wait up to 'timeout' milliseconds, or forever if negative, for events
+ *   of the descriptors in 'epfd'.  Returns the number of entries filled in
+ *   'events', at most 'maxevents', or -1 with the errno set.
+ *
+ ****************************************************************************/
+
+int epoll_wait(int epfd, FAR struct epoll_event *events, int maxevents, int timeout);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif							/* CONFIG_FS_EPOLL */
+#endif							/* __INCLUDE_SYS_EPOLL_H */
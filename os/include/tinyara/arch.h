@@ -1603,6 +1603,23 @@ int up_timer_cancel(FAR struct timespec *ts);
 int up_timer_start(FAR const struct timespec *ts);
 #endif
 
+/****************************************************************************
+ * Name: up_perf_gettime / up_perf_getfreq
+ *
+ * Description:
+ *   Return a free-running counter used to measure CPU time, and its rate in
+ *   counts per second.  The counter may wrap at 32 bits but must not wrap
+ *   more often than the system timer ticks.  The kernel provides weak
+ *   defaults based on the system timer; architectures with a cycle counter
+ *   should override them and select CONFIG_ARCH_HAVE_PERF_COUNTER.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUTIME
+uint32_t up_perf_gettime(void);
+uint32_t up_perf_getfreq(void);
+#endif
+
 /****************************************************************************
  * Name: up_romgetc
  *
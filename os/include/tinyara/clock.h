@@ -203,6 +203,35 @@ struct cpuload_s {
 };
 #endif
 
+#ifdef CONFIG_SCHED_CPUTIME
+/* This structure is used to report the CPU time of a thread.  All times are
+ * in microseconds.
+ */
+
+struct cputime_s {
+	uint64_t runtime;			/* Time running, interrupts excluded */
+	uint64_t irqtime;			/* Time in interrupt handlers while running,
+								 * zero without CONFIG_SCHED_CPUTIME_IRQ */
+	uint64_t waittime;			/* Time ready-to-run but not running */
+	uint64_t maxwait;			/* Longest wait to run */
+	uint32_t nvcsw;				/* Voluntary context switches */
+	uint32_t nivcsw;			/* Involuntary context switches */
+};
+
+/* Bucket i of the scheduling latency histogram counts the waits to run of
+ * less than 2^i microseconds not counted in a lower bucket.  The last
+ * bucket counts all longer waits.
+ */
+
+#define CLOCK_SCHEDLAT_NBUCKETS 16
+
+struct schedlat_s {
+	uint64_t irqtime;			/* Microseconds in interrupt handlers, zero
+								 * without CONFIG_SCHED_CPUTIME_IRQ */
+	uint32_t count[CLOCK_SCHEDLAT_NBUCKETS];	/* Waits to run per bucket */
+};
+#endif
+
 /* This type is the natural with of the system timer */
 
 #ifdef CONFIG_SYSTEM_TIME64
@@ -369,6 +398,43 @@ int clock_cpuload(int pid, FAR struct cpuload_s *cpuload);
  */
 #endif
 
+/****************************************************************************
+ * Function:  clock_cputime
+ *
+ * Description:
+ *   Return the CPU time measured for the select PID.
+ *
+ * Parameters:
+ *   pid - The task ID of the thread of interest.
+ *   cputime - The location to return the CPU time
+ *
+ * Return Value:
+ *   OK (0) on success; -ESRCH if 'pid' does not refer to a valid thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUTIME
+/**
+ * @cond
+ * @internal
+ */
+int clock_cputime(int pid, FAR struct cputime_s *cputime);
+
+/****************************************************************************
+ * Function:  clock_schedlatency
+ *
+ * Description:
+ *   Return the histogram of the waits to run of all threads and the total
+ *   time spent in interrupt handlers.
+ *
+ ****************************************************************************/
+
+void clock_schedlatency(FAR struct schedlat_s *schedlat);
+/**
+ * @endcond
+ */
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -122,6 +122,26 @@ struct file_operations {
 	int (*unlink)(FAR struct inode *inode);
 };
 
+#ifdef CONFIG_FS_AIO_RING
+/* One transfer taken from an AIO ring (see aio_ring_setup()).  A driver
+ * that can run the transfer without blocking may accept it through
+ * ioctl(FIOC_AIOSUBMIT) and later report the result with
+ * aio_ring_complete(), possibly from an interrupt handler.  Otherwise the
+ * transfer is performed on the low priority work queue.
+ */
+
+struct aio_request_s {
+	FAR struct aio_request_s *flink;	/* Used by the owner of the request */
+	FAR struct file *filep;		/* File to transfer to or from */
+	uint8_t op;					/* AIO_RING_READ, _WRITE or _FSYNC */
+	off_t offset;				/* File offset */
+	FAR void *buf;				/* Location of buffer */
+	size_t nbytes;				/* Length of transfer */
+	FAR void *udata;			/* Opaque to the driver */
+	FAR void *ring;				/* Opaque to the driver */
+};
+#endif
+
 /* This structure provides information about the state of a block driver */
 
 #ifndef CONFIG_DISABLE_MOUNTPOINT
@@ -273,6 +293,9 @@ struct file {
 	off_t f_pos;				/* File position */
 	FAR struct inode *f_inode;	/* Driver interface */
 	void *f_priv;				/* Per file driver private data */
+#ifdef CONFIG_FS_WRITEBEHIND
+	FAR struct wrbehind_s *f_wb;	/* Write-behind buffer (O_WRBEHIND) */
+#endif
 };
 
 /* This defines a list of files indexed by the file descriptor */
@@ -801,6 +824,21 @@ off_t file_seek(FAR struct file *filep, off_t offset, int whence);
 int file_fsync(FAR struct file *filep);
 #endif
 
+/* fs/aio/aio_ring.c ********************************************************/
+/****************************************************************************
+ * Name: aio_ring_complete
+ *
+ * Description:
+ *   Report the result of a transfer accepted with FIOC_AIOSUBMIT: the
+ *   number of bytes transferred or a negated errno value.  May be called
+ *   from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_AIO_RING
+void aio_ring_complete(FAR struct aio_request_s *req, ssize_t result);
+#endif
+
 /* fs/fs_fcntl.c ************************************************************/
 /****************************************************************************
  * Name: file_vfcntl
@@ -816,6 +854,42 @@ int file_fsync(FAR struct file *filep);
 int file_vfcntl(FAR struct file *filep, int cmd, va_list ap);
 #endif
 
+/* fs/vfs/fs_poll.c *********************************************************/
+/****************************************************************************
+ * Name: poll_notify
+ *
+ * Description:
+ *   Report the events a driver has set in fds->revents to the waiter.  A
+ *   descriptor in an epoll interest set is queued as ready; otherwise the
+ *   poll() semaphore is posted.  May be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+#ifdef CONFIG_FS_EPOLL
+void poll_notify(FAR struct pollfd *fds);
+#else
+#define poll_notify(fds) sem_post((fds)->sem)
+#endif
+#endif
+
+/* fs/vfs/fs_epoll.c ********************************************************/
+/****************************************************************************
+ * Name: epoll_purge
+ *
+ * Description:
+ *   Remove an open file ('struct file') or socket ('struct socket') that is
+ *   being closed from every epoll interest set and tear down its poll.
+ *   Called by the close paths while the file or socket is still open.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_EPOLL
+void epoll_purge(FAR void *obj);
+#else
+#define epoll_purge(obj)
+#endif
+
 /* drivers/dev_null.c *******************************************************/
 /****************************************************************************
  * Name: devnull_register
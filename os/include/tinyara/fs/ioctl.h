@@ -147,6 +147,11 @@
 #define FIONWRITE       _FIOC(0x0006)	/* IN:  Location to return value (int *)
 										 * OUT: Bytes writable to this fd
 										 */
+#define FIOC_AIOSUBMIT  _FIOC(0x0007)	/* IN:  FAR struct aio_request_s *
+										 * OUT: OK if the driver will call
+										 *      aio_ring_complete() for the
+										 *      request
+										 */
 
 /* TinyAra file system ioctl definitions **************************************/
 
@@ -229,6 +234,15 @@
 										 *      the block with specific debug
 										 *      command and data.
 										 * OUT: None.  */
+#define BIOC_FLUSH      _BIOC(0x000C)	/* Write back any data cached by the
+										 * driver to the device.
+										 * IN:  None
+										 * OUT: None */
+#define BIOC_GETWRSTATS _BIOC(0x000D)	/* Get the write statistics of an FTL
+										 * block device.
+										 * IN:  Pointer to a write-able struct
+										 *      ftl_wrstats_s (see mtd.h)
+										 * OUT: The statistics */
 
 /* TinyAra MTD driver ioctl definitions ***************************************/
 
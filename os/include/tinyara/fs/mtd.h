@@ -62,15 +62,27 @@
 #include <sys/types.h>
 #include <stdint.h>
 
+#include <tinyara/sched.h>
+
 /****************************************************************************
  * Pre-Processor Definitions
  ****************************************************************************/
 
 /* Macros to hide implementation */
 
+/* Successful erases and block writes are charged to the I/O counters of
+ * the calling task (see sched_ioaccount()).  Writes deferred to a worker
+ * thread, as by write-behind buffering, are charged to the worker.
+ */
+
+#ifdef CONFIG_SCHED_IOACCOUNT
+#define MTD_ERASE(d, s, n)     ((d)->erase  ? mtd_erase_account(d, s, n)     : (-ENOSYS))
+#define MTD_BWRITE(d, s, n, b) ((d)->bwrite ? mtd_bwrite_account(d, s, n, b) : (-ENOSYS))
+#else
 #define MTD_ERASE(d, s, n)     ((d)->erase  ? (d)->erase(d, s, n)     : (-ENOSYS))
-#define MTD_BREAD(d, s, n, b)  ((d)->bread  ? (d)->bread(d, s, n, b)  : (-ENOSYS))
 #define MTD_BWRITE(d, s, n, b) ((d)->bwrite ? (d)->bwrite(d, s, n, b) : (-ENOSYS))
+#endif
+#define MTD_BREAD(d, s, n, b)  ((d)->bread  ? (d)->bread(d, s, n, b)  : (-ENOSYS))
 #define MTD_READ(d, s, n, b)   ((d)->read   ? (d)->read(d, s, n, b)   : (-ENOSYS))
 #define MTD_WRITE(d, s, n, b)  ((d)->write  ? (d)->write(d, s, n, b)  : (-ENOSYS))
 #define MTD_IOCTL(d, c, a)     ((d)->ioctl  ? (d)->ioctl(d, c, a)     : (-ENOSYS))
@@ -96,6 +108,18 @@ struct mtd_geometry_s {
 	size_t neraseblocks;		/* Number of erase blocks */
 };
 
+/* Write statistics of an FTL block device returned by BIOC_GETWRSTATS.
+ * The write amplification is the number of blocks programmed to the device
+ * for each block written by the user of the block device.
+ */
+
+struct ftl_wrstats_s {
+	uint32_t nwritten;			/* Blocks written to the block device */
+	uint32_t nprogrammed;		/* Blocks programmed to the MTD device */
+	uint32_t nerased;			/* Erase blocks erased */
+	uint32_t amplification;		/* 100 * nprogrammed / nwritten */
+};
+
 /* The following defines the information for writing bytes to a sector
  * that are not a full page write (bytewrite).
  */
@@ -176,6 +200,36 @@ enum mtd_partition_tag_s {
 
 #ifndef __ASSEMBLY__
 
+#ifdef CONFIG_SCHED_IOACCOUNT
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/* Used by MTD_ERASE() and MTD_BWRITE() to count what the device did */
+
+static inline int mtd_erase_account(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks)
+{
+	int ret = dev->erase(dev, startblock, nblocks);
+
+	if (ret >= 0) {
+		sched_ioaccount(mtderases, nblocks);
+	}
+
+	return ret;
+}
+
+static inline ssize_t mtd_bwrite_account(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks, FAR const uint8_t *buffer)
+{
+	ssize_t ret = dev->bwrite(dev, startblock, nblocks, buffer);
+
+	if (ret > 0) {
+		sched_ioaccount(mtdblocks, ret);
+	}
+
+	return ret;
+}
+#endif
+
 #ifdef __cplusplus
 #define EXTERN extern "C"
 extern "C" {
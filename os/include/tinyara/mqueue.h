@@ -87,6 +87,8 @@ struct mqueue_inode_s {
 	int16_t nmsgs;				/* Number of message in the queue */
 	int16_t nwaitnotfull;		/* Number tasks waiting for not full */
 	int16_t nwaitnotempty;		/* Number tasks waiting for not empty */
+	dq_queue_t waitnotfull;		/* Tasks waiting for not full, highest priority first */
+	dq_queue_t waitnotempty;	/* Tasks waiting for not empty, highest priority first */
 #if CONFIG_MQ_MAXMSGSIZE < 256
 	uint8_t maxmsgsize;			/* Max size of message in message queue */
 #else
@@ -207,6 +209,90 @@ mqd_t mq_descreate(FAR struct tcb_s *mtcb, FAR struct mqueue_inode_s *msgq, int
 
 void mq_desclose(mqd_t mqdes);
 
+#ifdef CONFIG_MQ_ZEROCOPY
+/****************************************************************************
+ * Name: mq_getbuffer
+ *
+ * Description:
+ *   Take a message buffer from the message pool.  The caller fills in up
+ *   to the mq_msgsize of the queue and passes it to mq_sendbuffer(), or
+ *   returns it with mq_releasebuffer().
+ *
+ * Parameters:
+ *   mqdes - Message queue descriptor, opened for writing
+ *
+ * Return Value:
+ *   The message buffer; NULL with errno set on failure:
+ *
+ *   EINVAL   'mqdes' is NULL
+ *   EPERM    Message queue not opened for writing
+ *   ENOMEM   No message could be allocated
+ *
+ ****************************************************************************/
+
+FAR char *mq_getbuffer(mqd_t mqdes);
+
+/****************************************************************************
+ * Name: mq_sendbuffer
+ *
+ * Description:
+ *   Queue a buffer obtained from mq_getbuffer() without copying it.  This
+ *   blocks like mq_send() while the queue is full.  On success the buffer
+ *   belongs to the queue; on failure it still belongs to the caller.
+ *
+ * Parameters:
+ *   mqdes  - Message queue descriptor
+ *   buffer - Buffer returned by mq_getbuffer()
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Return Value:
+ *   0 (OK) on success; -1 (ERROR) with errno set as for mq_send().
+ *
+ ****************************************************************************/
+
+int mq_sendbuffer(mqd_t mqdes, FAR char *buffer, size_t msglen, int prio);
+
+/****************************************************************************
+ * Name: mq_receivebuffer
+ *
+ * Description:
+ *   Remove the oldest of the highest priority messages from the queue and
+ *   hand its buffer to the caller without copying it.  This blocks like
+ *   mq_receive() while the queue is empty.  The caller must return the
+ *   buffer with mq_releasebuffer() when done with it.
+ *
+ * Parameters:
+ *   mqdes  - Message queue descriptor, opened for reading
+ *   buffer - Location to return the message buffer
+ *   prio   - If not NULL, location to return the message priority
+ *
+ * Return Value:
+ *   The length of the message; -1 (ERROR) with errno set as for
+ *   mq_receive().
+ *
+ ****************************************************************************/
+
+ssize_t mq_receivebuffer(mqd_t mqdes, FAR char **buffer, FAR int *prio);
+
+/****************************************************************************
+ * Name: mq_releasebuffer
+ *
+ * Description:
+ *   Return a buffer from mq_getbuffer() or mq_receivebuffer() to the
+ *   message pool.
+ *
+ * Parameters:
+ *   buffer - The message buffer
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mq_releasebuffer(FAR char *buffer);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -192,6 +192,9 @@ EXTERN "C" {
 
 	ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, size_t blockcount, FAR uint8_t *rdbuffer);
 	ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock, size_t blockcount, FAR const uint8_t *wrbuffer);
+#ifdef CONFIG_DRVR_WRITEBUFFER
+	int rwb_flush(FAR struct rwbuffer_s *rwb);
+#endif
 
 	/* Character oriented transfers */
 
@@ -178,6 +178,16 @@
 #define CHILD_FLAG_TTYPE_KERNEL  (2 << CHILD_FLAG_TTYPE_SHIFT)	/* Kernel thread */
 #define CHILD_FLAG_EXITED          (1 << 0)	/* Bit 2: The child thread has exit'ed */
 
+/* Charge 'n' to the I/O counter 'field' of struct task_ioacct_s of the
+ * calling task.  This is an expression so that it can be used in macros.
+ */
+
+#ifdef CONFIG_SCHED_IOACCOUNT
+#define sched_ioaccount(field, n)  ((void)(sched_self()->ioacct.field += (uint32_t)(n)))
+#else
+#define sched_ioaccount(field, n)  ((void)0)
+#endif
+
 /********************************************************************************
  * Public Type Definitions
  ********************************************************************************/
@@ -464,6 +474,40 @@ struct task_group_s {
 };
 #endif
 
+/* struct task_ioacct_s **********************************************************/
+
+#ifdef CONFIG_SCHED_IOACCOUNT
+/** @brief I/O counters of a task, see sched_ioaccount() */
+struct task_ioacct_s {
+	uint32_t rcalls;			/* Successful read() calls             */
+	uint32_t rbytes;			/* Bytes read                          */
+	uint32_t wcalls;			/* Successful write() calls            */
+	uint32_t wbytes;			/* Bytes written                       */
+	uint32_t recvcalls;			/* Successful recv() calls             */
+	uint32_t recvbytes;			/* Bytes received                      */
+	uint32_t sendcalls;			/* Successful send() calls             */
+	uint32_t sendbytes;			/* Bytes sent                          */
+	uint32_t mtdblocks;			/* MTD blocks written                  */
+	uint32_t mtderases;			/* MTD erase blocks erased             */
+};
+#endif
+
+/* struct task_cputime_s *********************************************************/
+
+#ifdef CONFIG_SCHED_CPUTIME
+/** @brief CPU time of a task in units of up_perf_gettime() */
+struct task_cputime_s {
+	uint64_t runtime;			/* Time running, interrupts excluded   */
+	uint64_t irqtime;			/* Time in interrupts while running    */
+	uint64_t waittime;			/* Time ready-to-run but not running   */
+	uint32_t maxwait;			/* Longest wait to run                 */
+	uint32_t readytime;			/* Counter when made ready-to-run      */
+	uint32_t nvcsw;				/* Switches away while blocking        */
+	uint32_t nivcsw;			/* Switches away while preempted       */
+	uint8_t removed;			/* Left ready-to-run, not yet counted  */
+};
+#endif
+
 /* struct tcb_s ******************************************************************/
 
 FAR struct wdog_s;				/* Forward reference                   */
@@ -579,6 +623,14 @@ struct tcb_s {
 	int peak_alloc_size;
 	int num_alloc_free;
 #endif
+
+#ifdef CONFIG_SCHED_IOACCOUNT
+	struct task_ioacct_s ioacct;	/* I/O counters                        */
+#endif
+
+#ifdef CONFIG_SCHED_CPUTIME
+	struct task_cputime_s cputime;	/* CPU time accounting                 */
+#endif
 };
 
 /* struct task_tcb_s *************************************************************/
@@ -0,0 +1,165 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * include/tinyara/shmchan.h
+ *
+ * Shared memory channels: rings of fixed size message buffers in a memory
+ * region shared by the tasks exchanging the messages.  A producer fills a
+ * buffer in place and commits it; the consumer reads it in place and
+ * releases it, so a message is never copied.  A channel has one consumer,
+ * and one producer (SPSC) or any number of producers (MPSC).  The rings
+ * are lock free; a task only enters the kernel to sleep on an empty or a
+ * full ring, and a sleeping consumer is woken only by the commit that
+ * makes the ring non-empty.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_TINYARA_SHMCHAN_H
+#define __INCLUDE_TINYARA_SHMCHAN_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef CONFIG_LIBC_SHMCHAN
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Flags of shmch_create() */
+
+#define SHMCH_SPSC      0		/* One producer */
+#define SHMCH_MPSC      1		/* Any number of producers */
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* The layout of the shared region, private to the library */
+
+struct shmch_hdr_s;
+struct shmch_desc_s;
+
+/* A channel as attached by one task.  Each task exchanging messages on the
+ * channel attaches it with shmch_create() or shmch_open().
+ */
+
+struct shmch_s {
+	FAR struct shmch_hdr_s *hdr;	/* The shared region */
+	FAR struct shmch_desc_s *desc;	/* Descriptor of each buffer */
+	FAR uint8_t *data;			/* The message buffers */
+#ifdef CONFIG_MM_SHM
+	int shmid;					/* Identifier of the region */
+#endif
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: shmch_create / shmch_open / shmch_close
+ *
+ * Description:
+ *   shmch_create() creates the channel 'key' (not IPC_PRIVATE) with
+ *   'nslots' buffers (a power of two) of 'msgsize' bytes and attaches it.
+ *   shmch_open() attaches the existing channel 'key'.  shmch_close()
+ *   detaches a channel; the region is freed when the last task detaches
+ *   it.
+ *
+ * Returned Value:
+ *   OK, or ERROR with the errno set: EEXIST, ENOENT, EINVAL, ENOSPC or
+ *   ENOMEM, or an error of shmget() and shmat().
+ *
+ ****************************************************************************/
+
+int shmch_create(key_t key, unsigned int nslots, size_t msgsize, int flags, FAR struct shmch_s *ch);
+int shmch_open(key_t key, FAR struct shmch_s *ch);
+int shmch_close(FAR struct shmch_s *ch);
+
+/****************************************************************************
+ * Name: shmch_reserve / shmch_commit
+ *
+ * Description:
+ *   shmch_reserve() returns a free buffer of the channel to the producer,
+ *   waiting for one if the ring is full and 'wait' is true.  The producer
+ *   writes up to shmch_msgsize() bytes into it and passes it to the
+ *   consumer with shmch_commit().
+ *
+ * Returned Value:
+ *   shmch_reserve() returns NULL with the errno set to EAGAIN if the ring
+ *   is full and 'wait' is false.  shmch_commit() returns OK, or ERROR with
+ *   the errno set to EINVAL if 'buf' is not a reserved buffer or 'len' is
+ *   larger than shmch_msgsize().
+ *
+ ****************************************************************************/
+
+FAR void *shmch_reserve(FAR struct shmch_s *ch, bool wait);
+int shmch_commit(FAR struct shmch_s *ch, FAR void *buf, size_t len);
+
+/****************************************************************************
+ * Name: shmch_receive / shmch_release
+ *
+ * Description:
+ *   shmch_receive() returns the oldest message of the channel and its
+ *   length to the consumer, waiting for one if the ring is empty and
+ *   'wait' is true.  The message stays in the ring until it is released
+ *   with shmch_release().
+ *
+ * Returned Value:
+ *   shmch_receive() returns NULL with the errno set to EAGAIN if the ring
+ *   is empty and 'wait' is false.  shmch_release() returns OK, or ERROR
+ *   with the errno set to EINVAL if no message was received.
+ *
+ ****************************************************************************/
+
+FAR void *shmch_receive(FAR struct shmch_s *ch, FAR size_t *len, bool wait);
+int shmch_release(FAR struct shmch_s *ch);
+
+/****************************************************************************
+ * Name: shmch_msgsize
+ *
+ * Description:
+ *   Return the size of the message buffers of the channel.
+ *
+ ****************************************************************************/
+
+size_t shmch_msgsize(FAR struct shmch_s *ch);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif							/* CONFIG_LIBC_SHMCHAN */
+#endif							/* __INCLUDE_TINYARA_SHMCHAN_H */
@@ -74,6 +74,7 @@ typedef int (*lib_getc_t)(FAR struct lib_instream_s *this);
 
 struct lib_outstream_s;
 typedef void (*lib_putc_t)(FAR struct lib_outstream_s *this, int ch);
+typedef void (*lib_puts_t)(FAR struct lib_outstream_s *this, FAR const char *buf, int len);
 typedef int (*lib_flush_t)(FAR struct lib_outstream_s *this);
 
 struct lib_instream_s {
@@ -84,11 +85,13 @@ struct lib_instream_s {
 
 struct lib_outstream_s {
 	lib_putc_t put;				/* Put one character to the outstream */
+	lib_puts_t puts;			/* Put a run of characters to the outstream.
+								 * Optional, NULL means use put */
 #ifdef CONFIG_STDIO_LINEBUFFER
 	lib_flush_t flush;			/* Flush any buffered characters in the outstream */
 #endif
 	int nput;					/* Total number of characters put.  Written
-								 * by put method, readable by user */
+								 * by put and puts methods, readable by user */
 };
 
 /* Seek-able streams */
@@ -394,6 +397,18 @@ int lib_noflush(FAR struct lib_outstream_s *stream);
 int lib_snoflush(FAR struct lib_sostream_s *this);
 #endif
 
+/****************************************************************************
+ * Name: lib_stream_puts
+ *
+ * Description:
+ *  Put 'len' characters from 'buf' to an output stream, using the stream's
+ *  puts method if it has one and falling back to its put method if not.
+ *  Defined in lib/stdio/lib_libstreamputs.c
+ *
+ ****************************************************************************/
+
+void lib_stream_puts(FAR struct lib_outstream_s *this, FAR const char *buf, int len);
+
 /****************************************************************************
  * Name: lib_sprintf and lib_vsprintf
  *
@@ -260,6 +260,12 @@
  *     used for any purpose.  if CONFIG_SCHED_LPWORK is not defined, then
  *     there is only one kernel work queue and LPWORK == HPWORK.
  *
+ *   LPWORK_LONG: This is the ID to use for long-running work on the low
+ *     priority work queue, such as flash erases.  With more than one low
+ *     priority worker thread, such work is performed by a dedicated worker
+ *     so that it never delays the short work queued with LPWORK.  Otherwise
+ *     LPWORK_LONG is the same as LPWORK.
+ *
  * User Work Queue:
  *   USRWORK:  In the kernel phase a a kernel build, there should be no
  *     references to user-space work queues.  That would be an error.
@@ -273,6 +279,7 @@
 #define USRWORK  2				/* User mode work queue */
 #define HPWORK   USRWORK		/* Redirect kernel-mode references */
 #define LPWORK   USRWORK
+#define LPWORK_LONG USRWORK
 
 #else
 /* Kernel mode */
@@ -280,8 +287,10 @@
 #define HPWORK   0				/* High priority, kernel-mode work queue */
 #ifdef CONFIG_SCHED_LPWORK
 #define LPWORK (HPWORK+1)		/* Low priority, kernel-mode work queue */
+#define LPWORK_LONG (HPWORK+2)	/* Long-running, low priority work */
 #else
 #define LPWORK HPWORK			/* Redirect low-priority references */
+#define LPWORK_LONG HPWORK
 #endif
 #define USRWORK  LPWORK			/* Redirect user-mode references */
 
@@ -310,6 +319,21 @@ struct work_s {
 	systime_t delay;			/* Delay until work performed */
 };
 
+/* Accounting of the work performed by one kernel worker thread, as returned
+ * by work_getstats().  All times are in clock ticks.
+ */
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+struct work_stats_s {
+	uint32_t nrun;				/* Number of work items performed */
+	uint32_t nstolen;			/* Number taken from another worker's queue */
+	uint32_t runtime;			/* Total time spent in work callbacks */
+	uint32_t maxrun;			/* Longest time spent in one work callback */
+	worker_t maxworker;			/* The callback that took maxrun */
+	uint32_t maxlatency;		/* Longest time from due to started */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -432,6 +456,28 @@ int work_signal(int qid);
 
 #define work_available(work) ((work)->worker == NULL)
 
+/****************************************************************************
+ * Name: work_getstats
+ *
+ * Description:
+ *   Return the accounting of the work performed by one kernel worker
+ *   thread.
+ *
+ * Input parameters:
+ *   qid    - The work queue ID (HPWORK or LPWORK)
+ *   wndx   - The index of the worker thread in the work queue
+ *   pid    - Location to return the task ID of the worker thread
+ *   stats  - Location to return the accounting
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -EINVAL if there is no such queue or worker.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+int work_getstats(int qid, int wndx, FAR pid_t *pid, FAR struct work_stats_s *stats);
+#endif
+
 /****************************************************************************
  * Name: lpwork_boostpriority
  *
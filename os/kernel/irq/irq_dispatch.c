@@ -61,6 +61,7 @@
 #include <tinyara/irq.h>
 
 #include "irq/irq.h"
+#include "sched/sched.h"
 
 /****************************************************************************
  * Definitions
@@ -99,6 +100,9 @@ void irq_dispatch(int irq, FAR void *context)
 {
 	xcpt_t vector;
 	FAR void *arg;
+#ifdef CONFIG_SCHED_CPUTIME_IRQ
+	uint32_t start;
+#endif
 
 	/* Perform some sanity checks */
 
@@ -117,5 +121,11 @@ void irq_dispatch(int irq, FAR void *context)
 
 	/* Then dispatch to the interrupt handler */
 
+#ifdef CONFIG_SCHED_CPUTIME_IRQ
+	start = up_perf_gettime();
+	vector(irq, context, arg);
+	sched_cputime_irq(up_perf_gettime() - start);
+#else
 	vector(irq, context, arg);
+#endif
 }
@@ -0,0 +1,190 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ *  kernel/mqueue/mq_buffer.c
+ *
+ *   Zero-copy message transfer.  The message structures come from the same
+ *   pool as those used by mq_send(), so queue limits, priorities and
+ *   wakeups behave exactly as with mq_send() and mq_receive().
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/cancelpt.h>
+#include <tinyara/mqueue.h>
+
+#include "mqueue/mqueue.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_getbuffer
+ *
+ * Description:
+ *   Take a message buffer from the message pool.  See tinyara/mqueue.h.
+ *
+ ****************************************************************************/
+
+FAR char *mq_getbuffer(mqd_t mqdes)
+{
+	FAR struct mqueue_msg_s *mqmsg;
+
+	if (!mqdes) {
+		set_errno(EINVAL);
+		return NULL;
+	}
+
+	if ((mqdes->oflags & O_WROK) == 0) {
+		set_errno(EPERM);
+		return NULL;
+	}
+
+	mqmsg = mq_msgalloc();
+	if (!mqmsg) {
+		set_errno(ENOMEM);
+		return NULL;
+	}
+
+	return mqmsg->mail;
+}
+
+/****************************************************************************
+ * Name: mq_sendbuffer
+ *
+ * Description:
+ *   Queue a buffer obtained from mq_getbuffer() without copying it.  See
+ *   tinyara/mqueue.h.
+ *
+ ****************************************************************************/
+
+int mq_sendbuffer(mqd_t mqdes, FAR char *buffer, size_t msglen, int prio)
+{
+	FAR struct mqueue_inode_s *msgq;
+	irqstate_t saved_state;
+	int ret = ERROR;
+
+	/* mq_sendbuffer() is a cancellation point, like mq_send() */
+
+	(void)enter_cancellation_point();
+
+	if (mq_verifysend(mqdes, buffer, msglen, prio) != OK) {
+		leave_cancellation_point();
+		return ERROR;
+	}
+
+	sched_lock();
+	msgq = mqdes->msgq;
+
+	/* Send immediately from an interrupt handler or if the queue is not
+	 * full; otherwise wait for it to become not full.
+	 */
+
+	saved_state = irqsave();
+	if (up_interrupt_context() || msgq->nmsgs < msgq->maxmsgs || mq_waitsend(mqdes) == OK) {
+		irqrestore(saved_state);
+		ret = mq_dosend(mqdes, MQ_MSG_FROM_BUFFER(buffer), buffer, msglen, prio);
+	} else {
+		irqrestore(saved_state);
+	}
+
+	sched_unlock();
+	leave_cancellation_point();
+	return ret;
+}
+
+/****************************************************************************
+ * Name: mq_receivebuffer
+ *
+ * Description:
+ *   Receive a message and hand its buffer to the caller without copying
+ *   it.  See tinyara/mqueue.h.
+ *
+ ****************************************************************************/
+
+ssize_t mq_receivebuffer(mqd_t mqdes, FAR char **buffer, FAR int *prio)
+{
+	FAR struct mqueue_msg_s *mqmsg;
+	irqstate_t saved_state;
+	ssize_t ret = ERROR;
+
+	DEBUGASSERT(up_interrupt_context() == false);
+
+	/* mq_receivebuffer() is a cancellation point, like mq_receive() */
+
+	(void)enter_cancellation_point();
+
+	if (!buffer || !mqdes) {
+		set_errno(EINVAL);
+		leave_cancellation_point();
+		return ERROR;
+	}
+
+	if ((mqdes->oflags & O_RDOK) == 0) {
+		set_errno(EPERM);
+		leave_cancellation_point();
+		return ERROR;
+	}
+
+	sched_lock();
+
+	saved_state = irqsave();
+	mqmsg = mq_waitreceive(mqdes);
+	irqrestore(saved_state);
+
+	if (mqmsg) {
+		/* A NULL user buffer makes mq_doreceive() pass the message over
+		 * instead of copying and freeing it.
+		 */
+
+		ret = mq_doreceive(mqdes, mqmsg, NULL, prio);
+		*buffer = mqmsg->mail;
+	}
+
+	sched_unlock();
+	leave_cancellation_point();
+	return ret;
+}
+
+/****************************************************************************
+ * Name: mq_releasebuffer
+ *
+ * Description:
+ *   Return a message buffer to the message pool.  See tinyara/mqueue.h.
+ *
+ ****************************************************************************/
+
+void mq_releasebuffer(FAR char *buffer)
+{
+	if (buffer) {
+		mq_msgfree(MQ_MSG_FROM_BUFFER(buffer));
+	}
+}
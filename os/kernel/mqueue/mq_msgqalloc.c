@@ -130,6 +130,8 @@ FAR struct mqueue_inode_s *mq_msgqalloc(mode_t mode, FAR struct mq_attr *attr)
 		/* Initialize the new named message queue */
 
 		sq_init(&msgq->msglist);
+		dq_init(&msgq->waitnotfull);
+		dq_init(&msgq->waitnotempty);
 		if (attr) {
 			msgq->maxmsgs    = (int16_t)attr->mq_maxmsg;
 			msgq->maxmsgsize = (int16_t)attr->mq_msgsize;
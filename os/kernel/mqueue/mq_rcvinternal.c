@@ -254,7 +254,9 @@ FAR struct mqueue_msg_s *mq_waitreceive(mqd_t mqdes)
  * Parameters:
  *   mqdes - Message queue descriptor
  *   mqmsg   - The message obtained by mq_waitmsg()
- *   ubuffer - The address of the user provided buffer to receive the message
+ *   ubuffer - The address of the user provided buffer to receive the message.
+ *             If NULL, the message is not copied or freed; ownership of
+ *             mqmsg passes to the caller.
  *   prio    - The user-provided location to return the message priority.
  *
  * Return Value:
@@ -282,41 +284,43 @@ ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR char *ubuf
 
 	rcvmsglen = mqmsg->msglen;
 
-	/* Copy the message into the caller's buffer */
-
-	memcpy(ubuffer, (const void *)mqmsg->mail, rcvmsglen);
-
-	/* Copy the message priority as well (if a buffer is provided) */
+	/* Copy the message priority (if a buffer is provided) */
 
 	if (prio) {
 		*prio = mqmsg->priority;
 	}
 
-	/* We are done with the message.  Deallocate it now. */
+	/* Copy the message into the caller's buffer.  We are then done with
+	 * the message and deallocate it now.  Without a user buffer the
+	 * message itself is handed over (mq_receivebuffer()).
+	 */
 
-	mq_msgfree(mqmsg);
+	if (ubuffer) {
+		memcpy(ubuffer, (const void *)mqmsg->mail, rcvmsglen);
+		mq_msgfree(mqmsg);
+	}
 
 	/* Check if any tasks are waiting for the MQ not full event. */
 
 	msgq = mqdes->msgq;
 	if (msgq->nwaitnotfull > 0) {
-		/* Find the highest priority task that is waiting for
-		 * this queue to be not-full in g_waitingformqnotfull list.
+		/* The highest priority task that is waiting for this queue
+		 * to be not-full is at the head of its waitnotfull list.
 		 * This must be performed in a critical section because
 		 * messages can be sent from interrupt handlers.
 		 */
 
 		saved_state = irqsave();
-		for (btcb = (FAR struct tcb_s *)g_waitingformqnotfull.head; btcb && btcb->msgwaitq != msgq; btcb = btcb->flink) ;
+		btcb = (FAR struct tcb_s *)dq_peek(&msgq->waitnotfull);
 
-		/* If one was found, unblock it.  NOTE:  There is a race
-		 * condition here:  the queue might be full again by the
-		 * time the task is unblocked
+		/* Unblock it.  NOTE:  There is a race condition here:  the
+		 * queue might be full again by the time the task is unblocked.
+		 * Unblocking removes the task from the wait list and clears
+		 * its msgwaitq.
 		 */
 
-		ASSERT(btcb);
+		ASSERT(btcb && btcb->msgwaitq == msgq);
 
-		btcb->msgwaitq = NULL;
 		msgq->nwaitnotfull--;
 		up_unblock_task(btcb);
 
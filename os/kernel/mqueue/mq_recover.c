@@ -58,6 +58,7 @@
 
 #include <assert.h>
 
+#include <tinyara/arch.h>
 #include <tinyara/mqueue.h>
 #include <tinyara/sched.h>
 
@@ -108,26 +109,39 @@
 
 void mq_recover(FAR struct tcb_s *tcb)
 {
+	FAR struct mqueue_inode_s *msgq = tcb->msgwaitq;
+	irqstate_t flags;
+
 	/* If were were waiting for a timed message queue event, then the
 	 * timer was canceled and deleted in task_recover() before this
 	 * function was called.
 	 */
 
+	flags = irqsave();
+
 	/* Was the task waiting for a message queue to become non-empty? */
 
 	if (tcb->task_state == TSTATE_WAIT_MQNOTEMPTY) {
-		/* Decrement the count of waiters */
-
-		DEBUGASSERT(tcb->msgwaitq && tcb->msgwaitq->nwaitnotempty > 0);
-		tcb->msgwaitq->nwaitnotempty--;
+		/* Decrement the count of waiters and leave the wait list so that
+		 * mq_dosend() can no longer select this task.
+		 */
+
+		DEBUGASSERT(msgq && msgq->nwaitnotempty > 0);
+		msgq->nwaitnotempty--;
+		dq_rem((FAR dq_entry_t *)tcb, &msgq->waitnotempty);
+		tcb->msgwaitq = NULL;
 	}
 
 	/* Was the task waiting for a message queue to become non-full? */
 
 	else if (tcb->task_state == TSTATE_WAIT_MQNOTFULL) {
-		/* Decrement the count of waiters */
+		/* Decrement the count of waiters and leave the wait list */
 
-		DEBUGASSERT(tcb->msgwaitq && tcb->msgwaitq->nwaitnotfull > 0);
-		tcb->msgwaitq->nwaitnotfull--;
+		DEBUGASSERT(msgq && msgq->nwaitnotfull > 0);
+		msgq->nwaitnotfull--;
+		dq_rem((FAR dq_entry_t *)tcb, &msgq->waitnotfull);
+		tcb->msgwaitq = NULL;
 	}
+
+	irqrestore(flags);
 }
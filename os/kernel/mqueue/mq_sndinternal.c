@@ -335,7 +335,8 @@ int mq_waitsend(mqd_t mqdes)
  *
  * Parameters:
  *   mqdes - Message queue descriptor
- *   msg - Message to send
+ *   msg - Message to send.  May be mqmsg->mail, in which case no copy is
+ *         made.
  *   msglen - The length of the message in bytes
  *   prio - The priority of the message
  *
@@ -366,9 +367,13 @@ int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR const char *msg,
 	mqmsg->priority = prio;
 	mqmsg->msglen = msglen;
 
-	/* Copy the message data into the message */
+	/* Copy the message data into the message, unless the caller built it
+	 * in place (mq_sendbuffer())
+	 */
 
-	memcpy((void *)mqmsg->mail, (FAR const void *)msg, msglen);
+	if (msg != mqmsg->mail) {
+		memcpy((void *)mqmsg->mail, (FAR const void *)msg, msglen);
+	}
 
 	/* Insert the new message in the message queue */
 
@@ -430,19 +435,15 @@ int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR const char *msg,
 
 	saved_state = irqsave();
 	if (msgq->nwaitnotempty > 0) {
-		/* Find the highest priority task that is waiting for
-		 * this queue to be non-empty in g_waitingformqnotempty
-		 * list. sched_lock() should give us sufficent protection since
-		 * interrupts should never cause a change in this list
+		/* The highest priority task that is waiting for this queue
+		 * to be non-empty is at the head of its waitnotempty list.
+		 * Unblocking it removes it from the list and clears its
+		 * msgwaitq.
 		 */
 
-		for (btcb = (FAR struct tcb_s *)g_waitingformqnotempty.head; btcb && btcb->msgwaitq != msgq; btcb = btcb->flink) ;
-
-		/* If one was found, unblock it */
-
-		ASSERT(btcb);
+		btcb = (FAR struct tcb_s *)dq_peek(&msgq->waitnotempty);
+		ASSERT(btcb && btcb->msgwaitq == msgq);
 
-		btcb->msgwaitq = NULL;
 		msgq->nwaitnotempty--;
 		up_unblock_task(btcb);
 	}
@@ -130,8 +130,6 @@ void mq_waitirq(FAR struct tcb_s *wtcb, int errcode)
 		msgq = wtcb->msgwaitq;
 		DEBUGASSERT(msgq);
 
-		wtcb->msgwaitq = NULL;
-
 		/* Decrement the count of waiters and cancel the wait */
 
 		if (wtcb->task_state == TSTATE_WAIT_MQNOTEMPTY) {
@@ -146,7 +144,9 @@ void mq_waitirq(FAR struct tcb_s *wtcb, int errcode)
 
 		wtcb->pterrno = errcode;
 
-		/* Restart the task. */
+		/* Restart the task.  This removes it from the wait list of the
+		 * message queue and clears msgwaitq.
+		 */
 
 		up_unblock_task(wtcb);
 	}
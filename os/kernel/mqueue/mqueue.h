@@ -61,6 +61,7 @@
 #include <tinyara/compiler.h>
 
 #include <sys/types.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <limits.h>
@@ -92,6 +93,13 @@
 
 #define NUM_INTERRUPT_MSGS   8
 
+/* Return the message structure that contains a message buffer handed out
+ * by mq_getbuffer() or mq_receivebuffer().
+ */
+
+#define MQ_MSG_FROM_BUFFER(b) \
+	((FAR struct mqueue_msg_s *)((FAR char *)(b) - offsetof(struct mqueue_msg_s, mail)))
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
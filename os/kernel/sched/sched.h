@@ -65,6 +65,9 @@
 #include <sched.h>
 
 #include <tinyara/kmalloc.h>
+#ifndef CONFIG_DISABLE_MQUEUE
+#include <tinyara/mqueue.h>
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -115,6 +118,30 @@ struct pidhash_s {
 #endif
 };
 
+/* Return the list that holds a task in state 's'.  A task in the
+ * TSTATE_WAIT_SEM state resides in the wait list of the semaphore it is
+ * blocked on and a task waiting on a message queue in the matching wait
+ * list of that queue.  NULL is returned once the task has been detached
+ * from that list (see sem_recover() and mq_recover()).
+ */
+
+#if !defined(CONFIG_DISABLE_MQUEUE) && CONFIG_MQ_MAXMSGSIZE > 0
+#define SCHED_MQTASKLIST(t, s) \
+	((s) == TSTATE_WAIT_MQNOTEMPTY ? \
+	 ((t)->msgwaitq != NULL ? &(t)->msgwaitq->waitnotempty : NULL) : \
+	 (s) == TSTATE_WAIT_MQNOTFULL ? \
+	 ((t)->msgwaitq != NULL ? &(t)->msgwaitq->waitnotfull : NULL) : \
+	 (FAR dq_queue_t *)g_tasklisttable[s].list)
+#else
+#define SCHED_MQTASKLIST(t, s) \
+	((FAR dq_queue_t *)g_tasklisttable[s].list)
+#endif
+
+#define SCHED_TASKLIST(t, s) \
+	((s) == TSTATE_WAIT_SEM ? \
+	 ((t)->waitsem != NULL ? &(t)->waitsem->waitlist : NULL) : \
+	 SCHED_MQTASKLIST(t, s))
+
 /* This structure defines an element of the g_tasklisttable[].
  * This table is used to map a task_state enumeration to the
  * corresponding task list.
@@ -135,8 +162,14 @@ struct tasklist_s {
  * and by a series of task lists.  All of these tasks lists are declared
  * below. Although it is not always necessary, most of these lists are
  * prioritized so that common list handling logic can be used (only the
- * g_readytorun, the g_pendingtasks, and the g_waitingforsemaphore lists need
- * to be prioritized).
+ * g_readytorun, the g_pendingtasks, and the semaphore wait lists need to be
+ * prioritized).
+ *
+ * Tasks blocked on a semaphore are not kept in a global list.  Each
+ * semaphore carries its own prioritized wait list (see struct sem_s) so that
+ * sem_post() can find the waiter to wake without scanning the waiters of
+ * every other semaphore in the system.  Message queues do the same with
+ * their not-empty and not-full wait lists (see struct mqueue_inode_s).
  */
 
 /* This is the list of all tasks that are ready to run.  The head of this
@@ -154,32 +187,12 @@ extern volatile dq_queue_t g_readytorun;
 
 extern volatile dq_queue_t g_pendingtasks;
 
-/* This is the list of all tasks that are blocked waiting for a semaphore */
-
-extern volatile dq_queue_t g_waitingforsemaphore;
-
 /* This is the list of all tasks that are blocked waiting for a signal */
 
 #ifndef CONFIG_DISABLE_SIGNALS
 extern volatile dq_queue_t g_waitingforsignal;
 #endif
 
-/* This is the list of all tasks that are blocked waiting for a message
- * queue to become non-empty.
- */
-
-#ifndef CONFIG_DISABLE_MQUEUE
-extern volatile dq_queue_t g_waitingformqnotempty;
-#endif
-
-/* This is the list of all tasks that are blocked waiting for a message
- * queue to become non-full.
- */
-
-#ifndef CONFIG_DISABLE_MQUEUE
-extern volatile dq_queue_t g_waitingformqnotfull;
-#endif
-
 /* This is the list of all tasks that are blocking waiting for a page fill */
 
 #ifdef CONFIG_PAGING
@@ -243,6 +256,12 @@ extern const struct tasklist_s g_tasklisttable[NUM_TASK_STATES];
 extern volatile uint32_t g_cpuload_total;
 #endif
 
+#ifdef CONFIG_SCHED_CPUTIME
+/* The rate of the units of g_cpuload_total, in units per second */
+
+extern uint32_t g_cputime_loadfreq;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -276,6 +295,28 @@ void sched_timer_reassess(void);
 void weak_function sched_process_cpuload(void);
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD
+void sched_cpuload_charge(FAR struct tcb_s *tcb, uint32_t ticks);
+#endif
+
+#ifdef CONFIG_SCHED_CPUTIME
+void sched_cputime_initialize(void);
+void sched_cputime_ready(FAR struct tcb_s *tcb);
+void sched_cputime_switch(FAR struct tcb_s *from, FAR struct tcb_s *to, bool voluntary);
+void sched_cputime_remove(FAR struct tcb_s *tcb, FAR struct tcb_s *ntcb);
+void sched_cputime_block(FAR struct tcb_s *tcb);
+void sched_cputime_tick(void);
+#ifdef CONFIG_SCHED_CPUTIME_IRQ
+void sched_cputime_irq(uint32_t elapsed);
+#endif
+#else
+#define sched_cputime_initialize()
+#define sched_cputime_ready(tcb)
+#define sched_cputime_switch(from, to, voluntary)
+#define sched_cputime_remove(tcb, ntcb)
+#define sched_cputime_block(tcb)
+#endif
+
 bool sched_verifytcb(FAR struct tcb_s *tcb);
 int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype);
 
@@ -107,10 +107,19 @@
 
 void sched_addblocked(FAR struct tcb_s *btcb, tstate_t task_state)
 {
+	FAR dq_queue_t *tasklist;
+
 	/* Make sure that we received a valid blocked state */
 
 	ASSERT(task_state >= FIRST_BLOCKED_STATE && task_state <= LAST_BLOCKED_STATE);
 
+	/* Get the blocked task list associated with this state.  For
+	 * TSTATE_WAIT_SEM this is the wait list of btcb->waitsem.
+	 */
+
+	tasklist = SCHED_TASKLIST(btcb, task_state);
+	DEBUGASSERT(tasklist != NULL);
+
 	/* Add the TCB to the blocked task list associated with this state.
 	 * First, determine if the task is to be added to a prioritized task
 	 * list
@@ -119,14 +128,15 @@ void sched_addblocked(FAR struct tcb_s *btcb, tstate_t task_state)
 	if (g_tasklisttable[task_state].prioritized) {
 		/* Add the task to a prioritized list */
 
-		sched_addprioritized(btcb, (FAR dq_queue_t *)g_tasklisttable[task_state].list);
+		sched_addprioritized(btcb, tasklist);
 	} else {
 		/* Add the task to a non-prioritized list */
 
-		dq_addlast((FAR dq_entry_t *)btcb, (FAR dq_queue_t *)g_tasklisttable[task_state].list);
+		dq_addlast((FAR dq_entry_t *)btcb, tasklist);
 	}
 
 	/* Make sure the TCB's state corresponds to the list */
 
 	btcb->task_state = task_state;
+	sched_cputime_block(btcb);
 }
@@ -120,6 +120,8 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
 	FAR struct tcb_s *rtcb = this_task();
 	bool ret;
 
+	sched_cputime_ready(btcb);
+
 	/* Check if pre-emption is disabled for the current running task and if
 	 * the new ready-to-run task would cause the current running task to be
 	 * pre-empted.
@@ -141,6 +143,7 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
 		/* Inform the instrumentation logic that we are switching tasks */
 
 		sched_note_switch(rtcb, btcb);
+		sched_cputime_switch(rtcb, btcb, false);
 
 		/* The new btcb was added at the head of the ready-to-run list.  It
 		 * is now to new active task!
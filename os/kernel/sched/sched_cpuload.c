@@ -73,7 +73,9 @@
  * of the sampling in ticks per second for the selected timer.
  */
 
-#ifdef CONFIG_SCHED_CPULOAD_EXTCLK
+#if defined(CONFIG_SCHED_CPUTIME)
+#define CPULOAD_TICKSPERSEC g_cputime_loadfreq
+#elif defined(CONFIG_SCHED_CPULOAD_EXTCLK)
 #ifndef CONFIG_SCHED_CPULOAD_TICKSPERSEC
 #error CONFIG_SCHED_CPULOAD_TICKSPERSEC is not defined
 #endif
@@ -109,46 +111,37 @@ volatile uint32_t g_cpuload_total;
  ************************************************************************/
 
 /************************************************************************
- * Name: sched_process_cpuload
+ * Name: sched_cpuload_charge
  *
  * Description:
- *   Collect data that can be used for CPU load measurements.
- *
- * Inputs:
- *   None
- *
- * Return Value:
- *   None
+ *   Charge 'ticks' units of CPU time to 'tcb'.
  *
  * Assumptions/Limitations:
- *   This function is called from a timer interrupt handler with all
- *   interrupts disabled.
+ *   Called with interrupts disabled.
  *
  ************************************************************************/
 
-void weak_function sched_process_cpuload(void)
+void sched_cpuload_charge(FAR struct tcb_s *tcb, uint32_t ticks)
 {
-	FAR struct tcb_s *rtcb = this_task();
 	int hash_index;
 	int i;
 
-	/* Increment the count on the currently executing thread
-	 *
-	 * NOTE also that CPU load measurement data is retained in the g_pidhash
+	/* NOTE that CPU load measurement data is retained in the g_pidhash
 	 * table vs. in the TCB which would seem to be the more logic place.  It
 	 * is place in the hash table, instead, to facilitate CPU load adjustments
 	 * on all threads during timer interrupt handling. sched_foreach() could
 	 * do this too, but this would require a little more overhead.
 	 */
 
-	hash_index = PIDHASH(rtcb->pid);
-	g_pidhash[hash_index].ticks++;
+	hash_index = PIDHASH(tcb->pid);
+	g_pidhash[hash_index].ticks += ticks;
 
 	/* Increment tick count.  If the accumulated tick value exceed a time
 	 * constant, then shift the accumulators.
 	 */
 
-	if (++g_cpuload_total > (CONFIG_SCHED_CPULOAD_TIMECONSTANT * CPULOAD_TICKSPERSEC)) {
+	g_cpuload_total += ticks;
+	if (g_cpuload_total > (CONFIG_SCHED_CPULOAD_TIMECONSTANT * CPULOAD_TICKSPERSEC)) {
 		uint32_t total = 0;
 
 		/* Divide the tick count for every task by two and recalculate the
@@ -166,6 +159,39 @@ void weak_function sched_process_cpuload(void)
 	}
 }
 
+/************************************************************************
+ * Name: sched_process_cpuload
+ *
+ * Description:
+ *   Collect data that can be used for CPU load measurements.
+ *
+ * Inputs:
+ *   None
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions/Limitations:
+ *   This function is called from a timer interrupt handler with all
+ *   interrupts disabled.
+ *
+ ************************************************************************/
+
+void weak_function sched_process_cpuload(void)
+{
+#ifdef CONFIG_SCHED_CPUTIME
+	/* Charge the currently executing thread for the time since the last
+	 * context switch or tick.
+	 */
+
+	sched_cputime_tick();
+#else
+	/* Increment the count on the currently executing thread */
+
+	sched_cpuload_charge(this_task(), 1);
+#endif
+}
+
 /****************************************************************************
  * Function:  clock_cpuload
  *
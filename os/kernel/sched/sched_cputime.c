@@ -0,0 +1,463 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/************************************************************************
+ * kernel/sched/sched_cputime.c
+ *
+ * CPU time accounting at context switches.  A free-running counter is
+ * read whenever the running task changes, and the time since the last
+ * reading is charged to the task that was running.  With a counter
+ * finer than a tick, time spent in interrupt handlers is measured
+ * separately and subtracted from the run time of the interrupted task.
+ * The counter also measures how long a task waits between becoming
+ * ready-to-run and running.
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Included Files
+ ************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/clock.h>
+#include <arch/irq.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_CPUTIME
+
+/************************************************************************
+ * Pre-processor Definitions
+ ************************************************************************/
+
+/* CPU load is counted in units of the counter divided by a power of two
+ * that keep the rate at or below CPUTIME_LOADFREQ, so that the cpuload
+ * totals fit in 32 bits.
+ */
+
+#define CPUTIME_LOADFREQ 1000000
+
+/* How a task left the ready-to-run list, in task_cputime_s.removed */
+
+#define CPUTIME_REMOVED_NONE    0	/* Not removed, or already counted */
+#define CPUTIME_REMOVED_READY   1	/* Removed while waiting to run */
+#define CPUTIME_REMOVED_RUNNING 2	/* Removed while running, switched away */
+
+/************************************************************************
+ * Public Variables
+ ************************************************************************/
+
+/* The rate of the units of g_cpuload_total, in units per second */
+
+uint32_t g_cputime_loadfreq;
+
+/************************************************************************
+ * Private Variables
+ ************************************************************************/
+
+static uint32_t g_cputime_freq;		/* Counter rate in Hz */
+static uint8_t g_cputime_shift;		/* Counter to CPU load units */
+static uint32_t g_cputime_last;		/* Counter when last charged */
+static uint32_t g_cputime_loadrem;	/* Counter units not yet charged as load */
+#ifdef CONFIG_SCHED_CPUTIME_IRQ
+static uint32_t g_cputime_irqpend;	/* Interrupt time not yet charged */
+static uint64_t g_cputime_irqtotal;	/* All interrupt time */
+#endif
+
+/* Waits of less than g_schedlat_bound[i] counter units are counted in
+ * g_schedlat_count[i], unless counted in a lower bucket.
+ */
+
+static uint32_t g_schedlat_bound[CLOCK_SCHEDLAT_NBUCKETS - 1];
+static uint32_t g_schedlat_count[CLOCK_SCHEDLAT_NBUCKETS];
+
+/************************************************************************
+ * Private Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name: sched_cputime_charge
+ *
+ * Description:
+ *   Charge the time since the last charge to 'tcb', which has been
+ *   running all that time.
+ *
+ ************************************************************************/
+
+static void sched_cputime_charge(FAR struct tcb_s *tcb, uint32_t now)
+{
+	uint32_t elapsed = now - g_cputime_last;
+#ifdef CONFIG_SCHED_CPUTIME_IRQ
+	uint32_t irq = g_cputime_irqpend;
+
+	/* Interrupt time beyond the interval belongs to an interrupt that
+	 * switched tasks; leave it for the next task.
+	 */
+
+	if (irq > elapsed) {
+		irq = elapsed;
+	}
+
+	g_cputime_irqpend -= irq;
+	tcb->cputime.runtime += elapsed - irq;
+	tcb->cputime.irqtime += irq;
+#else
+	tcb->cputime.runtime += elapsed;
+#endif
+
+	/* Charge whole CPU load units and carry the rest, so that the
+	 * counter may wrap.
+	 */
+
+	g_cputime_loadrem += elapsed;
+	sched_cpuload_charge(tcb, g_cputime_loadrem >> g_cputime_shift);
+	g_cputime_loadrem &= ((uint32_t)1 << g_cputime_shift) - 1;
+	g_cputime_last = now;
+}
+
+/************************************************************************
+ * Name: sched_cputime_usec
+ *
+ * Description:
+ *   Convert counter units to microseconds without overflowing.
+ *
+ ************************************************************************/
+
+static uint64_t sched_cputime_usec(uint64_t count)
+{
+	uint32_t freq = g_cputime_freq;
+
+	if (freq == 0) {
+		return 0;
+	}
+
+	return (count / freq) * 1000000 + ((count % freq) * 1000000) / freq;
+}
+
+/************************************************************************
+ * Public Functions
+ ************************************************************************/
+
+#ifndef CONFIG_SCHED_TICKLESS
+/************************************************************************
+ * Name: up_perf_gettime / up_perf_getfreq
+ *
+ * Description:
+ *   Default counter for architectures without a cycle counter:  The
+ *   system timer, with the resolution of one tick.
+ *
+ ************************************************************************/
+
+uint32_t weak_function up_perf_gettime(void)
+{
+	return (uint32_t)clock_systimer();
+}
+
+uint32_t weak_function up_perf_getfreq(void)
+{
+	return CLOCKS_PER_SEC;
+}
+#else
+/************************************************************************
+ * Name: up_perf_gettime / up_perf_getfreq
+ *
+ * Description:
+ *   Default counter for architectures without a cycle counter:  The
+ *   tickless timer in microseconds.
+ *
+ ************************************************************************/
+
+uint32_t weak_function up_perf_gettime(void)
+{
+	struct timespec ts;
+
+	if (up_timer_gettime(&ts) < 0) {
+		return g_cputime_last;
+	}
+
+	return (uint32_t)ts.tv_sec * 1000000 + (uint32_t)ts.tv_nsec / 1000;
+}
+
+uint32_t weak_function up_perf_getfreq(void)
+{
+	return 1000000;
+}
+#endif
+
+/************************************************************************
+ * Name: sched_cputime_initialize
+ *
+ * Description:
+ *   Read the counter rate and start measuring.  Called once the timer
+ *   is running, by os_start() after up_initialize().
+ *
+ ************************************************************************/
+
+void sched_cputime_initialize(void)
+{
+	uint64_t bound;
+	int i;
+
+	g_cputime_freq = up_perf_getfreq();
+	DEBUGASSERT(g_cputime_freq > 0);
+
+	g_cputime_shift = 0;
+	while ((g_cputime_freq >> g_cputime_shift) > CPUTIME_LOADFREQ) {
+		g_cputime_shift++;
+	}
+
+	g_cputime_loadfreq = g_cputime_freq >> g_cputime_shift;
+
+	/* Bucket i ends at 2^i microseconds */
+
+	for (i = 0; i < CLOCK_SCHEDLAT_NBUCKETS - 1; i++) {
+		bound = ((uint64_t)g_cputime_freq << i) / 1000000;
+		g_schedlat_bound[i] = bound > UINT32_MAX ? UINT32_MAX : (uint32_t)bound;
+	}
+
+	g_cputime_last = up_perf_gettime();
+}
+
+/************************************************************************
+ * Name: sched_cputime_leave
+ *
+ * Description:
+ *   Charge the running task 'from' for its time up to 'now', and record
+ *   how long 'to' waited to run.
+ *
+ ************************************************************************/
+
+static void sched_cputime_leave(FAR struct tcb_s *from, FAR struct tcb_s *to, uint32_t now)
+{
+	uint32_t wait;
+	int i;
+
+	sched_cputime_charge(from, now);
+
+	/* A preempted task is ready-to-run from now on.  A blocked task is
+	 * restamped by sched_cputime_ready() when it is woken.
+	 */
+
+	from->cputime.readytime = now;
+
+	wait = now - to->cputime.readytime;
+	to->cputime.waittime += wait;
+	if (wait > to->cputime.maxwait) {
+		to->cputime.maxwait = wait;
+	}
+
+	for (i = 0; i < CLOCK_SCHEDLAT_NBUCKETS - 1 && wait >= g_schedlat_bound[i]; i++) ;
+	g_schedlat_count[i]++;
+}
+
+/************************************************************************
+ * Name: sched_cputime_ready
+ *
+ * Description:
+ *   Note that 'tcb' is added to the ready-to-run list.  A task that was
+ *   only taken off the list to change its priority, as for round-robin
+ *   or priority inheritance, keeps its time of becoming ready.  If it
+ *   was running, it has been preempted.
+ *
+ ************************************************************************/
+
+void sched_cputime_ready(FAR struct tcb_s *tcb)
+{
+	if (tcb->cputime.removed == CPUTIME_REMOVED_RUNNING) {
+		tcb->cputime.nivcsw++;
+	} else if (tcb->cputime.removed == CPUTIME_REMOVED_NONE) {
+		tcb->cputime.readytime = up_perf_gettime();
+	}
+
+	tcb->cputime.removed = CPUTIME_REMOVED_NONE;
+}
+
+/************************************************************************
+ * Name: sched_cputime_switch
+ *
+ * Description:
+ *   Charge the running task 'from' for its time up to now, and record
+ *   how long 'to' waited to run.  'voluntary' is true if 'from' stops
+ *   running because it yields, false if it is preempted.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ************************************************************************/
+
+void sched_cputime_switch(FAR struct tcb_s *from, FAR struct tcb_s *to, bool voluntary)
+{
+	sched_cputime_leave(from, to, up_perf_gettime());
+
+	if (voluntary) {
+		from->cputime.nvcsw++;
+	} else {
+		from->cputime.nivcsw++;
+	}
+}
+
+/************************************************************************
+ * Name: sched_cputime_remove
+ *
+ * Description:
+ *   Note that 'tcb' is removed from the ready-to-run list.  If it was
+ *   running, 'ntcb' runs next, otherwise 'ntcb' is NULL.  The switch is
+ *   counted once the task is blocked or made ready-to-run again.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ************************************************************************/
+
+void sched_cputime_remove(FAR struct tcb_s *tcb, FAR struct tcb_s *ntcb)
+{
+	if (ntcb != NULL) {
+		sched_cputime_leave(tcb, ntcb, up_perf_gettime());
+		tcb->cputime.removed = CPUTIME_REMOVED_RUNNING;
+	} else {
+		tcb->cputime.removed = CPUTIME_REMOVED_READY;
+	}
+}
+
+/************************************************************************
+ * Name: sched_cputime_block
+ *
+ * Description:
+ *   Note that 'tcb' is blocked.  If it was running, it gave up the CPU
+ *   voluntarily.
+ *
+ ************************************************************************/
+
+void sched_cputime_block(FAR struct tcb_s *tcb)
+{
+	if (tcb->cputime.removed == CPUTIME_REMOVED_RUNNING) {
+		tcb->cputime.nvcsw++;
+	}
+
+	tcb->cputime.removed = CPUTIME_REMOVED_NONE;
+}
+
+/************************************************************************
+ * Name: sched_cputime_tick
+ *
+ * Description:
+ *   Charge the running task for its time up to now.  Called on each
+ *   timer tick so that CPU load is current even if no task switches.
+ *
+ ************************************************************************/
+
+void sched_cputime_tick(void)
+{
+	sched_cputime_charge(this_task(), up_perf_gettime());
+}
+
+#ifdef CONFIG_SCHED_CPUTIME_IRQ
+/************************************************************************
+ * Name: sched_cputime_irq
+ *
+ * Description:
+ *   Account for 'elapsed' counter units spent in an interrupt handler.
+ *
+ ************************************************************************/
+
+void sched_cputime_irq(uint32_t elapsed)
+{
+	g_cputime_irqpend += elapsed;
+	g_cputime_irqtotal += elapsed;
+}
+#endif
+
+/****************************************************************************
+ * Function:  clock_cputime
+ *
+ * Description:
+ *   Return the CPU time measured for the select PID.
+ *
+ * Parameters:
+ *   pid - The task ID of the thread of interest.
+ *   cputime - The location to return the CPU time
+ *
+ * Return Value:
+ *   OK (0) on success; -ESRCH if 'pid' does not refer to a valid thread.
+ *
+ ****************************************************************************/
+
+int clock_cputime(int pid, FAR struct cputime_s *cputime)
+{
+	FAR struct tcb_s *tcb;
+	struct task_cputime_s snap;
+	irqstate_t flags;
+
+	DEBUGASSERT(cputime);
+
+	flags = irqsave();
+
+	tcb = sched_gettcb(pid);
+	if (tcb == NULL) {
+		irqrestore(flags);
+		return -ESRCH;
+	}
+
+	/* Bring the running task up to date */
+
+	sched_cputime_charge(this_task(), up_perf_gettime());
+	snap = tcb->cputime;
+	irqrestore(flags);
+
+	cputime->runtime = sched_cputime_usec(snap.runtime);
+	cputime->irqtime = sched_cputime_usec(snap.irqtime);
+	cputime->waittime = sched_cputime_usec(snap.waittime);
+	cputime->maxwait = sched_cputime_usec(snap.maxwait);
+	cputime->nvcsw = snap.nvcsw;
+	cputime->nivcsw = snap.nivcsw;
+	return OK;
+}
+
+/****************************************************************************
+ * Function:  clock_schedlatency
+ *
+ * Description:
+ *   Return the histogram of the waits to run of all threads and the total
+ *   time spent in interrupt handlers.
+ *
+ ****************************************************************************/
+
+void clock_schedlatency(FAR struct schedlat_s *schedlat)
+{
+	uint64_t irqtotal = 0;
+	irqstate_t flags;
+
+	DEBUGASSERT(schedlat);
+
+	flags = irqsave();
+	memcpy(schedlat->count, g_schedlat_count, sizeof(g_schedlat_count));
+#ifdef CONFIG_SCHED_CPUTIME_IRQ
+	irqtotal = g_cputime_irqtotal;
+#endif
+	irqrestore(flags);
+
+	schedlat->irqtime = sched_cputime_usec(irqtotal);
+}
+
+#endif							/* CONFIG_SCHED_CPUTIME */
@@ -116,7 +116,21 @@ void sched_removeblocked(FAR struct tcb_s *btcb)
 	 * with this state
 	 */
 
-	dq_rem((FAR dq_entry_t *)btcb, (dq_queue_t *)g_tasklisttable[task_state].list);
+	dq_rem((FAR dq_entry_t *)btcb, SCHED_TASKLIST(btcb, task_state));
+
+	/* Leaving the semaphore or message queue wait list ends the wait.  This
+	 * is done here, and not by the caller before unblocking, because the
+	 * wait list is found through waitsem or msgwaitq.
+	 */
+
+	if (task_state == TSTATE_WAIT_SEM) {
+		btcb->waitsem = NULL;
+	}
+#ifndef CONFIG_DISABLE_MQUEUE
+	else if (task_state == TSTATE_WAIT_MQNOTEMPTY || task_state == TSTATE_WAIT_MQNOTFULL) {
+		btcb->msgwaitq = NULL;
+	}
+#endif
 
 	/* Make sure the TCB's state corresponds to not being in
 	 * any list
@@ -129,6 +129,12 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
 		ret = true;
 	}
 
+	/* The caller either blocks the task or returns it to the ready-to-run
+	 * list, which tells whether a switch was voluntary.
+	 */
+
+	sched_cputime_remove(rtcb, ntcb);
+
 	/* Remove the TCB from the ready-to-run list */
 
 	dq_rem((FAR dq_entry_t *)rtcb, (FAR dq_queue_t *)&g_readytorun);
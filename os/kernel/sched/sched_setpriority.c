@@ -210,10 +210,10 @@ int sched_setpriority(FAR struct tcb_s *tcb, int sched_priority)
 
 		/* CASE 3a. The task resides in a prioritized list. */
 
-		if (g_tasklisttable[task_state].prioritized) {
+		if (g_tasklisttable[task_state].prioritized && SCHED_TASKLIST(tcb, task_state) != NULL) {
 			/* Remove the TCB from the prioritized task list */
 
-			dq_rem((FAR dq_entry_t *)tcb, (FAR dq_queue_t *)g_tasklisttable[task_state].list);
+			dq_rem((FAR dq_entry_t *)tcb, SCHED_TASKLIST(tcb, task_state));
 
 			/* Change the task priority */
 
@@ -223,7 +223,7 @@ int sched_setpriority(FAR struct tcb_s *tcb, int sched_priority)
 			 * position
 			 */
 
-			sched_addprioritized(tcb, (FAR dq_queue_t *)g_tasklisttable[task_state].list);
+			sched_addprioritized(tcb, SCHED_TASKLIST(tcb, task_state));
 		}
 
 		/* CASE 3b. The task resides in a non-prioritized list. */
@@ -127,6 +127,7 @@ int sched_yield(void)
 
 		/* A context switch will occur. */
 		sched_note_switch(rtcb, ntcb);
+		sched_cputime_switch(rtcb, ntcb, true);
 		ntcb->task_state = TSTATE_TASK_RUNNING;
 		switch_needed = true;
 
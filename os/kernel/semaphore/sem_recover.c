@@ -151,12 +151,14 @@ void sem_recover(FAR struct tcb_s *tcb)
 
 		sem->semcount++;
 
-		/* Clear the semaphore to assure that it is not reused.  But leave the
-		 * state as TSTATE_WAIT_SEM.  This is necessary because this is a
-		 * necessary indication that the TCB still resides in the waiting-for-
-		 * semaphore list.
+		/* Detach the TCB from the semaphore wait list so that a later
+		 * sem_post() cannot hand the count to the exiting task, and clear
+		 * the semaphore to assure that it is not reused.  The state is left
+		 * as TSTATE_WAIT_SEM; with waitsem cleared, the task termination
+		 * logic knows that there is no list left to remove the TCB from.
 		 */
 
+		dq_rem((FAR dq_entry_t *)tcb, &sem->waitlist);
 		tcb->waitsem = NULL;
 
 	}
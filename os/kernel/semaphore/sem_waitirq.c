@@ -145,15 +145,13 @@ void sem_waitirq(FAR struct tcb_s *wtcb, int errcode)
 
 		sem->semcount++;
 
-		/* Indicate that the semaphore wait is over. */
-
-		wtcb->waitsem = NULL;
-
 		/* Mark the errno value for the thread. */
 
 		wtcb->pterrno = errcode;
 
-		/* Restart the task. */
+		/* Restart the task.  Removing it from the semaphore wait list
+		 * indicates that the semaphore wait is over (waitsem is cleared).
+		 */
 
 		up_unblock_task(wtcb);
 	}
@@ -123,6 +123,7 @@ int task_restart(pid_t pid)
 	FAR struct tcb_s *rtcb;
 	FAR struct task_tcb_s *tcb;
 	irqstate_t state;
+	FAR dq_queue_t *tasklist;
 	int status;
 
 	trace_begin(TTRACE_TAG_TASK, "task_restart");
@@ -180,7 +181,10 @@ int task_restart(pid_t pid)
 		 */
 
 		state = irqsave();
-		dq_rem((FAR dq_entry_t *)tcb, (dq_queue_t *)g_tasklisttable[tcb->cmn.task_state].list);
+		tasklist = SCHED_TASKLIST(&tcb->cmn, tcb->cmn.task_state);
+		if (tasklist != NULL) {
+			dq_rem((FAR dq_entry_t *)tcb, tasklist);
+		}
 		tcb->cmn.task_state = TSTATE_TASK_INVALID;
 		irqrestore(state);
 
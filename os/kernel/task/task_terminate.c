@@ -143,6 +143,7 @@ int task_terminate(pid_t pid, bool nonblocking)
 {
 	FAR struct tcb_s *dtcb;
 	irqstate_t saved_state;
+	FAR dq_queue_t *tasklist;
 	trace_begin(TTRACE_TAG_TASK, "task_terminate");
 
 	/* Make sure the task does not become ready-to-run while we are futzing with
@@ -185,7 +186,10 @@ int task_terminate(pid_t pid, bool nonblocking)
 	/* Remove the task from the OS's tasks lists. */
 
 	saved_state = irqsave();
-	dq_rem((FAR dq_entry_t *)dtcb, (dq_queue_t *)g_tasklisttable[dtcb->task_state].list);
+	tasklist = SCHED_TASKLIST(dtcb, dtcb->task_state);
+	if (tasklist != NULL) {
+		dq_rem((FAR dq_entry_t *)dtcb, tasklist);
+	}
 	dtcb->task_state = TSTATE_TASK_INVALID;
 	irqrestore(saved_state);
 
@@ -114,6 +114,7 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *wo
 	struct work_s *cur_work;
 	irqstate_t flags;
 	int ret = -ENOENT;
+	int wndx;
 
 	DEBUGASSERT(work != NULL);
 
@@ -124,29 +125,30 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *wo
 
 	flags = irqsave();
 	if (work->worker != NULL) {
-		/* A little test of the integrity of the work queue */
-
-		DEBUGASSERT(work->dq.flink || (FAR dq_entry_t *)work == wqueue->q.tail);
-		DEBUGASSERT(work->dq.blink || (FAR dq_entry_t *)work == wqueue->q.head);
-
-		/* check whether requested work is in queue list or not */
-		cur_work = (struct work_s *)wqueue->q.head;
-		do {
-			if (cur_work == NULL) {
-				irqrestore(flags);
-				return -ENOENT;
-			} else if (cur_work == work) {
+		/* Find the worker whose queue holds the work */
+
+		for (wndx = 0; wndx < wqueue->nworkers; wndx++) {
+			for (cur_work = (struct work_s *)wqueue->worker[wndx].q.head; cur_work != NULL; cur_work = (struct work_s *)cur_work->dq.flink) {
+				if (cur_work == work) {
+					break;
+				}
+			}
+
+			if (cur_work != NULL) {
 				break;
 			}
+		}
 
-			cur_work = (struct work_s *)cur_work->dq.flink;
-		} while (1);
+		if (wndx >= wqueue->nworkers) {
+			irqrestore(flags);
+			return -ENOENT;
+		}
 
 		/* Remove the entry from the work queue and make sure that it is
 		 * mark as available (i.e., the worker field is nullified).
 		 */
 
-		dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+		dq_rem((FAR dq_entry_t *)work, &wqueue->worker[wndx].q);
 		work->worker = NULL;
 		ret = OK;
 	}
@@ -169,7 +171,7 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *wo
  *   by calling work_queue() again.
  *
  * Input parameters:
- *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   qid    - The work queue ID (HPWORK, LPWORK or LPWORK_LONG)
  *   work   - The previously queue work structure to cancel
  *
  * Returned Value:
@@ -191,7 +193,7 @@ int work_cancel(int qid, FAR struct work_s *work)
 	} else
 #endif
 #ifdef CONFIG_SCHED_LPWORK
-		if (qid == LPWORK) {
+		if (qid == LPWORK || qid == LPWORK_LONG) {
 			/* Cancel low priority work */
 
 			return work_qcancel((FAR struct kwork_wqueue_s *)&g_lpwork, work);
@@ -140,8 +140,9 @@ static int work_hpthread(int argc, char *argv[])
 #endif
 
 		/* Then process queued work.  work_process will not return until: (1)
-		 * there is no further work in the work queue, and (2) the polling
-		 * period provided by g_hpwork.delay expires.
+		 * there is no further due work in the work queue, and (2) the next
+		 * work falls due, a signal is received or the polling period
+		 * provided by g_hpwork.delay expires.
 		 */
 
 		work_process((FAR struct kwork_wqueue_s *)&g_hpwork, g_hpwork.delay, 0);
@@ -176,7 +177,8 @@ int work_hpstart(void)
 	/* Initialize work queue data structures */
 
 	g_hpwork.delay = CONFIG_SCHED_HPWORKPERIOD / USEC_PER_TICK;
-	dq_init(&g_hpwork.q);
+	g_hpwork.nworkers = 1;
+	dq_init(&g_hpwork.worker[0].q);
 
 	/* Start the high-priority, kernel mode worker thread */
 
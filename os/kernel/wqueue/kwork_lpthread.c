@@ -109,6 +109,11 @@ struct lp_wqueue_s g_lpwork;
  *   by the idle thread if CONFIG_SCHED_WORKQUEUE is not defined).  That will
  *   be the lower priority worker thread if it is available.
  *
+ *   Each thread has its own queue of work and also performs due work from
+ *   the queues of the other threads when idle.  With more than one thread,
+ *   the last thread only receives LPWORK_LONG work, which the other threads
+ *   never take.
+ *
  *   All kernel mode worker threads are started by the OS during normal
  *   bring up.  This entry point is referenced by OS internally and should
  *   not be accessed by application logic.
@@ -147,11 +152,11 @@ static int work_lpthread(int argc, char *argv[])
 		/* Thread 0 is special.  Only thread 0 performs period garbage collection */
 
 		if (wndx > 0) {
-			/* The other threads will perform work, waiting indefinitely until
-			 * signalled for the next work availability.
+			/* The other threads will perform work, sleeping until the next
+			 * work is due or until signalled for the next work availability.
 			 *
 			 * The special value of zero for the poll period instructs work_process
-			 * to wait indefinitely until a signal is received.
+			 * not to wake up periodically.
 			 */
 
 			work_process((FAR struct kwork_wqueue_s *)&g_lpwork, 0, wndx);
@@ -171,8 +176,9 @@ static int work_lpthread(int argc, char *argv[])
 			sched_garbagecollection();
 
 			/* Then process queued work.  work_process will not return until:
-			 * (1) there is no further work in the work queue, and (2) the polling
-			 * period provided by g_lpwork.delay expires.
+			 * (1) there is no further due work in the work queue, and (2) the
+			 * next work falls due, a signal is received or the polling period
+			 * provided by g_lpwork.delay expires.
 			 */
 
 			work_process((FAR struct kwork_wqueue_s *)&g_lpwork, g_lpwork.delay, 0);
@@ -208,10 +214,13 @@ int work_lpstart(void)
 
 	/* Initialize work queue data structures */
 
-	memset(&g_lpwork, 0, sizeof(struct kwork_wqueue_s));
+	memset(&g_lpwork, 0, sizeof(struct lp_wqueue_s));
 
 	g_lpwork.delay = CONFIG_SCHED_LPWORKPERIOD / USEC_PER_TICK;
-	dq_init(&g_lpwork.q);
+	g_lpwork.nworkers = CONFIG_SCHED_LPNTHREADS;
+	for (wndx = 0; wndx < CONFIG_SCHED_LPNTHREADS; wndx++) {
+		dq_init(&g_lpwork.worker[wndx].q);
+	}
 
 	/* Don't permit any of the threads to run until we have fully initialized
 	 * g_lpwork.
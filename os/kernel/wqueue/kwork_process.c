@@ -56,6 +56,7 @@
 #include <tinyara/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <unistd.h>
 #include <signal.h>
 #include <assert.h>
@@ -84,10 +85,6 @@
 #define WORK_CLOCK CLOCK_REALTIME
 #endif
 
-#ifndef MIN
-#define MIN(a, b) ((a) < (b) ? (a) : (b))
-#endif
-
 /****************************************************************************
  * Private Type Declarations
  ****************************************************************************/
@@ -104,6 +101,72 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_dequeue
+ *
+ * Description:
+ *   Remove the next due work for a worker.  The worker's own queue is
+ *   examined first and then the queues of the other workers, so that due
+ *   work does not wait for a busy worker while another one is idle.  Work
+ *   on the queue of the long worker is never taken by the other workers.
+ *   Each queue is in deadline order, so only its head needs to be examined.
+ *
+ *   Interrupts must be disabled by the caller.
+ *
+ * Input parameters:
+ *   wqueue - Describes the work queue to be processed
+ *   wndx   - The worker thread index
+ *   next   - Location to return the ticks until the earliest work that the
+ *            worker may take falls due, or zero if there is no such work.
+ *
+ * Returned Value:
+ *   The due work, or NULL if there is none
+ *
+ ****************************************************************************/
+
+static FAR struct work_s *work_dequeue(FAR struct kwork_wqueue_s *wqueue, int wndx, FAR systime_t *next)
+{
+	FAR struct kworker_s *kworker;
+	FAR struct work_s *work;
+	systime_t remaining;
+	systime_t now;
+	int ndx;
+	int i;
+
+	now = clock_systimer();
+	*next = 0;
+
+	for (i = 0; i < wqueue->nworkers; i++) {
+		ndx = (wndx + i) % wqueue->nworkers;
+		if (i > 0 && ndx == WORK_LONGWORKER(wqueue)) {
+			continue;
+		}
+
+		kworker = &wqueue->worker[ndx];
+		work = (FAR struct work_s *)kworker->q.head;
+		if (work == NULL) {
+			continue;
+		}
+
+		remaining = WORK_REMAINING(work, now);
+		if (remaining == 0) {
+			(void)dq_rem((FAR dq_entry_t *)work, &kworker->q);
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+			if (i > 0) {
+				wqueue->worker[wndx].stats.nstolen++;
+			}
+#endif
+			return work;
+		}
+
+		if (*next == 0 || remaining < *next) {
+			*next = remaining;
+		}
+	}
+
+	return NULL;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -117,8 +180,18 @@
  *   part of the internal implementation of each work queue; it should not
  *   be called from application level logic.
  *
+ *   Each worker has a queue that is kept in deadline order by work_queue(),
+ *   so only the heads of the queues are examined:  due work is taken from
+ *   the head, and the heads that are not yet due give the exact time to
+ *   sleep.  The worker sleeps until that deadline, or until signalled by
+ *   work_signal() when no work is pending.  See work_dequeue() for how
+ *   workers take work from each other.
+ *
  * Input parameters:
  *   wqueue - Describes the work queue to be processed
+ *   period - The longest time to sleep in clock ticks, or zero for no
+ *            limit.  Ignored with CONFIG_SCHED_TICKLESS.
+ *   wndx   - The worker thread index
  *
  * Returned Value:
  *   None
@@ -126,181 +199,118 @@
  ****************************************************************************/
 void work_process(FAR struct kwork_wqueue_s *wqueue, uint32_t period, int wndx)
 {
-	volatile FAR struct work_s *work;
+	FAR struct work_s *work;
 	worker_t worker;
 	irqstate_t flags;
 	FAR void *arg;
-	systime_t elapsed;
-#ifndef CONFIG_SCHED_WORKQUEUE_SORTING
-	systime_t remaining;
-#endif
-	systime_t stick;
-	systime_t ctick;
 	systime_t next;
+	bool forever;
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+	FAR struct work_stats_s *stats = &wqueue->worker[wndx].stats;
+	systime_t start;
+	uint32_t elapsed;
+#endif
 
 	/* Then process queued work.  We need to keep interrupts disabled while
 	 * we process items in the work list.
 	 */
 
-	next = period;
 	flags = irqsave();
 
-	/* Get the time that we started this polling cycle in clock ticks. */
-
-	stick = clock_systimer();
-
-	/* And check each entry in the work queue.  Since we have disabled
-	 * interrupts we know:  (1) we will not be suspended unless we do
-	 * so ourselves, and (2) there will be no changes to the work queue
+	/* Run all work that is due.  Since we have disabled interrupts we know:
+	 * (1) we will not be suspended unless we do so ourselves, and (2) there
+	 * will be no changes to the work queues.
 	 */
 
-	work = (FAR struct work_s *)wqueue->q.head;
-	while (work) {
-		/* Is this work ready?  It is ready if there is no delay or if
-		 * the delay has elapsed. qtime is the time that the work was added
-		 * to the work queue.  It will always be greater than or equal to
-		 * zero.  Therefore a delay of zero will always execute immediately.
+	while ((work = work_dequeue(wqueue, wndx, &next)) != NULL) {
+		/* Extract the work description from the entry (in case the work
+		 * instance by the re-used after it has been de-queued).
 		 */
 
-		ctick = clock_systimer();
-		elapsed = ctick - work->qtime;
+		worker = work->worker;
 
-		if (elapsed >= work->delay) {
-			/* Remove the ready-to-execute work from the list */
+		/* Check for a race condition where the work may be nullified
+		 * before it is removed from the queue.
+		 */
 
-			(void)dq_rem((struct dq_entry_s *)work, &wqueue->q);
+		if (worker != NULL) {
+			/* Extract the work argument (before re-enabling interrupts) */
 
-			/* Extract the work description from the entry (in case the work
-			 * instance by the re-used after it has been de-queued).
-			 */
+			arg = work->arg;
 
-			worker = work->worker;
-
-			/* Check for a race condition where the work may be nullified
-			 * before it is removed from the queue.
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+			/* The work fell due at qtime + delay; anything beyond that was
+			 * spent waiting for a worker.
 			 */
 
-			if (worker != NULL) {
-				/* Extract the work argument (before re-enabling interrupts) */
-
-				arg = work->arg;
-
-				/* Mark the work as no longer being queued */
-
-				work->worker = NULL;
-
-				/* Do the work.  Re-enable interrupts while the work is being
-				 * performed... we don't have any idea how long this will take!
-				 */
-
-				irqrestore(flags);
-				worker(arg);
+			start = clock_systimer();
+			elapsed = (uint32_t)((systime_t)(start - work->qtime) - work->delay);
+			if (elapsed > stats->maxlatency) {
+				stats->maxlatency = elapsed;
+			}
+#endif
 
-				/* Now, unfortunately, since we re-enabled interrupts we don't
-				 * know the state of the work list and we will have to start
-				 * back at the head of the list.
-				 */
+			/* Mark the work as no longer being queued */
 
-				flags = irqsave();
-				work = (FAR struct work_s *)wqueue->q.head;
-			} else {
-				/* Cancelled.. Just move to the next work in the list with
-				 * interrupts still disabled.
-				 */
+			work->worker = NULL;
 
-				work = (FAR struct work_s *)work->dq.flink;
-			}
-		} else {				/* elapsed < work->delay */
-
-			/* This one is not ready.
-			 *
-			 * NOTE that elapsed is relative to the the current time,
-			 * not the time of beginning of this queue processing pass.
-			 * So it may need an adjustment.
+			/* Do the work.  Re-enable interrupts while the work is being
+			 * performed... we don't have any idea how long this will take!
 			 */
 
-			elapsed += (ctick - stick);
-			if (elapsed > work->delay) {
-				/* The delay has expired while we are processing */
-
-				elapsed = work->delay;
+			irqrestore(flags);
+			worker(arg);
+			flags = irqsave();
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+			elapsed = (uint32_t)(clock_systimer() - start);
+			stats->nrun++;
+			stats->runtime += elapsed;
+			if (elapsed > stats->maxrun) {
+				stats->maxrun = elapsed;
+				stats->maxworker = worker;
 			}
-
-			/* Will it be ready before the next scheduled wakeup interval? */
-
-#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
-			next = work->delay - elapsed;
-
-			/* Then break at while loop due to sorted list */
-			break;
-#else
-			remaining = work->delay - elapsed;
-			if (remaining < next) {
-				/* Yes.. Then schedule to wake up when the work is ready */
-				next = remaining;
-			}
-
-			/* Then try the next in the list. */
-
-			work = (FAR struct work_s *)work->dq.flink;
 #endif
 		}
 	}
 
-#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
-	if ((FAR struct work_s *)wqueue->q.head == NULL) {
-		period = 0;
-	}
-#endif
+	/* If nothing is pending, sleep until signalled by work_queue() */
 
-#if (defined(CONFIG_SCHED_LPWORK) && CONFIG_SCHED_LPNTHREADS > 0) || defined(CONFIG_SCHED_WORKQUEUE_SORTING)
-	/* Value of zero for period means that we should wait indefinitely until
-	 * signalled.  This option is used only for the case where there are
-	 * multiple, low-priority worker threads.  In that case, only one of
-	 * the threads does the poll... the others simple.  In all other cases
-	 * period will be non-zero and equal to wqueue->delay.
+	forever = (next == 0);
+
+#ifndef CONFIG_SCHED_TICKLESS
+	/* With a periodic tick, a worker that is given a period also wakes up
+	 * at least once per period so that its caller can do periodic duties
+	 * like garbage collection.  A tickless system sleeps for as long as it
+	 * can.
 	 */
 
-	if (period == 0) {
+	if (period > 0 && (forever || next > period)) {
+		next = period;
+		forever = false;
+	}
+#endif
+
+	wqueue->worker[wndx].busy = false;
+	if (forever) {
 		sigset_t set;
 
 		/* Wait indefinitely until signalled with SIGWORK */
 
 		sigemptyset(&set);
 		sigaddset(&set, SIGWORK);
-
-		wqueue->worker[wndx].busy = false;
 		DEBUGVERIFY(sigwaitinfo(&set, NULL));
-		wqueue->worker[wndx].busy = true;
-	} else
-#endif
-	{
-#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
-		if (next > 0) {
-#else
-		/* Get the delay (in clock ticks) since we started the sampling */
-
-		elapsed = clock_systimer() - stick;
-		if (elapsed < period && next > 0) {
-			/* How much time would we need to delay to get to the end of the
-			 * sampling period?  The amount of time we delay should be the smaller
-			 * of the time to the end of the sampling period and the time to the
-			 * next work expiry.
-			 */
+	} else {
+		/* Sleep until the earliest work is due.  We will wait here until
+		 * either the time elapses or until we are awakened by a signal
+		 * because earlier work was queued.  Interrupts will be re-enabled
+		 * while we wait.
+		 */
 
-			remaining = period - elapsed;
-			next = MIN(next, remaining);
-#endif
-			/* Wait awhile to check the work list.  We will wait here until
-			 * either the time elapses or until we are awakened by a signal.
-			 * Interrupts will be re-enabled while we wait.
-			 */
-			wqueue->worker[wndx].busy = false;
-			usleep(next * USEC_PER_TICK);
-			wqueue->worker[wndx].busy = true;
-		}
+		usleep(next * USEC_PER_TICK);
 	}
 
+	wqueue->worker[wndx].busy = true;
 	irqrestore(flags);
 }
 
@@ -104,7 +104,8 @@
  *   and remove it from the work queue.
  *
  * Input parameters:
- *   qid    - The work queue ID (index)
+ *   wqueue - The work queue
+ *   wndx   - The index of the worker whose queue receives the work
  *   work   - The work structure to queue
  *   worker - The worker callback to be invoked.  The callback will invoked
  *            on the worker thread of execution.
@@ -118,45 +119,56 @@
  *
  ****************************************************************************/
 
-static int work_qqueue(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work, worker_t worker, FAR void *arg, uint32_t delay)
+static int work_qqueue(FAR struct kwork_wqueue_s *wqueue, int wndx, FAR struct work_s *work, worker_t worker, FAR void *arg, uint32_t delay)
 {
+	FAR struct dq_queue_s *q = &wqueue->worker[wndx].q;
 	struct work_s *cur_work;
 	struct work_s *next_work;
 	irqstate_t flags;
+	systime_t now;
+	int i;
 	DEBUGASSERT(work != NULL);
 
-	next_work = NULL;
 	flags = irqsave();
+	now = clock_systimer();
 
-	/* check whether requested work is in queue list or not */
-	cur_work = (struct work_s *)wqueue->q.head;
-	while (cur_work != NULL) {
-		if (cur_work == work) {
-			irqrestore(flags);
-			return -EALREADY;
-		}
+	/* Check whether requested work is in queue list or not.  Work on a
+	 * queue always has a worker, so work without one (new, completed or
+	 * cancelled work) needs no search.
+	 */
 
-		if ((cur_work->delay > delay) && (next_work == NULL)) {
-			next_work = cur_work;
+	if (work->worker != NULL) {
+		for (i = 0; i < wqueue->nworkers; i++) {
+			for (cur_work = (struct work_s *)wqueue->worker[i].q.head; cur_work != NULL; cur_work = (struct work_s *)cur_work->dq.flink) {
+				if (cur_work == work) {
+					irqrestore(flags);
+					return -EALREADY;
+				}
+			}
 		}
+	}
 
-		cur_work = (struct work_s *)cur_work->dq.flink;
+	/* Find the first work that falls due after this one.  The queue is kept
+	 * in deadline order so that work_process() only ever has to look at
+	 * its head.
+	 */
+
+	for (next_work = (struct work_s *)q->head; next_work != NULL; next_work = (struct work_s *)next_work->dq.flink) {
+		if (WORK_REMAINING(next_work, now) > delay) {
+			break;
+		}
 	}
 
 	work->worker = worker;		/* Work callback */
 	work->arg = arg;			/* Callback argument */
 	work->delay = delay;		/* Delay until work performed */
-	work->qtime = clock_systimer();	/* Time work queued */
+	work->qtime = now;			/* Time work queued */
 
-#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
 	if (next_work) {
-		dq_addbefore((FAR dq_entry_t *)next_work, (FAR dq_entry_t *)work, &wqueue->q);
+		dq_addbefore((FAR dq_entry_t *)next_work, (FAR dq_entry_t *)work, q);
 	} else {
-		dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+		dq_addlast((FAR dq_entry_t *)work, q);
 	}
-#else
-	dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
-#endif
 
 	irqrestore(flags);
 
@@ -164,6 +176,51 @@ static int work_qqueue(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *wor
 }
 #endif
 
+/****************************************************************************
+ * Name: work_lpselect
+ *
+ * Description:
+ *   Select the low priority worker whose queue receives new work.  Long
+ *   work always goes to the last worker.  Short work goes to an idle short
+ *   worker if there is one and is otherwise spread over the short workers
+ *   in turn; an idle worker takes it from there if that worker is busy
+ *   when the work falls due.
+ *
+ * Input parameters:
+ *   qid    - LPWORK or LPWORK_LONG
+ *
+ * Returned Value:
+ *   The index of the selected worker in g_lpwork
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LPWORK
+static int work_lpselect(int qid)
+{
+#if CONFIG_SCHED_LPNTHREADS > 1
+	static uint8_t next;
+	int nshort = CONFIG_SCHED_LPNTHREADS - 1;
+	int wndx;
+
+	if (qid == LPWORK_LONG) {
+		return WORK_LONGWORKER(&g_lpwork);
+	}
+
+	for (wndx = 0; wndx < nshort; wndx++) {
+		if (!g_lpwork.worker[wndx].busy) {
+			return wndx;
+		}
+	}
+
+	wndx = next;
+	next = (next + 1) % nshort;
+	return wndx;
+#else
+	return 0;
+#endif
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -206,7 +263,7 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker, FAR void *arg,
 	if (qid == HPWORK) {
 		/* Cancel high priority work */
 
-		result = work_qqueue((FAR struct kwork_wqueue_s *)&g_hpwork, work, worker, arg, delay);
+		result = work_qqueue((FAR struct kwork_wqueue_s *)&g_hpwork, 0, work, worker, arg, delay);
 		if (result != OK) {
 			return result;
 		}
@@ -214,14 +271,14 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker, FAR void *arg,
 	} else
 #endif
 #ifdef CONFIG_SCHED_LPWORK
-		if (qid == LPWORK) {
-			/* Cancel low priority work */
+		if (qid == LPWORK || qid == LPWORK_LONG) {
+			/* Queue low priority work */
 
-			result = work_qqueue((FAR struct kwork_wqueue_s *)&g_lpwork, work, worker, arg, delay);
+			result = work_qqueue((FAR struct kwork_wqueue_s *)&g_lpwork, work_lpselect(qid), work, worker, arg, delay);
 			if (result != OK) {
 				return result;
 			}
-			return work_signal(LPWORK);
+			return work_signal(qid);
 		} else
 #endif
 		{
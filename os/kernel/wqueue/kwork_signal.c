@@ -97,11 +97,17 @@ int work_signal(int qid)
 	} else
 #endif
 #ifdef CONFIG_SCHED_LPWORK
-		if (qid == LPWORK) {
+		if (qid == LPWORK_LONG) {
+			/* Only the long worker performs long work */
+
+			pid = g_lpwork.worker[WORK_LONGWORKER(&g_lpwork)].pid;
+		} else if (qid == LPWORK) {
 			int wndx;
 			int i;
 
-			/* Find an IDLE worker thread */
+			/* Find an IDLE worker thread.  Any worker may take due short work
+			 * from the queue of a busy one.
+			 */
 
 			for (wndx = 0, i = 0; i < CONFIG_SCHED_LPNTHREADS; i++) {
 				/* Is this worker thread busy? */
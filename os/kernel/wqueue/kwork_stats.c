@@ -0,0 +1,94 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/wqueue/kwork_stats.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <errno.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/wqueue.h>
+
+#include "wqueue/wqueue.h"
+
+#if defined(CONFIG_SCHED_WORKQUEUE) && defined(CONFIG_SCHED_WORKQUEUE_STATS)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_getstats
+ *
+ * Description:
+ *   Return the accounting of the work performed by one kernel worker
+ *   thread.
+ *
+ * Input parameters:
+ *   qid    - The work queue ID (HPWORK or LPWORK)
+ *   wndx   - The index of the worker thread in the work queue
+ *   pid    - Location to return the task ID of the worker thread
+ *   stats  - Location to return the accounting
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -EINVAL if there is no such queue or worker.
+ *
+ ****************************************************************************/
+
+int work_getstats(int qid, int wndx, FAR pid_t *pid, FAR struct work_stats_s *stats)
+{
+	FAR struct kwork_wqueue_s *wqueue;
+	irqstate_t flags;
+
+#ifdef CONFIG_SCHED_HPWORK
+	if (qid == HPWORK) {
+		wqueue = (FAR struct kwork_wqueue_s *)&g_hpwork;
+	} else
+#endif
+#ifdef CONFIG_SCHED_LPWORK
+		if (qid == LPWORK || qid == LPWORK_LONG) {
+			wqueue = (FAR struct kwork_wqueue_s *)&g_lpwork;
+		} else
+#endif
+		{
+			return -EINVAL;
+		}
+
+	if (wndx < 0 || wndx >= wqueue->nworkers) {
+		return -EINVAL;
+	}
+
+	/* Take a consistent snapshot; the worker updates it with interrupts
+	 * disabled.
+	 */
+
+	flags = irqsave();
+	*pid = wqueue->worker[wndx].pid;
+	*stats = wqueue->worker[wndx].stats;
+	irqrestore(flags);
+
+	return OK;
+}
+
+#endif							/* CONFIG_SCHED_WORKQUEUE && CONFIG_SCHED_WORKQUEUE_STATS */
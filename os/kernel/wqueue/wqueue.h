@@ -63,6 +63,9 @@
 #include <stdbool.h>
 #include <queue.h>
 
+#include <tinyara/clock.h>
+#include <tinyara/wqueue.h>
+
 #ifdef CONFIG_SCHED_WORKQUEUE
 
 /****************************************************************************
@@ -74,21 +77,45 @@
 #define HPWORKNAME "hpwork"
 #define LPWORKNAME "lpwork"
 
+/* Ticks until 'w' is due at time 'now', or zero if it is already due.
+ * Each queue is kept ordered by this value, which orders the work by its
+ * deadline (qtime + delay) as long as pending delays are shorter than half
+ * the range of systime_t.
+ */
+
+#define WORK_REMAINING(w, now) \
+	((systime_t)((now) - (w)->qtime) >= (w)->delay ? 0 : \
+	 (w)->delay - (systime_t)((now) - (w)->qtime))
+
+/* The index of the worker that performs long-running work.  With more than
+ * one worker, the last worker of a queue only receives work queued with
+ * LPWORK_LONG, and the other workers never take work from its queue.
+ */
+
+#define WORK_LONGWORKER(q) ((q)->nworkers - 1)
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
-/* This represents one worker */
+/* This represents one worker.  Each worker has its own queue of pending
+ * work.  An idle worker also takes due work from the queues of the other
+ * workers of the same work queue.
+ */
 
 struct kworker_s {
 	pid_t pid;					/* The task ID of the worker thread */
 	volatile bool busy;			/* True: Worker is not available */
+	struct dq_queue_s q;		/* Pending work, earliest deadline first */
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+	struct work_stats_s stats;	/* Accounting of the work performed */
+#endif
 };
 
 /* This structure defines the state of one kernel-mode work queue */
 
 struct kwork_wqueue_s {
 	uint32_t delay;				/* Delay between polling cycles (ticks) */
-	struct dq_queue_s q;		/* The queue of pending work */
+	uint8_t nworkers;			/* Number of workers in worker[] */
 	struct kworker_s worker[1];	/* Describes a worker thread */
 };
 
@@ -99,7 +126,7 @@ struct kwork_wqueue_s {
 #ifdef CONFIG_SCHED_HPWORK
 struct hp_wqueue_s {
 	uint32_t delay;				/* Delay between polling cycles (ticks) */
-	struct dq_queue_s q;		/* The queue of pending work */
+	uint8_t nworkers;			/* Always one */
 	struct kworker_s worker[1];	/* Describes the single high priority worker */
 };
 #endif
@@ -111,7 +138,7 @@ struct hp_wqueue_s {
 #ifdef CONFIG_SCHED_LPWORK
 struct lp_wqueue_s {
 	uint32_t delay;				/* Delay between polling cycles (ticks) */
-	struct dq_queue_s q;		/* The queue of pending work */
+	uint8_t nworkers;			/* CONFIG_SCHED_LPNTHREADS */
 
 	/* Describes each thread in the low priority queue's thread pool */
 
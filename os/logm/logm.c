@@ -18,6 +18,7 @@
 
 #include <stdio.h>
 #include <stdarg.h>
+#include <string.h>
 #include <unistd.h>
 #include <arch/irq.h>
 #include <tinyara/config.h>
@@ -33,6 +34,7 @@ int g_logm_tail;
 int g_logm_dropmsg_count;
 int g_logm_overflow_offset;
 
+#ifndef CONFIG_LOGM_BINARY
 static void logm_putc(FAR struct lib_outstream_s *this, int ch)
 {
 	if ((g_logm_tail + this->nput + 1) % logm_bufsize != g_logm_head) {
@@ -40,20 +42,53 @@ static void logm_putc(FAR struct lib_outstream_s *this, int ch)
 	}
 }
 
+static void logm_puts(FAR struct lib_outstream_s *this, FAR const char *buf, int len)
+{
+	int pos = (g_logm_tail + this->nput) % logm_bufsize;
+	int nfree = (g_logm_head - pos - 1 + logm_bufsize) % logm_bufsize;
+	int chunk;
+
+	/* Copy as much of the run as fits before the head, wrapping around the
+	 * end of the buffer at most once.
+	 */
+
+	if (len > nfree) {
+		len = nfree;
+	}
+
+	while (len > 0) {
+		chunk = logm_bufsize - pos;
+		if (chunk > len) {
+			chunk = len;
+		}
+
+		memcpy(&g_logm_rsvbuf[pos], buf, chunk);
+		this->nput += chunk;
+		buf += chunk;
+		len -= chunk;
+		pos = 0;
+	}
+}
+
 static void logm_outstream(FAR struct lib_outstream_s *outstream)
 {
 	outstream->put = logm_putc;
+	outstream->puts = logm_puts;
 #ifdef CONFIG_STDIO_LINEBUFFER
 	outstream->flush = lib_noflush;
 #endif
 	outstream->nput = 0;
 }
+#endif
 
 #ifdef CONFIG_ARCH_LOWPUTC
 static void logm_flush(struct lib_outstream_s *stream)
 {
 	sched_lock();
 
+#ifdef CONFIG_LOGM_BINARY
+	logm_binary_flush(stream);
+#else
 	while (g_logm_head != g_logm_tail) {
 		stream->put(stream, g_logm_rsvbuf[g_logm_head]);
 		g_logm_head = (g_logm_head + 1) % logm_bufsize;
@@ -62,6 +97,7 @@ static void logm_flush(struct lib_outstream_s *stream)
 	if (LOGM_STATUS(LOGM_BUFFER_OVERFLOW)) {
 		LOGM_STATUS_CLEAR(LOGM_BUFFER_OVERFLOW);
 	}
+#endif
 
 	/* Reset nput in stream for next stream */
 	stream->nput = 0;
@@ -73,16 +109,23 @@ static void logm_flush(struct lib_outstream_s *stream)
 /* logm_internal hook for syslog & printfs */
 int logm_internal(int flag, int indx, int priority, const char *fmt, va_list ap)
 {
-	irqstate_t flags;
 	int ret = 0;
 	struct lib_outstream_s strm;
+#ifndef CONFIG_LOGM_BINARY
+	irqstate_t flags;
 #ifdef CONFIG_LOGM_TIMESTAMP
 	struct timespec ts;
+#endif
 #endif
 
 	if (LOGM_STATUS(LOGM_READY) && !LOGM_STATUS(LOGM_BUFFER_RESIZE_REQ) \
 		&& flag == LOGM_NORMAL && !up_interrupt_context()) {
 
+#ifdef CONFIG_LOGM_BINARY
+		/* The caller's format string may not outlive the call, format it now */
+
+		ret = logm_binary_text(priority, fmt, ap);
+#else
 		flags = irqsave();
 
 		if (LOGM_STATUS(LOGM_BUFFER_OVERFLOW)) {
@@ -110,6 +153,7 @@ int logm_internal(int flag, int indx, int priority, const char *fmt, va_list ap)
 			g_logm_overflow_offset = g_logm_tail;
 		}
 		irqrestore(flags);
+#endif
 	} else {
 		/* Low Output: Sytem is not yet completely ready or this is called from interrupt handler */
 #ifdef CONFIG_ARCH_LOWPUTC
@@ -131,7 +175,18 @@ int logm(int flag, int indx, int priority, const char *fmt, ...)
 	/* LOGIC for initial test here */
 
 	va_start(ap, fmt);
-	ret = logm_internal(flag, indx, priority, fmt, ap);
+#ifdef CONFIG_LOGM_BINARY
+	/* Record the format string and the arguments, also from interrupt
+	 * handlers.  The logm task formats them when it flushes the buffer.
+	 */
+
+	if (LOGM_STATUS(LOGM_READY) && !LOGM_STATUS(LOGM_BUFFER_RESIZE_REQ) && flag == LOGM_NORMAL) {
+		ret = logm_binary(priority, fmt, ap);
+	} else
+#endif
+	{
+		ret = logm_internal(flag, indx, priority, fmt, ap);
+	}
 	va_end(ap);
 
 	return ret;
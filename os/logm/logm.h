@@ -20,6 +20,8 @@
 
 #include <tinyara/config.h>
 #include <stdint.h>
+#include <stdarg.h>
+#include <tinyara/logm.h>
 
 /****************************************************************************
  * Preprocessor Definitions
@@ -33,6 +35,17 @@
 #define LOGM_BUFFER_SIZE (10240)
 #endif
 
+/* Binary records are word aligned, so is the buffer size */
+
+#ifdef CONFIG_LOGM_BINARY
+#undef LOGM_BUFFER_SIZE
+#define LOGM_BUFFER_SIZE ((CONFIG_LOGM_BUFFER_SIZE) & ~3)
+#endif
+
+/* Number of priorities with their own count of dropped messages */
+
+#define LOGM_NPRIORITY LOGM_OFF
+
 #ifdef CONFIG_LOGM_PRINT_INTERVAL
 #define LOGM_PRINT_INTERVAL        CONFIG_LOGM_PRINT_INTERVAL
 #else
@@ -74,12 +87,21 @@ EXTERN int logm_bufsize;
 EXTERN uint8_t logm_status;
 EXTERN volatile int new_logm_bufsize;
 EXTERN volatile int logm_print_interval;
+#ifdef CONFIG_LOGM_BINARY
+EXTERN int g_logm_dropmsg_prio[LOGM_NPRIORITY];
+#endif
 
 /************************************************************************************
  * Private Function Prototypes
  ************************************************************************************/
 int logm_task(int argc, char *argv[]);
 void logm_register_tashcmds(void);
+#ifdef CONFIG_LOGM_BINARY
+struct lib_outstream_s;
+int logm_binary(int priority, const char *fmt, va_list ap);
+int logm_binary_text(int priority, const char *fmt, va_list ap);
+void logm_binary_flush(struct lib_outstream_s *stream);
+#endif
 static int logm_tash(int argc, char **args);
 
 #undef EXTERN
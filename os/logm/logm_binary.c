@@ -0,0 +1,759 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/* Binary logging (CONFIG_LOGM_BINARY)
+ *
+ * g_logm_rsvbuf holds a ring of records instead of text.  A logm() call
+ * stores its format string pointer, the system time and its raw arguments;
+ * the arguments are only formatted when the logm task drains the ring.
+ * printf() and syslog() output is still formatted by the caller, because
+ * their format strings may not outlive the call, and is stored as a text
+ * record in the same ring so that the order of all messages is kept.
+ *
+ * A writer reserves its record with interrupts disabled for a few
+ * instructions only, fills it in with interrupts enabled and then commits
+ * it by setting its type.  The reader stops at the first record that is
+ * not committed yet.  Messages that do not fit are dropped and counted per
+ * priority.
+ */
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <arch/irq.h>
+#include <tinyara/arch.h>
+#include <tinyara/clock.h>
+#include <tinyara/logm.h>
+#include <tinyara/streams.h>
+#include "logm.h"
+
+#ifdef CONFIG_LOGM_BINARY
+
+/* Records start at multiples of 4 bytes */
+
+#define LOGM_ALIGN(n)       (((n) + 3) & ~3)
+#define LOGM_HDRSIZE        LOGM_ALIGN(sizeof(struct logm_rec_s))
+
+/* Arguments of one logm() call take up to LOGM_ARGSIZE bytes, and a
+ * string argument up to LOGM_STRSIZE bytes with its terminator.
+ */
+
+#define LOGM_ARGSIZE        128
+#define LOGM_STRSIZE        64
+
+/* The text of a printf() or syslog() message is cut at LOGM_TEXTSIZE bytes
+ * so that the size of its record fits in 16 bits.
+ */
+
+#define LOGM_TEXTSIZE       ((UINT16_MAX & ~3) - LOGM_HDRSIZE)
+
+/* Record types.  A record is LOGM_REC_BUSY from its reservation until it
+ * has been filled in, all with interrupts disabled, so that a writer that
+ * is deleted cannot leave a busy record behind.
+ */
+
+#define LOGM_REC_BUSY       0
+#define LOGM_REC_BINARY     1	/* Format string and arguments */
+#define LOGM_REC_TEXT       2	/* Formatted text */
+#define LOGM_REC_PAD        3	/* Unused space up to the end of the buffer */
+
+/* Argument types of a conversion */
+
+#define LOGM_ARG_NONE       0	/* "%%" or an unknown conversion */
+#define LOGM_ARG_INT        1
+#define LOGM_ARG_LONG       2
+#define LOGM_ARG_LLONG      3
+#define LOGM_ARG_PTR        4
+#define LOGM_ARG_DOUBLE     5
+#define LOGM_ARG_STR        6
+#define LOGM_ARG_COUNT      7	/* "%n": takes a pointer and prints nothing */
+
+struct logm_rec_s {
+	volatile uint8_t type;		/* See LOGM_REC_* */
+	uint8_t priority;
+	uint16_t len;				/* Size of the record, a multiple of 4 */
+	uint32_t time;				/* System time in ticks */
+	union {
+		FAR const char *fmt;	/* LOGM_REC_BINARY: The format string */
+		size_t nbytes;			/* LOGM_REC_TEXT: The length of the text */
+	} u;
+};
+
+/* Writes text into the ring after the header of a text record */
+
+struct logm_textstream_s {
+	struct lib_outstream_s public;
+	int pos;					/* Where the next byte goes */
+	int nfree;					/* Bytes left for the text */
+};
+
+int g_logm_dropmsg_prio[LOGM_NPRIORITY];
+
+/* The drop counts already reported by logm_binary_flush() */
+
+static int g_logm_reported_prio[LOGM_NPRIORITY];
+
+/* Set while logm_binary_flush() runs, a nested call returns at once */
+
+static volatile bool g_logm_flushing;
+
+static const char *const g_logm_prioname[LOGM_NPRIORITY] = {
+	"EMR", "ART", "CRT", "ERR", "WRN", "NTCE", "INF", "DBG"
+};
+
+/****************************************************************************
+ * Ring
+ ****************************************************************************/
+
+static int logm_clamp_priority(int priority)
+{
+	if (priority < 0 || priority >= LOGM_NPRIORITY) {
+		return LOGM_NPRIORITY - 1;
+	}
+
+	return priority;
+}
+
+/* Reserve 'len' bytes for a record at the tail of the ring, which must be
+ * called with interrupts disabled.  With 'contiguous', the whole record
+ * must be contiguous, otherwise only its header.  Returns the record or
+ * NULL if there is no room.
+ */
+
+static FAR struct logm_rec_s *logm_reserve(int len, bool contiguous)
+{
+	FAR struct logm_rec_s *rec;
+	int pos = g_logm_tail;
+	int skip = 0;
+	int used;
+
+	if (logm_bufsize - pos < LOGM_HDRSIZE || (contiguous && logm_bufsize - pos < len)) {
+		skip = logm_bufsize - pos;
+	}
+
+	/* One word always stays free so that a full ring is not empty */
+
+	used = (g_logm_tail - g_logm_head + logm_bufsize) % logm_bufsize;
+	if (used + skip + len > logm_bufsize - 4) {
+		return NULL;
+	}
+
+	if (skip > 0) {
+		if (skip >= LOGM_HDRSIZE) {
+			rec = (FAR struct logm_rec_s *)&g_logm_rsvbuf[pos];
+			rec->len = skip;
+			rec->type = LOGM_REC_PAD;
+		}
+
+		pos = 0;
+	}
+
+	rec = (FAR struct logm_rec_s *)&g_logm_rsvbuf[pos];
+	rec->type = LOGM_REC_BUSY;
+	rec->len = len;
+	g_logm_tail = (pos + len) % logm_bufsize;
+
+	return rec;
+}
+
+static void logm_drop(int priority)
+{
+	g_logm_dropmsg_prio[priority]++;
+	LOGM_STATUS_SET(LOGM_BUFFER_OVERFLOW);
+}
+
+/****************************************************************************
+ * Conversions
+ ****************************************************************************/
+
+/* Parse the conversion at 'fmt', which points to a '%'.  Returns the
+ * number of '*' arguments before the value in *nstar, the type of the
+ * value in *type and the end of the conversion.
+ */
+
+static FAR const char *logm_parseconv(FAR const char *fmt, FAR int *nstar, FAR int *type)
+{
+	int lng = 0;
+
+	*nstar = 0;
+	*type = LOGM_ARG_NONE;
+
+	fmt++;
+	while (*fmt != '\0' && strchr("-+ #0", *fmt) != NULL) {
+		fmt++;
+	}
+
+	if (*fmt == '*') {
+		(*nstar)++;
+		fmt++;
+	} else {
+		while (*fmt >= '0' && *fmt <= '9') {
+			fmt++;
+		}
+	}
+
+	if (*fmt == '.') {
+		fmt++;
+		if (*fmt == '*') {
+			(*nstar)++;
+			fmt++;
+		} else {
+			while (*fmt >= '0' && *fmt <= '9') {
+				fmt++;
+			}
+		}
+	}
+
+	for (;; fmt++) {
+		if (*fmt == 'l') {
+			lng++;
+		} else if (*fmt == 'j') {
+			lng = 2;
+		} else if (*fmt == 'z' || *fmt == 't') {
+			lng = sizeof(size_t) > sizeof(long) ? 2 : 1;
+		} else if (*fmt != 'h' && *fmt != 'L') {
+			break;
+		}
+	}
+
+	switch (*fmt) {
+	case 'd':
+	case 'i':
+	case 'u':
+	case 'o':
+	case 'x':
+	case 'X':
+	case 'c':
+		*type = lng >= 2 ? LOGM_ARG_LLONG : lng == 1 ? LOGM_ARG_LONG : LOGM_ARG_INT;
+		break;
+	case 'p':
+		*type = LOGM_ARG_PTR;
+		break;
+	case 's':
+		*type = LOGM_ARG_STR;
+		break;
+	case 'f':
+	case 'F':
+	case 'e':
+	case 'E':
+	case 'g':
+	case 'G':
+		*type = LOGM_ARG_DOUBLE;
+		break;
+	case 'n':
+		*type = LOGM_ARG_COUNT;
+		break;
+	case '\0':
+		return fmt;
+	default:
+		break;
+	}
+
+	return fmt + 1;
+}
+
+/* Store the arguments of 'fmt' at 'args' and return their size, a
+ * multiple of 4.  Arguments that do not fit are left out.
+ */
+
+static int logm_packargs(FAR uint8_t *args, FAR const char *fmt, va_list ap)
+{
+	FAR const char *str;
+	int size = 0;
+	int nstar;
+	int type;
+	int len;
+	union {
+		int i;
+		long l;
+		long long ll;
+		FAR void *p;
+		double d;
+	} v;
+
+	while ((fmt = strchr(fmt, '%')) != NULL) {
+		fmt = logm_parseconv(fmt, &nstar, &type);
+
+		for (; nstar > 0; nstar--) {
+			v.i = va_arg(ap, int);
+			if (size + sizeof(int) > LOGM_ARGSIZE) {
+				return size;
+			}
+
+			memcpy(&args[size], &v.i, sizeof(int));
+			size += LOGM_ALIGN(sizeof(int));
+		}
+
+		switch (type) {
+		case LOGM_ARG_INT:
+			v.i = va_arg(ap, int);
+			len = sizeof(int);
+			break;
+		case LOGM_ARG_LONG:
+			v.l = va_arg(ap, long);
+			len = sizeof(long);
+			break;
+		case LOGM_ARG_LLONG:
+			v.ll = va_arg(ap, long long);
+			len = sizeof(long long);
+			break;
+		case LOGM_ARG_PTR:
+			v.p = va_arg(ap, FAR void *);
+			len = sizeof(FAR void *);
+			break;
+		case LOGM_ARG_DOUBLE:
+			v.d = va_arg(ap, double);
+			len = sizeof(double);
+			break;
+		case LOGM_ARG_STR:
+			str = va_arg(ap, FAR const char *);
+			if (str == NULL) {
+				str = "(null)";
+			}
+
+			/* Strings are copied, they may be gone when the record is
+			 * formatted.
+			 */
+
+			len = LOGM_ARGSIZE - size - 1;
+			if (len > LOGM_STRSIZE - 1) {
+				len = LOGM_STRSIZE - 1;
+			}
+
+			if (len < 0) {
+				return size;
+			}
+
+			len = strnlen(str, len);
+			memcpy(&args[size], str, len);
+			args[size + len] = '\0';
+			size += LOGM_ALIGN(len + 1);
+			continue;
+		case LOGM_ARG_COUNT:
+			(void)va_arg(ap, FAR void *);
+			continue;
+		default:
+			continue;
+		}
+
+		if (size + len > LOGM_ARGSIZE) {
+			return size;
+		}
+
+		memcpy(&args[size], &v, len);
+		size += LOGM_ALIGN(len);
+	}
+
+	return size;
+}
+
+/* Print the conversion 'spec' of 'type' with the argument at 'arg'.  The
+ * '*' width and precision in 'spec' have been replaced by their values.
+ */
+
+static void logm_printconv(FAR struct lib_outstream_s *stream, FAR const char *spec, int type, FAR const uint8_t *arg)
+{
+	union {
+		int i;
+		long l;
+		long long ll;
+		FAR void *p;
+		double d;
+	} v;
+
+	switch (type) {
+	case LOGM_ARG_INT:
+		memcpy(&v.i, arg, sizeof(int));
+		(void)lib_sprintf(stream, spec, v.i);
+		break;
+	case LOGM_ARG_LONG:
+		memcpy(&v.l, arg, sizeof(long));
+		(void)lib_sprintf(stream, spec, v.l);
+		break;
+	case LOGM_ARG_LLONG:
+		memcpy(&v.ll, arg, sizeof(long long));
+		(void)lib_sprintf(stream, spec, v.ll);
+		break;
+	case LOGM_ARG_PTR:
+		memcpy(&v.p, arg, sizeof(FAR void *));
+		(void)lib_sprintf(stream, spec, v.p);
+		break;
+	case LOGM_ARG_DOUBLE:
+		memcpy(&v.d, arg, sizeof(double));
+		(void)lib_sprintf(stream, spec, v.d);
+		break;
+	case LOGM_ARG_STR:
+		(void)lib_sprintf(stream, spec, (FAR const char *)arg);
+		break;
+	default:
+		break;
+	}
+}
+
+/* Print 'fmt' with the 'size' bytes of arguments stored at 'args' by
+ * logm_packargs().  Output stops at the first argument that was left out.
+ */
+
+static void logm_format(FAR struct lib_outstream_s *stream, FAR const char *fmt, FAR const uint8_t *args, int size)
+{
+	FAR const char *conv;
+	char spec[24];
+	int nspec;
+	int nstar;
+	int type;
+	int star;
+	int len;
+	int pos = 0;
+
+	while ((conv = strchr(fmt, '%')) != NULL) {
+		lib_stream_puts(stream, fmt, conv - fmt);
+		fmt = logm_parseconv(conv, &nstar, &type);
+
+		if (type == LOGM_ARG_NONE) {
+			/* "%%" prints '%', anything else is printed as it is */
+
+			if (conv[1] == '%') {
+				stream->put(stream, '%');
+			} else {
+				lib_stream_puts(stream, conv, fmt - conv);
+			}
+
+			continue;
+		}
+
+		/* Copy the conversion, replacing each '*' by its value.  Flags
+		 * beyond the size of spec are left out.
+		 */
+
+		for (nspec = 0; conv < fmt; conv++) {
+			if (*conv != '*') {
+				if (nspec < sizeof(spec) - 12 || conv + 1 == fmt) {
+					spec[nspec++] = *conv;
+				}
+				continue;
+			}
+
+			if (pos + sizeof(int) > size) {
+				return;
+			}
+
+			memcpy(&star, &args[pos], sizeof(int));
+			pos += LOGM_ALIGN(sizeof(int));
+
+			if (star < 0 && spec[nspec - 1] == '.') {
+				/* A negative precision is taken as if it were omitted */
+
+				nspec--;
+			} else if (nspec < sizeof(spec) - 12) {
+				nspec += sprintf(&spec[nspec], "%d", star);
+			}
+		}
+
+		spec[nspec] = '\0';
+
+		if (type == LOGM_ARG_COUNT) {
+			continue;
+		}
+
+		switch (type) {
+		case LOGM_ARG_INT:
+			len = sizeof(int);
+			break;
+		case LOGM_ARG_LONG:
+			len = sizeof(long);
+			break;
+		case LOGM_ARG_LLONG:
+			len = sizeof(long long);
+			break;
+		case LOGM_ARG_PTR:
+			len = sizeof(FAR void *);
+			break;
+		case LOGM_ARG_DOUBLE:
+			len = sizeof(double);
+			break;
+		default:
+			len = strlen((FAR const char *)&args[pos]) + 1;
+			break;
+		}
+
+		if (pos + len > size) {
+			return;
+		}
+
+		logm_printconv(stream, spec, type, &args[pos]);
+		pos += LOGM_ALIGN(len);
+	}
+
+	lib_stream_puts(stream, fmt, strlen(fmt));
+}
+
+/****************************************************************************
+ * Text records
+ ****************************************************************************/
+
+static void logm_textputc(FAR struct lib_outstream_s *this, int ch)
+{
+	FAR struct logm_textstream_s *strm = (FAR struct logm_textstream_s *)this;
+
+	if (strm->nfree > 0) {
+		g_logm_rsvbuf[strm->pos] = ch;
+		strm->pos = (strm->pos + 1) % logm_bufsize;
+		strm->nfree--;
+		this->nput++;
+	}
+}
+
+static void logm_textputs(FAR struct lib_outstream_s *this, FAR const char *buf, int len)
+{
+	FAR struct logm_textstream_s *strm = (FAR struct logm_textstream_s *)this;
+	int chunk;
+
+	if (len > strm->nfree) {
+		len = strm->nfree;
+	}
+
+	while (len > 0) {
+		chunk = logm_bufsize - strm->pos;
+		if (chunk > len) {
+			chunk = len;
+		}
+
+		memcpy(&g_logm_rsvbuf[strm->pos], buf, chunk);
+		strm->pos = (strm->pos + chunk) % logm_bufsize;
+		strm->nfree -= chunk;
+		this->nput += chunk;
+		buf += chunk;
+		len -= chunk;
+	}
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* Record a logm() message without formatting it.  'fmt' must stay valid
+ * until the message has been printed, as string constants do.  This may be
+ * called from interrupt handlers.  Returns the size of the record, or 0 if
+ * the message was dropped.
+ */
+
+int logm_binary(int priority, FAR const char *fmt, va_list ap)
+{
+	FAR struct logm_rec_s *rec;
+	uint32_t args[LOGM_ARGSIZE / sizeof(uint32_t)];
+	irqstate_t flags;
+	int size;
+
+	priority = logm_clamp_priority(priority);
+	size = logm_packargs((FAR uint8_t *)args, fmt, ap);
+
+	/* The arguments are packed already, filling the record is short */
+
+	flags = irqsave();
+	rec = logm_reserve(LOGM_HDRSIZE + size, true);
+	if (rec == NULL) {
+		logm_drop(priority);
+		irqrestore(flags);
+		return 0;
+	}
+
+	rec->priority = priority;
+	rec->time = (uint32_t)clock_systimer();
+	rec->u.fmt = fmt;
+	memcpy((FAR uint8_t *)rec + LOGM_HDRSIZE, args, size);
+
+	/* Commit the record */
+
+	rec->type = LOGM_REC_BINARY;
+	irqrestore(flags);
+
+	return LOGM_HDRSIZE + size;
+}
+
+/* Format a printf() or syslog() message into a text record.  Returns the
+ * number of characters stored.
+ */
+
+int logm_binary_text(int priority, FAR const char *fmt, va_list ap)
+{
+	FAR struct logm_rec_s *rec;
+	struct logm_textstream_s strm;
+	irqstate_t flags;
+	int used;
+
+	priority = logm_clamp_priority(priority);
+
+	flags = irqsave();
+
+	/* Reserve the header first, the text takes whatever is free after it */
+
+	rec = logm_reserve(LOGM_HDRSIZE, false);
+	if (rec == NULL) {
+		logm_drop(priority);
+		irqrestore(flags);
+		return 0;
+	}
+
+	used = (g_logm_tail - g_logm_head + logm_bufsize) % logm_bufsize;
+	strm.public.put = logm_textputc;
+	strm.public.puts = logm_textputs;
+#ifdef CONFIG_STDIO_LINEBUFFER
+	strm.public.flush = lib_noflush;
+#endif
+	strm.public.nput = 0;
+	strm.pos = g_logm_tail;
+	strm.nfree = logm_bufsize - 4 - used;
+	if (strm.nfree > LOGM_TEXTSIZE) {
+		strm.nfree = LOGM_TEXTSIZE;
+	}
+
+	(void)lib_vsprintf(&strm.public, fmt, ap);
+
+	rec->priority = priority;
+	rec->time = (uint32_t)clock_systimer();
+	rec->u.nbytes = strm.public.nput;
+	rec->len = LOGM_ALIGN(LOGM_HDRSIZE + strm.public.nput);
+	g_logm_tail = ((FAR char *)rec - g_logm_rsvbuf + rec->len) % logm_bufsize;
+	rec->type = LOGM_REC_TEXT;
+
+	irqrestore(flags);
+	return strm.public.nput;
+}
+
+/* Print and remove the committed records at the head of the ring, then
+ * report the messages dropped since the last call.  Only one flush runs at
+ * a time: a call made while another one is in progress, as from an
+ * interrupt handler or from output printed by the flush itself, returns
+ * without printing anything.  Interrupt handlers never format the ring,
+ * the logm task prints it later.
+ */
+
+void logm_binary_flush(FAR struct lib_outstream_s *stream)
+{
+	FAR struct logm_rec_s *rec;
+	FAR const char *text;
+	irqstate_t flags;
+	int dropped[LOGM_NPRIORITY];
+	int ndropped = 0;
+	int first;
+	int head;
+	int pos;
+	int i;
+#ifdef CONFIG_LOGM_TIMESTAMP
+	uint64_t usec;
+#endif
+
+	if (up_interrupt_context()) {
+		return;
+	}
+
+	flags = irqsave();
+	if (g_logm_flushing) {
+		irqrestore(flags);
+		return;
+	}
+	g_logm_flushing = true;
+	irqrestore(flags);
+
+	/* Writers only append at the tail, so the record at the head stays
+	 * in place until this flush advances the head past it.
+	 */
+
+	for (;;) {
+		flags = irqsave();
+		head = g_logm_head;
+		if (head == g_logm_tail) {
+			irqrestore(flags);
+			break;
+		}
+
+		if (logm_bufsize - head < LOGM_HDRSIZE) {
+			g_logm_head = 0;
+			irqrestore(flags);
+			continue;
+		}
+
+		rec = (FAR struct logm_rec_s *)&g_logm_rsvbuf[head];
+		irqrestore(flags);
+
+		if (rec->type == LOGM_REC_BUSY) {
+			/* Only seen by a flush that runs within the critical
+			 * section of a writer, as after a crash there; stop at it.
+			 */
+
+			break;
+		}
+
+#ifdef CONFIG_LOGM_TIMESTAMP
+		if (rec->type != LOGM_REC_PAD) {
+			usec = TICK2USEC((uint64_t)rec->time);
+			(void)lib_sprintf(stream, "[%4d.%4d] ", (int)(usec / 1000000), (int)(usec % 1000000) / 100);
+		}
+#endif
+
+		if (rec->type == LOGM_REC_BINARY) {
+			logm_format(stream, rec->u.fmt, (FAR const uint8_t *)rec + LOGM_HDRSIZE, rec->len - LOGM_HDRSIZE);
+		} else if (rec->type == LOGM_REC_TEXT) {
+			/* The text may wrap around the end of the buffer */
+
+			pos = (head + LOGM_HDRSIZE) % logm_bufsize;
+			text = &g_logm_rsvbuf[pos];
+			first = logm_bufsize - pos;
+			if (first >= rec->u.nbytes) {
+				lib_stream_puts(stream, text, rec->u.nbytes);
+			} else {
+				lib_stream_puts(stream, text, first);
+				lib_stream_puts(stream, g_logm_rsvbuf, rec->u.nbytes - first);
+			}
+		}
+
+		flags = irqsave();
+		g_logm_head = (head + rec->len) % logm_bufsize;
+		irqrestore(flags);
+	}
+
+	if (!LOGM_STATUS(LOGM_BUFFER_OVERFLOW)) {
+		g_logm_flushing = false;
+		return;
+	}
+
+	flags = irqsave();
+	for (i = 0; i < LOGM_NPRIORITY; i++) {
+		dropped[i] = g_logm_dropmsg_prio[i] - g_logm_reported_prio[i];
+		g_logm_reported_prio[i] = g_logm_dropmsg_prio[i];
+		ndropped += dropped[i];
+	}
+	LOGM_STATUS_CLEAR(LOGM_BUFFER_OVERFLOW);
+	irqrestore(flags);
+
+	(void)lib_sprintf(stream, "\n[LOGM BUFFER OVERFLOW] %d messages are dropped (", ndropped);
+	for (i = 0; i < LOGM_NPRIORITY; i++) {
+		if (dropped[i] > 0) {
+			ndropped -= dropped[i];
+			(void)lib_sprintf(stream, "%s %d%s", g_logm_prioname[i], dropped[i], ndropped > 0 ? ", " : ")\n");
+		}
+	}
+
+	g_logm_flushing = false;
+}
+
+#endif							/* CONFIG_LOGM_BINARY */
@@ -23,6 +23,9 @@
 #include <arch/irq.h>
 #include <tinyara/logm.h>
 #include <tinyara/config.h>
+#ifdef CONFIG_LOGM_BINARY
+#include <tinyara/streams.h>
+#endif
 #include "logm.h"
 #ifdef CONFIG_LOGM_TEST
 #include "logm_test.h"
@@ -63,6 +66,9 @@ static int logm_change_bufsize(int buflen)
 int logm_task(int argc, char *argv[])
 {
 	irqstate_t flags;
+#ifdef CONFIG_LOGM_BINARY
+	struct lib_stdoutstream_s strm;
+#endif
 
 	g_logm_rsvbuf = (char *)malloc(logm_bufsize);
 	memset(g_logm_rsvbuf, 0, logm_bufsize);
@@ -75,6 +81,10 @@ int logm_task(int argc, char *argv[])
 #endif
 
 	while (1) {
+#ifdef CONFIG_LOGM_BINARY
+		lib_stdoutstream(&strm, stdout);
+		logm_binary_flush(&strm.public);
+#else
 		while (g_logm_head != g_logm_tail) {
 			fputc(g_logm_rsvbuf[g_logm_head], stdout);
 			g_logm_head = (g_logm_head + 1) % logm_bufsize;
@@ -86,9 +96,22 @@ int logm_task(int argc, char *argv[])
 				g_logm_overflow_offset = -1;
 			}
 		}
+#endif
 
 		if (LOGM_STATUS(LOGM_BUFFER_RESIZE_REQ)) {
 			flags = irqsave();
+#ifdef CONFIG_LOGM_BINARY
+			/* Print the records written since the flush before the
+			 * buffer is replaced.  Every record is committed, so this
+			 * only waits for the writers to pause.
+			 */
+
+			if (g_logm_head != g_logm_tail) {
+				irqrestore(flags);
+				usleep(logm_print_interval);
+				continue;
+			}
+#endif
 			if (logm_change_bufsize(new_logm_bufsize) != OK) {
 				fprintf(stdout, "\n[LOGM] Failed to change buffer size\n");
 			}
@@ -56,6 +56,12 @@ static void logm_info(void)
 	fprintf(stdout, "[LOGM CONFIGURATIONS]\n");
 	fprintf(stdout, "  Buffer size : %d (bytes)\n", bufsize);
 	fprintf(stdout, "  Flusing interval : %d (ms)\n", interval);
+#ifdef CONFIG_LOGM_BINARY
+	fprintf(stdout, "  Dropped messages : EMR %d ART %d CRT %d ERR %d WRN %d NTCE %d INF %d DBG %d\n",
+			g_logm_dropmsg_prio[LOGM_EMR], g_logm_dropmsg_prio[LOGM_ART], g_logm_dropmsg_prio[LOGM_CRT],
+			g_logm_dropmsg_prio[LOGM_ERR], g_logm_dropmsg_prio[LOGM_WRN], g_logm_dropmsg_prio[LOGM_NTCE],
+			g_logm_dropmsg_prio[LOGM_INF], g_logm_dropmsg_prio[LOGM_DBG]);
+#endif
 }
 
 static int logm_tash(int argc, char **args)
@@ -74,6 +74,14 @@
 #define SIZEOF_GAT(n) ((n + 31) >> 5)
 #define SIZEOF_GRAN_S(n) (sizeof(struct gran_s) + sizeof(uint32_t) * (SIZEOF_GAT(n) - 1))
 
+/* Search hints are kept for runs of 1, 2, 4, 8, 16 and 32 granules.  The
+ * hint of an allocation of n granules is the one of the largest of these
+ * sizes not above n.
+ */
+
+#define GRAN_NHINTS 6
+#define gran_hintidx(n) ((n) >= 16 ? ((n) >= 32 ? 5 : 4) : (n) >= 4 ? ((n) >= 8 ? 3 : 2) : ((n) >= 2 ? 1 : 0))
+
 /* Debug */
 
 #ifdef CONFIG_CPP_HAVE_VARARGS
@@ -103,6 +111,8 @@
 struct gran_s {
 	uint8_t    log2gran;		/* Log base 2 of the size of one granule */
 	uint16_t   ngranules;		/* The total number of (aligned) granules in the heap */
+	uint16_t   nfree;			/* The number of free granules */
+	uint16_t   hint[GRAN_NHINTS];	/* No free run of the size starts before this GAT entry */
 #ifdef CONFIG_GRAN_INTR
 	irqstate_t irqstate;		/* For exclusive access to the GAT */
 #else
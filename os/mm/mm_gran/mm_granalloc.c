@@ -56,6 +56,7 @@
 
 #include <tinyara/config.h>
 
+#include <stdint.h>
 #include <assert.h>
 
 #include <tinyara/mm/gran.h>
@@ -68,10 +69,123 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Index of the lowest set bit of a non-zero GAT entry */
+
+#ifdef __GNUC__
+#define gran_ctz(x) __builtin_ctz(x)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifndef gran_ctz
+static inline int gran_ctz(uint32_t x)
+{
+	int n = 0;
+
+	if ((x & 0x0000ffff) == 0) {
+		n += 16;
+		x >>= 16;
+	}
+
+	if ((x & 0x000000ff) == 0) {
+		n += 8;
+		x >>= 8;
+	}
+
+	if ((x & 0x0000000f) == 0) {
+		n += 4;
+		x >>= 4;
+	}
+
+	if ((x & 0x00000003) == 0) {
+		n += 2;
+		x >>= 2;
+	}
+
+	return n + ((x & 1) ^ 1);
+}
+#endif
+
+/****************************************************************************
+ * Name: gran_search
+ *
+ * Description:
+ *   Find the first run of 'ngranules' free granules, searching one GAT
+ *   entry at a time from the search hint of the size.
+ *
+ * Input Parameters:
+ *   priv - The granule heap state structure.
+ *   ngranules - The number of granules needed, 1 to 32.
+ *
+ * Returned Value:
+ *   The granule number of the run, or -1 if there is none.
+ *
+ ****************************************************************************/
+
+static int gran_search(FAR struct gran_s *priv, unsigned int ngranules)
+{
+	unsigned int nentries = SIZEOF_GAT(priv->ngranules);
+	unsigned int gatidx;
+	unsigned int len;
+	unsigned int shift;
+	uint64_t     run;
+	uint32_t     starts;
+	int          granno = -1;
+	int          hint;
+
+	for (gatidx = priv->hint[gran_hintidx(ngranules)]; gatidx < nentries; gatidx++) {
+		/* Skip the entries with no free granule */
+
+		if (priv->gat[gatidx] == 0xffffffff) {
+			continue;
+		}
+
+		/* Take the free bits of this entry and of the next one, so that runs
+		 * may continue into the next entry.  The granules past the end of
+		 * the heap are marked allocated.
+		 */
+
+		run = priv->gat[gatidx];
+		if (gatidx + 1 < nentries) {
+			run |= (uint64_t)priv->gat[gatidx + 1] << 32;
+		} else {
+			run |= (uint64_t)0xffffffff << 32;
+		}
+
+		run = ~run;
+
+		/* AND the free bits with themselves shifted, doubling the length
+		 * covered each time: bit n is then set if the granules n to
+		 * n + ngranules - 1 are all free.
+		 */
+
+		for (len = 1; len < ngranules; len += shift) {
+			shift = len < ngranules - len ? len : ngranules - len;
+			run &= run >> shift;
+		}
+
+		/* Take the first run that starts in this entry */
+
+		starts = (uint32_t)run;
+		if (starts != 0) {
+			granno = (gatidx << 5) + gran_ctz(starts);
+			break;
+		}
+	}
+
+	/* No run of this size, or any larger size, starts before this entry */
+
+	for (hint = 0; hint < GRAN_NHINTS; hint++) {
+		if ((1u << hint) >= ngranules && priv->hint[hint] < gatidx) {
+			priv->hint[hint] = gatidx;
+		}
+	}
+
+	return granno;
+}
+
 /****************************************************************************
  * Name: gran_common_alloc
  *
@@ -91,14 +205,8 @@ static inline FAR void *gran_common_alloc(FAR struct gran_s *priv, size_t size)
 {
 	unsigned int ngranules;
 	size_t       tmpmask;
-	uintptr_t    alloc;
-	uint32_t     curr;
-	uint32_t     next;
-	uint32_t     mask;
-	int          granidx;
-	int          gatidx;
-	int          bitidx;
-	int          shift;
+	uintptr_t    alloc = 0;
+	int          granno;
 
 	DEBUGASSERT(priv && size <= 32 * (1 << priv->log2gran));
 
@@ -111,147 +219,26 @@ static inline FAR void *gran_common_alloc(FAR struct gran_s *priv, size_t size)
 
 		tmpmask = (1 << priv->log2gran) - 1;
 		ngranules = (size + tmpmask) >> priv->log2gran;
-
-		/* Then create mask for that number of granules */
-
 		DEBUGASSERT(ngranules <= 32);
-		mask = 0xffffffff >> (32 - ngranules);
-
-		/* Now search the granule allocation table for that number of contiguous */
-
-		alloc = priv->heapstart;
-
-		for (granidx = 0; granidx < priv->ngranules; granidx += 32) {
-			/* Get the GAT index associated with the granule table entry */
-
-			gatidx = granidx >> 5;
-			curr = priv->gat[gatidx];
-
-			/* Handle the case where there are no free granules in the entry */
-
-			if (curr == 0xffffffff) {
-				alloc += (32 << priv->log2gran);
-				continue;
-			}
-
-			/* Get the next entry from the GAT to support a 64 bit shift */
-
-			if (granidx < priv->ngranules) {
-				next = priv->gat[gatidx + 1];
-			}
-
-			/* Use all ones when are at the last entry in the GAT (meaning
-			 * nothing can be allocated.
-			 */
-
-			else {
-				next = 0xffffffff;
-			}
-
-			/* Search through the allocations in the 'curr' GAT entry
-			 * to see if we can satisfy the allocation starting in that
-			 * entry.
-			 *
-			 * This loop continues until either all of the bits have been
-			 * examined (bitidx >= 32), or until there are insufficient
-			 * granules left to satisfy the allocation.
-			 */
-
-			for (bitidx = 0; bitidx < 32 && (granidx + bitidx + ngranules) <= priv->ngranules;) {
-				/* Break out if there are no further free bits in 'curr'.
-				 * All of the zero bits might have gotten shifted out.
-				 */
-
-				if (curr == 0xffffffff) {
-					break;
-				}
-
-				/* Check for the first zero bit in the lower or upper 16-bits.
-				 * From the test above, we know that at least one of the 32-
-				 * bits in 'curr' is zero.
-				 */
-
-				else if ((curr & 0x0000ffff) == 0x0000ffff) {
-					/* Not in the lower 16 bits.  The first free bit must be
-					 * in the upper 16 bits.
-					 */
-
-					shift = 16;
-				}
-
-				/* We know that the first free bit is now within the lower 16
-				 * bits of 'curr'.  Is it in the upper or lower byte?
-				 */
-
-				else if ((curr & 0x0000ff) == 0x000000ff) {
-					/* Not in the lower 8 bits.  The first free bit must be in
-					 * the upper 8 bits.
-					 */
-
-					shift = 8;
-				}
-
-				/* We know that the first free bit is now within the lower 4
-				 * bits of 'curr'.  Is it in the upper or lower nibble?
-				 */
-
-				else if ((curr & 0x00000f) == 0x0000000f) {
-					/* Not in the lower 4 bits.  The first free bit must be in
-					 * the upper 4 bits.
-					 */
-
-					shift = 4;
-				}
-
-				/* We know that the first free bit is now within the lower 4 bits
-				 * of 'curr'.  Is it in the upper or lower pair?
-				 */
-
-				else if ((curr & 0x000003) == 0x00000003) {
-					/* Not in the lower 2 bits.  The first free bit must be in
-					 * the upper 2 bits.
-					 */
-
-					shift = 2;
-				}
-
-				/* We know that the first free bit is now within the lower 4 bits
-				 * of 'curr'.  Check if we have the allocation at this bit position.
-				 */
-
-				else if ((curr & mask) == 0) {
-					/* Yes.. mark these granules allocated */
-
-					gran_mark_allocated(priv, alloc, ngranules);
-
-					/* And return the allocation address */
-
-					gran_leave_critical(priv);
-					return (FAR void *)alloc;
-				}
-
-				/* The free allocation does not start at this position */
 
-				else {
-					shift = 1;
-				}
+		/* Search the granule allocation table, unless there are not that
+		 * many free granules left.
+		 */
 
-				/* Set up for the next time through the loop.  Perform a 64
-				 * bit shift to move to the next gran position andi ncrement
-				 * to the next candidate allocation address.
-				 */
+		if (ngranules <= priv->nfree) {
+			granno = gran_search(priv, ngranules);
+			if (granno >= 0) {
+				/* Mark these granules allocated */
 
-				alloc  += (shift << priv->log2gran);
-				curr    = (curr >> shift) | (next << (32 - shift));
-				next  >>= shift;
-				bitidx += shift;
+				alloc = priv->heapstart + ((uintptr_t)granno << priv->log2gran);
+				gran_mark_allocated(priv, alloc, ngranules);
 			}
 		}
 
 		gran_leave_critical(priv);
 	}
 
-	return NULL;
+	return (FAR void *)alloc;
 }
 
 /****************************************************************************
@@ -91,7 +91,9 @@ static inline void gran_common_free(FAR struct gran_s *priv, FAR void *memory, s
 	unsigned int granmask;
 	unsigned int ngranules;
 	unsigned int avail;
+	unsigned int hintidx;
 	uint32_t     gatmask;
+	int          i;
 
 	DEBUGASSERT(priv && memory && size <= 32 * (1 << priv->log2gran));
 
@@ -114,6 +116,18 @@ static inline void gran_common_free(FAR struct gran_s *priv, FAR void *memory, s
 
 	granmask = (1 << priv->log2gran) - 1;
 	ngranules = (size + granmask) >> priv->log2gran;
+	priv->nfree += ngranules;
+
+	/* The freed granules may complete runs of up to 32 granules starting
+	 * from 31 granules before them: search from there again.
+	 */
+
+	hintidx = granno >= 32 ? (granno - 31) >> 5 : 0;
+	for (i = 0; i < GRAN_NHINTS; i++) {
+		if (priv->hint[i] > hintidx) {
+			priv->hint[i] = hintidx;
+		}
+	}
 
 	/* Clear bits in the GAT entry or entries */
 
@@ -146,8 +146,17 @@ static inline FAR struct gran_s *gran_common_initialize(FAR void *heapstart, siz
 
 		priv->log2gran  = log2gran;
 		priv->ngranules = ngranules;
+		priv->nfree     = ngranules;
 		priv->heapstart = alignedstart;
 
+		/* Mark the bits past the last granule allocated, so that searches
+		 * need not check the end of the heap.
+		 */
+
+		if ((ngranules & 31) != 0) {
+			priv->gat[ngranules >> 5] = 0xffffffff << (ngranules & 31);
+		}
+
 		/* Initialize mutual exclusion support */
 
 #ifndef CONFIG_GRAN_INTR
@@ -109,6 +109,9 @@ void gran_mark_allocated(FAR struct gran_s *priv, uintptr_t alloc, unsigned int
 	gatidx = granno >> 5;
 	gatbit = granno & 31;
 
+	DEBUGASSERT(ngranules <= priv->nfree);
+	priv->nfree -= ngranules;
+
 	/* Mark bits in the GAT entry or entries */
 
 	avail = 32 - gatbit;
@@ -91,9 +91,20 @@
 #include <string.h>
 #include <poll.h>
 #include <time.h>
+#include <tinyara/fs/fs.h>
 
 #define NUM_SOCKETS MEMP_NUM_NETCONN
 
+/* A poll that stays set up across waits (an epoll interest set) wants
+ * every event, not just the first one.
+ */
+
+#ifdef CONFIG_FS_EPOLL
+#define LWIP_POLL_PERSISTENT(fds) ((fds)->cb != NULL)
+#else
+#define LWIP_POLL_PERSISTENT(fds) 0
+#endif
+
 /** Description for a task waiting in select */
 struct lwip_select_cb {
 	/** Pointer to the next waiting task */
@@ -112,6 +123,8 @@ struct lwip_select_cb {
 #else
 	/** Pointer to semaphore used post output event */
 	sys_sem_t *poll_sem;
+	/** The pollfd of the poll, to report events */
+	struct pollfd *fds;
 	/** Pointer to event-set of requested poll events */
 	pollevent_t events;
 	/** socket descriptor value */
@@ -548,6 +561,11 @@ int lwip_close(int s)
 int lwip_sock_close(struct socket *sock)
 {
 	int is_tcp = 0;
+
+	/* Take the socket out of the epoll sets before it goes away */
+
+	epoll_purge(sock);
+
 	if (sock->conn != NULL) {
 		is_tcp = netconn_type(sock->conn) == NETCONN_TCP;
 	} else {
@@ -1415,8 +1433,10 @@ static int lwip_poll_setup(int fd, struct socket * sock, struct pollfd * fds)
 	/* Check if any requested events are already in effect */
 	if (nready > 0 && fds->revents != 0) {
 		/* Yes.. then signal the poll logic */
-		sys_sem_signal(fds->sem);
-		return 0;
+		poll_notify(fds);
+		if (!LWIP_POLL_PERSISTENT(fds)) {
+			return 0;
+		}
 	}
 
 	scb_size = LWIP_MEM_ALIGN_SIZE(sizeof(struct lwip_select_cb));
@@ -1434,6 +1454,7 @@ static int lwip_poll_setup(int fd, struct socket * sock, struct pollfd * fds)
 	select_cb->prev = NULL;
 	select_cb->sem_signalled = 0;
 	select_cb->poll_sem = fds->sem;
+	select_cb->fds = fds;
 	select_cb->events = fds->events;
 	select_cb->sfd = fd;
 
@@ -1466,7 +1487,7 @@ static int lwip_poll_setup(int fd, struct socket * sock, struct pollfd * fds)
 	if (nready > 0 && fds->revents != 0) {
 		/* Yes.. then signal the poll logic */
 
-		sys_sem_signal(fds->sem);
+		poll_notify(fds);
 	}
 
 	return 0;
@@ -1529,9 +1550,6 @@ static int lwip_poll_teardown(int fd, struct socket * sock, struct pollfd * fds)
 
 int lwip_poll(int fd, struct pollfd * fds, bool setup)
 {
-
-	int ret = 0;
-
 	struct socket *sock = NULL;
 
 	/* First get the socket's status (protected)... */
@@ -1541,18 +1559,34 @@ int lwip_poll(int fd, struct pollfd * fds, bool setup)
 		return -EBADF;
 	}
 
+	return lwip_sock_poll(sock, fds, setup);
+}
+
+/****************************************************************************
+ * Function: lwip_sock_poll
+ *
+ * Description:
+ *   Like lwip_poll(), but for the socket instead of the descriptor
+ *   fds->fd.  Used by epoll to tear down a poll whatever the descriptor
+ *   refers to by then.
+ *
+ ****************************************************************************/
+
+int lwip_sock_poll(struct socket *sock, struct pollfd *fds, bool setup)
+{
+	int ret = 0;
+
 	/* Check if we are setting up or tearing down the poll */
 
 	if (setup) {
 		/* Perform the LWIP poll() setup */
-		ret = lwip_poll_setup(fd, sock, fds);
+		ret = lwip_poll_setup(fds->fd, sock, fds);
 	} else {
 		/* Perform the LWIP poll() teardown */
-		ret = lwip_poll_teardown(fd, sock, fds);
+		ret = lwip_poll_teardown(fds->fd, sock, fds);
 	}
 
 	return ret;
-
 }
 
 #endif							/*LWIP_SELECT */
@@ -1679,13 +1713,25 @@ again:
 				}
 			}
 			if (do_signal) {
-				scb->sem_signalled = 1;
 				/* Don't call SYS_ARCH_UNPROTECT() before signaling the semaphore, as this might
 				   lead to the select thread taking itself off the list, invalidagin the semaphore. */
 #if LWIP_SELECT
+				scb->sem_signalled = 1;
 				sys_sem_signal(&scb->sem);
 #else
-				sys_sem_signal(scb->poll_sem);
+				if (sock->rcvevent > 0) {
+					scb->fds->revents |= (scb->events & POLLIN);
+				}
+				if (sock->sendevent != 0) {
+					scb->fds->revents |= (scb->events & POLLOUT);
+				}
+				if (sock->errevent != 0) {
+					scb->fds->revents |= (scb->events & POLLERR);
+				}
+				if (!LWIP_POLL_PERSISTENT(scb->fds)) {
+					scb->sem_signalled = 1;
+				}
+				poll_notify(scb->fds);
 #endif
 			}
 		}
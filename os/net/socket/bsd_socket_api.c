@@ -55,11 +55,22 @@
 
 #include <tinyara/config.h>
 #include <tinyara/cancelpt.h>
+#include <tinyara/sched.h>
 
 #ifdef CONFIG_NET
 
 #include <sys/socket.h>
 
+/* Charge a successful transfer to the I/O counters of the calling task */
+
+#define socket_ioaccount(dir, result) \
+	do { \
+		if ((result) >= 0) { \
+			sched_ioaccount(dir##calls, 1); \
+			sched_ioaccount(dir##bytes, (result)); \
+		} \
+	} while (0)
+
 int bind(int s, const struct sockaddr *name, socklen_t namelen)
 {
 	return lwip_bind(s, name, namelen);
@@ -128,6 +139,7 @@ int recv(int s, void *mem, size_t len, int flags)
 	(void)enter_cancellation_point();
 	int result = lwip_recv(s, mem, len, flags);
 	leave_cancellation_point();
+	socket_ioaccount(recv, result);
 	return result;
 }
 
@@ -137,6 +149,7 @@ int recvfrom(int s, void *mem, size_t len, int flags, struct sockaddr *from, soc
 	(void)enter_cancellation_point();
 	int result = lwip_recvfrom(s, mem, len, flags, from, fromlen);
 	leave_cancellation_point();
+	socket_ioaccount(recv, result);
 	return result;
 }
 
@@ -146,6 +159,7 @@ int send(int s, const void *data, size_t size, int flags)
 	(void)enter_cancellation_point();
 	int result = lwip_send(s, data, size, flags);
 	leave_cancellation_point();
+	socket_ioaccount(send, result);
 	return result;
 }
 
@@ -155,6 +169,7 @@ int sendto(int s, const void *data, size_t size, int flags, const struct sockadd
 	(void)enter_cancellation_point();
 	int result = lwip_sendto(s, data, size, flags, to, tolen);
 	leave_cancellation_point();
+	socket_ioaccount(send, result);
 	return result;
 }
 